@@ -0,0 +1,70 @@
+#include <catch2/catch_all.hpp>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/StructuralHash.hpp"
+#include "cpp/cad/core/usecase/DiffModelsUseCase.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::Part;
+
+namespace {
+
+// 1000 groups x 100 assemblies x 10 parts = 1M parts, 100k assemblies.
+Model makeSyntheticModel() {
+  Model model;
+  model.root.id.value = "root";
+  model.root.name = "Root";
+  for (int g = 0; g < 1000; ++g) {
+    Assembly group;
+    group.id.value = "g" + std::to_string(g);
+    group.name = "Group " + std::to_string(g);
+    for (int a = 0; a < 100; ++a) {
+      Assembly assembly;
+      assembly.id.value = std::string(group.id.value) + "a" + std::to_string(a);
+      assembly.name = "Assembly " + std::to_string(a);
+      for (int p = 0; p < 10; ++p) {
+        Part part;
+        part.id.value = std::string(assembly.id.value) + "p" + std::to_string(p);
+        part.name = "Hex Bolt M" + std::to_string(p + 3);
+        assembly.parts.push_back(std::move(part));
+      }
+      group.children.push_back(std::move(assembly));
+    }
+    model.root.children.push_back(std::move(group));
+  }
+  return model;
+}
+
+} // namespace
+
+TEST_CASE("Diff of two 1M-part revisions with a handful of changes",
+          "[benchmark]") {
+  Model before = makeSyntheticModel();
+  Model after = before;
+  after.root.children[17].children[3].parts[4].name = "Washer";
+  after.root.children[512].children.pop_back();
+  after.root.children[900].children[42].parts.push_back(
+      after.root.children[901].children[1].parts.back());
+  after.root.children[901].children[1].parts.pop_back();
+
+  BENCHMARK("computeStructuralHashes (1M parts)") {
+    cad::domain::computeStructuralHashes(before.root);
+    return before.root.subtreeHash;
+  };
+
+  cad::concurrency::ThreadPool pool(0);
+  BENCHMARK("computeStructuralHashes on a pool (1M parts)") {
+    cad::domain::computeStructuralHashes(before.root, pool);
+    return before.root.subtreeHash;
+  };
+
+  cad::domain::computeStructuralHashes(after.root);
+
+  BENCHMARK("DiffModelsUseCase::compare (1M parts, 3 edits)") {
+    return cad::usecase::DiffModelsUseCase::compare(before, after);
+  };
+
+  auto diff = cad::usecase::DiffModelsUseCase::compare(before, after);
+  REQUIRE(diff.changes.size() == 3);
+}
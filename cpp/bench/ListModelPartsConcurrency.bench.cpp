@@ -0,0 +1,64 @@
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/usecase/ListModelPartsUseCase.hpp"
+
+namespace {
+
+class CountingLogger final : public cad::ports::LoggerPort {
+public:
+  void log(cad::ports::LogLevel, const std::string &) override {
+    count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<std::size_t> count_{0};
+};
+
+std::string makeFakeModel(int assemblies, int partsPerAssembly) {
+  std::string content;
+  for (int a = 0; a < assemblies; ++a) {
+    content += "Assembly: A" + std::to_string(a) + "\n";
+    for (int p = 0; p < partsPerAssembly; ++p) {
+      content += "Part: P" + std::to_string(p) + "\n";
+    }
+    content += "EndAssembly\n";
+  }
+  return content;
+}
+
+} // namespace
+
+// Throughput of one shared use case instance as the pool grows; the time per
+// batch should fall roughly linearly until the cores are saturated.
+TEST_CASE("Concurrent list throughput vs threads", "[benchmark]") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+  CountingLogger logger;
+
+  constexpr int kLocators = 256;
+  std::vector<std::string> locators;
+  for (int i = 0; i < kLocators; ++i) {
+    locators.push_back("mem:" + std::to_string(i));
+    source.registerContent(locators.back(), makeFakeModel(100, 10));
+  }
+  cad::usecase::ListModelPartsUseCase usecase(source, reader, logger);
+
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned threads = 1; threads <= 2 * cores && threads <= 64;
+       threads *= 2) {
+    cad::concurrency::ThreadPool pool(threads);
+    BENCHMARK(std::to_string(kLocators) + " lists, " + std::to_string(threads) +
+              " threads") {
+      return usecase.listAll(locators, pool).size();
+    };
+  }
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch_all.hpp>
+
+#include <string>
+
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/usecase/BasicListModelPartsUseCase.hpp"
+#include "cpp/cad/core/usecase/ListModelPartsUseCase.hpp"
+
+namespace {
+
+// Discards messages but counts them so the calls cannot be optimised away.
+class CountingLogger final : public cad::ports::LoggerPort {
+public:
+  void log(cad::ports::LogLevel, const std::string &message) override {
+    bytes_ += message.size();
+  }
+  std::size_t bytes() const { return bytes_; }
+
+private:
+  std::size_t bytes_ = 0;
+};
+
+std::string makeFakeModel(int assemblies, int partsPerAssembly) {
+  std::string content;
+  for (int a = 0; a < assemblies; ++a) {
+    content += "Assembly: A" + std::to_string(a) + "\n";
+    for (int p = 0; p < partsPerAssembly; ++p) {
+      content += "Part: P" + std::to_string(p) + "\n";
+    }
+    content += "EndAssembly\n";
+  }
+  return content;
+}
+
+// Keeps the compiler from seeing the dynamic type behind the port reference.
+[[gnu::noinline]] cad::ports::LoggerPort &opaque(cad::ports::LoggerPort &port) {
+  return port;
+}
+
+} // namespace
+
+TEST_CASE("Virtual vs static dispatch in the listing use case", "[benchmark]") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+  CountingLogger logger;
+  source.registerContent("mem:bench", makeFakeModel(1000, 10));
+
+  cad::usecase::ListModelPartsUseCase dynamicUseCase(source, reader, logger);
+  cad::usecase::BasicListModelPartsUseCase staticUseCase(source, reader,
+                                                         logger);
+  REQUIRE(dynamicUseCase.list("mem:bench") == staticUseCase.list("mem:bench"));
+
+  BENCHMARK("list, ports (virtual)") {
+    return dynamicUseCase.list("mem:bench");
+  };
+  BENCHMARK("list, concrete adapters (static)") {
+    return staticUseCase.list("mem:bench");
+  };
+
+  // Per-node path: one logger call per node of a 1M-node model.
+  const std::string message = "node";
+  cad::ports::LoggerPort &port = opaque(logger);
+  BENCHMARK("1M per-node calls, virtual") {
+    for (int i = 0; i < 1000000; ++i) {
+      port.log(cad::ports::LogLevel::Trace, message);
+    }
+    return logger.bytes();
+  };
+  BENCHMARK("1M per-node calls, static") {
+    for (int i = 0; i < 1000000; ++i) {
+      logger.log(cad::ports::LogLevel::Trace, message);
+    }
+    return logger.bytes();
+  };
+}
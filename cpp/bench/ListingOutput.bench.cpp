@@ -0,0 +1,73 @@
+#include <catch2/catch_all.hpp>
+
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+#include "cpp/cad/adapters/cad-model-reader/text/TextCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/listing-writer/json/JsonListingWriterAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/memory/SpanStreamBuf.hpp"
+#include "cpp/cad/core/usecase/ModelListing.hpp"
+
+using cad::adapters::json::JsonListingWriterAdapter;
+
+namespace {
+
+// Counts and drops everything written, so only formatting is timed
+class NullBuffer : public std::streambuf {
+public:
+  std::size_t bytes = 0;
+
+protected:
+  std::streamsize xsputn(const char *, std::streamsize n) override {
+    bytes += static_cast<std::size_t>(n);
+    return n;
+  }
+  int overflow(int c) override {
+    ++bytes;
+    return c;
+  }
+};
+
+// The text format of ParallelModelListing's tree: 6 levels of 8-way
+// assemblies with two parts each, ~900k nodes.
+void grow(std::string &content, int depth) {
+  content += "Part: Part 0\nPart: Part 1\n";
+  if (depth == 0) {
+    return;
+  }
+  for (int c = 0; c < 8; ++c) {
+    content += "Assembly: Assembly " + std::to_string(7 - c) + "\n";
+    grow(content, depth - 1);
+    content += "EndAssembly\n";
+  }
+}
+
+} // namespace
+
+// Structured output against the text listing and against parsing the same
+// model: writing records should cost no more than reading them did.
+TEST_CASE("Listing output formats on a ~900k-node model", "[benchmark]") {
+  std::string content;
+  grow(content, 6);
+  auto parse = [&] {
+    cad::adapters::memory::SpanIStream stream(content);
+    return cad::adapters::text::TextCadModelReaderAdapter().readModelFromStream(stream);
+  };
+  const cad::domain::Model model = parse();
+
+  BENCHMARK("parse, text reader") { return parse().root.children.size(); };
+  BENCHMARK("text lines") { return cad::usecase::listModelLines(model).size(); };
+  for (auto [label, layout] : {std::pair{"ndjson", JsonListingWriterAdapter::Layout::Lines},
+                               std::pair{"json", JsonListingWriterAdapter::Layout::Array}}) {
+    BENCHMARK(std::string(label) + " records") {
+      NullBuffer sink;
+      std::ostream out(&sink);
+      JsonListingWriterAdapter writer(out, layout);
+      cad::usecase::writeModelListing(model, writer);
+      writer.finish();
+      return sink.bytes;
+    };
+  }
+}
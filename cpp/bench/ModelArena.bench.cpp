@@ -0,0 +1,98 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/core/domain/ModelArena.hpp"
+
+using cad::domain::Model;
+using cad::domain::ModelArena;
+
+namespace {
+
+// Forwards to `upstream` and counts allocations.
+class CountingResource final : public std::pmr::memory_resource {
+public:
+  std::size_t allocations = 0;
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t align) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void *p, std::size_t bytes, std::size_t align) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+std::string makeFakeModel(int assemblies, int partsPerAssembly) {
+  std::string content;
+  for (int a = 0; a < assemblies; ++a) {
+    content += "Assembly: Assembly number " + std::to_string(a) + "\n";
+    for (int p = 0; p < partsPerAssembly; ++p) {
+      content += "Part: A part with a long name " + std::to_string(p) + "\n";
+    }
+    content += "EndAssembly\n";
+  }
+  return content;
+}
+
+Model parse(const std::string &content, std::pmr::memory_resource *resource) {
+  std::istringstream stream(content);
+  return cad::adapters::fake::FakeCadModelReaderAdapter().readModelFromStream(
+      stream, resource);
+}
+
+} // namespace
+
+// 5k assemblies x 10 parts: per-node heap allocation against one arena per
+// model, for the parse and for the teardown alone.
+TEST_CASE("Model allocation and teardown: heap vs arena", "[benchmark]") {
+  const std::string content = makeFakeModel(5000, 10);
+
+  CountingResource heap;
+  { Model model = parse(content, &heap); }
+  CountingResource chunks;
+  {
+    ModelArena arena(ModelArena::kDefaultInitialBytes, &chunks);
+    arena.adopt(parse(content, arena.resource()));
+  }
+  WARN("upstream allocations per model: heap " << heap.allocations
+                                               << ", arena " << chunks.allocations);
+  CHECK(chunks.allocations * 100 < heap.allocations);
+
+  BENCHMARK("parse + teardown, heap") {
+    return parse(content, std::pmr::new_delete_resource()).root.children.size();
+  };
+
+  BENCHMARK("parse + teardown, arena") {
+    ModelArena arena;
+    return arena.adopt(parse(content, arena.resource())).root.children.size();
+  };
+
+  BENCHMARK_ADVANCED("teardown, heap")(Catch::Benchmark::Chronometer meter) {
+    std::vector<std::unique_ptr<Model>> models;
+    for (int i = 0; i < meter.runs(); ++i) {
+      models.push_back(std::make_unique<Model>(
+          parse(content, std::pmr::new_delete_resource())));
+    }
+    meter.measure([&](int i) { models[i].reset(); });
+  };
+
+  BENCHMARK_ADVANCED("teardown, arena")(Catch::Benchmark::Chronometer meter) {
+    std::vector<std::unique_ptr<ModelArena>> arenas;
+    for (int i = 0; i < meter.runs(); ++i) {
+      arenas.push_back(std::make_unique<ModelArena>());
+      arenas.back()->adopt(parse(content, arenas.back()->resource()));
+    }
+    meter.measure([&](int i) { arenas[i].reset(); });
+  };
+}
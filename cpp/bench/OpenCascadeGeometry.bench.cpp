@@ -0,0 +1,205 @@
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "cpp/cad/adapters/cad-model-reader/opencascade/OpenCascadeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/usecase/FindDuplicateGeometryUseCase.hpp"
+
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <STEPCAFControl_Writer.hxx>
+#include <TDocStd_Document.hxx>
+#include <XCAFApp_Application.hxx>
+#include <XCAFDoc_DocumentTool.hxx>
+#include <XCAFDoc_ShapeTool.hxx>
+#include <gp_Trsf.hxx>
+
+using cad::adapters::opencascade::OpenCascadeCadModelReaderAdapter;
+
+namespace {
+
+std::string readFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  std::ostringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+// An assembly of `prototypes` distinct cylinders, each placed `instances`
+// times, written as STEP. With `copies`, every cylinder is built and added
+// that many times over, as a model exported without shared geometry would
+// hold it.
+std::string makeSyntheticStep(int prototypes, int instances, int copies = 1) {
+  ::opencascade::handle<TDocStd_Document> doc;
+  XCAFApp_Application::GetApplication()->NewDocument("MDTV-XCAF", doc);
+  auto shapeTool = XCAFDoc_DocumentTool::ShapeTool(doc->Main());
+  TDF_Label assembly = shapeTool->NewShape();
+  for (int p = 0; p < prototypes * copies; ++p) {
+    TDF_Label prototype = shapeTool->AddShape(
+        BRepPrimAPI_MakeCylinder(1.0 + 0.01 * (p / copies), 5.0).Shape(), false);
+    for (int i = 0; i < instances; ++i) {
+      gp_Trsf placement;
+      placement.SetTranslation(gp_Vec(10.0 * p, 10.0 * i, 0.0));
+      shapeTool->AddComponent(assembly, prototype, TopLoc_Location(placement));
+    }
+  }
+  shapeTool->UpdateAssemblies();
+
+  STEPCAFControl_Writer writer;
+  writer.Transfer(doc, STEPControl_AsIs);
+  std::string path = "bench_synthetic_assembly.step";
+  writer.Write(path.c_str());
+  XCAFApp_Application::GetApplication()->Close(doc);
+  std::string content = readFile(path);
+  std::remove(path.c_str());
+  return content;
+}
+
+void benchmarkThreads(const std::string &label, const std::string &content) {
+  OpenCascadeCadModelReaderAdapter adapter;
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned threads = 1; threads <= cores; threads *= 2) {
+    cad::concurrency::ThreadPool pool(threads);
+    BENCHMARK(label + ", " + std::to_string(threads) + " threads") {
+      std::istringstream stream(content);
+      return adapter
+          .readMeasuredModel(stream, pool, std::pmr::get_default_resource())
+          .prototypes.size();
+    };
+  }
+}
+
+// Triangles per second of read plus meshing as the pool grows, printed once
+// per thread count next to the Catch2 timings.
+void benchmarkTessellation(const std::string &label, const std::string &content) {
+  OpenCascadeCadModelReaderAdapter adapter;
+  cad::ports::TessellationOptions options;
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned threads = 1; threads <= cores; threads *= 2) {
+    cad::concurrency::ThreadPool pool(threads);
+    std::size_t triangles = 0;
+    auto tessellate = [&] {
+      std::istringstream stream(content);
+      triangles = 0;
+      adapter.readTessellatedModel(
+          stream, options, pool,
+          [&](const std::string &, cad::domain::Mesh &&mesh) {
+            triangles += mesh.triangleCount();
+          },
+          std::pmr::get_default_resource());
+      return triangles;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    tessellate();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << label << ", " << threads << " threads: " << triangles
+              << " triangles, " << static_cast<std::size_t>(triangles / elapsed.count())
+              << " triangles/s\n";
+
+    BENCHMARK(label + ", tessellate, " + std::to_string(threads) + " threads") {
+      return tessellate();
+    };
+  }
+}
+
+} // namespace
+
+// Read plus measurement time as the pool grows. Reading is serial, so the
+// measured share of the time should fall with the thread count.
+TEST_CASE("Prototype measurement vs threads", "[benchmark][opencascade]") {
+  std::string ballValve = readFile("test-data/ExampleBallValve.step");
+  if (ballValve.empty()) {
+    ballValve = readFile("../test-data/ExampleBallValve.step");
+  }
+  if (!ballValve.empty()) {
+    benchmarkThreads("ExampleBallValve.step", ballValve);
+  }
+
+  benchmarkThreads("200 prototypes x 20 instances", makeSyntheticStep(200, 20));
+}
+
+// Where meshing outweighs reading, throughput should follow the thread count
+// until prototypes run out.
+TEST_CASE("Prototype tessellation vs threads", "[benchmark][opencascade]") {
+  benchmarkTessellation("200 prototypes x 20 instances", makeSyntheticStep(200, 20));
+}
+
+// Signing and comparing prototypes as the pool grows; the read is done once,
+// outside the timing. 400 prototypes fall into 100 buckets of four copies.
+TEST_CASE("Duplicate geometry detection vs threads", "[benchmark][opencascade]") {
+  std::istringstream stream(makeSyntheticStep(100, 2, 4));
+  OpenCascadeCadModelReaderAdapter adapter;
+  auto geometry = adapter.readPrototypeGeometry(stream, std::pmr::get_default_resource());
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  std::ostringstream log;
+  cad::adapters::fake::FakeLoggerAdapter logger(log);
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned threads = 1; threads <= cores; threads *= 2) {
+    cad::concurrency::ThreadPool pool(threads);
+    cad::usecase::FindDuplicateGeometryUseCase usecase(source, adapter, logger, pool);
+    BENCHMARK("100 prototypes x 4 copies, " + std::to_string(threads) + " threads") {
+      return usecase.findGroups(*geometry, 1e-4).size();
+    };
+  }
+}
+
+// Read time of the same content with and without the BinXCAF document cache.
+// The cached reader is primed once, so every timed read is a reload.
+TEST_CASE("STEP transfer vs binary document reload", "[benchmark][opencascade]") {
+  std::string content = makeSyntheticStep(200, 20);
+  std::filesystem::path cache =
+      std::filesystem::temp_directory_path() / "cad_bench_step_cache";
+  std::filesystem::remove_all(cache);
+
+  OpenCascadeCadModelReaderAdapter transfer;
+  OpenCascadeCadModelReaderAdapter cached(cache.string());
+  std::istringstream prime(content);
+  cached.readModelFromStream(prime);
+
+  BENCHMARK("200 prototypes x 20 instances, STEP transfer") {
+    std::istringstream stream(content);
+    return transfer.readModelFromStream(stream).root.children.size();
+  };
+  BENCHMARK("200 prototypes x 20 instances, BinXCAF reload") {
+    std::istringstream stream(content);
+    return cached.readModelFromStream(stream).root.children.size();
+  };
+
+  std::filesystem::remove_all(cache);
+}
+
+// Read time of the sample file per transfer profile; `mask bench:profiles`
+// reports peak memory per profile from separate processes.
+TEST_CASE("STEP read profiles", "[benchmark][opencascade]") {
+  using cad::adapters::opencascade::StepReadProfile;
+  std::string ballValve = readFile("test-data/ExampleBallValve.step");
+  if (ballValve.empty()) {
+    ballValve = readFile("../test-data/ExampleBallValve.step");
+  }
+  if (ballValve.empty()) {
+    return;
+  }
+
+  for (auto [label, profile] : {std::pair{"structure", StepReadProfile::Structure},
+                                std::pair{"names", StepReadProfile::Names},
+                                std::pair{"full", StepReadProfile::Full}}) {
+    OpenCascadeCadModelReaderAdapter adapter("", profile);
+    BENCHMARK(std::string("ExampleBallValve.step, ") + label + " profile") {
+      std::istringstream stream(ballValve);
+      return adapter.readModelFromStream(stream).root.children.size();
+    };
+  }
+}
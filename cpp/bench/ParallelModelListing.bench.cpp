@@ -0,0 +1,52 @@
+#include <catch2/catch_all.hpp>
+
+#include <string>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/usecase/ModelListing.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::Part;
+
+namespace {
+
+// Balanced synthetic tree: 8^6 leaves under 6 levels of 8-way assemblies,
+// two parts per assembly; ~300k assemblies and ~600k parts.
+void grow(Assembly &assembly, int depth) {
+  for (int p = 0; p < 2; ++p) {
+    Part part;
+    part.name = "Part " + std::to_string(p);
+    assembly.parts.push_back(std::move(part));
+  }
+  if (depth == 0) {
+    return;
+  }
+  for (int c = 0; c < 8; ++c) {
+    Assembly child;
+    child.name = "Assembly " + std::to_string(7 - c);
+    grow(child, depth - 1);
+    assembly.children.push_back(std::move(child));
+  }
+}
+
+} // namespace
+
+// Time per listing should fall close to 1/threads up to the core count.
+TEST_CASE("Parallel listing of a ~900k-node model vs threads", "[benchmark]") {
+  Model model;
+  model.root.name = "Root";
+  grow(model.root, 6);
+
+  BENCHMARK("serial listModelLines") {
+    return cad::usecase::listModelLines(model).size();
+  };
+
+  for (std::size_t threads : {2, 4, 8, 16, 32}) {
+    cad::concurrency::ThreadPool pool(threads);
+    BENCHMARK("parallel listModelLines, " + std::to_string(threads) +
+              " threads") {
+      return cad::usecase::listModelLines(model, pool).size();
+    };
+  }
+}
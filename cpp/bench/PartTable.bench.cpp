@@ -0,0 +1,76 @@
+#include <catch2/catch_all.hpp>
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+#include "cpp/cad/adapters/part-table-writer/arrow/ArrowPartTableWriterAdapter.hpp"
+#include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/core/usecase/ExportPartTableUseCase.hpp"
+
+using cad::domain::Assembly;
+
+namespace {
+
+// Counts and drops everything written, so only the export is timed
+class NullBuffer : public std::streambuf {
+public:
+  std::size_t bytes = 0;
+
+protected:
+  std::streamsize xsputn(const char *, std::streamsize n) override {
+    bytes += static_cast<std::size_t>(n);
+    return n;
+  }
+  int overflow(int c) override {
+    ++bytes;
+    return c;
+  }
+};
+
+// 6 levels of 8-way assemblies with four parts each, ~1.2M parts; every
+// part instantiates one of 16 prototypes
+void grow(Assembly &assembly, int depth, std::size_t &next) {
+  for (int p = 0; p < 4; ++p) {
+    auto &part = assembly.parts.emplace_back();
+    part.id.value = "part-" + std::to_string(next);
+    part.name = "Part " + std::to_string(p);
+    part.prototypeId = "proto-" + std::to_string(next++ % 16);
+  }
+  if (depth == 0) {
+    return;
+  }
+  for (int c = 0; c < 8; ++c) {
+    Assembly &child = assembly.children.emplace_back();
+    child.name = "Assembly " + std::to_string(c);
+    grow(child, depth - 1, next);
+  }
+}
+
+} // namespace
+
+// A million-part model to an Arrow file, serially and with a worker per
+// core: well under a second either way.
+TEST_CASE("Part table export of a ~1.2M-part model", "[benchmark]") {
+  cad::domain::Model model;
+  model.root.name = "Root";
+  std::size_t parts = 0;
+  grow(model.root, 6, parts);
+
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  for (std::size_t threads : {std::size_t{1}, std::size_t{0}}) {
+    cad::concurrency::ThreadPool pool(threads);
+    cad::usecase::ExportPartTableUseCase usecase(source, reader, logger, pool);
+    BENCHMARK("arrow, " + std::to_string(pool.size()) + " threads") {
+      NullBuffer sink;
+      std::ostream out(&sink);
+      cad::adapters::arrow::ArrowPartTableWriterAdapter writer(out);
+      usecase.writeTable(model, writer);
+      return sink.bytes;
+    };
+  }
+}
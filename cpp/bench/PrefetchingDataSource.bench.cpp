@@ -0,0 +1,87 @@
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpp/cad/adapters/cad-model-reader/text/TextCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/memory/MemoryModelDataSourceAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/prefetch/PrefetchingModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/domain/ModelArena.hpp"
+
+namespace {
+
+// Memory source paying a fixed latency per open, as a network share or a
+// cold disk would
+class SlowSource final : public cad::ports::ModelDataSourcePort {
+public:
+  cad::adapters::memory::MemoryModelDataSourceAdapter memory;
+
+  std::unique_ptr<std::istream> open(const std::string &locator) override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return memory.open(locator);
+  }
+};
+
+// About 1 MB of the line format: 16-part assemblies
+std::string makeText() {
+  std::string content;
+  for (int a = 0; content.size() < (std::size_t(1) << 20); ++a) {
+    content += "Assembly: Subassembly " + std::to_string(a) + "\n";
+    for (int p = 0; p < 16; ++p) {
+      content += "  Part: Fastener M" + std::to_string(4 + p % 8) + "\n";
+    }
+    content += "EndAssembly\n";
+  }
+  return content;
+}
+
+// Opens and parses every locator in turn, as ResolveReferencesUseCase does
+// with one level, after hinting them all
+std::size_t readBatch(cad::ports::ModelDataSourcePort &source,
+                      const std::vector<std::string> &locators) {
+  source.prefetch(locators);
+  std::size_t assemblies = 0;
+  for (const auto &locator : locators) {
+    auto stream = source.open(locator);
+    cad::domain::ModelArena arena;
+    assemblies += arena
+                      .adopt(cad::adapters::text::TextCadModelReaderAdapter().readModelFromStream(
+                          *stream, arena.resource()))
+                      .root.children.size();
+  }
+  return assemblies;
+}
+
+} // namespace
+
+// 32 files at 10 ms of latency each plus their parse time. Without read-ahead
+// the batch takes the sum of both; with it, close to the larger.
+TEST_CASE("Batch of slow files with and without read-ahead", "[benchmark]") {
+  SlowSource slow;
+  std::vector<std::string> locators;
+  const auto content = std::make_shared<const std::string>(makeText());
+  for (int i = 0; i < 32; ++i) {
+    locators.push_back("mem:part" + std::to_string(i));
+    slow.memory.registerBuffer(locators.back(), content);
+  }
+
+  BENCHMARK("direct") { return readBatch(slow, locators); };
+
+  for (std::size_t ioThreads : {1, 2, 4}) {
+    BENCHMARK("read-ahead, " + std::to_string(ioThreads) + " I/O threads") {
+      cad::adapters::prefetch::PrefetchingModelDataSourceAdapter prefetching(
+          slow, cad::adapters::prefetch::PrefetchingModelDataSourceAdapter::kDefaultBudgetBytes,
+          ioThreads);
+      return readBatch(prefetching, locators);
+    };
+  }
+
+  cad::adapters::prefetch::PrefetchingModelDataSourceAdapter prefetching(slow);
+  REQUIRE(readBatch(prefetching, locators) == readBatch(slow, locators));
+  REQUIRE(prefetching.stats().hits == locators.size());
+  std::cout << "peak read-ahead bytes: " << prefetching.stats().peakBytes << "\n";
+}
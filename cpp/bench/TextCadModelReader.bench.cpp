@@ -0,0 +1,71 @@
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/text/TextCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/memory/SpanStreamBuf.hpp"
+#include "cpp/cad/core/domain/ModelArena.hpp"
+
+namespace {
+
+// About `megabytes` MB of generated text: 4-level assemblies of 16 parts,
+// with names repeating as generator output does.
+std::string makeText(std::size_t megabytes) {
+  std::string content;
+  content.reserve(megabytes << 20);
+  for (int a = 0; content.size() < (megabytes << 20); ++a) {
+    for (int level = 0; level < 4; ++level) {
+      content += "  Assembly: Subassembly " + std::to_string((a + level) % 64) + "\n";
+      for (int p = 0; p < 16; ++p) {
+        content += "    Part: Fastener M" + std::to_string(4 + p % 8) + " x " +
+                   std::to_string(10 + p) + "\n";
+      }
+    }
+    content += "EndAssembly\nEndAssembly\nEndAssembly\nEndAssembly\n";
+  }
+  return content;
+}
+
+// One read into an arena; prints GB/s next to the Catch2 timings
+template <typename Read>
+void measure(const std::string &label, const std::string &content, Read read) {
+  auto start = std::chrono::steady_clock::now();
+  {
+    cad::domain::ModelArena arena;
+    arena.adopt(read(arena.resource()));
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << label << ": " << content.size() / elapsed.count() / 1e9 << " GB/s\n";
+
+  BENCHMARK(std::string(label)) {
+    cad::domain::ModelArena arena;
+    return arena.adopt(read(arena.resource())).root.children.size();
+  };
+}
+
+} // namespace
+
+// Throughput of the line format on 64 MB. Target: at least 3x the
+// getline-based fake reader. Finding the lines runs at memory speed (several
+// GB/s); what remains is building the nodes, each part several times the
+// size of its line.
+TEST_CASE("Text model read throughput", "[benchmark]") {
+  const std::string content = makeText(256);
+
+  measure("fake reader, istringstream", content, [&](std::pmr::memory_resource *resource) {
+    std::istringstream stream(content);
+    return cad::adapters::fake::FakeCadModelReaderAdapter().readModelFromStream(stream, resource);
+  });
+  measure("text reader, istringstream", content, [&](std::pmr::memory_resource *resource) {
+    std::istringstream stream(content);
+    return cad::adapters::text::TextCadModelReaderAdapter().readModelFromStream(stream, resource);
+  });
+  measure("text reader, in place", content, [&](std::pmr::memory_resource *resource) {
+    cad::adapters::memory::SpanIStream stream(content);
+    return cad::adapters::text::TextCadModelReaderAdapter().readModelFromStream(stream, resource);
+  });
+}
@@ -0,0 +1,114 @@
+#include "cpp/cad/adapters/cad-model-reader/auto/AutoDetectingCadModelReaderAdapter.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "cpp/cad/adapters/common/PrefixReplayStreamBuf.hpp"
+#include "cpp/cad/adapters/model-data-source/compressed/DecompressingStream.hpp"
+
+using cad::adapters::common::ModelFormat;
+using cad::domain::Model;
+
+namespace cad::adapters::autodetect {
+
+namespace {
+
+// How many times larger the decoded model files typically are than their
+// compressed form; text CAD formats compress well, so these lean high
+constexpr std::size_t kGzipExpansion = 6;
+constexpr std::size_t kZstdExpansion = 8;
+// Peak bytes per decoded input byte of the hungriest reader; the decoded
+// format is not known without decompressing
+constexpr std::size_t kBytesPerDecodedByte = 32;
+
+} // namespace
+
+void AutoDetectingCadModelReaderAdapter::registerReader(ModelFormat format,
+                                                        ReaderFactory factory) {
+  readers_[format] = Entry{std::move(factory), nullptr};
+}
+
+cad::ports::CadModelReaderPort *
+AutoDetectingCadModelReaderAdapter::readerFor(ModelFormat format) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = readers_.find(format);
+  if (it == readers_.end()) {
+    return nullptr;
+  }
+  if (!it->second.reader && it->second.factory) {
+    it->second.reader = it->second.factory();
+  }
+  return it->second.reader.get();
+}
+
+Model AutoDetectingCadModelReaderAdapter::readModelFromStream(
+    std::istream &stream, std::pmr::memory_resource *resource) {
+  return read(stream, resource, nullptr);
+}
+
+Model AutoDetectingCadModelReaderAdapter::readModelFromStream(
+    std::istream &stream, std::pmr::memory_resource *resource,
+    cad::ports::ProgressPort &progress) {
+  return read(stream, resource, &progress);
+}
+
+std::size_t AutoDetectingCadModelReaderAdapter::estimateReadBytes(std::istream &stream) {
+  std::streambuf *buffer = stream.rdbuf();
+  const auto start = buffer ? buffer->pubseekoff(0, std::ios_base::cur, std::ios_base::in)
+                            : std::streampos(-1);
+  if (start == std::streampos(-1)) {
+    return 0;
+  }
+  std::string prefix(cad::adapters::common::kProbeBytes, '\0');
+  const auto got = buffer->sgetn(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+  prefix.resize(static_cast<std::size_t>(std::max<std::streamsize>(got, 0)));
+  if (buffer->pubseekpos(start, std::ios_base::in) != start) {
+    return 0;
+  }
+  const ModelFormat format = cad::adapters::common::probeFormat(prefix).format;
+  if (format == ModelFormat::Gzip || format == ModelFormat::Zstd) {
+    // Judged from the compressed size, as decoding it all up front would
+    // cost as much as the read
+    const std::size_t expansion = format == ModelFormat::Gzip ? kGzipExpansion : kZstdExpansion;
+    return cad::ports::remainingStreamBytes(stream) * expansion * kBytesPerDecodedByte;
+  }
+  cad::ports::CadModelReaderPort *reader = readerFor(format);
+  return reader ? reader->estimateReadBytes(stream) : 0;
+}
+
+Model AutoDetectingCadModelReaderAdapter::read(std::istream &stream,
+                                               std::pmr::memory_resource *resource,
+                                               cad::ports::ProgressPort *progress) {
+  // Non-owning view of the caller's stream so it can be wrapped like any
+  // data-source stream.
+  auto input = std::make_unique<std::istream>(stream.rdbuf());
+  auto peeked = cad::adapters::common::peekPrefix(std::move(input),
+                                                  cad::adapters::common::kProbeBytes);
+  auto probe = cad::adapters::common::probeFormat(peeked.prefix);
+
+  if (probe.format == ModelFormat::Gzip || probe.format == ModelFormat::Zstd) {
+    auto decoded = cad::adapters::compressed::decompressIfNeeded(std::move(peeked.stream));
+    if (!decoded) {
+      Model model(cad::domain::DomainAllocator{resource});
+      model.root.name = std::string("Unsupported compression: ") +
+                        cad::adapters::common::toString(probe.format);
+      return model;
+    }
+    peeked = cad::adapters::common::peekPrefix(std::move(decoded),
+                                               cad::adapters::common::kProbeBytes);
+    probe = cad::adapters::common::probeFormat(peeked.prefix);
+  }
+
+  cad::ports::CadModelReaderPort *reader = readerFor(probe.format);
+  if (!reader) {
+    Model model(cad::domain::DomainAllocator{resource});
+    model.root.name = std::string("No reader for model format: ") +
+                      cad::adapters::common::toString(probe.format);
+    return model;
+  }
+  return progress ? reader->readModelFromStream(*peeked.stream, resource, *progress)
+                  : reader->readModelFromStream(*peeked.stream, resource);
+}
+
+} // namespace cad::adapters::autodetect
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <memory_resource>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "cpp/cad/adapters/common/FormatProbe.hpp"
+#include "cpp/cad/core/ports/CadModelReaderPort.hpp"
+
+namespace cad::adapters::autodetect {
+
+// Reader that sniffs the first kProbeBytes of the stream and hands the whole
+// stream, unconsumed, to the reader registered for the detected format.
+// Compressed containers are unwrapped and probed again. Readers are created
+// on first use, so formats that never show up cost nothing. Register readers
+// before sharing the adapter between threads.
+class AutoDetectingCadModelReaderAdapter final
+    : public cad::ports::CadModelReaderPort {
+public:
+  using ReaderFactory =
+      std::function<std::unique_ptr<cad::ports::CadModelReaderPort>()>;
+
+  void registerReader(cad::adapters::common::ModelFormat format,
+                      ReaderFactory factory);
+
+  using CadModelReaderPort::readModelFromStream;
+  cad::domain::Model
+  readModelFromStream(std::istream &stream,
+                      std::pmr::memory_resource *resource) override;
+  // Progress is forwarded to the reader for the detected format
+  cad::domain::Model
+  readModelFromStream(std::istream &stream, std::pmr::memory_resource *resource,
+                      cad::ports::ProgressPort &progress) override;
+  // The estimate of the reader for the detected format, probed from a
+  // seekable stream and rewound. Compressed input, whose decoded size is not
+  // known up front, is judged from its size and a typical ratio for the
+  // compression; streams that cannot seek come out as 0
+  std::size_t estimateReadBytes(std::istream &stream) override;
+
+private:
+  cad::domain::Model read(std::istream &stream, std::pmr::memory_resource *resource,
+                          cad::ports::ProgressPort *progress);
+  cad::ports::CadModelReaderPort *readerFor(cad::adapters::common::ModelFormat format);
+
+  struct Entry {
+    ReaderFactory factory;
+    std::unique_ptr<cad::ports::CadModelReaderPort> reader;
+  };
+  std::mutex mutex_; // guards lazy creation in readerFor
+  std::map<cad::adapters::common::ModelFormat, Entry> readers_;
+};
+
+} // namespace cad::adapters::autodetect
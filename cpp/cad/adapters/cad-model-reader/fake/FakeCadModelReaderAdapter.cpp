@@ -1,7 +1,11 @@
 #include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
 
+#include <cstdint>
 #include <stack>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 
 using cad::domain::Assembly;
 using cad::domain::Model;
@@ -9,49 +13,87 @@ using cad::domain::Part;
 
 namespace cad::adapters::fake {
 
-static std::string trim(const std::string &s) {
+static constexpr std::string_view kAssembly = "Assembly:";
+static constexpr std::string_view kPart = "Part:";
+
+// Model bytes per input byte, measured on generated 16 MB inputs (about 26)
+// and rounded up: every line becomes a node several hundred bytes large
+static constexpr std::size_t kBytesPerInputByte = 28;
+
+// A view into `s`, so names are copied once, straight into their node
+static std::string_view trim(std::string_view s) {
   size_t start = s.find_first_not_of(" \t\r\n");
   size_t end = s.find_last_not_of(" \t\r\n");
-  if (start == std::string::npos)
-    return "";
+  if (start == std::string_view::npos)
+    return {};
   return s.substr(start, end - start + 1);
 }
 
-Model FakeCadModelReaderAdapter::readModelFromStream(std::istream &stream) {
+static Model read(std::istream &stream, std::pmr::memory_resource *resource,
+                  cad::ports::ProgressPort *progress) {
+  const cad::domain::DomainAllocator alloc(resource);
   std::string line;
   std::stack<Assembly> stack;
-  Assembly root;
+  Assembly root(alloc);
   root.name = "Root";
-  stack.push(root);
+  stack.push(std::move(root));
 
+  std::uint64_t lines = 0;
   while (std::getline(stream, line)) {
-    line = trim(line);
-    if (line.rfind("Assembly:", 0) == 0) {
-      Assembly child;
-      child.name = trim(line.substr(std::string("Assembly:").size()));
-      stack.push(child);
-    } else if (line.rfind("Part:", 0) == 0) {
-      Part p;
-      p.name = trim(line.substr(std::string("Part:").size()));
-      stack.top().parts.push_back(p);
-    } else if (line == "EndAssembly") {
+    if (progress && ++lines % cad::ports::kProgressInterval == 0) {
+      progress->report("entities", lines, 0);
+      cad::ports::throwIfCancelled(progress);
+    }
+    std::string_view text = trim(line);
+    if (text.substr(0, kAssembly.size()) == kAssembly) {
+      Assembly child(alloc);
+      child.name = trim(text.substr(kAssembly.size()));
+      stack.push(std::move(child));
+    } else if (text.substr(0, kPart.size()) == kPart) {
+      Part p(alloc);
+      p.name = trim(text.substr(kPart.size()));
+      stack.top().parts.push_back(std::move(p));
+    } else if (text == "EndAssembly") {
       if (stack.size() >= 2) {
-        Assembly finished = stack.top();
+        // Moved, not copied: copying would cost O(subtree) per level
+        Assembly finished = std::move(stack.top());
         stack.pop();
-        stack.top().children.push_back(finished);
+        stack.top().children.push_back(std::move(finished));
       }
     }
   }
+  // getline stops the same way at the end of the input and on an error
+  // thrown by the stream buffer (corrupt or truncated compressed input),
+  // which istream turns into badbit
+  if (stream.bad()) {
+    throw std::runtime_error("error reading model stream");
+  }
 
   while (stack.size() > 1) {
-    Assembly finished = stack.top();
+    Assembly finished = std::move(stack.top());
     stack.pop();
-    stack.top().children.push_back(finished);
+    stack.top().children.push_back(std::move(finished));
   }
 
-  Model model;
-  model.root = stack.top();
+  Model model(alloc);
+  model.root = std::move(stack.top());
   return model;
 }
 
+Model FakeCadModelReaderAdapter::readModelFromStream(
+    std::istream &stream, std::pmr::memory_resource *resource) {
+  return read(stream, resource, nullptr);
+}
+
+Model FakeCadModelReaderAdapter::readModelFromStream(
+    std::istream &stream, std::pmr::memory_resource *resource,
+    cad::ports::ProgressPort &progress) {
+  cad::ports::throwIfCancelled(&progress);
+  return read(stream, resource, &progress);
+}
+
+std::size_t FakeCadModelReaderAdapter::estimateReadBytes(std::istream &stream) {
+  return cad::ports::remainingStreamBytes(stream) * kBytesPerInputByte;
+}
+
 } // namespace cad::adapters::fake
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <istream>
+#include <memory_resource>
 
 #include "cpp/cad/core/ports/CadModelReaderPort.hpp"
 
@@ -14,9 +16,17 @@ namespace cad::adapters::fake {
 //   Part: <name>
 //   EndAssembly
 // Nested assemblies are delimited by Assembly/EndAssembly.
-class FakeCadModelReaderAdapter : public cad::ports::CadModelReaderPort {
+class FakeCadModelReaderAdapter final : public cad::ports::CadModelReaderPort {
 public:
-  cad::domain::Model readModelFromStream(std::istream &stream) override;
+  using CadModelReaderPort::readModelFromStream;
+  cad::domain::Model
+  readModelFromStream(std::istream &stream,
+                      std::pmr::memory_resource *resource) override;
+  // Reports and polls every kProgressInterval lines
+  cad::domain::Model
+  readModelFromStream(std::istream &stream, std::pmr::memory_resource *resource,
+                      cad::ports::ProgressPort &progress) override;
+  std::size_t estimateReadBytes(std::istream &stream) override;
 };
 
 } // namespace cad::adapters::fake
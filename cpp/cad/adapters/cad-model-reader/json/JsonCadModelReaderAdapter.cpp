@@ -1,7 +1,19 @@
 #include "cpp/cad/adapters/cad-model-reader/json/JsonCadModelReaderAdapter.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "cpp/cad/adapters/common/ProgressStreamBuf.hpp"
+#include "cpp/cad/core/domain/Traversal.hpp"
 
 using cad::domain::Assembly;
 using cad::domain::Model;
@@ -9,20 +21,87 @@ using cad::domain::Part;
 
 namespace cad::adapters::json {
 
-cad::domain::Model JsonCadModelReaderAdapter::readModelFromStream(std::istream &stream) {
+namespace {
+
+// Peak bytes per input byte, measured on generated 16 MB inputs (about 20,
+// of which 13 are the model and the rest the document) and rounded up
+constexpr std::size_t kBytesPerInputByte = 24;
+
+// Moves each assembly from the flat map into its parent. Nodes are
+// (placed assembly, its id); a parent reserves its children up front, so
+// the pointers handed to the traversal stay valid while its subtree is built.
+struct TreeBuilder {
+  std::map<std::string, Assembly>& assemblies;
+  const std::map<std::string, std::vector<std::string>>& childIds;
+
+  bool enter(const std::pair<Assembly*, std::string>&, std::size_t) { return true; }
+
+  template <typename Push>
+  void children(const std::pair<Assembly*, std::string>& node, Push&& push) {
+    auto ids = childIds.find(node.second);
+    if (ids == childIds.end()) {
+      return;
+    }
+    Assembly& parent = *node.first;
+    parent.children.reserve(ids->second.size());
+    for (const auto& id : ids->second) {
+      auto it = assemblies.find(id);
+      if (it == assemblies.end()) {
+        continue; // already placed; parent_id links form a cycle
+      }
+      parent.children.push_back(std::move(it->second));
+      assemblies.erase(it);
+      push(std::pair<Assembly*, std::string>{&parent.children.back(), id});
+    }
+  }
+
+  void leave(const std::pair<Assembly*, std::string>&, std::size_t) {}
+};
+
+// Counts built nodes and reports every kProgressInterval of them
+struct EntityProgress {
+  cad::ports::ProgressPort* progress;
+  std::uint64_t total;
+  std::uint64_t done = 0;
+
+  void step() {
+    if (progress && ++done % cad::ports::kProgressInterval == 0) {
+      progress->report("entities", done, total);
+      cad::ports::throwIfCancelled(progress);
+    }
+  }
+};
+
+std::size_t arraySize(const nlohmann::json& j, const char* key) {
+  auto it = j.find(key);
+  return it != j.end() && it->is_array() ? it->size() : 0;
+}
+
+Model read(std::istream &stream, std::pmr::memory_resource *resource,
+           cad::ports::ProgressPort *progress) {
+  const cad::domain::DomainAllocator alloc(resource);
   try {
     nlohmann::json j;
-    stream >> j;
+    if (progress) {
+      cad::adapters::common::ProgressIStream input(stream, *progress);
+      input >> j;
+    } else {
+      stream >> j;
+    }
+    EntityProgress entities{progress, arraySize(j, "assemblies") + arraySize(j, "parts")};
     
     // Parse assemblies
     std::map<std::string, Assembly> assemblyMap;
     
     if (j.contains("assemblies") && j["assemblies"].is_array()) {
       for (const auto& assemblyJson : j["assemblies"]) {
+        entities.step();
         if (assemblyJson.contains("id") && assemblyJson.contains("name")) {
-          Assembly assembly;
-          assembly.name = assemblyJson["name"];
-          assemblyMap[assemblyJson["id"]] = assembly;
+          const auto& id = assemblyJson["id"].get_ref<const std::string&>();
+          Assembly assembly(alloc);
+          assembly.id.value = id;
+          assembly.name = assemblyJson["name"].get_ref<const std::string&>();
+          assemblyMap.insert_or_assign(id, std::move(assembly));
         }
       }
     }
@@ -30,22 +109,28 @@ cad::domain::Model JsonCadModelReaderAdapter::readModelFromStream(std::istream &
     // Parse parts and assign to assemblies
     if (j.contains("parts") && j["parts"].is_array()) {
       for (const auto& partJson : j["parts"]) {
+        entities.step();
         if (partJson.contains("id") && partJson.contains("name") && partJson.contains("assembly_id")) {
-          Part part;
-          part.name = partJson["name"];
-          
-          std::string assemblyId = partJson["assembly_id"];
-          if (assemblyMap.find(assemblyId) != assemblyMap.end()) {
-            assemblyMap[assemblyId].parts.push_back(part);
+          auto owner = assemblyMap.find(partJson["assembly_id"].get_ref<const std::string&>());
+          if (owner != assemblyMap.end()) {
+            Part part(alloc);
+            part.id.value = partJson["id"].get_ref<const std::string&>();
+            part.name = partJson["name"].get_ref<const std::string&>();
+            auto reference = partJson.find("reference");
+            if (reference != partJson.end() && reference->is_string()) {
+              part.reference = reference->get_ref<const std::string&>();
+            }
+            owner->second.parts.push_back(std::move(part));
           }
         }
       }
     }
     
     // Build hierarchy - find root and build tree
-    Assembly root;
+    Assembly root(alloc);
     root.name = "Root"; // Default root name
-    std::map<std::string, std::string> parentMap; // child_id -> parent_id
+    std::string rootId = "root"; // parent of orphans when no root is declared
+    std::map<std::string, std::vector<std::string>> childIds; // parent_id -> child ids
     
     // Build parent mapping
     if (j.contains("assemblies") && j["assemblies"].is_array()) {
@@ -53,38 +138,431 @@ cad::domain::Model JsonCadModelReaderAdapter::readModelFromStream(std::istream &
         if (assemblyJson.contains("id")) {
           std::string id = assemblyJson["id"];
           if (assemblyJson.contains("parent_id") && !assemblyJson["parent_id"].is_null()) {
-            parentMap[id] = assemblyJson["parent_id"];
+            childIds[assemblyJson["parent_id"]].push_back(id);
           } else {
             // This is the root
-            root = assemblyMap[id];
+            rootId = id;
           }
         }
       }
     }
-    
-    // Build the tree structure
-    std::function<void(Assembly&, const std::string&)> buildTree = [&](Assembly& parent, const std::string& parentId) {
-      for (const auto& [childId, parentIdFromMap] : parentMap) {
-        if (parentIdFromMap == parentId) {
-          Assembly child = assemblyMap[childId];
-          buildTree(child, childId); // Recursively build children
-          parent.children.push_back(child);
-        }
+    // Children are attached in id order; children declared without a name
+    // are still attached, unnamed
+    for (auto& [parentId, ids] : childIds) {
+      std::sort(ids.begin(), ids.end());
+      ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+      for (const auto& id : ids) {
+        assemblyMap.try_emplace(id, alloc);
       }
-    };
+    }
+    auto rootIt = assemblyMap.find(rootId);
+    if (rootIt != assemblyMap.end()) {
+      root = std::move(rootIt->second);
+      assemblyMap.erase(rootIt);
+    }
     
-    buildTree(root, "root");
+    // Build the tree structure top-down with an explicit stack. Every
+    // assembly is taken out of the map once, so a parent_id cycle cannot loop.
+    TreeBuilder builder{assemblyMap, childIds};
+    std::pair<Assembly*, std::string> top{&root, rootId};
+    cad::domain::DepthFirstTraversal<std::pair<Assembly*, std::string>>().run(top, builder);
     
-    Model model;
-    model.root = root;
+    Model model(alloc);
+    model.root = std::move(root);
     return model;
     
   } catch (const nlohmann::json::exception& e) {
+    // A cancelled parse fails on the cut-off input
+    cad::ports::throwIfCancelled(progress);
     // Return empty model on parse error
-    Model model;
+    Model model(alloc);
     model.root.name = "Root";
     return model;
   }
 }
 
+// Byte range of one entry object in the document text, braces included
+struct Span {
+  std::size_t begin = 0;
+  std::size_t end = 0;
+
+  bool empty() const { return begin == end; }
+};
+
+// One string-valued field of an entry, classified the way read() treats
+// it: only strings are usable, other present values fail the whole read.
+// The text is kept only for the fields that link entries together.
+struct Field {
+  enum class Kind : std::uint8_t { Absent, String, Null, Other };
+  Kind kind = Kind::Absent;
+  std::string text;
+
+  bool present() const { return kind != Kind::Absent; }
+  bool string() const { return kind == Kind::String; }
+};
+
+struct Entry {
+  Field id, name, parent, owner, reference;
+  Span span;
+};
+
+// Iterates over the document text for the parser, keeping the position
+// after the last character read in `*read`. The parser reads no further
+// than a brace before reporting it, so the position locates each object.
+class TrackingIterator {
+public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = char;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const char *;
+  using reference = const char &;
+
+  TrackingIterator(const char *at, const char **read) : at_(at), read_(read) {}
+
+  reference operator*() const { return *at_; }
+  TrackingIterator &operator++() {
+    *read_ = ++at_;
+    return *this;
+  }
+  TrackingIterator operator++(int) {
+    TrackingIterator before = *this;
+    ++*this;
+    return before;
+  }
+  friend bool operator==(const TrackingIterator &a, const TrackingIterator &b) {
+    return a.at_ == b.at_;
+  }
+  friend bool operator!=(const TrackingIterator &a, const TrackingIterator &b) {
+    return a.at_ != b.at_;
+  }
+
+private:
+  const char *at_;
+  const char **read_;
+};
+
+// Collects the fields read() looks at from every "assemblies" and "parts"
+// entry, and where the entry lies, without building a JSON document.
+class EntryCollector final : public nlohmann::json_sax<nlohmann::json> {
+public:
+  std::vector<Entry> assemblies;
+  std::vector<Entry> parts;
+
+  // `*read` is the parser's position in the text starting at `text`
+  EntryCollector(const char *text, const char *const *read) : text_(text), read_(read) {}
+
+  bool null() override { return value(Field::Kind::Null); }
+  bool boolean(bool) override { return value(Field::Kind::Other); }
+  bool number_integer(number_integer_t) override { return value(Field::Kind::Other); }
+  bool number_unsigned(number_unsigned_t) override { return value(Field::Kind::Other); }
+  bool number_float(number_float_t, const string_t &) override {
+    return value(Field::Kind::Other);
+  }
+  bool string(string_t &text) override {
+    if (field_ && depth_ == kEntryDepth && keepText_) {
+      field_->text = text;
+    }
+    return value(Field::Kind::String);
+  }
+  bool binary(binary_t &) override { return value(Field::Kind::Other); }
+
+  bool start_object(std::size_t) override {
+    value(Field::Kind::Other);
+    ++depth_;
+    if (depth_ == kEntryDepth && section_) {
+      section_->emplace_back().span.begin = offset() - 1; // just read the brace
+      inEntry_ = true;
+    }
+    return true;
+  }
+  bool end_object() override {
+    if (depth_ == kEntryDepth && inEntry_) {
+      section_->back().span.end = offset();
+      inEntry_ = false;
+    }
+    --depth_;
+    return true;
+  }
+  bool start_array(std::size_t) override {
+    std::vector<Entry> *section = depth_ == 1 ? sectionFor(key_) : nullptr;
+    value(Field::Kind::Other);
+    ++depth_;
+    if (section) {
+      section_ = section;
+    }
+    return true;
+  }
+  bool end_array() override {
+    if (depth_ == 2) {
+      section_ = nullptr;
+    }
+    --depth_;
+    return true;
+  }
+  bool key(string_t &key) override {
+    if (depth_ == 1) {
+      key_ = key;
+    } else if (depth_ == kEntryDepth && inEntry_) {
+      Entry &entry = section_->back();
+      field_ = key == "id"            ? &entry.id
+               : key == "name"        ? &entry.name
+               : key == "parent_id"   ? &entry.parent
+               : key == "assembly_id" ? &entry.owner
+               : key == "reference"   ? &entry.reference
+                                      : nullptr;
+      // Names and references are read again from the text on expansion
+      keepText_ = field_ == &entry.id || field_ == &entry.parent || field_ == &entry.owner;
+    }
+    return true;
+  }
+  bool parse_error(std::size_t, const std::string &,
+                   const nlohmann::detail::exception &) override {
+    return false;
+  }
+
+private:
+  static constexpr int kEntryDepth = 3; // document, section array, entry
+
+  std::size_t offset() const { return static_cast<std::size_t>(*read_ - text_); }
+
+  std::vector<Entry> *sectionFor(const std::string &key) {
+    return key == "assemblies" ? &assemblies : key == "parts" ? &parts : nullptr;
+  }
+
+  // Every value: a field's value is classified, and a section key given
+  // again replaces the earlier section, as in a JSON document
+  bool value(Field::Kind kind) {
+    if (field_ && depth_ == kEntryDepth) {
+      field_->kind = kind;
+    }
+    field_ = nullptr;
+    if (depth_ == 1) {
+      if (std::vector<Entry> *section = sectionFor(key_)) {
+        section->clear();
+      }
+    }
+    return true;
+  }
+
+  const char *text_;
+  const char *const *read_;
+  int depth_ = 0;
+  std::string key_;                        // last key of the document object
+  std::vector<Entry> *section_ = nullptr;  // array being read, if a section
+  bool inEntry_ = false;
+  Field *field_ = nullptr;                 // field the next value belongs to
+  bool keepText_ = false;                  // whether field_ keeps its text
+};
+
+// An assembly as placed by read(): where its entry and those of its parts
+// lie in the text, and its children.
+struct IndexedAssembly {
+  Span entry; // empty for an assembly only named as a parent, which is bare
+  std::vector<Span> parts;
+  std::vector<std::size_t> children; // indices into the index
+};
+
+// What an opened model keeps besides the text: no ids or names, which are
+// parsed from the text as assemblies are expanded.
+struct JsonIndex {
+  std::vector<IndexedAssembly> assemblies;
+  std::size_t root = 0;
+  bool defaultRoot = false; // no root in the text: "Root", as read() names it
+};
+
+// Places index entries into their parents exactly as TreeBuilder places
+// assemblies, so every assembly is claimed once and in the same order.
+struct IndexTreeBuilder {
+  std::vector<IndexedAssembly> &index;
+  const std::vector<std::string_view> &ids; // by index entry
+  std::map<std::string_view, std::size_t> &unplaced;
+  const std::map<std::string_view, std::vector<std::string_view>> &childIds;
+  std::size_t root;
+  std::string_view rootId; // also when the root is the default one, without an id
+
+  bool enter(std::size_t, std::size_t) { return true; }
+
+  template <typename Push> void children(std::size_t node, Push &&push) {
+    auto found = childIds.find(node == root ? rootId : ids[node]);
+    if (found == childIds.end()) {
+      return;
+    }
+    for (std::string_view id : found->second) {
+      auto it = unplaced.find(id);
+      if (it == unplaced.end()) {
+        continue;
+      }
+      index[node].children.push_back(it->second);
+      unplaced.erase(it);
+      push(it->second);
+    }
+  }
+
+  void leave(std::size_t, std::size_t) {}
+};
+
+class JsonLazyModel final : public cad::domain::LazyModel {
+public:
+  JsonLazyModel(const cad::domain::DomainAllocator &alloc, std::string text, JsonIndex index)
+      : LazyModel(alloc, index.root), text_(std::move(text)), index_(std::move(index)) {
+    label(index_.root, rootNode());
+  }
+
+private:
+  void expandNode(std::size_t key, Assembly &node,
+                  std::vector<std::size_t> &childKeys) override {
+    const IndexedAssembly &entry = index_.assemblies[key];
+    node.parts.reserve(entry.parts.size());
+    for (const Span &span : entry.parts) {
+      const nlohmann::json json = parse(span);
+      Part &part = node.parts.emplace_back();
+      part.id.value = json["id"].get_ref<const std::string &>();
+      part.name = json["name"].get_ref<const std::string &>();
+      auto reference = json.find("reference");
+      if (reference != json.end() && reference->is_string()) {
+        part.reference = reference->get_ref<const std::string &>();
+      }
+    }
+    node.children.reserve(entry.children.size());
+    for (std::size_t child : entry.children) {
+      label(child, node.children.emplace_back());
+      childKeys.push_back(child);
+    }
+  }
+
+  // Only the entry is parsed; the index was built from a valid document
+  nlohmann::json parse(const Span &span) const {
+    return nlohmann::json::parse(text_.data() + span.begin, text_.data() + span.end);
+  }
+
+  void label(std::size_t key, Assembly &node) const {
+    const Span &span = index_.assemblies[key].entry;
+    if (!span.empty()) {
+      const nlohmann::json json = parse(span);
+      node.id.value = json["id"].get_ref<const std::string &>();
+      node.name = json["name"].get_ref<const std::string &>();
+    } else if (key == index_.root && index_.defaultRoot) {
+      node.name = "Root";
+    }
+  }
+
+  std::string text_;
+  JsonIndex index_;
+};
+
+// The index read() would build the model from, or std::nullopt wherever
+// read() fails and returns a bare "Root"
+std::optional<JsonIndex> buildIndex(const std::string &text) {
+  const char *read = text.data();
+  EntryCollector entries(text.data(), &read);
+  if (!nlohmann::json::sax_parse(TrackingIterator(text.data(), &read),
+                                 TrackingIterator(text.data() + text.size(), &read), &entries,
+                                 nlohmann::json::input_format_t::json, false)) {
+    return std::nullopt;
+  }
+
+  JsonIndex index;
+  std::vector<IndexedAssembly> &assemblies = index.assemblies;
+  std::vector<std::string_view> ids; // by index entry, viewing `entries`
+  std::map<std::string_view, std::size_t> named; // last named entry per id, as assemblyMap
+  for (const Entry &entry : entries.assemblies) {
+    if (entry.id.present() && entry.name.present()) {
+      if (!entry.id.string() || !entry.name.string()) {
+        return std::nullopt;
+      }
+      assemblies.push_back({entry.span, {}, {}});
+      ids.push_back(entry.id.text);
+      named.insert_or_assign(entry.id.text, assemblies.size() - 1);
+    }
+  }
+  for (const Entry &entry : entries.parts) {
+    if (entry.id.present() && entry.name.present() && entry.owner.present()) {
+      if (!entry.id.string() || !entry.name.string() || !entry.owner.string()) {
+        return std::nullopt;
+      }
+      auto owner = named.find(entry.owner.text);
+      if (owner != named.end()) {
+        assemblies[owner->second].parts.push_back(entry.span);
+      }
+    }
+  }
+
+  std::string_view rootId = "root";
+  std::map<std::string_view, std::vector<std::string_view>> childIds;
+  for (const Entry &entry : entries.assemblies) {
+    if (!entry.id.present()) {
+      continue;
+    }
+    if (!entry.id.string()) {
+      return std::nullopt;
+    }
+    if (entry.parent.present() && entry.parent.kind != Field::Kind::Null) {
+      if (!entry.parent.string()) {
+        return std::nullopt;
+      }
+      childIds[entry.parent.text].push_back(entry.id.text);
+    } else {
+      rootId = entry.id.text;
+    }
+  }
+  std::map<std::string_view, std::size_t> unplaced = std::move(named);
+  for (auto &[parentId, children] : childIds) {
+    std::sort(children.begin(), children.end());
+    children.erase(std::unique(children.begin(), children.end()), children.end());
+    for (std::string_view id : children) {
+      if (unplaced.count(id) == 0) {
+        assemblies.emplace_back();
+        ids.push_back(id);
+        unplaced.emplace(id, assemblies.size() - 1);
+      }
+    }
+  }
+
+  auto rootIt = unplaced.find(rootId);
+  if (rootIt != unplaced.end()) {
+    index.root = rootIt->second;
+    unplaced.erase(rootIt);
+  } else {
+    assemblies.emplace_back();
+    ids.emplace_back();
+    index.root = assemblies.size() - 1;
+    index.defaultRoot = true;
+  }
+  IndexTreeBuilder builder{assemblies, ids, unplaced, childIds, index.root, rootId};
+  cad::domain::DepthFirstTraversal<std::size_t>().run(index.root, builder);
+  return index;
+}
+
+} // namespace
+
+cad::domain::Model JsonCadModelReaderAdapter::readModelFromStream(
+    std::istream &stream, std::pmr::memory_resource *resource) {
+  return read(stream, resource, nullptr);
+}
+
+cad::domain::Model JsonCadModelReaderAdapter::readModelFromStream(
+    std::istream &stream, std::pmr::memory_resource *resource,
+    cad::ports::ProgressPort &progress) {
+  cad::ports::throwIfCancelled(&progress);
+  return read(stream, resource, &progress);
+}
+
+std::size_t JsonCadModelReaderAdapter::estimateReadBytes(std::istream &stream) {
+  return cad::ports::remainingStreamBytes(stream) * kBytesPerInputByte;
+}
+
+std::unique_ptr<cad::domain::LazyModel>
+JsonCadModelReaderAdapter::openLazyModel(std::istream &stream,
+                                         std::pmr::memory_resource *resource) {
+  const cad::domain::DomainAllocator alloc(resource);
+  std::string text(std::istreambuf_iterator<char>(stream), {});
+  auto index = buildIndex(text);
+  if (!index) {
+    Model model(alloc);
+    model.root.name = "Root";
+    return cad::domain::LazyModel::fromModel(std::move(model));
+  }
+  return std::make_unique<JsonLazyModel>(alloc, std::move(text), std::move(*index));
+}
+
 } // namespace cad::adapters::json
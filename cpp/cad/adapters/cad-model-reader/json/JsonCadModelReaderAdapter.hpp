@@ -1,15 +1,39 @@
 #pragma once
 
+#include <cstddef>
 #include <istream>
+#include <memory_resource>
 
 #include "cpp/cad/core/domain/Model.hpp"
 #include "cpp/cad/core/ports/CadModelReaderPort.hpp"
+#include "cpp/cad/core/ports/LazyModelReaderPort.hpp"
 
 namespace cad::adapters::json {
 
-class JsonCadModelReaderAdapter : public cad::ports::CadModelReaderPort {
+// Reads the flat JSON format (see test-data/README.md). A lazily opened
+// model keeps the input text and an index built in one SAX pass, without a
+// JSON document: per assembly where its entry and its parts' entries lie in
+// the text, and its placed children. No id or name is copied or interned
+// until its assembly is expanded, which parses just those entries; the text
+// itself stays in memory for the model's lifetime.
+class JsonCadModelReaderAdapter final : public cad::ports::CadModelReaderPort,
+                                        public cad::ports::LazyModelReaderPort {
 public:
-  cad::domain::Model readModelFromStream(std::istream &stream) override;
+  using CadModelReaderPort::readModelFromStream;
+  cad::domain::Model
+  readModelFromStream(std::istream &stream,
+                      std::pmr::memory_resource *resource) override;
+  // Reports bytes while parsing, then entities as nodes are built
+  cad::domain::Model
+  readModelFromStream(std::istream &stream, std::pmr::memory_resource *resource,
+                      cad::ports::ProgressPort &progress) override;
+  // Counts the JSON document, which is dropped once the model is built
+  std::size_t estimateReadBytes(std::istream &stream) override;
+
+  using LazyModelReaderPort::openLazyModel;
+  // Expands to the same assemblies, parts and order as readModelFromStream
+  std::unique_ptr<cad::domain::LazyModel>
+  openLazyModel(std::istream &stream, std::pmr::memory_resource *resource) override;
 };
 
 } // namespace cad::adapters::json
@@ -0,0 +1,12 @@
+#include "cpp/cad/adapters/cad-model-reader/lazy/ExpandingCadModelReaderAdapter.hpp"
+
+#include <utility>
+
+namespace cad::adapters::lazy {
+
+cad::domain::Model ExpandingCadModelReaderAdapter::readModelFromStream(
+    std::istream &stream, std::pmr::memory_resource *resource) {
+  return std::move(*reader_.openLazyModel(stream, resource)).expandAll();
+}
+
+} // namespace cad::adapters::lazy
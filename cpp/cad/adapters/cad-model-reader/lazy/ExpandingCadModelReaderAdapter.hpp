@@ -0,0 +1,29 @@
+#pragma once
+
+#include <istream>
+#include <memory_resource>
+
+#include "cpp/cad/core/ports/CadModelReaderPort.hpp"
+#include "cpp/cad/core/ports/LazyModelReaderPort.hpp"
+
+namespace cad::adapters::lazy {
+
+// Reads a whole model through a lazy reader by opening it and expanding
+// every assembly, so use cases written against CadModelReaderPort (listing,
+// diffing) run unchanged on the lazy path. Thread safety is the wrapped
+// reader's.
+class ExpandingCadModelReaderAdapter final : public cad::ports::CadModelReaderPort {
+public:
+  explicit ExpandingCadModelReaderAdapter(cad::ports::LazyModelReaderPort &reader)
+      : reader_(reader) {}
+
+  using CadModelReaderPort::readModelFromStream;
+  cad::domain::Model
+  readModelFromStream(std::istream &stream,
+                      std::pmr::memory_resource *resource) override;
+
+private:
+  cad::ports::LazyModelReaderPort &reader_;
+};
+
+} // namespace cad::adapters::lazy
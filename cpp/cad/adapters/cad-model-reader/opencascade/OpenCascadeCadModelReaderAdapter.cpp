@@ -1,12 +1,29 @@
 #include "cpp/cad/adapters/cad-model-reader/opencascade/OpenCascadeCadModelReaderAdapter.hpp"
 
-#include <sstream>
-#include <memory>
-#include <fstream>
-#include <filesystem>
 #include <algorithm>
-#include <iterator>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "cpp/cad/adapters/common/FormatProbe.hpp"
+#include "cpp/cad/adapters/common/PrefixReplayStreamBuf.hpp"
+#include "cpp/cad/adapters/common/ProgressStreamBuf.hpp"
+#include "cpp/cad/core/domain/StructuralHash.hpp"
+#include "cpp/cad/core/domain/Traversal.hpp"
 
 // OpenCASCADE headers - ordered for proper Handle<T> template resolution
 #include <Standard_Handle.hxx>
@@ -19,9 +36,23 @@
 // Document and application framework
 #include <TDocStd_Document.hxx>
 #include <XCAFApp_Application.hxx>
+#include <BinXCAFDrivers.hxx>
+#include <PCDM_ReaderStatus.hxx>
+#include <PCDM_StoreStatus.hxx>
 
 // STEP reading
+#include <STEPCAFControl_Controller.hxx>
 #include <STEPCAFControl_Reader.hxx>
+#include <DESTEP_Parameters.hxx>
+#include <Interface_InterfaceModel.hxx>
+#include <XSControl_WorkSession.hxx>
+#include <StepBasic_Document.hxx>
+#include <StepBasic_ProductDefinitionWithAssociatedDocuments.hxx>
+#include <TCollection_HAsciiString.hxx>
+#include <Transfer_Binder.hxx>
+#include <Transfer_TransientProcess.hxx>
+#include <TransferBRep.hxx>
+#include <XSControl_TransferReader.hxx>
 
 // XDE framework for shape and name handling
 #include <XCAFDoc_DocumentTool.hxx>
@@ -30,13 +61,137 @@
 #include <TDF_Label.hxx>
 #include <TDataStd_Name.hxx>
 #include <TopoDS_Shape.hxx>
+#include <TopoDS_TShape.hxx>
+#include <TDF_Tool.hxx>
+#include <TopLoc_Location.hxx>
+#include <gp_Trsf.hxx>
+
+// Geometric properties
+#include <BRepBndLib.hxx>
+#include <BRepGProp.hxx>
+#include <Bnd_Box.hxx>
+#include <GProp_GProps.hxx>
+#include <Standard_Failure.hxx>
+
+// Progress and cancellation
+#include <Message_ProgressIndicator.hxx>
+#include <Message_ProgressRange.hxx>
+#include <Message_ProgressScope.hxx>
+
+// Tessellation
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRep_Tool.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
+
+// Shape comparison
+#include <BRepAdaptor_Curve.hxx>
+#include <GProp_PrincipalProps.hxx>
+#include <Precision.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Vertex.hxx>
 
 using cad::domain::Assembly;
 using cad::domain::Model;
 using cad::domain::Part;
+using cad::domain::Placement;
+using cad::domain::Point3;
 
 namespace cad::adapters::opencascade {
 
+namespace {
+
+// Peak bytes per byte of STEP. A rough, conservative figure: the entity
+// graph of the parsed file is several times its text, and the transferred
+// B-rep shapes and XDE labels come on top
+constexpr std::size_t kBytesPerInputByte = 32;
+
+// XCAFApp_Application is a process-wide singleton whose document list is not
+// synchronized, so creating and closing documents is serialized. Reading and
+// transferring into distinct documents then runs in parallel.
+std::mutex &applicationMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+// Forwards OCCT progress to a ProgressPort. OCCT polls UserBreak() and
+// abandons the transfer once it is true; Show() runs under the indicator's
+// own lock.
+class ProgressIndicator : public Message_ProgressIndicator {
+public:
+  explicit ProgressIndicator(cad::ports::ProgressPort& progress) : progress_(progress) {}
+
+  Standard_Boolean UserBreak() override { return progress_.cancelled(); }
+
+  void Show(const Message_ProgressScope&, const Standard_Boolean) override {
+    progress_.report("transfer", static_cast<std::uint64_t>(GetPosition() * 1000), 1000);
+  }
+
+private:
+  cad::ports::ProgressPort& progress_;
+};
+
+// Owns one XDE document for the duration of a read (or of a lazily opened
+// model) and closes it afterwards, so the application does not accumulate
+// documents.
+class ScopedDocument {
+public:
+  ScopedDocument() {
+    std::lock_guard<std::mutex> lock(applicationMutex());
+    app_ = application();
+    app_->NewDocument("MDTV-XCAF", doc_);
+  }
+  ~ScopedDocument() {
+    std::lock_guard<std::mutex> lock(applicationMutex());
+    if (!doc_.IsNull()) {
+      app_->Close(doc_);
+    }
+  }
+  // Opens a document saved earlier; get() is null if that fails
+  explicit ScopedDocument(const std::string &path) {
+    std::lock_guard<std::mutex> lock(applicationMutex());
+    app_ = application();
+    try {
+      if (app_->Open(TCollection_ExtendedString(path.c_str()), doc_) != PCDM_RS_OK) {
+        doc_.Nullify();
+      }
+    } catch (const Standard_Failure &) {
+      doc_.Nullify();
+    }
+  }
+  ScopedDocument(const ScopedDocument &) = delete;
+  ScopedDocument &operator=(const ScopedDocument &) = delete;
+  // Hands the open document over, to outlive the read (see StepLazyModel)
+  ScopedDocument(ScopedDocument &&other) noexcept
+      : app_(other.app_), doc_(other.doc_) {
+    other.doc_.Nullify();
+  }
+
+  const ::opencascade::handle<TDocStd_Document> &get() const { return doc_; }
+
+private:
+  // Called with the application mutex held
+  static ::opencascade::handle<XCAFApp_Application> application() {
+    // The STEP controller registers global translation parameters and
+    // BinXCAF its storage drivers; this must happen once before readers run
+    // concurrently.
+    static const bool initialized = [] {
+      BinXCAFDrivers::DefineFormat(XCAFApp_Application::GetApplication());
+      return STEPCAFControl_Controller::Init();
+    }();
+    (void)initialized;
+    return XCAFApp_Application::GetApplication();
+  }
+
+  ::opencascade::handle<XCAFApp_Application> app_;
+  ::opencascade::handle<TDocStd_Document> doc_;
+};
+
 // Helper function to extract name from a label
 std::string extractNameFromLabel(const TDF_Label& label, const std::string& fallbackName) {
   ::opencascade::handle<TDataStd_Name> nameAttr;
@@ -49,194 +204,826 @@ std::string extractNameFromLabel(const TDF_Label& label, const std::string& fall
   return fallbackName;
 }
 
-// Helper function to process a shape label recursively
-void processShapeLabel(const ::opencascade::handle<XCAFDoc_ShapeTool>& shapeTool, 
-                      const TDF_Label& label, 
-                      Assembly& parentAssembly,
-                      int& partCounter) {
+// A label still to be visited, the assembly its shape is added to and the
+// accumulated placement of the component path leading to it
+struct ShapeNode {
+  TDF_Label label;
+  Assembly* parent;
+  TopLoc_Location location;
+};
+
+// Prototype shapes by label entry, as referenced by Part::prototypeId
+using PrototypeShapes = std::map<std::string, TopoDS_Shape>;
+
+bool hasFaces(const TopoDS_Shape& shape) {
+  return !shape.IsNull() && TopExp_Explorer(shape, TopAbs_FACE).More();
+}
+
+// File names of externally defined products, by the shape their product
+// definition transferred to, which is the shape of the label instancing
+// them. Names are no key: unrelated products may share one.
+using ExternalReferences = std::map<const TopoDS_TShape*, std::string>;
+
+// Products whose definition points at a document file: the pieces of an
+// assembly saved one part per file. Their shapes transfer empty from a
+// stream, so parts record the file for ResolveReferencesUseCase instead.
+ExternalReferences collectExternalReferences(STEPCAFControl_Reader& reader) {
+  ExternalReferences references;
+  const ::opencascade::handle<XSControl_WorkSession>& session = reader.ChangeReader().WS();
+  ::opencascade::handle<Interface_InterfaceModel> model = session->Model();
+  if (model.IsNull() || session->TransferReader().IsNull()) {
+    return references;
+  }
+  ::opencascade::handle<Transfer_TransientProcess> process =
+      session->TransferReader()->TransientProcess();
+  if (process.IsNull()) {
+    return references;
+  }
+  for (Standard_Integer i = 1; i <= model->NbEntities(); i++) {
+    auto definition = ::opencascade::handle<StepBasic_ProductDefinitionWithAssociatedDocuments>::
+        DownCast(model->Value(i));
+    if (definition.IsNull()) {
+      continue;
+    }
+    ::opencascade::handle<Transfer_Binder> binder = process->Find(definition);
+    if (binder.IsNull() || !binder->HasResult()) {
+      continue;
+    }
+    const TopoDS_Shape shape = TransferBRep::ShapeResult(process, binder);
+    if (shape.IsNull()) {
+      continue;
+    }
+    for (Standard_Integer j = 1; j <= definition->NbDocIds(); j++) {
+      ::opencascade::handle<StepBasic_Document> document = definition->DocIdsValue(j);
+      if (!document.IsNull() && !document->Id().IsNull() && document->Id()->Length() > 0) {
+        references.try_emplace(shape.TShape().get(), document->Id()->ToCString());
+        break;
+      }
+    }
+  }
+  return references;
+}
+
+// The file `shape` is defined in, when it is an external product's and
+// transferred without faces; nullptr for geometry of its own
+const std::string* externalReference(const ExternalReferences& references,
+                                     const TopoDS_Shape& shape) {
+  if (shape.IsNull()) {
+    return nullptr;
+  }
+  auto reference = references.find(shape.TShape().get());
+  return reference != references.end() && !hasFaces(shape) ? &reference->second : nullptr;
+}
+
+std::string labelEntry(const TDF_Label& label) {
+  TCollection_AsciiString entry;
+  TDF_Tool::Entry(label, entry);
+  return std::string(entry.ToCString());
+}
+
+// The name of the shape at `label`; an unnamed one is called after its label
+// entry, which reads and lazy expansions alike know it by
+std::string shapeName(const TDF_Label& label) {
+  return extractNameFromLabel(label, "Entity_" + labelEntry(label));
+}
+
+cad::domain::Placement toPlacement(const TopLoc_Location& location) {
+  cad::domain::Placement placement;
+  if (location.IsIdentity()) {
+    return placement;
+  }
+  // Value() includes the scale factor
+  const gp_Trsf trsf = location.Transformation();
+  for (int r = 0; r < 3; ++r) {
+    for (int c = 0; c < 3; ++c) {
+      placement.linear[3 * r + c] = trsf.Value(r + 1, c + 1);
+    }
+    placement.translation[r] = trsf.Value(r + 1, 4);
+  }
+  return placement;
+}
+
+// Bounding box, volume and area of one prototype in its own coordinates;
+// nullopt when OCCT cannot measure it.
+std::optional<cad::domain::GeometricProperties> measureShape(const TopoDS_Shape& shape) {
+  try {
+    cad::domain::GeometricProperties properties;
+    Bnd_Box box;
+    BRepBndLib::Add(shape, box);
+    if (!box.IsVoid()) {
+      Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
+      box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+      properties.bounds.add({xmin, ymin, zmin});
+      properties.bounds.add({xmax, ymax, zmax});
+    }
+    GProp_GProps volume;
+    BRepGProp::VolumeProperties(shape, volume);
+    properties.volume = std::abs(volume.Mass());
+    GProp_GProps surface;
+    BRepGProp::SurfaceProperties(shape, surface);
+    properties.area = surface.Mass();
+    return properties;
+  } catch (const Standard_Failure&) {
+    return std::nullopt;
+  }
+}
+
+// Triangulates one prototype in its own coordinates; empty when OCCT cannot
+// mesh it. BRepMesh stores the triangulation on the faces it meshes, and
+// distinct prototypes can share faces (a compound holding another
+// prototype's solid, one shape under several labels), so a private copy is
+// meshed rather than the shape other tasks may be meshing too.
+cad::domain::Mesh triangulate(const TopoDS_Shape& shape,
+                              const cad::ports::TessellationOptions& options) {
+  cad::domain::Mesh mesh;
+  try {
+    const TopoDS_Shape copy = BRepBuilderAPI_Copy(shape, Standard_True, Standard_False).Shape();
+    // No parallelism inside a shape: prototypes are already spread over the pool
+    BRepMesh_IncrementalMesh mesher(copy, options.linearDeflection, Standard_False,
+                                    options.angularDeflection, Standard_False);
+    for (TopExp_Explorer faces(copy, TopAbs_FACE); faces.More(); faces.Next()) {
+      const TopoDS_Face& face = TopoDS::Face(faces.Current());
+      TopLoc_Location location;
+      ::opencascade::handle<Poly_Triangulation> triangulation =
+          BRep_Tool::Triangulation(face, location);
+      if (triangulation.IsNull()) {
+        continue;
+      }
+      const gp_Trsf trsf = location.Transformation();
+      const auto base = static_cast<std::uint32_t>(mesh.vertexCount());
+      for (Standard_Integer i = 1; i <= triangulation->NbNodes(); ++i) {
+        gp_Pnt point = triangulation->Node(i).Transformed(trsf);
+        mesh.positions.push_back(static_cast<float>(point.X()));
+        mesh.positions.push_back(static_cast<float>(point.Y()));
+        mesh.positions.push_back(static_cast<float>(point.Z()));
+      }
+      // Reversed faces point inwards as triangulated
+      const bool reversed = face.Orientation() == TopAbs_REVERSED;
+      for (Standard_Integer i = 1; i <= triangulation->NbTriangles(); ++i) {
+        Standard_Integer a, b, c;
+        triangulation->Triangle(i).Get(a, b, c);
+        if (reversed) {
+          std::swap(b, c);
+        }
+        mesh.indices.push_back(base + static_cast<std::uint32_t>(a - 1));
+        mesh.indices.push_back(base + static_cast<std::uint32_t>(b - 1));
+        mesh.indices.push_back(base + static_cast<std::uint32_t>(c - 1));
+      }
+    }
+  } catch (const Standard_Failure&) {
+    return {};
+  }
+  return mesh;
+}
+
+// Mass properties of the volume of a shape, or of its surface when it
+// encloses none (sheets, loose faces)
+GProp_GProps bodyProperties(const TopoDS_Shape& shape) {
+  GProp_GProps volume;
+  BRepGProp::VolumeProperties(shape, volume);
+  if (std::abs(volume.Mass()) > Precision::Confusion()) {
+    return volume;
+  }
+  GProp_GProps surface;
+  BRepGProp::SurfaceProperties(shape, surface);
+  return surface;
+}
+
+// Centre of mass and principal axes of inertia, by ascending moment
+struct InertiaFrame {
+  Point3 centre;
+  std::array<Point3, 3> axes;
+  std::array<double, 3> moments;
+  double mass;
+};
+
+InertiaFrame inertiaFrame(const GProp_GProps& properties) {
+  InertiaFrame frame;
+  const gp_Pnt centre = properties.CentreOfMass();
+  frame.centre = {centre.X(), centre.Y(), centre.Z()};
+  frame.mass = std::abs(properties.Mass());
+  const GProp_PrincipalProps principal = properties.PrincipalProperties();
+  Standard_Real moments[3];
+  principal.Moments(moments[0], moments[1], moments[2]);
+  const gp_Vec axes[3] = {principal.FirstAxisOfInertia(), principal.SecondAxisOfInertia(),
+                          principal.ThirdAxisOfInertia()};
+  std::array<int, 3> order{0, 1, 2};
+  std::sort(order.begin(), order.end(), [&moments](int a, int b) {
+    return std::abs(moments[a]) < std::abs(moments[b]);
+  });
+  for (int i = 0; i < 3; ++i) {
+    const gp_Vec& axis = axes[order[i]];
+    frame.axes[i] = {axis.X(), axis.Y(), axis.Z()};
+    frame.moments[i] = std::abs(moments[order[i]]);
+  }
+  return frame;
+}
+
+// Topology counts and mass properties of one prototype; nullopt when OCCT
+// cannot measure it.
+std::optional<cad::ports::ShapeSignature> shapeSignature(const TopoDS_Shape& shape) {
+  try {
+    cad::ports::ShapeSignature signature;
+    const TopAbs_ShapeEnum kinds[] = {TopAbs_SOLID, TopAbs_FACE, TopAbs_EDGE, TopAbs_VERTEX};
+    for (std::size_t i = 0; i < 4; ++i) {
+      TopTools_IndexedMapOfShape shapes;
+      TopExp::MapShapes(shape, kinds[i], shapes);
+      signature.topology[i] = static_cast<std::size_t>(shapes.Extent());
+    }
+    GProp_GProps volume;
+    BRepGProp::VolumeProperties(shape, volume);
+    GProp_GProps surface;
+    BRepGProp::SurfaceProperties(shape, surface);
+    signature.volume = std::abs(volume.Mass());
+    signature.area = surface.Mass();
+    const InertiaFrame frame =
+        inertiaFrame(signature.volume > Precision::Confusion() ? volume : surface);
+    if (frame.mass > 0) {
+      for (std::size_t i = 0; i < 3; ++i) {
+        signature.extents[i] = std::sqrt(frame.moments[i] / frame.mass);
+      }
+    }
+    return signature;
+  } catch (const Standard_Failure&) {
+    return std::nullopt;
+  }
+}
+
+// Vertices and edge midpoints: a sample that pins down where the edges of a
+// shape run, and so the shape, at a cost linear in its topology
+std::vector<Point3> samplePoints(const TopoDS_Shape& shape) {
+  std::vector<Point3> points;
+  TopTools_IndexedMapOfShape vertices;
+  TopExp::MapShapes(shape, TopAbs_VERTEX, vertices);
+  for (Standard_Integer i = 1; i <= vertices.Extent(); ++i) {
+    const gp_Pnt point = BRep_Tool::Pnt(TopoDS::Vertex(vertices(i)));
+    points.push_back({point.X(), point.Y(), point.Z()});
+  }
+  TopTools_IndexedMapOfShape edges;
+  TopExp::MapShapes(shape, TopAbs_EDGE, edges);
+  for (Standard_Integer i = 1; i <= edges.Extent(); ++i) {
+    const TopoDS_Edge& edge = TopoDS::Edge(edges(i));
+    if (BRep_Tool::Degenerated(edge)) {
+      continue;
+    }
+    BRepAdaptor_Curve curve(edge);
+    const gp_Pnt point = curve.Value(0.5 * (curve.FirstParameter() + curve.LastParameter()));
+    points.push_back({point.X(), point.Y(), point.Z()});
+  }
+  return points;
+}
+
+bool byX(const Point3& a, const Point3& b) { return a[0] < b[0]; }
+
+// Whether every one of `points` lies within `tolerance` of one of `sorted`,
+// which is ordered by x
+bool covers(const std::vector<Point3>& sorted, const std::vector<Point3>& points,
+            double tolerance) {
+  for (const Point3& point : points) {
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), point[0] - tolerance,
+                               [](const Point3& p, double x) { return p[0] < x; });
+    bool found = false;
+    for (; !found && it != sorted.end() && (*it)[0] <= point[0] + tolerance; ++it) {
+      const double dx = (*it)[0] - point[0];
+      const double dy = (*it)[1] - point[1];
+      const double dz = (*it)[2] - point[2];
+      found = dx * dx + dy * dy + dz * dz <= tolerance * tolerance;
+    }
+    if (!found) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The rigid placement carrying `from` onto `to`. Candidate rotations are the
+// identity, then each proper rotation taking the principal axes of `from`
+// onto those of `to` up to their signs; each is completed by the translation
+// between the centres of mass and accepted when the sample points of both
+// shapes cover each other.
+std::optional<Placement> matchShapes(const TopoDS_Shape& from, const TopoDS_Shape& to,
+                                     double tolerance) {
+  try {
+    const std::vector<Point3> source = samplePoints(from);
+    std::vector<Point3> target = samplePoints(to);
+    if (source.empty() || source.size() != target.size()) {
+      return std::nullopt;
+    }
+    std::sort(target.begin(), target.end(), byX);
+    const InertiaFrame a = inertiaFrame(bodyProperties(from));
+    const InertiaFrame b = inertiaFrame(bodyProperties(to));
+
+    std::vector<Placement> candidates(1);
+    for (int signs = 0; signs < 8; ++signs) {
+      Placement rotation;
+      for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+          double value = 0;
+          for (int i = 0; i < 3; ++i) {
+            value += ((signs >> i) & 1 ? -1.0 : 1.0) * b.axes[i][r] * a.axes[i][c];
+          }
+          rotation.linear[3 * r + c] = value;
+        }
+      }
+      if (rotation.determinant() > 0) {
+        candidates.push_back(rotation);
+      }
+    }
+
+    std::vector<Point3> moved(source.size());
+    for (Placement& candidate : candidates) {
+      const Point3 turned = candidate.apply(a.centre);
+      for (int k = 0; k < 3; ++k) {
+        candidate.translation[k] = b.centre[k] - turned[k];
+      }
+      std::transform(source.begin(), source.end(), moved.begin(),
+                     [&candidate](const Point3& point) { return candidate.apply(point); });
+      if (!covers(target, moved, tolerance)) {
+        continue;
+      }
+      std::sort(moved.begin(), moved.end(), byX);
+      if (covers(moved, target, tolerance)) {
+        return candidate;
+      }
+    }
+    return std::nullopt;
+  } catch (const Standard_Failure&) {
+    return std::nullopt;
+  }
+}
+
+// A read model and its prototype shapes, which outlive the closed document
+// (they are reference counted). Every call reads its shapes only, so calls
+// on distinct prototypes run concurrently.
+class StepPrototypeGeometry final : public cad::ports::PrototypeGeometry {
+public:
+  StepPrototypeGeometry(Model model, PrototypeShapes shapes)
+      : model_(std::move(model)), shapes_(std::move(shapes)) {}
+
+  Model& model() override { return model_; }
+
+  std::vector<std::string> prototypeIds() const override {
+    std::vector<std::string> ids;
+    ids.reserve(shapes_.size());
+    for (const auto& entry : shapes_) {
+      ids.push_back(entry.first);
+    }
+    return ids;
+  }
+
+  std::optional<cad::ports::ShapeSignature>
+  signature(const std::string& prototypeId) const override {
+    auto it = shapes_.find(prototypeId);
+    return it == shapes_.end() ? std::nullopt : shapeSignature(it->second);
+  }
+
+  std::optional<Placement> match(const std::string& from, const std::string& to,
+                                 double tolerance) const override {
+    auto source = shapes_.find(from);
+    auto target = shapes_.find(to);
+    if (source == shapes_.end() || target == shapes_.end()) {
+      return std::nullopt;
+    }
+    return matchShapes(source->second, target->second, tolerance);
+  }
+
+private:
+  Model model_;
+  PrototypeShapes shapes_;
+};
+
+// Builds the hierarchy below the free shapes with an explicit stack. An
+// assembly's address is stable while its subtree is built: its parent's
+// children only grow when a later sibling is entered, after this subtree.
+class ShapeHierarchyBuilder {
+public:
+  // With `prototypes`, the shape of every prototype a part instantiates is
+  // recorded there for measuring.
+  ShapeHierarchyBuilder(const ::opencascade::handle<XCAFDoc_ShapeTool>& shapeTool,
+                        PrototypeShapes* prototypes, const ExternalReferences& references)
+      : shapeTool_(shapeTool), prototypes_(prototypes), references_(references) {}
+
+  bool enter(const ShapeNode& node, std::size_t) {
+    const std::string name = shapeName(node.label);
+    Assembly& parentAssembly = *node.parent;
+    next_.clear();
+
+    if (shapeTool_->IsAssembly(node.label)) {
+      // Create a new assembly and queue its components
+      parentAssembly.children.emplace_back();
+      Assembly& assembly = parentAssembly.children.back();
+      assembly.name = name;
+
+      TDF_LabelSequence components;
+      shapeTool_->GetComponents(node.label, components);
+      for (Standard_Integer i = 1; i <= components.Length(); i++) {
+        next_.push_back({components.Value(i), &assembly, node.location});
+      }
+
+    } else if (shapeTool_->IsComponent(node.label)) {
+      // This is a component reference - visit the actual shape it refers to
+      TDF_Label refLabel;
+      if (shapeTool_->GetReferredShape(node.label, refLabel)) {
+        next_.push_back({refLabel, &parentAssembly,
+                         node.location * XCAFDoc_ShapeTool::GetLocation(node.label)});
+      } else {
+        // Fallback: treat as a part
+        parentAssembly.parts.emplace_back().name = name + " (Component)";
+      }
+
+    } else if (shapeTool_->IsSimpleShape(node.label)) {
+      // This is a simple shape (part), an instance of its label's geometry
+      Part& part = parentAssembly.parts.emplace_back();
+      part.name = name;
+      part.placement = toPlacement(node.location);
+      if (const std::string* reference =
+              externalReference(references_, XCAFDoc_ShapeTool::GetShape(node.label))) {
+        part.reference = *reference;
+      } else {
+        part.prototypeId = labelEntry(node.label);
+      }
+      if (prototypes_ && !part.prototypeId.empty()) {
+        prototypes_->try_emplace(std::string(part.prototypeId),
+                                 XCAFDoc_ShapeTool::GetShape(node.label));
+      }
+
+    } else {
+      // Unknown shape type - treat as part
+      parentAssembly.parts.emplace_back().name = name + " (Unknown)";
+    }
+    return !next_.empty();
+  }
+
+  template <typename Push>
+  void children(const ShapeNode&, Push&& push) {
+    for (const auto& child : next_) {
+      push(child);
+    }
+  }
+
+  void leave(const ShapeNode&, std::size_t) {}
+
+private:
+  const ::opencascade::handle<XCAFDoc_ShapeTool>& shapeTool_;
+  PrototypeShapes* prototypes_;
+  const ExternalReferences& references_;
+  std::vector<ShapeNode> next_; // children found by the last enter()
+};
+
+// The model name followed by the number of assemblies and parts in the
+// document, as the root is named
+std::string rootName(const ::opencascade::handle<XCAFDoc_ShapeTool>& shapeTool,
+                     const std::string& modelName) {
+  int totalParts = 0;
+  int totalAssemblies = 0;
+  TDF_LabelSequence allShapes;
+  shapeTool->GetShapes(allShapes);
+  for (Standard_Integer i = 1; i <= allShapes.Length(); i++) {
+    TDF_Label label = allShapes.Value(i);
+    if (shapeTool->IsAssembly(label)) {
+      totalAssemblies++;
+    } else if (shapeTool->IsSimpleShape(label) || shapeTool->IsComponent(label)) {
+      totalParts++;
+    }
+  }
+
+  std::string name = modelName;
+  if (totalAssemblies > 0 || totalParts > 0) {
+    name += " (" + std::to_string(totalAssemblies) + " assemblies, " +
+            std::to_string(totalParts) + " parts)";
+  }
+  return name;
+}
+
+// Builds the model from a transferred (or reloaded) XDE document
+Model buildModel(const ::opencascade::handle<TDocStd_Document>& doc,
+                 const std::string& modelName, Model model,
+                 PrototypeShapes* prototypes,
+                 const ExternalReferences& references = {}) {
+  // Get the shape tool for accessing hierarchy
+  ::opencascade::handle<XCAFDoc_ShapeTool> shapeTool = XCAFDoc_DocumentTool::ShapeTool(doc->Main());
+  if (shapeTool.IsNull()) {
+    model.root.name = "Error accessing shape tool";
+    return model;
+  }
   
-  std::string baseName = "Entity_" + std::to_string(partCounter++);
-  std::string shapeName = extractNameFromLabel(label, baseName);
+  // Get free shapes (top-level shapes)
+  TDF_LabelSequence freeShapes;
+  shapeTool->GetFreeShapes(freeShapes);
   
-  if (shapeTool->IsAssembly(label)) {
-    // Create a new assembly
-    Assembly assembly;
-    assembly.name = shapeName;
-    
-    // Get components of this assembly
-    TDF_LabelSequence components;
-    shapeTool->GetComponents(label, components);
-    
-    // Process each component recursively
-    for (Standard_Integer i = 1; i <= components.Length(); i++) {
-      processShapeLabel(shapeTool, components.Value(i), assembly, partCounter);
+  if (freeShapes.Length() == 0) {
+    model.root.name = "No shapes found in STEP file";
+    return model;
+  }
+  
+  // Use the model name extracted from the original content
+  model.root.name = rootName(shapeTool, modelName);
+  
+  // Process each free shape
+  ShapeHierarchyBuilder builder(shapeTool, prototypes, references);
+  cad::domain::DepthFirstTraversal<ShapeNode> traversal;
+  for (Standard_Integer i = 1; i <= freeShapes.Length(); i++) {
+    traversal.run(ShapeNode{freeShapes.Value(i), &model.root, TopLoc_Location()},
+                  builder);
+  }
+  
+  return model;
+}
+
+// A model expanded straight from the label tree of the document it keeps
+// open. Each assembly is named when its parent is expanded and filled in
+// like ShapeHierarchyBuilder would, one level at a time, so the expanded
+// model equals the read one.
+class StepLazyModel final : public cad::domain::LazyModel {
+public:
+  StepLazyModel(const cad::domain::DomainAllocator& alloc, ScopedDocument document,
+                const ::opencascade::handle<XCAFDoc_ShapeTool>& shapeTool,
+                const std::string& modelName, ExternalReferences references)
+      : LazyModel(alloc, kRootKey), document_(std::move(document)),
+        shapeTool_(shapeTool), references_(std::move(references)) {
+    rootNode().name = rootName(shapeTool_, modelName);
+  }
+
+private:
+  // Keys index nodes_; the root stands for the free shapes
+  static constexpr std::size_t kRootKey = 0;
+
+  struct Node {
+    TDF_Label label;
+    TopLoc_Location location;
+  };
+
+  void expandNode(std::size_t key, Assembly& node,
+                  std::vector<std::size_t>& childKeys) override {
+    TDF_LabelSequence labels;
+    if (key == kRootKey) {
+      shapeTool_->GetFreeShapes(labels);
+    } else {
+      shapeTool_->GetComponents(nodes_[key].label, labels);
     }
-    
-    parentAssembly.children.push_back(assembly);
-    
-  } else if (shapeTool->IsComponent(label)) {
-    // This is a component reference - get the actual shape it refers to
-    TDF_Label refLabel;
-    if (shapeTool->GetReferredShape(label, refLabel)) {
-      processShapeLabel(shapeTool, refLabel, parentAssembly, partCounter);
+    const TopLoc_Location location = nodes_[key].location;
+    for (Standard_Integer i = 1; i <= labels.Length(); i++) {
+      add(labels.Value(i), location, node, childKeys);
+    }
+  }
+
+  void add(TDF_Label label, TopLoc_Location location, Assembly& parent,
+           std::vector<std::size_t>& childKeys) {
+    if (shapeTool_->IsComponent(label)) {
+      TDF_Label refLabel;
+      if (!shapeTool_->GetReferredShape(label, refLabel)) {
+        parent.parts.emplace_back().name = shapeName(label) + " (Component)";
+        return;
+      }
+      location = location * XCAFDoc_ShapeTool::GetLocation(label);
+      label = refLabel;
+    }
+    const std::string name = shapeName(label);
+
+    if (shapeTool_->IsAssembly(label)) {
+      parent.children.emplace_back().name = name;
+      childKeys.push_back(nodes_.size());
+      nodes_.push_back({label, location});
+    } else if (shapeTool_->IsSimpleShape(label)) {
+      Part& part = parent.parts.emplace_back();
+      part.name = name;
+      part.placement = toPlacement(location);
+      if (const std::string* reference =
+              externalReference(references_, XCAFDoc_ShapeTool::GetShape(label))) {
+        part.reference = *reference;
+      } else {
+        part.prototypeId = labelEntry(label);
+      }
     } else {
-      // Fallback: treat as a part
-      Part part;
-      part.name = shapeName + " (Component)";
-      parentAssembly.parts.push_back(part);
+      parent.parts.emplace_back().name = name + " (Unknown)";
     }
-    
-  } else if (shapeTool->IsSimpleShape(label)) {
-    // This is a simple shape (part)
-    Part part;
-    part.name = shapeName;
-    parentAssembly.parts.push_back(part);
-    
-  } else {
-    // Unknown shape type - treat as part
-    Part part;
-    part.name = shapeName + " (Unknown)";
-    parentAssembly.parts.push_back(part);
   }
+
+  ScopedDocument document_;
+  ::opencascade::handle<XCAFDoc_ShapeTool> shapeTool_;
+  ExternalReferences references_;
+  std::vector<Node> nodes_{Node{TDF_Label(), TopLoc_Location()}};
+};
+
+// What a read makes of the document once it is transferred or reloaded:
+// the model name from the header, the external references and the model
+// holding the root so far. The document may be moved from.
+using DocumentConsumer = std::function<Model(
+    ScopedDocument& document, const std::string& modelName,
+    const ExternalReferences& references, Model model)>;
+
+DocumentConsumer buildInto(PrototypeShapes* prototypes) {
+  return [prototypes](ScopedDocument& document, const std::string& modelName,
+                      const ExternalReferences& references, Model model) {
+    return buildModel(document.get(), modelName, std::move(model), prototypes,
+                      references);
+  };
+}
+
+const char* profileName(StepReadProfile profile) {
+  switch (profile) {
+  case StepReadProfile::Structure:
+    return "structure";
+  case StepReadProfile::Names:
+    return "names";
+  case StepReadProfile::Full:
+    break;
+  }
+  return "full";
+}
+
+// Cache file for STEP content: length plus two independently seeded 64-bit
+// hashes, so a stale or colliding entry is practically impossible. Documents
+// read with a reduced profile lack attributes, so they are kept apart.
+std::filesystem::path cachePath(const std::string& directory,
+                                std::string_view content, StepReadProfile profile) {
+  namespace hashing = cad::domain::hashing;
+  char key[96];
+  std::snprintf(key, sizeof(key), "%zx-%016llx%016llx%s%s.xbf", content.size(),
+                static_cast<unsigned long long>(hashing::hashBytes(content, 0x5354455031ULL)),
+                static_cast<unsigned long long>(hashing::hashBytes(content, 0x5354455032ULL)),
+                profile == StepReadProfile::Full ? "" : "-",
+                profile == StepReadProfile::Full ? "" : profileName(profile));
+  return std::filesystem::path(directory) / key;
+}
+
+// Switches off the XDE attributes a profile does not keep; each one is a
+// separate pass over the STEP entities during transfer. The reader's modes
+// are per instance, so reads with different profiles can run concurrently.
+void configureReader(STEPCAFControl_Reader& reader, StepReadProfile profile) {
+  const bool full = profile == StepReadProfile::Full;
+  reader.SetNameMode(profile != StepReadProfile::Structure);
+  reader.SetColorMode(full);
+  reader.SetLayerMode(full);
+  reader.SetPropsMode(full);
+  reader.SetGDTMode(full);
+  reader.SetMatMode(full);
+  reader.SetViewMode(full);
+  reader.SetSHUOMode(full);
+}
+
+// The read.step.* parameters for a profile, passed per read rather than
+// through the process-wide Interface_Static values.
+DESTEP_Parameters stepParameters(StepReadProfile profile) {
+  DESTEP_Parameters parameters;
+  parameters.InitFromStatic();
+  if (profile != StepReadProfile::Full) {
+    parameters.ReadShapeAspect = false;   // read.step.shape.aspect
+    parameters.ReadSubshapeNames = false; // read.stepcaf.subshapes.name
+    parameters.ReadConstrRelation = false; // read.step.constructivegeom.relationship
+    parameters.ReadTessellated = DESTEP_Parameters::RWMode_Tessellated_Off; // read.step.tessellated
+    parameters.ReadColor = false;
+    parameters.ReadLayer = false;
+    parameters.ReadProps = false;
+    parameters.ReadName = profile == StepReadProfile::Names;
+  }
+  return parameters;
 }
 
-cad::domain::Model OpenCascadeCadModelReaderAdapter::readModelFromStream(std::istream &stream) {
-  Model model;
+// Writes `doc` as BinXCAF under a private name and renames it into place, so
+// concurrent readers never see a partial file. Failures only cost the cache.
+void storeInCache(const ::opencascade::handle<TDocStd_Document>& doc,
+                  const std::filesystem::path& path) {
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  std::filesystem::path partial = path;
+  partial.replace_extension(".partial-" + std::to_string(std::random_device()()) + ".xbf");
+  try {
+    std::lock_guard<std::mutex> lock(applicationMutex());
+    doc->ChangeStorageFormat("BinXCAF");
+    if (XCAFApp_Application::GetApplication()->SaveAs(
+            doc, TCollection_ExtendedString(partial.string().c_str())) != PCDM_SS_OK) {
+      std::filesystem::remove(partial, ec);
+      return;
+    }
+  } catch (const Standard_Failure&) {
+    std::filesystem::remove(partial, ec);
+    return;
+  }
+  std::filesystem::rename(partial, path, ec);
+  if (ec) {
+    std::filesystem::remove(partial, ec);
+  }
+}
+
+Model readStep(std::istream& stream, std::pmr::memory_resource* resource,
+               const std::string& cacheDirectory, StepReadProfile profile,
+               cad::ports::ProgressPort* progress, const DocumentConsumer& consume) {
+  // Nodes are emplaced into their parents, so the whole hierarchy inherits
+  // the root's allocator
+  Model model(cad::domain::DomainAllocator{resource});
   model.root.name = "STEP Model";
   
   try {
-    // Read all stream data into a string
-    std::string content((std::istreambuf_iterator<char>(stream)),
-                        std::istreambuf_iterator<char>());
+    // With progress, every byte passes a counting buffer that also cuts the
+    // input short once the read is cancelled
+    std::optional<cad::adapters::common::ProgressStreamBuf> counted;
+    std::streambuf* source = stream.rdbuf();
+    if (progress) {
+      source = &counted.emplace(source, *progress);
+    }
+
+    // Only the first few KB are needed to recognise the file and read the
+    // model name from its HEADER section
+    std::string prefix(cad::adapters::common::kProbeBytes, '\0');
+    std::streamsize prefixSize = source->sgetn(
+        prefix.data(), static_cast<std::streamsize>(prefix.size()));
+    prefix.resize(prefixSize > 0 ? static_cast<std::size_t>(prefixSize) : 0);
     
-    if (content.empty()) {
+    if (prefix.empty()) {
       model.root.name = "Empty STEP file";
       return model;
     }
     
-    // Create a temporary file since OpenCASCADE readers work with files
-    std::filesystem::path tempFile = std::filesystem::temp_directory_path() / "temp_step_file.step";
-    
-    // Try to extract model name from the content itself before writing to temp file
+    // Take the model name from FILE_NAME in the header
     std::string originalModelName = "STEP Model";
-    try {
-      // Look for FILE_NAME in the content
-      size_t fileNamePos = content.find("FILE_NAME(");
-      if (fileNamePos != std::string::npos) {
-        size_t nameStart = content.find("/* name */ '", fileNamePos);
-        if (nameStart != std::string::npos) {
-          nameStart += 12; // Length of "/* name */ '"
-          size_t nameEnd = content.find("'", nameStart);
-          if (nameEnd != std::string::npos) {
-            std::string modelName = content.substr(nameStart, nameEnd - nameStart);
-            if (!modelName.empty() && modelName != "Unknown") {
-              originalModelName = modelName;
-            }
-          }
+    cad::adapters::common::StepHeader header = cad::adapters::common::parseStepHeader(prefix);
+    if (!header.name.empty() && header.name != "Unknown") {
+      originalModelName = header.name;
+    }
+
+    // The cache is keyed by content, so with a cache the whole file is read
+    // up front; the reload then skips STEP parsing and transfer entirely
+    std::string content;
+    std::filesystem::path cached;
+    if (!cacheDirectory.empty()) {
+      content = std::move(prefix);
+      char buffer[64 * 1024];
+      std::streamsize n;
+      while ((n = source->sgetn(buffer, sizeof(buffer))) > 0) {
+        content.append(buffer, static_cast<std::size_t>(n));
+      }
+      cad::ports::throwIfCancelled(progress);
+      cached = cachePath(cacheDirectory, content, profile);
+      std::error_code ec;
+      if (std::filesystem::exists(cached, ec)) {
+        ScopedDocument document(cached.string());
+        if (!document.get().IsNull()) {
+          return consume(document, originalModelName, {}, std::move(model));
         }
       }
-    } catch (...) {
-      // If extraction fails, keep default name
     }
     
-    // Write content to temporary file
-    {
-      std::ofstream tempStream(tempFile);
-      if (!tempStream) {
-        model.root.name = "Error creating temporary file";
-        return model;
-      }
-      tempStream << content;
-    }
+    // Parse straight from the caller's stream with the prefix replayed in
+    // front of the unread rest; no temporary file is shared between reads
+    // (or, with a cache, from the content already read)
+    cad::adapters::common::PrefixReplayIStream input(
+        cached.empty() ? std::move(prefix) : std::move(content),
+        cached.empty() ? source : nullptr);
     
     try {
-      // Initialize XDE Application and Document
-      ::opencascade::handle<XCAFApp_Application> app = XCAFApp_Application::GetApplication();
-      ::opencascade::handle<TDocStd_Document> doc;
-      app->NewDocument("MDTV-XCAF", doc);
+      // Each read works on its own XDE document
+      ScopedDocument document;
+      ::opencascade::handle<TDocStd_Document> doc = document.get();
       
       // Create STEP reader with XDE support
       STEPCAFControl_Reader reader;
-      reader.SetNameMode(true);  // Enable name reading
-      
-      // Read the STEP file
-      IFSelect_ReturnStatus status = reader.ReadFile(tempFile.string().c_str());
+      configureReader(reader, profile);
       
-      // Clean up temporary file
-      std::filesystem::remove(tempFile);
+      // Read the STEP data
+      IFSelect_ReturnStatus status =
+          reader.ReadStream(originalModelName.c_str(), stepParameters(profile), input);
       
       if (status != IFSelect_RetDone) {
+        cad::ports::throwIfCancelled(progress);
         model.root.name = "Error reading STEP file";
         return model;
       }
       
       // Transfer data to the document
-      if (!reader.Transfer(doc)) {
-        model.root.name = "Error transferring STEP data";
-        return model;
+      bool transferred;
+      if (progress) {
+        ::opencascade::handle<ProgressIndicator> indicator = new ProgressIndicator(*progress);
+        transferred = reader.Transfer(doc, indicator->Start());
+      } else {
+        transferred = reader.Transfer(doc);
       }
-      
-      // Get the shape tool for accessing hierarchy
-      ::opencascade::handle<XCAFDoc_ShapeTool> shapeTool = XCAFDoc_DocumentTool::ShapeTool(doc->Main());
-      if (shapeTool.IsNull()) {
-        model.root.name = "Error accessing shape tool";
-        return model;
-      }
-      
-      // Get free shapes (top-level shapes)
-      TDF_LabelSequence freeShapes;
-      shapeTool->GetFreeShapes(freeShapes);
-      
-      if (freeShapes.Length() == 0) {
-        model.root.name = "No shapes found in STEP file";
+      cad::ports::throwIfCancelled(progress);
+      if (!transferred) {
+        model.root.name = "Error transferring STEP data";
         return model;
       }
-      
-      // Count total parts and assemblies for the root name
-      int totalParts = 0;
-      int totalAssemblies = 0;
-      
-      // First pass: count entities
-      TDF_LabelSequence allShapes;
-      shapeTool->GetShapes(allShapes);
-      for (Standard_Integer i = 1; i <= allShapes.Length(); i++) {
-        TDF_Label label = allShapes.Value(i);
-        if (shapeTool->IsAssembly(label)) {
-          totalAssemblies++;
-        } else if (shapeTool->IsSimpleShape(label) || shapeTool->IsComponent(label)) {
-          totalParts++;
-        }
-      }
-      
-      // Use the model name extracted from the original content
-      std::string rootName = originalModelName;
-      if (totalAssemblies > 0 || totalParts > 0) {
-        rootName += " (" + std::to_string(totalAssemblies) + " assemblies, " + 
-                    std::to_string(totalParts) + " parts)";
+
+      // The reference table lives in the STEP entities, which a cached
+      // document does not keep, so files with references are not cached
+      ExternalReferences references = collectExternalReferences(reader);
+      if (!cached.empty() && references.empty()) {
+        storeInCache(doc, cached);
       }
-      model.root.name = rootName;
       
-      // Process each free shape
-      int partCounter = 1;
-      for (Standard_Integer i = 1; i <= freeShapes.Length(); i++) {
-        TDF_Label label = freeShapes.Value(i);
-        processShapeLabel(shapeTool, label, model.root, partCounter);
-      }
-      
-      return model;
+      return consume(document, originalModelName, references, std::move(model));
       
+    } catch (const cad::ports::ReadCancelled&) {
+      throw;
     } catch (const std::exception& e) {
-      // Clean up temporary file in case of exception
-      std::filesystem::remove(tempFile);
-      
       // Fallback to simplified parsing
       model.root.name = "STEP Model (XDE parsing failed, using fallback)";
-      Part part;
-      part.name = "STEP_Content (" + std::string(e.what()) + ")";
-      model.root.parts.push_back(part);
+      model.root.parts.emplace_back().name = "STEP_Content (" + std::string(e.what()) + ")";
       return model;
     }
     
+  } catch (const cad::ports::ReadCancelled&) {
+    throw;
   } catch (const std::exception& e) {
     // Return model with error message
     model.root.name = "Exception reading STEP file: " + std::string(e.what());
@@ -244,4 +1031,210 @@ cad::domain::Model OpenCascadeCadModelReaderAdapter::readModelFromStream(std::is
   }
 }
 
+// Waits for a task that may still point into shapes about to be freed, when
+// the caller is already unwinding; its own outcome no longer matters. Futures
+// already consumed are skipped.
+template <typename T>
+void settle(cad::concurrency::ThreadPool& pool, std::future<T>& future) {
+  if (!future.valid()) {
+    return;
+  }
+  try {
+    pool.await(future);
+  } catch (...) {
+  }
+}
+
+} // namespace
+
+std::optional<StepReadProfile> parseStepReadProfile(std::string_view name) {
+  for (StepReadProfile profile :
+       {StepReadProfile::Structure, StepReadProfile::Names, StepReadProfile::Full}) {
+    if (name == profileName(profile)) {
+      return profile;
+    }
+  }
+  return std::nullopt;
+}
+
+OpenCascadeCadModelReaderAdapter::OpenCascadeCadModelReaderAdapter(
+    std::string cacheDirectory, StepReadProfile profile)
+    : cacheDirectory_(std::move(cacheDirectory)), profile_(profile) {}
+
+cad::domain::Model OpenCascadeCadModelReaderAdapter::readModelFromStream(
+    std::istream &stream, std::pmr::memory_resource *resource) {
+  return readStep(stream, resource, cacheDirectory_, profile_, nullptr, buildInto(nullptr));
+}
+
+cad::domain::Model OpenCascadeCadModelReaderAdapter::readModelFromStream(
+    std::istream &stream, std::pmr::memory_resource *resource,
+    cad::ports::ProgressPort &progress) {
+  cad::ports::throwIfCancelled(&progress);
+  return readStep(stream, resource, cacheDirectory_, profile_, &progress, buildInto(nullptr));
+}
+
+std::size_t OpenCascadeCadModelReaderAdapter::estimateReadBytes(std::istream &stream) {
+  return cad::ports::remainingStreamBytes(stream) * kBytesPerInputByte;
+}
+
+std::unique_ptr<cad::domain::LazyModel> OpenCascadeCadModelReaderAdapter::openLazyModel(
+    std::istream &stream, std::pmr::memory_resource *resource) {
+  // The document stays open in the lazy model; reads that end with an error
+  // root (or with no shapes) yield that root as a complete model
+  std::unique_ptr<cad::domain::LazyModel> lazy;
+  Model model = readStep(
+      stream, resource, cacheDirectory_, profile_, nullptr,
+      [&lazy](ScopedDocument& document, const std::string& modelName,
+              const ExternalReferences& references, Model built) {
+        ::opencascade::handle<XCAFDoc_ShapeTool> shapeTool =
+            XCAFDoc_DocumentTool::ShapeTool(document.get()->Main());
+        TDF_LabelSequence freeShapes;
+        if (!shapeTool.IsNull()) {
+          shapeTool->GetFreeShapes(freeShapes);
+        }
+        if (freeShapes.Length() == 0) {
+          return buildModel(document.get(), modelName, std::move(built), nullptr);
+        }
+        lazy = std::make_unique<StepLazyModel>(built.get_allocator(),
+                                               std::move(document), shapeTool,
+                                               modelName, references);
+        return built;
+      });
+  if (lazy) {
+    return lazy;
+  }
+  return cad::domain::LazyModel::fromModel(std::move(model));
+}
+
+cad::ports::MeasuredModel OpenCascadeCadModelReaderAdapter::readMeasuredModel(
+    std::istream &stream, cad::concurrency::ThreadPool &pool,
+    std::pmr::memory_resource *resource) {
+  return measure(stream, pool, resource, nullptr);
+}
+
+cad::ports::MeasuredModel OpenCascadeCadModelReaderAdapter::readMeasuredModel(
+    std::istream &stream, cad::concurrency::ThreadPool &pool,
+    std::pmr::memory_resource *resource, cad::ports::ProgressPort &progress) {
+  cad::ports::throwIfCancelled(&progress);
+  return measure(stream, pool, resource, &progress);
+}
+
+cad::ports::MeasuredModel OpenCascadeCadModelReaderAdapter::measure(
+    std::istream &stream, cad::concurrency::ThreadPool &pool,
+    std::pmr::memory_resource *resource, cad::ports::ProgressPort *progress) {
+  PrototypeShapes shapes;
+  cad::ports::MeasuredModel result{
+      readStep(stream, resource, cacheDirectory_, profile_, progress, buildInto(&shapes)), {}};
+
+  // Shapes outlive the closed document (they are reference counted), so the
+  // prototypes are measured after the read, one task each. Shared geometry
+  // is measured once; instances are placed by the caller. Once cancelled,
+  // tasks not yet started give up straight away.
+  std::vector<std::future<std::optional<cad::domain::GeometricProperties>>> pending;
+  pending.reserve(shapes.size());
+  for (const auto& entry : shapes) {
+    const TopoDS_Shape* shape = &entry.second;
+    pending.push_back(pool.submit([shape, progress] {
+      cad::ports::throwIfCancelled(progress);
+      return measureShape(*shape);
+    }));
+  }
+  auto shape = shapes.begin();
+  std::uint64_t measured = 0;
+  try {
+    for (auto& future : pending) {
+      if (auto properties = pool.await(future)) {
+        result.prototypes.emplace(shape->first, *properties);
+      }
+      ++shape;
+      if (progress) {
+        progress->report("measure", ++measured, pending.size());
+      }
+    }
+  } catch (...) {
+    // Tasks still in flight point into `shapes`; let them finish first
+    for (auto& future : pending) {
+      settle(pool, future);
+    }
+    throw;
+  }
+  return result;
+}
+
+std::unique_ptr<cad::ports::PrototypeGeometry>
+OpenCascadeCadModelReaderAdapter::readPrototypeGeometry(std::istream &stream,
+                                                        std::pmr::memory_resource *resource) {
+  PrototypeShapes shapes;
+  Model model = readStep(stream, resource, cacheDirectory_, profile_, nullptr, buildInto(&shapes));
+  return std::make_unique<StepPrototypeGeometry>(std::move(model), std::move(shapes));
+}
+
+std::unique_ptr<cad::ports::PrototypeGeometry>
+OpenCascadeCadModelReaderAdapter::readPrototypeGeometry(std::istream &stream,
+                                                        std::pmr::memory_resource *resource,
+                                                        cad::ports::ProgressPort &progress) {
+  cad::ports::throwIfCancelled(&progress);
+  PrototypeShapes shapes;
+  Model model = readStep(stream, resource, cacheDirectory_, profile_, &progress, buildInto(&shapes));
+  return std::make_unique<StepPrototypeGeometry>(std::move(model), std::move(shapes));
+}
+
+cad::domain::Model OpenCascadeCadModelReaderAdapter::readTessellatedModel(
+    std::istream &stream, const cad::ports::TessellationOptions &options,
+    cad::concurrency::ThreadPool &pool, const MeshSink &sink,
+    std::pmr::memory_resource *resource) {
+  return tessellate(stream, options, pool, sink, resource, nullptr);
+}
+
+cad::domain::Model OpenCascadeCadModelReaderAdapter::readTessellatedModel(
+    std::istream &stream, const cad::ports::TessellationOptions &options,
+    cad::concurrency::ThreadPool &pool, const MeshSink &sink,
+    std::pmr::memory_resource *resource, cad::ports::ProgressPort &progress) {
+  cad::ports::throwIfCancelled(&progress);
+  return tessellate(stream, options, pool, sink, resource, &progress);
+}
+
+cad::domain::Model OpenCascadeCadModelReaderAdapter::tessellate(
+    std::istream &stream, const cad::ports::TessellationOptions &options,
+    cad::concurrency::ThreadPool &pool, const MeshSink &sink,
+    std::pmr::memory_resource *resource, cad::ports::ProgressPort *progress) {
+  PrototypeShapes shapes;
+  Model model = readStep(stream, resource, cacheDirectory_, profile_, progress, buildInto(&shapes));
+
+  // Meshes are handed over in prototype order. At most `window` of them are
+  // being built or waiting at any time, so memory follows the largest few
+  // meshes rather than the model.
+  using Pending = std::pair<const std::string*, std::future<cad::domain::Mesh>>;
+  const std::size_t window = 2 * std::max<std::size_t>(1, pool.size());
+  std::deque<Pending> pending;
+  auto next = shapes.begin();
+  std::uint64_t meshed = 0;
+  try {
+    while (next != shapes.end() || !pending.empty()) {
+      while (next != shapes.end() && pending.size() < window) {
+        const TopoDS_Shape* shape = &next->second;
+        pending.emplace_back(&next->first, pool.submit([shape, options, progress] {
+                               cad::ports::throwIfCancelled(progress);
+                               return triangulate(*shape, options);
+                             }));
+        ++next;
+      }
+      cad::domain::Mesh mesh = pool.await(pending.front().second);
+      const std::string& prototypeId = *pending.front().first;
+      pending.pop_front();
+      sink(prototypeId, std::move(mesh));
+      if (progress) {
+        progress->report("mesh", ++meshed, shapes.size());
+      }
+    }
+  } catch (...) {
+    // Tasks still in flight point into `shapes`; let them finish first
+    for (auto& task : pending) {
+      settle(pool, task.second);
+    }
+    throw;
+  }
+  return model;
+}
+
 } // namespace cad::adapters::opencascade
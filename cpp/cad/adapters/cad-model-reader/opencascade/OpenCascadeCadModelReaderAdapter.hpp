@@ -1,15 +1,117 @@
 #pragma once
 
 #include <istream>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
 
 #include "cpp/cad/core/domain/Model.hpp"
 #include "cpp/cad/core/ports/CadModelReaderPort.hpp"
+#include "cpp/cad/core/ports/GeometricPropertiesPort.hpp"
+#include "cpp/cad/core/ports/LazyModelReaderPort.hpp"
+#include "cpp/cad/core/ports/PrototypeGeometryPort.hpp"
+#include "cpp/cad/core/ports/TessellationPort.hpp"
 
 namespace cad::adapters::opencascade {
 
-class OpenCascadeCadModelReaderAdapter : public cad::ports::CadModelReaderPort {
+// How much of a STEP file a read transfers into the XDE document. Every
+// profile yields the same hierarchy and geometry; Full also reads colors,
+// layers, validation properties, GD&T and materials, Names only product
+// names, and Structure not even those, so parts are named Entity_<n> and
+// external references (which are matched by name) stay unresolved.
+enum class StepReadProfile { Structure, Names, Full };
+
+// "structure", "names" or "full"; std::nullopt for anything else.
+std::optional<StepReadProfile> parseStepReadProfile(std::string_view name);
+
+// STEP reader. Parts carry the label of the shape they instantiate as
+// prototypeId and the component placement leading to it, so it also serves
+// geometric properties, meshes and shape comparisons, computed once per
+// prototype.
+//
+// With a cache directory, each transferred document is also saved there in
+// OCCT's binary XDE format (BinXCAF), keyed by a hash of the STEP content.
+// Reading the same content again reloads that document instead of parsing
+// and transferring STEP, and yields the same model. Each profile has its own
+// cache entries.
+//
+// A lazily opened model keeps the transferred document open and expands
+// assemblies from its label tree, so opening still costs the STEP transfer
+// (or the cache reload) but not building the whole hierarchy.
+class OpenCascadeCadModelReaderAdapter final
+    : public cad::ports::CadModelReaderPort,
+      public cad::ports::GeometricPropertiesPort,
+      public cad::ports::TessellationPort,
+      public cad::ports::LazyModelReaderPort,
+      public cad::ports::PrototypeGeometryPort {
 public:
-  cad::domain::Model readModelFromStream(std::istream &stream) override;
+  OpenCascadeCadModelReaderAdapter() = default;
+  explicit OpenCascadeCadModelReaderAdapter(
+      std::string cacheDirectory, StepReadProfile profile = StepReadProfile::Full);
+
+  using CadModelReaderPort::readModelFromStream;
+  cad::domain::Model
+  readModelFromStream(std::istream &stream,
+                      std::pmr::memory_resource *resource) override;
+  // Reports bytes while parsing and OCCT's transfer progress; a cancelled
+  // transfer is abandoned through OCCT's user break
+  cad::domain::Model
+  readModelFromStream(std::istream &stream, std::pmr::memory_resource *resource,
+                      cad::ports::ProgressPort &progress) override;
+  // Counts the STEP entity graph and the transferred document, not only the
+  // model; a cached document costs less than this
+  std::size_t estimateReadBytes(std::istream &stream) override;
+
+  cad::ports::MeasuredModel
+  readMeasuredModel(std::istream &stream, cad::concurrency::ThreadPool &pool,
+                    std::pmr::memory_resource *resource) override;
+  // Reports the read as above, then each measured prototype
+  cad::ports::MeasuredModel
+  readMeasuredModel(std::istream &stream, cad::concurrency::ThreadPool &pool,
+                    std::pmr::memory_resource *resource,
+                    cad::ports::ProgressPort &progress) override;
+
+  cad::domain::Model
+  readTessellatedModel(std::istream &stream,
+                       const cad::ports::TessellationOptions &options,
+                       cad::concurrency::ThreadPool &pool, const MeshSink &sink,
+                       std::pmr::memory_resource *resource) override;
+  // Reports the read as above, then each meshed prototype
+  cad::domain::Model
+  readTessellatedModel(std::istream &stream,
+                       const cad::ports::TessellationOptions &options,
+                       cad::concurrency::ThreadPool &pool, const MeshSink &sink,
+                       std::pmr::memory_resource *resource,
+                       cad::ports::ProgressPort &progress) override;
+
+  using LazyModelReaderPort::openLazyModel;
+  std::unique_ptr<cad::domain::LazyModel>
+  openLazyModel(std::istream &stream, std::pmr::memory_resource *resource) override;
+
+  // Signatures come from OCCT's mass properties; shapes are matched through
+  // their vertices and edge midpoints, first as they are, then aligned by
+  // their principal axes of inertia. Shapes with repeated principal moments
+  // (e.g. cylinders) therefore match only when they are not turned.
+  std::unique_ptr<cad::ports::PrototypeGeometry>
+  readPrototypeGeometry(std::istream &stream, std::pmr::memory_resource *resource) override;
+  std::unique_ptr<cad::ports::PrototypeGeometry>
+  readPrototypeGeometry(std::istream &stream, std::pmr::memory_resource *resource,
+                        cad::ports::ProgressPort &progress) override;
+
+private:
+  cad::ports::MeasuredModel measure(std::istream &stream, cad::concurrency::ThreadPool &pool,
+                                    std::pmr::memory_resource *resource,
+                                    cad::ports::ProgressPort *progress);
+  cad::domain::Model tessellate(std::istream &stream,
+                                const cad::ports::TessellationOptions &options,
+                                cad::concurrency::ThreadPool &pool, const MeshSink &sink,
+                                std::pmr::memory_resource *resource,
+                                cad::ports::ProgressPort *progress);
+
+  std::string cacheDirectory_; // empty: no cache
+  StepReadProfile profile_ = StepReadProfile::Full;
 };
 
 } // namespace cad::adapters::opencascade
@@ -0,0 +1,216 @@
+#include "cpp/cad/adapters/cad-model-reader/text/TextCadModelReaderAdapter.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cpp/cad/adapters/model-data-source/memory/SpanStreamBuf.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::Name;
+
+namespace cad::adapters::text {
+
+namespace {
+
+constexpr std::string_view kAssembly = "Assembly:";
+constexpr std::string_view kPart = "Part:";
+constexpr std::string_view kEndAssembly = "EndAssembly";
+
+// Block size for streams that cannot be read in place
+constexpr std::size_t kBlockBytes = 1 << 20;
+
+// Model bytes per input byte, measured on generated 16 MB inputs (about 18)
+// and rounded up. Blocks are reused, so the model is the whole peak.
+constexpr std::size_t kBytesPerInputByte = 20;
+
+bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+std::string_view trim(std::string_view s) {
+  std::size_t begin = 0;
+  std::size_t end = s.size();
+  while (begin < end && isSpace(s[begin])) {
+    ++begin;
+  }
+  while (end > begin && isSpace(s[end - 1])) {
+    --end;
+  }
+  return s.substr(begin, end - begin);
+}
+
+bool startsWith(std::string_view s, std::string_view prefix) {
+  return s.size() >= prefix.size() &&
+         std::memcmp(s.data(), prefix.data(), prefix.size()) == 0;
+}
+
+// Builds the tree line by line. `path_` holds the open assemblies, root
+// first; each is the last child of the one before it, and a parent's
+// children only grow while it is the innermost open assembly, so the
+// pointers stay valid. Part names wait in `names_` until their assembly
+// closes, so its parts are allocated once, at their final size, instead of
+// being moved as the vector grows: parts are large and most of a model.
+class TreeBuilder {
+public:
+  TreeBuilder(Model &model, cad::ports::ProgressPort *progress)
+      : progress_(progress), path_{&model.root}, names_(1) {}
+
+  void line(std::string_view raw) {
+    std::string_view text = trim(raw);
+    if (text.empty()) {
+      return;
+    }
+    // One byte picks the only keyword the line can start with
+    switch (text[0]) {
+    case 'A':
+      if (startsWith(text, kAssembly)) {
+        Assembly &child = path_.back()->children.emplace_back();
+        child.name = trim(text.substr(kAssembly.size()));
+        path_.push_back(&child);
+        if (names_.size() < path_.size()) {
+          names_.emplace_back();
+        }
+      }
+      break;
+    case 'P':
+      if (startsWith(text, kPart)) {
+        names_[path_.size() - 1].emplace_back(trim(text.substr(kPart.size())));
+      }
+      break;
+    case 'E':
+      // Unmatched EndAssembly lines are ignored; the root never closes
+      if (text == kEndAssembly && path_.size() >= 2) {
+        close();
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  // Called after every line, with the bytes consumed so far
+  void advance(std::uint64_t bytes, std::uint64_t totalBytes) {
+    if (progress_ && ++lines_ % cad::ports::kProgressInterval == 0) {
+      progress_->report("bytes", bytes, totalBytes);
+      cad::ports::throwIfCancelled(progress_);
+    }
+  }
+
+  // Closes the assemblies left open, root last
+  void finish() {
+    while (!path_.empty()) {
+      close();
+    }
+  }
+
+private:
+  void close() {
+    std::vector<Name> &names = names_[path_.size() - 1];
+    auto &parts = path_.back()->parts;
+    parts.reserve(parts.size() + names.size());
+    for (const Name &name : names) {
+      parts.emplace_back().name = name;
+    }
+    names.clear(); // keeps its capacity for the next assembly at this depth
+    path_.pop_back();
+  }
+
+  cad::ports::ProgressPort *progress_;
+  std::vector<Assembly *> path_;
+  std::vector<std::vector<Name>> names_; // pending part names per depth
+  std::uint64_t lines_ = 0;
+};
+
+// Feeds every line of `bytes` to `builder`, the last one even without a
+// newline when `final`; returns the length of the complete lines.
+std::size_t readLines(std::string_view bytes, bool final, TreeBuilder &builder,
+                      std::uint64_t offset, std::uint64_t totalBytes) {
+  const char *begin = bytes.data();
+  const char *end = begin + bytes.size();
+  const char *cursor = begin;
+  while (cursor != end) {
+    const void *found = std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor));
+    if (!found) {
+      break;
+    }
+    const char *newline = static_cast<const char *>(found);
+    builder.line(std::string_view(cursor, static_cast<std::size_t>(newline - cursor)));
+    cursor = newline + 1;
+    builder.advance(offset + static_cast<std::uint64_t>(cursor - begin), totalBytes);
+  }
+  if (final && cursor != end) {
+    builder.line(std::string_view(cursor, static_cast<std::size_t>(end - cursor)));
+    cursor = end;
+  }
+  return static_cast<std::size_t>(cursor - begin);
+}
+
+Model read(std::istream &stream, std::pmr::memory_resource *resource,
+           cad::ports::ProgressPort *progress) {
+  Model model(cad::domain::DomainAllocator{resource});
+  model.root.name = "Root";
+  TreeBuilder builder(model, progress);
+
+  // Bytes already in memory are read where they are, from the stream's
+  // position on
+  if (auto *span = dynamic_cast<cad::adapters::memory::SpanIStream *>(&stream)) {
+    std::streamoff position = span->tellg();
+    if (position >= 0) {
+      std::string_view bytes = span->view().substr(static_cast<std::size_t>(position));
+      readLines(bytes, true, builder, 0, bytes.size());
+      builder.finish();
+      span->seekg(0, std::ios_base::end);
+      return model;
+    }
+  }
+
+  // Otherwise block by block; a line cut by the end of a block moves to the
+  // front of the buffer, which only grows for lines longer than a block
+  std::streambuf *source = stream.rdbuf();
+  std::vector<char> buffer(kBlockBytes);
+  std::size_t carried = 0;
+  std::uint64_t consumed = 0;
+  while (true) {
+    if (carried == buffer.size()) {
+      buffer.resize(2 * buffer.size());
+    }
+    std::streamsize n = source ? source->sgetn(buffer.data() + carried,
+                                               static_cast<std::streamsize>(buffer.size() - carried))
+                               : 0;
+    const bool final = n <= 0;
+    const std::size_t filled = carried + (final ? 0 : static_cast<std::size_t>(n));
+    std::size_t used = readLines(std::string_view(buffer.data(), filled), final, builder,
+                                 consumed, 0);
+    consumed += used;
+    if (final) {
+      break;
+    }
+    carried = filled - used;
+    std::memmove(buffer.data(), buffer.data() + used, carried);
+  }
+  builder.finish();
+  stream.setstate(std::ios_base::eofbit);
+  return model;
+}
+
+} // namespace
+
+Model TextCadModelReaderAdapter::readModelFromStream(
+    std::istream &stream, std::pmr::memory_resource *resource) {
+  return read(stream, resource, nullptr);
+}
+
+Model TextCadModelReaderAdapter::readModelFromStream(
+    std::istream &stream, std::pmr::memory_resource *resource,
+    cad::ports::ProgressPort &progress) {
+  cad::ports::throwIfCancelled(&progress);
+  return read(stream, resource, &progress);
+}
+
+std::size_t TextCadModelReaderAdapter::estimateReadBytes(std::istream &stream) {
+  return cad::ports::remainingStreamBytes(stream) * kBytesPerInputByte;
+}
+
+} // namespace cad::adapters::text
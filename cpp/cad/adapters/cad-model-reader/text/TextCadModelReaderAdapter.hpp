@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <memory_resource>
+
+#include "cpp/cad/core/ports/CadModelReaderPort.hpp"
+
+namespace cad::adapters::text {
+
+// Reads the line format of FakeCadModelReaderAdapter (Assembly: / Part: /
+// EndAssembly) into the same model, fast enough for multi-GB generated
+// inputs.
+//
+// Lines are found with memchr, which libc vectorizes, and tokenized as views
+// into the input, so a name is copied once, into its node. Streams from the
+// memory data source are read in place; any other stream is read in large
+// blocks, with only a line cut by a block boundary carried over. Assemblies
+// are emplaced into their parent as they open, so nothing is moved or copied
+// when they close.
+class TextCadModelReaderAdapter final : public cad::ports::CadModelReaderPort {
+public:
+  using CadModelReaderPort::readModelFromStream;
+  cad::domain::Model
+  readModelFromStream(std::istream &stream,
+                      std::pmr::memory_resource *resource) override;
+  // Reports bytes consumed and polls every kProgressInterval lines
+  cad::domain::Model
+  readModelFromStream(std::istream &stream, std::pmr::memory_resource *resource,
+                      cad::ports::ProgressPort &progress) override;
+  std::size_t estimateReadBytes(std::istream &stream) override;
+};
+
+} // namespace cad::adapters::text
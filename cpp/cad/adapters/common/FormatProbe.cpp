@@ -0,0 +1,225 @@
+#include "cpp/cad/adapters/common/FormatProbe.hpp"
+
+#include <cctype>
+
+namespace cad::adapters::common {
+
+namespace {
+
+bool startsWith(std::string_view s, std::string_view prefix) {
+  return s.substr(0, prefix.size()) == prefix;
+}
+
+// Tokenizer for the STEP header: keywords, 'strings', punctuation.
+// Comments are skipped, anything else is returned as a single character.
+class StepHeaderLexer {
+public:
+  enum class Kind { End, Keyword, String, Punct, Other };
+  struct Token {
+    Kind kind = Kind::End;
+    std::string text;
+  };
+
+  explicit StepHeaderLexer(std::string_view input) : in_(input) {}
+
+  Token next() {
+    skipSpaceAndComments();
+    if (pos_ >= in_.size()) {
+      return {};
+    }
+    char c = in_[pos_];
+    if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+      std::size_t start = pos_;
+      while (pos_ < in_.size() &&
+             (std::isalnum(static_cast<unsigned char>(in_[pos_])) ||
+              in_[pos_] == '_' || in_[pos_] == '-')) {
+        ++pos_;
+      }
+      return {Kind::Keyword, std::string(in_.substr(start, pos_ - start))};
+    }
+    if (c == '\'') {
+      return readString();
+    }
+    ++pos_;
+    if (c == '(' || c == ')' || c == ',' || c == ';') {
+      return {Kind::Punct, std::string(1, c)};
+    }
+    return {Kind::Other, std::string(1, c)};
+  }
+
+private:
+  void skipSpaceAndComments() {
+    while (pos_ < in_.size()) {
+      if (std::isspace(static_cast<unsigned char>(in_[pos_]))) {
+        ++pos_;
+      } else if (startsWith(in_.substr(pos_), "/*")) {
+        std::size_t end = in_.find("*/", pos_ + 2);
+        pos_ = end == std::string_view::npos ? in_.size() : end + 2;
+      } else {
+        break;
+      }
+    }
+  }
+
+  Token readString() {
+    Token token{Kind::String, {}};
+    ++pos_; // opening quote
+    while (pos_ < in_.size()) {
+      char c = in_[pos_++];
+      if (c != '\'') {
+        token.text += c;
+      } else if (pos_ < in_.size() && in_[pos_] == '\'') {
+        token.text += '\'';
+        ++pos_;
+      } else {
+        return token;
+      }
+    }
+    return {Kind::End, {}}; // unterminated: the prefix ended mid-string
+  }
+
+  std::string_view in_;
+  std::size_t pos_ = 0;
+};
+
+// Collects the arguments of one header entity as a flat list of top-level
+// items, where each item is the list of strings it contains. FILE_NAME's
+// 'name' is items[0][0], FILE_SCHEMA's identifiers are items[0].
+bool readEntityArguments(StepHeaderLexer &lexer,
+                         std::vector<std::vector<std::string>> &items) {
+  using Kind = StepHeaderLexer::Kind;
+  auto token = lexer.next();
+  if (token.kind != Kind::Punct || token.text != "(") {
+    return false;
+  }
+  int depth = 1;
+  items.emplace_back();
+  while (depth > 0) {
+    token = lexer.next();
+    if (token.kind == Kind::End) {
+      return false;
+    }
+    if (token.kind == Kind::String) {
+      items.back().push_back(token.text);
+    } else if (token.kind == Kind::Punct && token.text == "(") {
+      ++depth;
+    } else if (token.kind == Kind::Punct && token.text == ")") {
+      --depth;
+    } else if (token.kind == Kind::Punct && token.text == "," && depth == 1) {
+      items.emplace_back();
+    }
+  }
+  token = lexer.next();
+  return token.kind == Kind::Punct && token.text == ";";
+}
+
+bool looksLikeFakeText(std::string_view prefix) {
+  std::size_t pos = prefix.find_first_not_of(" \t\r\n");
+  if (pos == std::string_view::npos) {
+    return false;
+  }
+  std::string_view line = prefix.substr(pos);
+  return startsWith(line, "Assembly:") || startsWith(line, "Part:") ||
+         startsWith(line, "EndAssembly");
+}
+
+} // namespace
+
+const char *toString(ModelFormat format) {
+  switch (format) {
+  case ModelFormat::Step:
+    return "step";
+  case ModelFormat::Json:
+    return "json";
+  case ModelFormat::FakeText:
+    return "fake";
+  case ModelFormat::Gzip:
+    return "gzip";
+  case ModelFormat::Zstd:
+    return "zstd";
+  case ModelFormat::Unknown:
+    break;
+  }
+  return "unknown";
+}
+
+StepHeader parseStepHeader(std::string_view prefix) {
+  using Kind = StepHeaderLexer::Kind;
+  StepHeader header;
+  StepHeaderLexer lexer(prefix);
+
+  auto token = lexer.next();
+  if (token.kind != Kind::Keyword || token.text != "ISO-10303-21") {
+    return header;
+  }
+  lexer.next(); // ';'
+  token = lexer.next();
+  if (token.kind != Kind::Keyword || token.text != "HEADER") {
+    return header;
+  }
+  lexer.next(); // ';'
+
+  while (true) {
+    token = lexer.next();
+    if (token.kind != Kind::Keyword) {
+      return header;
+    }
+    if (token.text == "ENDSEC") {
+      header.complete = true;
+      return header;
+    }
+
+    std::vector<std::vector<std::string>> items;
+    if (!readEntityArguments(lexer, items)) {
+      return header;
+    }
+    if (token.text == "FILE_DESCRIPTION" && !items.empty()) {
+      header.description = items[0];
+    } else if (token.text == "FILE_NAME") {
+      if (!items.empty() && !items[0].empty()) {
+        header.name = items[0][0];
+      }
+      if (items.size() > 5 && !items[5].empty()) {
+        header.originatingSystem = items[5][0];
+      }
+    } else if (token.text == "FILE_SCHEMA" && !items.empty()) {
+      header.schemas = items[0];
+    }
+  }
+}
+
+ProbeResult probeFormat(std::string_view prefix) {
+  prefix = prefix.substr(0, kProbeBytes);
+  ProbeResult result;
+
+  if (startsWith(prefix, "\x1f\x8b")) {
+    result.format = ModelFormat::Gzip;
+    return result;
+  }
+  if (startsWith(prefix, "\x28\xb5\x2f\xfd")) {
+    result.format = ModelFormat::Zstd;
+    return result;
+  }
+
+  std::string_view text = prefix;
+  if (startsWith(text, "\xef\xbb\xbf")) {
+    text.remove_prefix(3); // UTF-8 BOM
+  }
+  std::size_t first = text.find_first_not_of(" \t\r\n");
+  if (first == std::string_view::npos) {
+    return result;
+  }
+  text.remove_prefix(first);
+
+  if (startsWith(text, "ISO-10303-21")) {
+    result.format = ModelFormat::Step;
+    result.stepHeader = parseStepHeader(text);
+  } else if (text.front() == '{' || text.front() == '[') {
+    result.format = ModelFormat::Json;
+  } else if (looksLikeFakeText(text)) {
+    result.format = ModelFormat::FakeText;
+  }
+  return result;
+}
+
+} // namespace cad::adapters::common
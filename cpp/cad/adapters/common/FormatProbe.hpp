@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cad::adapters::common {
+
+enum class ModelFormat { Unknown, Step, Json, FakeText, Gzip, Zstd };
+
+const char *toString(ModelFormat format);
+
+// The ISO 10303-21 HEADER section entities the readers care about.
+struct StepHeader {
+  std::vector<std::string> description; // FILE_DESCRIPTION description list
+  std::string name;                     // FILE_NAME name
+  std::string originatingSystem;        // FILE_NAME originating_system
+  std::vector<std::string> schemas;     // FILE_SCHEMA identifiers
+  bool complete = false;                // ENDSEC reached within the prefix
+};
+
+struct ProbeResult {
+  ModelFormat format = ModelFormat::Unknown;
+  std::optional<StepHeader> stepHeader; // set for ModelFormat::Step
+};
+
+// How much of an input is read for probing. STEP headers are a few hundred
+// bytes; the margin covers long descriptions and leading comments.
+constexpr std::size_t kProbeBytes = 16 * 1024;
+
+// Classifies an input from its first bytes only (at most kProbeBytes are
+// looked at), never from its name.
+ProbeResult probeFormat(std::string_view prefix);
+
+// Parses the HEADER section of a STEP file up to ENDSEC. Comments and ''
+// escapes are handled; parsing stops quietly at the end of `prefix`.
+StepHeader parseStepHeader(std::string_view prefix);
+
+} // namespace cad::adapters::common
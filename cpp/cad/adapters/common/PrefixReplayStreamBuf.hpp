@@ -0,0 +1,87 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <utility>
+
+namespace cad::adapters::common {
+
+// Streambuf that first replays bytes already taken from `source` and then
+// continues reading from it, so a prefix can be inspected on streams that
+// cannot seek back (pipes, decompressors, network streams).
+class PrefixReplayStreamBuf : public std::streambuf {
+public:
+  PrefixReplayStreamBuf(std::string prefix, std::streambuf *source)
+      : prefix_(std::move(prefix)), source_(source) {
+    if (!prefix_.empty()) {
+      setg(prefix_.data(), prefix_.data(), prefix_.data() + prefix_.size());
+    }
+  }
+
+protected:
+  int_type underflow() override {
+    if (gptr() < egptr()) {
+      return traits_type::to_int_type(*gptr());
+    }
+    std::streamsize n = source_ ? source_->sgetn(buffer_, sizeof(buffer_)) : 0;
+    if (n <= 0) {
+      return traits_type::eof();
+    }
+    setg(buffer_, buffer_, buffer_ + n);
+    return traits_type::to_int_type(*gptr());
+  }
+
+private:
+  std::string prefix_;
+  std::streambuf *source_;
+  char buffer_[64 * 1024];
+};
+
+// Owning istream over a PrefixReplayStreamBuf. `source` may be null when the
+// caller keeps the underlying stream alive itself.
+class PrefixReplayIStream : public std::istream {
+public:
+  PrefixReplayIStream(std::string prefix, std::streambuf *sourceBuffer,
+                      std::unique_ptr<std::istream> source = nullptr)
+      : std::istream(nullptr), source_(std::move(source)),
+        buffer_(std::move(prefix), sourceBuffer) {
+    rdbuf(&buffer_);
+  }
+
+private:
+  std::unique_ptr<std::istream> source_;
+  PrefixReplayStreamBuf buffer_;
+};
+
+// Reads up to `limit` bytes from the front of `stream`. Seekable streams are
+// rewound and returned as-is; otherwise the stream is wrapped so that the
+// peeked bytes are read again.
+struct PeekedStream {
+  std::string prefix;
+  std::unique_ptr<std::istream> stream;
+};
+
+inline PeekedStream peekPrefix(std::unique_ptr<std::istream> stream,
+                               std::size_t limit) {
+  PeekedStream result;
+  result.prefix.resize(limit);
+  std::streambuf *buffer = stream->rdbuf();
+  std::streampos start = buffer->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+  std::streamsize n =
+      buffer->sgetn(result.prefix.data(), static_cast<std::streamsize>(limit));
+  result.prefix.resize(n > 0 ? static_cast<std::size_t>(n) : 0);
+
+  if (start != std::streampos(std::streamoff(-1)) &&
+      buffer->pubseekpos(start, std::ios_base::in) == start) {
+    result.stream = std::move(stream);
+  } else {
+    std::streambuf *source = stream->rdbuf();
+    result.stream = std::make_unique<PrefixReplayIStream>(result.prefix, source,
+                                                          std::move(stream));
+  }
+  return result;
+}
+
+} // namespace cad::adapters::common
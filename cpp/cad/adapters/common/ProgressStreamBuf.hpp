@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <streambuf>
+
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+
+namespace cad::adapters::common {
+
+// Streambuf that forwards `source` in chunks and reports the bytes consumed
+// to `progress` after each one. Once progress is cancelled it reports end of
+// file, so parsers that offer no other way to stop give up at the next chunk;
+// the reader then throws ReadCancelled. The total is known when `source` can
+// seek, and 0 otherwise.
+class ProgressStreamBuf : public std::streambuf {
+public:
+  ProgressStreamBuf(std::streambuf *source, cad::ports::ProgressPort &progress)
+      : source_(source), progress_(progress), total_(remainingBytes(source)) {}
+
+protected:
+  int_type underflow() override {
+    if (gptr() < egptr()) {
+      return traits_type::to_int_type(*gptr());
+    }
+    if (progress_.cancelled()) {
+      return traits_type::eof();
+    }
+    std::streamsize n = source_->sgetn(buffer_, sizeof(buffer_));
+    if (n <= 0) {
+      return traits_type::eof();
+    }
+    consumed_ += static_cast<std::uint64_t>(n);
+    progress_.report("bytes", consumed_, total_);
+    setg(buffer_, buffer_, buffer_ + n);
+    return traits_type::to_int_type(*gptr());
+  }
+
+private:
+  static std::uint64_t remainingBytes(std::streambuf *source) {
+    const auto failed = std::streampos(std::streamoff(-1));
+    std::streampos current = source->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+    if (current == failed) {
+      return 0;
+    }
+    std::streampos end = source->pubseekoff(0, std::ios_base::end, std::ios_base::in);
+    source->pubseekpos(current, std::ios_base::in);
+    return end == failed ? 0 : static_cast<std::uint64_t>(end - current);
+  }
+
+  std::streambuf *source_;
+  cad::ports::ProgressPort &progress_;
+  std::uint64_t total_;
+  std::uint64_t consumed_ = 0;
+  char buffer_[64 * 1024];
+};
+
+// istream over a ProgressStreamBuf; the source stream must outlive it.
+class ProgressIStream : public std::istream {
+public:
+  ProgressIStream(std::istream &source, cad::ports::ProgressPort &progress)
+      : std::istream(nullptr), buffer_(source.rdbuf(), progress) {
+    rdbuf(&buffer_);
+  }
+
+private:
+  ProgressStreamBuf buffer_;
+};
+
+} // namespace cad::adapters::common
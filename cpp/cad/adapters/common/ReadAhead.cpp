@@ -0,0 +1,22 @@
+#include "cpp/cad/adapters/common/ReadAhead.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace cad::adapters::common {
+
+void adviseWillNeed(const std::string &path) {
+#ifdef POSIX_FADV_WILLNEED
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return;
+  }
+  // The advice outlives the descriptor: it queues reads on the file itself
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  ::close(fd);
+#else
+  (void)path;
+#endif
+}
+
+} // namespace cad::adapters::common
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+namespace cad::adapters::common {
+
+// Asks the kernel to start reading the file at `path` into the page cache
+// (posix_fadvise WILLNEED) and returns without waiting. A later read then
+// finds the data cached while the caller was busy elsewhere. Missing files
+// and systems without the advice are ignored.
+void adviseWillNeed(const std::string &path);
+
+} // namespace cad::adapters::common
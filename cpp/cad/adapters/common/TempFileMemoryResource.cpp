@@ -0,0 +1,90 @@
+#include "cpp/cad/adapters/common/TempFileMemoryResource.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace cad::adapters::common {
+
+namespace {
+
+std::size_t pageBytes() {
+  static const std::size_t bytes = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  return bytes;
+}
+
+std::size_t roundToPages(std::size_t bytes) {
+  const std::size_t page = pageBytes();
+  return (std::max<std::size_t>(bytes, 1) + page - 1) / page * page;
+}
+
+// An open descriptor of a new file in `directory` that no name refers to,
+// or -1
+int openUnlinked(const std::string &directory) {
+#ifdef O_TMPFILE
+  const int unnamed = ::open(directory.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+  if (unnamed >= 0) {
+    return unnamed;
+  }
+#endif
+  // Filesystems without O_TMPFILE: create, then unlink straight away
+  const std::string name = directory + "/cad-spill-XXXXXX";
+  std::vector<char> path(name.begin(), name.end());
+  path.push_back('\0');
+  const int fd = ::mkstemp(path.data());
+  if (fd >= 0) {
+    ::unlink(path.data());
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+  return fd;
+}
+
+} // namespace
+
+std::string TempFileMemoryResource::defaultDirectory() {
+  const char *tmp = std::getenv("TMPDIR");
+  return tmp && *tmp ? tmp : "/var/tmp";
+}
+
+TempFileMemoryResource::TempFileMemoryResource(std::string directory)
+    : directory_(std::move(directory)) {}
+
+void *TempFileMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+  // Mappings are page aligned
+  if (alignment > pageBytes()) {
+    throw std::bad_alloc();
+  }
+  const std::size_t length = roundToPages(bytes);
+  const int fd = openUnlinked(directory_);
+  if (fd < 0) {
+    throw std::bad_alloc();
+  }
+  void *p = MAP_FAILED;
+  if (::ftruncate(fd, static_cast<off_t>(length)) == 0) {
+    p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  // The mapping keeps the file alive; it goes with munmap
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  const std::size_t mapped = mapped_.fetch_add(length, std::memory_order_relaxed) + length;
+  std::size_t peak = peak_.load(std::memory_order_relaxed);
+  while (mapped > peak && !peak_.compare_exchange_weak(peak, mapped, std::memory_order_relaxed)) {
+  }
+  return p;
+}
+
+void TempFileMemoryResource::do_deallocate(void *p, std::size_t bytes, std::size_t) {
+  const std::size_t length = roundToPages(bytes);
+  ::munmap(p, length);
+  mapped_.fetch_sub(length, std::memory_order_relaxed);
+}
+
+} // namespace cad::adapters::common
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+namespace cad::adapters::common {
+
+// Memory resource whose every allocation is a shared mapping of its own
+// unlinked temporary file, for models too large for the memory budget: used
+// as the upstream of a ModelArena, the model's chunks live in file-backed
+// pages, which the kernel writes back and drops under memory pressure
+// instead of killing the process (a cgroup counts them, but reclaims them).
+// Pick a directory on disk: on tmpfs the pages are as unreclaimable as heap
+// without swap.
+//
+// Each allocation costs a file, a mapping and at least a page, so this suits
+// the few large chunks of an arena, not node-sized allocations. Throws
+// std::bad_alloc when a file cannot be created, sized or mapped.
+//
+// Thread safety: allocate and deallocate may be called from any thread.
+class TempFileMemoryResource final : public std::pmr::memory_resource {
+public:
+  // $TMPDIR if set, else /var/tmp (disk-backed where /tmp is tmpfs).
+  static std::string defaultDirectory();
+
+  explicit TempFileMemoryResource(std::string directory = defaultDirectory());
+
+  const std::string &directory() const { return directory_; }
+  // Bytes mapped right now, and at most at once
+  std::size_t mappedBytes() const { return mapped_.load(std::memory_order_relaxed); }
+  std::size_t peakBytes() const { return peak_.load(std::memory_order_relaxed); }
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+  std::string directory_;
+  std::atomic<std::size_t> mapped_{0};
+  std::atomic<std::size_t> peak_{0};
+};
+
+} // namespace cad::adapters::common
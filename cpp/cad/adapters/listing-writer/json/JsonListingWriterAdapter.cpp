@@ -0,0 +1,136 @@
+#include "cpp/cad/adapters/listing-writer/json/JsonListingWriterAdapter.hpp"
+
+#include <charconv>
+#include <cstring>
+
+namespace cad::adapters::json {
+
+namespace {
+
+// Escape for every byte that may not appear raw in a JSON string, else 0
+constexpr char escapeFor(unsigned char c) {
+  switch (c) {
+  case '"':
+    return '"';
+  case '\\':
+    return '\\';
+  case '\b':
+    return 'b';
+  case '\f':
+    return 'f';
+  case '\n':
+    return 'n';
+  case '\r':
+    return 'r';
+  case '\t':
+    return 't';
+  default:
+    return c < 0x20 ? 'u' : 0;
+  }
+}
+
+// escapeFor() by table, so the scan is one load and test per byte
+struct EscapeTable {
+  char escapes[256];
+  constexpr EscapeTable() : escapes() {
+    for (int c = 0; c < 256; ++c) {
+      escapes[c] = escapeFor(static_cast<unsigned char>(c));
+    }
+  }
+};
+constexpr EscapeTable kEscapes;
+
+constexpr std::size_t kWorstEscape = 6; // \u00XX
+
+// Writes `text` escaped to `out`, which has room for kWorstEscape bytes per
+// input byte; returns the end of what it wrote.
+char *escapeInto(char *out, std::string_view text) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  for (char c : text) {
+    const auto byte = static_cast<unsigned char>(c);
+    const char escape = kEscapes.escapes[byte];
+    if (escape == 0) {
+      *out++ = c;
+    } else if (escape == 'u') {
+      std::memcpy(out, "\\u00", 4);
+      out[4] = kHex[byte >> 4];
+      out[5] = kHex[byte & 0xF];
+      out += 6;
+    } else {
+      out[0] = '\\';
+      out[1] = escape;
+      out += 2;
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+JsonListingWriterAdapter::JsonListingWriterAdapter(std::ostream &out, Layout layout)
+    : out_(out), layout_(layout), buffer_(new char[kBufferBytes]) {}
+
+void JsonListingWriterAdapter::addRecord(const cad::ports::ListingRecord &record) {
+  if (layout_ == Layout::Array) {
+    append(empty_ ? "[\n" : ",\n");
+  }
+  empty_ = false;
+
+  append("{\"path\":");
+  appendString(record.path);
+  append(",\"depth\":");
+  char digits[24];
+  auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), record.depth);
+  (void)ec; // 24 digits hold any size_t
+  append(std::string_view(digits, static_cast<std::size_t>(end - digits)));
+  append(record.kind == cad::ports::ListingRecord::Kind::Assembly
+             ? ",\"kind\":\"assembly\",\"id\":"
+             : ",\"kind\":\"part\",\"id\":");
+  appendString(record.id);
+  append(",\"name\":");
+  appendString(record.name);
+  append(layout_ == Layout::Lines ? "}\n" : "}");
+}
+
+void JsonListingWriterAdapter::finish() {
+  if (layout_ == Layout::Array) {
+    append(empty_ ? "[]\n" : "\n]\n");
+  }
+  flush();
+  out_.flush();
+}
+
+void JsonListingWriterAdapter::append(std::string_view bytes) {
+  if (size_ + bytes.size() > kBufferBytes) {
+    flush();
+    if (bytes.size() > kBufferBytes) {
+      out_.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+      return;
+    }
+  }
+  std::memcpy(buffer_.get() + size_, bytes.data(), bytes.size());
+  size_ += bytes.size();
+}
+
+// Strings are escaped straight into the buffer, which first makes room for
+// the worst case, every byte escaped as \u00XX; a string too long for that
+// goes through in slices.
+void JsonListingWriterAdapter::appendString(std::string_view text) {
+  append("\"");
+  while (!text.empty()) {
+    std::string_view slice = text.substr(0, kBufferBytes / kWorstEscape);
+    if (size_ + kWorstEscape * slice.size() > kBufferBytes) {
+      flush();
+    }
+    size_ = static_cast<std::size_t>(escapeInto(buffer_.get() + size_, slice) - buffer_.get());
+    text.remove_prefix(slice.size());
+  }
+  append("\"");
+}
+
+void JsonListingWriterAdapter::flush() {
+  out_.write(buffer_.get(), static_cast<std::streamsize>(size_));
+  size_ = 0;
+}
+
+} // namespace cad::adapters::json
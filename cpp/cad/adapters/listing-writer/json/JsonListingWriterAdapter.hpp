@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string_view>
+
+#include "cpp/cad/core/ports/ListingWriterPort.hpp"
+
+namespace cad::adapters::json {
+
+// Writes listing records as JSON objects with path, depth, kind ("assembly"
+// or "part"), id and name:
+//
+//   {"path":"/Root/Engine","depth":1,"kind":"assembly","id":"engine","name":"Engine"}
+//
+// one per line (NDJSON), or as the elements of one array, also one per line.
+// Records are formatted straight into a large buffer that is written to
+// `out` whenever it fills, so nothing is allocated per record. Strings are
+// escaped as JSON requires; bytes above 0x7F pass through unchanged.
+class JsonListingWriterAdapter final : public cad::ports::ListingWriterPort {
+public:
+  enum class Layout { Lines, Array };
+
+  JsonListingWriterAdapter(std::ostream &out, Layout layout);
+
+  void addRecord(const cad::ports::ListingRecord &record) override;
+  void finish() override;
+
+private:
+  static constexpr std::size_t kBufferBytes = 1 << 20;
+
+  void append(std::string_view bytes);
+  void appendString(std::string_view text);
+  void flush();
+
+  std::ostream &out_;
+  Layout layout_;
+  std::unique_ptr<char[]> buffer_;
+  std::size_t size_ = 0;
+  bool empty_ = true;
+};
+
+} // namespace cad::adapters::json
@@ -1,16 +1,31 @@
 #pragma once
 
 #include <iostream>
+#include <mutex>
 #include <string>
 
 #include "cpp/cad/core/ports/LoggerPort.hpp"
 
 namespace cad::adapters::fake {
 
-class FakeLoggerAdapter : public cad::ports::LoggerPort {
+class FakeLoggerAdapter final : public cad::ports::LoggerPort {
 public:
+  explicit FakeLoggerAdapter(std::ostream &out = std::cout) : out_(out) {}
+
   void log(cad::ports::LogLevel level, const std::string &message) override {
-    std::cout << message << "\n";
+    std::string line = message + "\n";
+    // One write per message, serialized so concurrent lines do not interleave.
+    std::lock_guard<std::mutex> lock(outputMutex());
+    out_.write(line.data(), static_cast<std::streamsize>(line.size()));
+  }
+
+private:
+  std::ostream &out_;
+
+  // Shared by all instances: they mostly write to the same std::cout.
+  static std::mutex &outputMutex() {
+    static std::mutex mutex;
+    return mutex;
   }
 };
 
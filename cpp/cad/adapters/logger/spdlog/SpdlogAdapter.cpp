@@ -3,15 +3,24 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/common.h>
 
+#include <mutex>
+
 namespace cad::adapters::spdlog {
 
 SpdlogAdapter::SpdlogAdapter(std::shared_ptr<::spdlog::logger> logger)
     : logger_(logger) {
   if (!logger_) {
-    // Create a default console logger if none provided
-    logger_ = ::spdlog::stdout_color_mt("cad_logger");
-    logger_->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
-    // Colors are automatically enabled with stdout_color_mt
+    // Create a default console logger if none provided; later instances
+    // share it (the _mt sink is thread-safe). The mutex makes the
+    // check-then-create race-free across threads.
+    static std::mutex creation;
+    std::lock_guard<std::mutex> lock(creation);
+    logger_ = ::spdlog::get("cad_logger");
+    if (!logger_) {
+      logger_ = ::spdlog::stdout_color_mt("cad_logger");
+      logger_->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
+      // Colors are automatically enabled with stdout_color_mt
+    }
   }
 }
 
@@ -7,7 +7,7 @@
 
 namespace cad::adapters::spdlog {
 
-class SpdlogAdapter : public cad::ports::LoggerPort {
+class SpdlogAdapter final : public cad::ports::LoggerPort {
 public:
   explicit SpdlogAdapter(std::shared_ptr<::spdlog::logger> logger = nullptr);
   ~SpdlogAdapter() override = default;
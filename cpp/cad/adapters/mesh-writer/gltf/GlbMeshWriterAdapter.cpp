@@ -0,0 +1,188 @@
+#include "cpp/cad/adapters/mesh-writer/gltf/GlbMeshWriterAdapter.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include <nlohmann/json.hpp>
+
+namespace cad::adapters::gltf {
+
+namespace {
+
+constexpr std::uint32_t kGlbMagic = 0x46546C67; // "glTF"
+constexpr std::uint32_t kGlbVersion = 2;
+constexpr std::uint32_t kJsonChunk = 0x4E4F534A; // "JSON"
+constexpr std::uint32_t kBinChunk = 0x004E4942;  // "BIN\0"
+constexpr int kFloat = 5126;
+constexpr int kUnsignedInt = 5125;
+constexpr int kArrayBuffer = 34962;
+constexpr int kElementArrayBuffer = 34963;
+constexpr std::size_t kCopyChunk = 1 << 20;
+
+// GLB is little-endian throughout, as are the platforms we build for
+void writeU32(std::ostream &out, std::uint32_t value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// glTF matrices are column-major 4x4
+nlohmann::json toMatrix(const cad::domain::Placement &placement) {
+  const auto &m = placement.linear;
+  const auto &t = placement.translation;
+  return nlohmann::json::array({m[0], m[3], m[6], 0.0, m[1], m[4], m[7], 0.0,
+                                m[2], m[5], m[8], 0.0, t[0], t[1], t[2], 1.0});
+}
+
+} // namespace
+
+GlbMeshWriterAdapter::GlbMeshWriterAdapter(std::ostream &out)
+    : out_(out), spill_(std::tmpfile(), &std::fclose) {
+  if (!spill_) {
+    throw std::runtime_error("glb: cannot create temporary file");
+  }
+}
+
+void GlbMeshWriterAdapter::spill(const void *data, std::size_t bytes) {
+  if (bytes != 0 && std::fwrite(data, 1, bytes, spill_.get()) != bytes) {
+    throw std::runtime_error("glb: failed to write temporary mesh data");
+  }
+  binaryLength_ += bytes;
+}
+
+void GlbMeshWriterAdapter::addMesh(const std::string &prototypeId,
+                                   const cad::domain::Mesh &mesh) {
+  if (finished_) {
+    throw std::logic_error("glb: mesh added after finish()");
+  }
+  MeshRecord record{prototypeId, binaryLength_, 0, mesh.vertexCount(),
+                    mesh.indices.size(), {}, {}};
+  record.min.fill(std::numeric_limits<float>::max());
+  record.max.fill(std::numeric_limits<float>::lowest());
+  for (std::size_t i = 0; i < mesh.positions.size(); ++i) {
+    record.min[i % 3] = std::min(record.min[i % 3], mesh.positions[i]);
+    record.max[i % 3] = std::max(record.max[i % 3], mesh.positions[i]);
+  }
+  // Both element types are 4 bytes wide, so views stay 4-byte aligned
+  spill(mesh.positions.data(), mesh.positions.size() * sizeof(float));
+  record.indicesOffset = binaryLength_;
+  spill(mesh.indices.data(), mesh.indices.size() * sizeof(std::uint32_t));
+
+  meshByPrototype_[prototypeId] = meshes_.size();
+  meshes_.push_back(std::move(record));
+}
+
+void GlbMeshWriterAdapter::addInstance(const std::string &prototypeId,
+                                       const std::string &name,
+                                       const cad::domain::Placement &placement) {
+  if (finished_) {
+    throw std::logic_error("glb: instance added after finish()");
+  }
+  auto it = meshByPrototype_.find(prototypeId);
+  if (it == meshByPrototype_.end()) {
+    throw std::invalid_argument("glb: no mesh for prototype " + prototypeId);
+  }
+  instances_.push_back({it->second, name, placement});
+}
+
+void GlbMeshWriterAdapter::finish() {
+  if (finished_) {
+    return;
+  }
+  finished_ = true;
+
+  nlohmann::json document;
+  document["asset"] = {{"version", "2.0"}, {"generator", "cad_cli"}};
+  auto &meshes = document["meshes"] = nlohmann::json::array();
+  auto &accessors = document["accessors"] = nlohmann::json::array();
+  auto &views = document["bufferViews"] = nlohmann::json::array();
+  for (const auto &mesh : meshes_) {
+    std::size_t view = views.size();
+    views.push_back({{"buffer", 0},
+                     {"byteOffset", mesh.positionsOffset},
+                     {"byteLength", mesh.vertexCount * 3 * sizeof(float)},
+                     {"target", kArrayBuffer}});
+    views.push_back({{"buffer", 0},
+                     {"byteOffset", mesh.indicesOffset},
+                     {"byteLength", mesh.indexCount * sizeof(std::uint32_t)},
+                     {"target", kElementArrayBuffer}});
+    std::size_t accessor = accessors.size();
+    accessors.push_back({{"bufferView", view},
+                         {"componentType", kFloat},
+                         {"count", mesh.vertexCount},
+                         {"type", "VEC3"},
+                         {"min", mesh.min},
+                         {"max", mesh.max}});
+    accessors.push_back({{"bufferView", view + 1},
+                         {"componentType", kUnsignedInt},
+                         {"count", mesh.indexCount},
+                         {"type", "SCALAR"}});
+    meshes.push_back(
+        {{"name", mesh.name},
+         {"primitives",
+          {{{"attributes", {{"POSITION", accessor}}}, {"indices", accessor + 1}}}}});
+  }
+  auto &nodes = document["nodes"] = nlohmann::json::array();
+  nlohmann::json roots = nlohmann::json::array();
+  for (std::size_t i = 0; i < instances_.size(); ++i) {
+    const auto &instance = instances_[i];
+    nlohmann::json node = {{"mesh", instance.mesh}, {"name", instance.name}};
+    if (!instance.placement.isIdentity()) {
+      node["matrix"] = toMatrix(instance.placement);
+    }
+    nodes.push_back(std::move(node));
+    roots.push_back(i);
+  }
+  // glTF forbids empty top-level arrays and scenes with an empty node list;
+  // an export without geometry is a valid file with one empty scene
+  nlohmann::json scene = nlohmann::json::object();
+  if (!roots.empty()) {
+    scene["nodes"] = std::move(roots);
+  }
+  document["scenes"] = nlohmann::json::array({std::move(scene)});
+  document["scene"] = 0;
+  if (binaryLength_ != 0) {
+    document["buffers"] = {{{"byteLength", binaryLength_}}};
+  }
+  for (const char *key : {"meshes", "accessors", "bufferViews", "nodes"}) {
+    if (document[key].empty()) {
+      document.erase(key);
+    }
+  }
+
+  std::string json = document.dump();
+  json.resize((json.size() + 3) / 4 * 4, ' ');
+  std::uint64_t total = 12 + 8 + json.size() + (binaryLength_ ? 8 + binaryLength_ : 0);
+  if (total > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::runtime_error("glb: output exceeds 4 GiB");
+  }
+
+  writeU32(out_, kGlbMagic);
+  writeU32(out_, kGlbVersion);
+  writeU32(out_, static_cast<std::uint32_t>(total));
+  writeU32(out_, static_cast<std::uint32_t>(json.size()));
+  writeU32(out_, kJsonChunk);
+  out_.write(json.data(), static_cast<std::streamsize>(json.size()));
+  if (binaryLength_ != 0) {
+    writeU32(out_, static_cast<std::uint32_t>(binaryLength_));
+    writeU32(out_, kBinChunk);
+    std::rewind(spill_.get());
+    std::vector<char> buffer(kCopyChunk);
+    std::uint64_t copied = 0;
+    std::size_t n;
+    while ((n = std::fread(buffer.data(), 1, buffer.size(), spill_.get())) > 0) {
+      out_.write(buffer.data(), static_cast<std::streamsize>(n));
+      copied += n;
+    }
+    // The header already states the full length; a short copy is an error,
+    // not a smaller file
+    if (std::ferror(spill_.get()) || copied != binaryLength_) {
+      throw std::runtime_error("glb: failed to read temporary mesh data");
+    }
+  }
+  out_.flush();
+  if (!out_) {
+    throw std::runtime_error("glb: failed to write output");
+  }
+}
+
+} // namespace cad::adapters::gltf
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cpp/cad/core/ports/MeshWriterPort.hpp"
+
+namespace cad::adapters::gltf {
+
+// Writes binary glTF 2.0 (.glb): one glTF mesh per prototype and one node per
+// instance referencing it. GLB puts the JSON chunk, which holds every offset,
+// before the binary chunk, so mesh data is spilled to an anonymous temporary
+// file as it arrives and copied to `out` by finish(). Memory holds only
+// per-mesh and per-instance metadata, never the geometry of more than one
+// mesh.
+class GlbMeshWriterAdapter final : public cad::ports::MeshWriterPort {
+public:
+  explicit GlbMeshWriterAdapter(std::ostream &out);
+
+  void addMesh(const std::string &prototypeId,
+               const cad::domain::Mesh &mesh) override;
+  void addInstance(const std::string &prototypeId, const std::string &name,
+                   const cad::domain::Placement &placement) override;
+  void finish() override;
+
+private:
+  struct MeshRecord {
+    std::string name;
+    std::uint64_t positionsOffset;
+    std::uint64_t indicesOffset;
+    std::size_t vertexCount;
+    std::size_t indexCount;
+    std::array<float, 3> min;
+    std::array<float, 3> max;
+  };
+  struct InstanceRecord {
+    std::size_t mesh;
+    std::string name;
+    cad::domain::Placement placement;
+  };
+
+  void spill(const void *data, std::size_t bytes);
+
+  std::ostream &out_;
+  std::unique_ptr<std::FILE, int (*)(std::FILE *)> spill_;
+  std::uint64_t binaryLength_ = 0;
+  std::vector<MeshRecord> meshes_;
+  std::unordered_map<std::string, std::size_t> meshByPrototype_;
+  std::vector<InstanceRecord> instances_;
+  bool finished_ = false;
+};
+
+} // namespace cad::adapters::gltf
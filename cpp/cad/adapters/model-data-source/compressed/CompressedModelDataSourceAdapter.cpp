@@ -0,0 +1,12 @@
+#include "cpp/cad/adapters/model-data-source/compressed/CompressedModelDataSourceAdapter.hpp"
+
+#include "cpp/cad/adapters/model-data-source/compressed/DecompressingStream.hpp"
+
+namespace cad::adapters::compressed {
+
+std::unique_ptr<std::istream>
+CompressedModelDataSourceAdapter::open(const std::string &locator) {
+  return decompressIfNeeded(inner_.open(locator));
+}
+
+} // namespace cad::adapters::compressed
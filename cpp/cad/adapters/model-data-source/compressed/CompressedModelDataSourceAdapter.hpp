@@ -0,0 +1,29 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
+
+namespace cad::adapters::compressed {
+
+// Decorator adding transparent gzip/zstd decoding to any data source, e.g.
+// the in-memory one. Detection is by magic bytes only.
+class CompressedModelDataSourceAdapter final
+    : public cad::ports::ModelDataSourcePort {
+public:
+  explicit CompressedModelDataSourceAdapter(cad::ports::ModelDataSourcePort &inner)
+      : inner_(inner) {}
+
+  std::unique_ptr<std::istream> open(const std::string &locator) override;
+  void prefetch(const std::vector<std::string> &locators) override {
+    inner_.prefetch(locators);
+  }
+
+private:
+  cad::ports::ModelDataSourcePort &inner_;
+};
+
+} // namespace cad::adapters::compressed
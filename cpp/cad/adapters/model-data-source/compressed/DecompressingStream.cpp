@@ -0,0 +1,220 @@
+#include "cpp/cad/adapters/model-data-source/compressed/DecompressingStream.hpp"
+
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <zlib.h>
+#ifdef CAD_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "cpp/cad/adapters/common/PrefixReplayStreamBuf.hpp"
+
+namespace cad::adapters::compressed {
+
+namespace {
+
+constexpr std::size_t kInputChunk = 64 * 1024;
+constexpr std::size_t kOutputChunk = 256 * 1024;
+
+// Pulls compressed bytes from `source` and exposes the decoded bytes through
+// the get area. Subclasses implement one decoding step. Errors are thrown
+// from underflow(), which std::istream turns into badbit.
+class DecompressingStreamBuf : public std::streambuf {
+public:
+  explicit DecompressingStreamBuf(std::unique_ptr<std::istream> source)
+      : source_(std::move(source)), input_(kInputChunk), output_(kOutputChunk) {}
+
+protected:
+  int_type underflow() override {
+    if (gptr() < egptr()) {
+      return traits_type::to_int_type(*gptr());
+    }
+    while (true) {
+      if (inputBegin_ == inputEnd_ && !sourceDone_) {
+        std::streamsize n = source_->rdbuf()->sgetn(
+            input_.data(), static_cast<std::streamsize>(input_.size()));
+        inputBegin_ = 0;
+        inputEnd_ = n > 0 ? static_cast<std::size_t>(n) : 0;
+        sourceDone_ = inputEnd_ == 0;
+      }
+      if (sourceDone_ && inputBegin_ == inputEnd_ && !hasBufferedOutput()) {
+        if (!atFrameBoundary()) {
+          throw std::runtime_error("truncated compressed stream");
+        }
+        return traits_type::eof();
+      }
+
+      std::size_t produced = decode();
+      if (produced > 0) {
+        setg(output_.data(), output_.data(), output_.data() + produced);
+        return traits_type::to_int_type(*gptr());
+      }
+    }
+  }
+
+  // Decodes from input_[inputBegin_, inputEnd_) into output_, advancing
+  // inputBegin_, and returns the number of bytes written.
+  virtual std::size_t decode() = 0;
+  // Whether the decoder still holds output it has not flushed yet.
+  virtual bool hasBufferedOutput() const { return false; }
+  // Whether the input ended cleanly between frames/members.
+  virtual bool atFrameBoundary() const = 0;
+
+  std::unique_ptr<std::istream> source_;
+  std::vector<char> input_;
+  std::vector<char> output_;
+  std::size_t inputBegin_ = 0;
+  std::size_t inputEnd_ = 0;
+  bool sourceDone_ = false;
+};
+
+// gzip, including multi-member files as produced by pigz/bgzip and `cat`ed
+// archives: after each member the inflater is reset and decoding continues.
+class GzipStreamBuf final : public DecompressingStreamBuf {
+public:
+  explicit GzipStreamBuf(std::unique_ptr<std::istream> source)
+      : DecompressingStreamBuf(std::move(source)) {
+    // 15 window bits + 16 selects the gzip wrapper.
+    if (inflateInit2(&zs_, 15 + 16) != Z_OK) {
+      throw std::runtime_error("inflateInit2 failed");
+    }
+  }
+  ~GzipStreamBuf() override { inflateEnd(&zs_); }
+
+protected:
+  std::size_t decode() override {
+    if (memberDone_) {
+      if (inputBegin_ == inputEnd_) {
+        return 0;
+      }
+      inflateReset(&zs_);
+      memberDone_ = false;
+    }
+
+    zs_.next_in = reinterpret_cast<Bytef *>(input_.data() + inputBegin_);
+    zs_.avail_in = static_cast<uInt>(inputEnd_ - inputBegin_);
+    zs_.next_out = reinterpret_cast<Bytef *>(output_.data());
+    zs_.avail_out = static_cast<uInt>(output_.size());
+
+    int rc = inflate(&zs_, Z_NO_FLUSH);
+    inputBegin_ = inputEnd_ - zs_.avail_in;
+    if (rc == Z_STREAM_END) {
+      memberDone_ = true;
+    } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+      throw std::runtime_error(std::string("gzip: ") +
+                               (zs_.msg ? zs_.msg : "corrupt data"));
+    }
+    return output_.size() - zs_.avail_out;
+  }
+
+  bool hasBufferedOutput() const override {
+    // inflate() stops early when the output buffer is full; more may be
+    // pending even without new input.
+    return !memberDone_ && zs_.avail_out == 0;
+  }
+
+  bool atFrameBoundary() const override { return memberDone_; }
+
+private:
+  z_stream zs_{};
+  bool memberDone_ = false;
+};
+
+#ifdef CAD_HAVE_ZSTD
+class ZstdStreamBuf final : public DecompressingStreamBuf {
+public:
+  explicit ZstdStreamBuf(std::unique_ptr<std::istream> source)
+      : DecompressingStreamBuf(std::move(source)), dstream_(ZSTD_createDStream()) {
+    if (!dstream_) {
+      throw std::runtime_error("ZSTD_createDStream failed");
+    }
+    ZSTD_initDStream(dstream_);
+  }
+  ~ZstdStreamBuf() override { ZSTD_freeDStream(dstream_); }
+
+protected:
+  std::size_t decode() override {
+    ZSTD_inBuffer in{input_.data(), inputEnd_, inputBegin_};
+    ZSTD_outBuffer out{output_.data(), output_.size(), 0};
+    std::size_t rc = ZSTD_decompressStream(dstream_, &out, &in);
+    if (ZSTD_isError(rc)) {
+      throw std::runtime_error(std::string("zstd: ") + ZSTD_getErrorName(rc));
+    }
+    inputBegin_ = in.pos;
+    // 0 means a frame was completely decoded and flushed.
+    frameDone_ = rc == 0;
+    outputFull_ = out.pos == out.size;
+    return out.pos;
+  }
+
+  bool hasBufferedOutput() const override { return outputFull_; }
+
+  bool atFrameBoundary() const override { return frameDone_; }
+
+private:
+  ZSTD_DStream *dstream_;
+  bool frameDone_ = false;
+  bool outputFull_ = false;
+};
+#endif
+
+class DecompressingIStream final : public std::istream {
+public:
+  explicit DecompressingIStream(std::unique_ptr<std::streambuf> buffer)
+      : std::istream(buffer.get()), buffer_(std::move(buffer)) {}
+
+private:
+  std::unique_ptr<std::streambuf> buffer_;
+};
+
+} // namespace
+
+Compression detectCompression(std::string_view prefix) {
+  auto starts = [&](std::string_view magic) {
+    return prefix.substr(0, magic.size()) == magic;
+  };
+  if (starts("\x1f\x8b")) {
+    return Compression::Gzip;
+  }
+  if (starts("\x28\xb5\x2f\xfd")) {
+    return Compression::Zstd;
+  }
+  return Compression::None;
+}
+
+bool isSupported(Compression compression) {
+#ifdef CAD_HAVE_ZSTD
+  return true;
+#else
+  return compression != Compression::Zstd;
+#endif
+}
+
+std::unique_ptr<std::istream>
+decompressIfNeeded(std::unique_ptr<std::istream> stream) {
+  if (!stream) {
+    return stream;
+  }
+  auto peeked = common::peekPrefix(std::move(stream), 4);
+  switch (detectCompression(peeked.prefix)) {
+  case Compression::None:
+    return std::move(peeked.stream);
+  case Compression::Gzip:
+    return std::make_unique<DecompressingIStream>(
+        std::make_unique<GzipStreamBuf>(std::move(peeked.stream)));
+  case Compression::Zstd:
+#ifdef CAD_HAVE_ZSTD
+    return std::make_unique<DecompressingIStream>(
+        std::make_unique<ZstdStreamBuf>(std::move(peeked.stream)));
+#else
+    return nullptr;
+#endif
+  }
+  return nullptr;
+}
+
+} // namespace cad::adapters::compressed
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <string_view>
+
+namespace cad::adapters::compressed {
+
+enum class Compression { None, Gzip, Zstd };
+
+// Identifies a compressed container from its first bytes (gzip 1f 8b, zstd
+// frame 28 b5 2f fd). File names are never consulted.
+Compression detectCompression(std::string_view prefix);
+
+// True when this build can decode `compression` (zstd support is optional).
+bool isSupported(Compression compression);
+
+// Returns `stream` unchanged when it is not compressed, otherwise a stream
+// that inflates it incrementally as it is read. Returns null for a
+// compressed format this build cannot decode. Corrupt or truncated input
+// throws std::runtime_error from the stream buffer; formatted std::istream
+// reads turn that into badbit.
+std::unique_ptr<std::istream>
+decompressIfNeeded(std::unique_ptr<std::istream> stream);
+
+} // namespace cad::adapters::compressed
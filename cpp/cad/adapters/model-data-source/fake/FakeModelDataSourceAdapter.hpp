@@ -3,6 +3,8 @@
 #include <istream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
 
@@ -10,15 +12,17 @@
 
 namespace cad::adapters::fake {
 
-class FakeModelDataSourceAdapter : public cad::ports::ModelDataSourcePort {
+class FakeModelDataSourceAdapter final : public cad::ports::ModelDataSourcePort {
 public:
   // Registers a virtual locator with content string (simulates a file or remote
   // resource)
   void registerContent(const std::string &locator, const std::string &content) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
     store_[locator] = content;
   }
 
   std::unique_ptr<std::istream> open(const std::string &locator) override {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
     auto it = store_.find(locator);
     if (it == store_.end()) {
       return std::unique_ptr<std::istream>();
@@ -27,6 +31,7 @@ public:
   }
 
 private:
+  mutable std::shared_mutex mutex_;
   std::map<std::string, std::string> store_;
 };
 
@@ -2,6 +2,9 @@
 
 #include <fstream>
 
+#include "cpp/cad/adapters/common/ReadAhead.hpp"
+#include "cpp/cad/adapters/model-data-source/compressed/DecompressingStream.hpp"
+
 namespace cad::adapters::file {
 
 std::unique_ptr<std::istream> FileModelDataSourceAdapter::open(const std::string &locator) {
@@ -11,7 +14,14 @@ std::unique_ptr<std::istream> FileModelDataSourceAdapter::open(const std::string
     return nullptr;
   }
   
-  return std::move(fileStream);
+  // gzip/zstd files are decoded on the fly, detected by their magic bytes
+  return cad::adapters::compressed::decompressIfNeeded(std::move(fileStream));
+}
+
+void FileModelDataSourceAdapter::prefetch(const std::vector<std::string> &locators) {
+  for (const auto &locator : locators) {
+    cad::adapters::common::adviseWillNeed(locator);
+  }
 }
 
 } // namespace cad::adapters::file
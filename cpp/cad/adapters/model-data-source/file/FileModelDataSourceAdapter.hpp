@@ -2,14 +2,18 @@
 
 #include <istream>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
 
 namespace cad::adapters::file {
 
-class FileModelDataSourceAdapter : public cad::ports::ModelDataSourcePort {
+class FileModelDataSourceAdapter final : public cad::ports::ModelDataSourcePort {
 public:
   std::unique_ptr<std::istream> open(const std::string &locator) override;
+  // Starts kernel read-ahead of every file (posix_fadvise)
+  void prefetch(const std::vector<std::string> &locators) override;
 };
 
 } // namespace cad::adapters::file
@@ -1,28 +1,50 @@
 #include "cpp/cad/adapters/model-data-source/json/JsonModelDataSourceAdapter.hpp"
 
 #include <filesystem>
+#include <fstream>
+
+#include "cpp/cad/adapters/common/PrefixReplayStreamBuf.hpp"
+#include "cpp/cad/adapters/common/ReadAhead.hpp"
+#include "cpp/cad/adapters/model-data-source/compressed/DecompressingStream.hpp"
 
 namespace cad::adapters::json {
 
 std::unique_ptr<std::istream> JsonModelDataSourceAdapter::open(const std::string &locator) {
   // Check if the locator is a file path ending with .json
-  if (locator.size() < 5 || locator.substr(locator.size() - 5) != ".json") {
-    return nullptr;
-  }
+  bool jsonSuffix = locator.size() >= 5 && locator.substr(locator.size() - 5) == ".json";
   
   // Check if file exists
   if (!std::filesystem::exists(locator)) {
     return nullptr;
   }
   
-  // Create file stream
-  file_stream_ = std::make_unique<std::ifstream>(locator);
-  if (!file_stream_->is_open() || !file_stream_->good()) {
+  // Create file stream; it is owned by the returned stream, so concurrent
+  // opens share nothing
+  auto fileStream = std::make_unique<std::ifstream>(locator, std::ios::binary);
+  if (!fileStream->is_open() || !fileStream->good()) {
+    return nullptr;
+  }
+  
+  // Compressed exports (e.g. model.json.gz) are recognised by their magic
+  // bytes rather than the suffix and decoded while reading
+  auto peeked = cad::adapters::common::peekPrefix(
+      std::unique_ptr<std::istream>(std::move(fileStream)), 4);
+  if (cad::adapters::compressed::detectCompression(peeked.prefix) !=
+      cad::adapters::compressed::Compression::None) {
+    return cad::adapters::compressed::decompressIfNeeded(std::move(peeked.stream));
+  }
+  if (!jsonSuffix) {
     return nullptr;
   }
   
   // Return the stream (transfers ownership to caller)
-  return std::unique_ptr<std::istream>(file_stream_.release());
+  return std::move(peeked.stream);
+}
+
+void JsonModelDataSourceAdapter::prefetch(const std::vector<std::string> &locators) {
+  for (const auto &locator : locators) {
+    cad::adapters::common::adviseWillNeed(locator);
+  }
 }
 
 } // namespace cad::adapters::json
@@ -1,20 +1,18 @@
 #pragma once
 
-#include <fstream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
 
 namespace cad::adapters::json {
 
-class JsonModelDataSourceAdapter : public cad::ports::ModelDataSourcePort {
+class JsonModelDataSourceAdapter final : public cad::ports::ModelDataSourcePort {
 public:
   std::unique_ptr<std::istream> open(const std::string &locator) override;
-
-private:
-  // Store file streams to keep them alive
-  std::unique_ptr<std::ifstream> file_stream_;
+  // Starts kernel read-ahead of every file (posix_fadvise)
+  void prefetch(const std::vector<std::string> &locators) override;
 };
 
 } // namespace cad::adapters::json
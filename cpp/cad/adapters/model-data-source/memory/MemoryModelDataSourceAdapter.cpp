@@ -0,0 +1,51 @@
+#include "cpp/cad/adapters/model-data-source/memory/MemoryModelDataSourceAdapter.hpp"
+
+#include <mutex>
+
+#include "cpp/cad/adapters/model-data-source/memory/SpanStreamBuf.hpp"
+
+namespace cad::adapters::memory {
+
+void MemoryModelDataSourceAdapter::registerView(const std::string &locator,
+                                                std::string_view bytes) {
+  registerBuffer(locator, nullptr, bytes);
+}
+
+void MemoryModelDataSourceAdapter::registerBuffer(
+    const std::string &locator, std::shared_ptr<const void> owner,
+    std::string_view bytes) {
+  std::unique_lock lock(mutex_);
+  buffers_[locator] = BufferView{std::move(owner), bytes};
+}
+
+void MemoryModelDataSourceAdapter::registerBuffer(
+    const std::string &locator, std::shared_ptr<const std::string> buffer) {
+  std::string_view bytes = buffer ? std::string_view(*buffer) : std::string_view();
+  registerBuffer(locator, std::move(buffer), bytes);
+}
+
+bool MemoryModelDataSourceAdapter::unregister(const std::string &locator) {
+  std::unique_lock lock(mutex_);
+  return buffers_.erase(locator) > 0;
+}
+
+std::optional<BufferView>
+MemoryModelDataSourceAdapter::view(const std::string &locator) const {
+  std::shared_lock lock(mutex_);
+  auto it = buffers_.find(locator);
+  if (it == buffers_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+std::unique_ptr<std::istream>
+MemoryModelDataSourceAdapter::open(const std::string &locator) {
+  std::optional<BufferView> buffer = view(locator);
+  if (!buffer) {
+    return nullptr;
+  }
+  return std::make_unique<SpanIStream>(buffer->bytes, std::move(buffer->owner));
+}
+
+} // namespace cad::adapters::memory
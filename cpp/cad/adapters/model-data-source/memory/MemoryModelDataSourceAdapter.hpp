@@ -0,0 +1,55 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
+
+namespace cad::adapters::memory {
+
+// Bytes registered under a locator, plus whatever keeps them alive. `owner`
+// is empty for caller-owned views.
+struct BufferView {
+  std::shared_ptr<const void> owner;
+  std::string_view bytes;
+};
+
+// Serves in-memory buffers (e.g. uploads already held by an embedding
+// service) without copying them: open() returns a stream reading directly
+// from the registered bytes, and view() exposes them as a contiguous span.
+//
+// Lookups are hashed. open() and view() take a shared lock and may run
+// concurrently from any number of threads; registration takes an exclusive
+// lock.
+class MemoryModelDataSourceAdapter final
+    : public cad::ports::ModelDataSourcePort {
+public:
+  // Caller-owned bytes: they must stay valid and unchanged until the locator
+  // is unregistered and every stream opened from it has been destroyed.
+  void registerView(const std::string &locator, std::string_view bytes);
+
+  // Ref-counted bytes: `owner` keeps `bytes` alive, and each opened stream or
+  // returned view holds a reference, so unregistering never invalidates a
+  // reader that is still running.
+  void registerBuffer(const std::string &locator,
+                      std::shared_ptr<const void> owner, std::string_view bytes);
+  void registerBuffer(const std::string &locator,
+                      std::shared_ptr<const std::string> buffer);
+
+  bool unregister(const std::string &locator);
+
+  std::optional<BufferView> view(const std::string &locator) const;
+
+  std::unique_ptr<std::istream> open(const std::string &locator) override;
+
+private:
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, BufferView> buffers_;
+};
+
+} // namespace cad::adapters::memory
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string_view>
+
+namespace cad::adapters::memory {
+
+// Read-only streambuf over bytes owned elsewhere. Nothing is copied: the get
+// area points straight at the caller's buffer. Seeking is supported so that
+// readers can rewind after probing.
+class SpanStreamBuf : public std::streambuf {
+public:
+  explicit SpanStreamBuf(std::string_view bytes) {
+    // The get area is never written through; std::streambuf only wants char*.
+    char *begin = const_cast<char *>(bytes.data());
+    setg(begin, begin, begin + bytes.size());
+  }
+
+  // The whole underlying buffer, independent of the current read position.
+  std::string_view view() const {
+    return {eback(), static_cast<std::size_t>(egptr() - eback())};
+  }
+
+protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override {
+    if (!(which & std::ios_base::in)) {
+      return pos_type(off_type(-1));
+    }
+    off_type base = dir == std::ios_base::beg   ? 0
+                    : dir == std::ios_base::cur ? gptr() - eback()
+                                                : egptr() - eback();
+    off_type target = base + off;
+    if (target < 0 || target > egptr() - eback()) {
+      return pos_type(off_type(-1));
+    }
+    setg(eback(), eback() + target, egptr());
+    return pos_type(target);
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+
+  std::streamsize showmanyc() override {
+    std::streamsize left = egptr() - gptr();
+    return left > 0 ? left : -1;
+  }
+};
+
+// istream over a SpanStreamBuf that optionally keeps the buffer's owner alive
+// for as long as the stream exists.
+class SpanIStream : public std::istream {
+public:
+  explicit SpanIStream(std::string_view bytes,
+                       std::shared_ptr<const void> owner = nullptr)
+      : std::istream(nullptr), owner_(std::move(owner)), buffer_(bytes) {
+    rdbuf(&buffer_);
+  }
+
+  std::string_view view() const { return buffer_.view(); }
+
+private:
+  std::shared_ptr<const void> owner_;
+  SpanStreamBuf buffer_;
+};
+
+} // namespace cad::adapters::memory
@@ -0,0 +1,251 @@
+#include "cpp/cad/adapters/model-data-source/prefetch/PrefetchingModelDataSourceAdapter.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cpp/cad/adapters/model-data-source/memory/SpanStreamBuf.hpp"
+
+namespace cad::adapters::prefetch {
+
+namespace {
+
+// Read size for streams of unknown length
+constexpr std::size_t kChunkBytes = std::size_t(1) << 20;
+
+} // namespace
+
+struct PrefetchingModelDataSourceAdapter::State {
+  // The bytes of one locator. Once counted against the budget it holds the
+  // state and gives the bytes back when the last reference goes.
+  struct Buffer {
+    std::string bytes;
+    std::size_t charged = 0;
+    std::shared_ptr<State> state;
+
+    ~Buffer() {
+      if (state) {
+        state->release(charged);
+      }
+    }
+  };
+
+  enum class Status { Queued, Reading, Ready, Failed };
+
+  struct Entry {
+    Status status = Status::Queued;
+    std::uint64_t hint = 0; // position in hint order
+    std::shared_ptr<Buffer> buffer;
+  };
+
+  std::mutex mutex;
+  std::condition_variable changed;
+  const std::size_t budget;
+  std::size_t held = 0;
+  Stats stats;
+  bool stopping = false;
+  std::deque<std::string> queue;                  // hinted and not yet started
+  std::unordered_map<std::string, Entry> entries; // hinted and not yet opened
+  std::uint64_t hinted = 0;                       // hints given so far
+  std::uint64_t passed = 0; // hints before this one were passed over by open()
+
+  explicit State(std::size_t budgetBytes) : budget(budgetBytes) {}
+
+  void release(std::size_t bytes) {
+    {
+      std::lock_guard lock(mutex);
+      held -= bytes;
+    }
+    changed.notify_all();
+  }
+
+  // Drops the buffers of passed-over hints, oldest first, until the budget
+  // has room again; whether it has. Called with the lock held.
+  bool dropPassedOver() {
+    std::vector<std::unordered_map<std::string, Entry>::iterator> stale;
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+      if (it->second.status == Status::Ready && it->second.hint < passed) {
+        stale.push_back(it);
+      }
+    }
+    std::sort(stale.begin(), stale.end(),
+              [](const auto &a, const auto &b) { return a->second.hint < b->second.hint; });
+    for (auto it : stale) {
+      if (held < budget) {
+        break;
+      }
+      // Given back here rather than by the buffer, as the lock is held
+      Buffer &buffer = *it->second.buffer;
+      held -= buffer.charged;
+      buffer.state.reset();
+      entries.erase(it);
+      ++stats.dropped;
+    }
+    return held < budget;
+  }
+};
+
+PrefetchingModelDataSourceAdapter::PrefetchingModelDataSourceAdapter(
+    cad::ports::ModelDataSourcePort &inner, std::size_t budgetBytes, std::size_t ioThreads)
+    : inner_(inner), state_(std::make_shared<State>(budgetBytes)) {
+  for (std::size_t i = 0; i < std::max<std::size_t>(ioThreads, 1); ++i) {
+    threads_.emplace_back([this] { readAhead(); });
+  }
+}
+
+PrefetchingModelDataSourceAdapter::~PrefetchingModelDataSourceAdapter() {
+  {
+    std::lock_guard lock(state_->mutex);
+    state_->stopping = true;
+    state_->queue.clear();
+  }
+  state_->changed.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+  // Unopened buffers give their bytes back as they go, which takes the lock
+  std::unordered_map<std::string, State::Entry> dropped;
+  {
+    std::lock_guard lock(state_->mutex);
+    dropped.swap(state_->entries);
+  }
+}
+
+void PrefetchingModelDataSourceAdapter::prefetch(const std::vector<std::string> &locators) {
+  {
+    std::lock_guard lock(state_->mutex);
+    for (const auto &locator : locators) {
+      if (auto [it, added] = state_->entries.try_emplace(locator); added) {
+        it->second.hint = state_->hinted++;
+        state_->queue.push_back(locator);
+      }
+    }
+  }
+  state_->changed.notify_all();
+}
+
+std::unique_ptr<std::istream>
+PrefetchingModelDataSourceAdapter::open(const std::string &locator) {
+  std::shared_ptr<State::Buffer> buffer;
+  {
+    std::unique_lock lock(state_->mutex);
+    auto &entries = state_->entries;
+    auto it = entries.find(locator);
+    if (it != entries.end()) {
+      // Hints before this one that are still unopened were skipped
+      state_->passed = std::max(state_->passed, it->second.hint);
+    }
+    if (it != entries.end() && it->second.status == State::Status::Queued) {
+      // Not started: the caller needs it now, so it skips the queue
+      auto &queue = state_->queue;
+      queue.erase(std::find(queue.begin(), queue.end(), locator));
+      entries.erase(it);
+    } else if (it != entries.end()) {
+      // Other hints may rehash the map while waiting, so look up again
+      state_->changed.wait(lock, [&] {
+        it = entries.find(locator);
+        return it == entries.end() || it->second.status != State::Status::Reading;
+      });
+      if (it != entries.end()) {
+        buffer = std::move(it->second.buffer);
+        entries.erase(it);
+      }
+    }
+    ++(buffer ? state_->stats.hits : state_->stats.misses);
+  }
+  // Passed-over buffers may now make room for read-ahead
+  state_->changed.notify_all();
+  if (!buffer) {
+    // Unhinted, not started, or failed: read the usual way, which also
+    // reports a failure the usual way
+    return inner_.open(locator);
+  }
+  const std::string_view bytes(buffer->bytes);
+  return std::make_unique<cad::adapters::memory::SpanIStream>(bytes, std::move(buffer));
+}
+
+void PrefetchingModelDataSourceAdapter::readAhead() {
+  State &state = *state_;
+  std::unique_lock lock(state.mutex);
+  for (;;) {
+    state.changed.wait(lock, [&state] {
+      return state.stopping ||
+             (!state.queue.empty() && (state.held < state.budget || state.dropPassedOver()));
+    });
+    if (state.stopping) {
+      return;
+    }
+    const std::string locator = std::move(state.queue.front());
+    state.queue.pop_front();
+    state.entries[locator].status = State::Status::Reading;
+    lock.unlock();
+
+    auto buffer = std::make_shared<State::Buffer>();
+    bool complete = false;
+    try {
+      auto stream = inner_.open(locator);
+      if (stream && *stream) {
+        std::streambuf *in = stream->rdbuf();
+        std::string &bytes = buffer->bytes;
+        // Seekable streams (plain files) are read in one go into a buffer
+        // of their size; others a chunk at a time
+        std::size_t expected = 0;
+        const auto end = in->pubseekoff(0, std::ios_base::end, std::ios_base::in);
+        if (end != std::streampos(-1)) {
+          if (in->pubseekoff(0, std::ios_base::beg, std::ios_base::in) != std::streampos(0)) {
+            throw std::runtime_error("cannot rewind " + locator);
+          }
+          expected = static_cast<std::size_t>(end);
+        }
+        std::size_t size = 0;
+        for (;;) {
+          // One spare byte, so that a sized read still ends short
+          const std::size_t want = size < expected ? expected - size + 1 : kChunkBytes;
+          bytes.resize(size + want);
+          const auto got = in->sgetn(bytes.data() + size, static_cast<std::streamsize>(want));
+          size += static_cast<std::size_t>(std::max<std::streamsize>(got, 0));
+          if (got < static_cast<std::streamsize>(want)) {
+            break;
+          }
+        }
+        bytes.resize(size);
+        complete = true;
+      }
+    } catch (...) {
+      // open() tries again through the inner source and reports the error
+    }
+
+    lock.lock();
+    State::Entry &entry = state.entries[locator];
+    if (complete) {
+      buffer->charged = buffer->bytes.capacity();
+      buffer->state = state_;
+      state.held += buffer->charged;
+      state.stats.peakBytes = std::max(state.stats.peakBytes, state.held);
+      entry.status = State::Status::Ready;
+      entry.buffer = std::move(buffer);
+    } else {
+      entry.status = State::Status::Failed;
+    }
+    state.changed.notify_all();
+  }
+}
+
+PrefetchingModelDataSourceAdapter::Stats PrefetchingModelDataSourceAdapter::stats() const {
+  std::lock_guard lock(state_->mutex);
+  return state_->stats;
+}
+
+std::size_t PrefetchingModelDataSourceAdapter::heldBytes() const {
+  std::lock_guard lock(state_->mutex);
+  return state_->held;
+}
+
+} // namespace cad::adapters::prefetch
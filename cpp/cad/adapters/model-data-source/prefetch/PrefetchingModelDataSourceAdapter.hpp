@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
+
+namespace cad::adapters::prefetch {
+
+// Decorator reading hinted locators (see ModelDataSourcePort::prefetch) into
+// memory on its own I/O threads, in hint order, while the caller parses
+// what it opened before. open() of a locator that has been read hands its
+// buffer over without copying; one still being read is waited for, and
+// anything else, hinted or not, is opened through the inner source as
+// usual. Batch time then tends to the larger of storage and parse time
+// rather than their sum.
+//
+// Read-ahead stops while the buffers held, read but not opened or opened
+// and still streaming, reach `budgetBytes`, and resumes as streams are
+// destroyed. Files being read count once complete, so the budget can be
+// passed by at most one file per I/O thread. A hinted locator the caller has
+// passed over, by opening one hinted after it, is taken to be skipped: when
+// the budget stops read-ahead, such buffers are dropped, oldest hint first,
+// and opening one later reads through the inner source. Other unopened
+// buffers are kept until the adapter is destroyed.
+//
+// Thread safety: as ModelDataSourcePort. `inner` must outlive the adapter;
+// returned streams may outlive both.
+class PrefetchingModelDataSourceAdapter final : public cad::ports::ModelDataSourcePort {
+public:
+  static constexpr std::size_t kDefaultBudgetBytes = std::size_t(256) << 20;
+  static constexpr std::size_t kDefaultIoThreads = 2;
+
+  struct Stats {
+    std::size_t hits = 0;      // opens served from a read-ahead buffer
+    std::size_t misses = 0;    // opens passed through to the inner source
+    std::size_t peakBytes = 0; // most buffer bytes held at once
+    std::size_t dropped = 0;   // buffers dropped unopened to make room
+  };
+
+  explicit PrefetchingModelDataSourceAdapter(cad::ports::ModelDataSourcePort &inner,
+                                             std::size_t budgetBytes = kDefaultBudgetBytes,
+                                             std::size_t ioThreads = kDefaultIoThreads);
+  // Waits for reads in progress; drops hinted locators not yet read.
+  ~PrefetchingModelDataSourceAdapter() override;
+
+  PrefetchingModelDataSourceAdapter(const PrefetchingModelDataSourceAdapter &) = delete;
+  PrefetchingModelDataSourceAdapter &operator=(const PrefetchingModelDataSourceAdapter &) = delete;
+
+  std::unique_ptr<std::istream> open(const std::string &locator) override;
+  void prefetch(const std::vector<std::string> &locators) override;
+
+  Stats stats() const;
+  // Buffer bytes held right now
+  std::size_t heldBytes() const;
+
+private:
+  struct State;
+
+  void readAhead();
+
+  cad::ports::ModelDataSourcePort &inner_;
+  // Shared with the buffers handed out, which give their bytes back to the
+  // budget when their stream is destroyed, possibly after the adapter
+  std::shared_ptr<State> state_;
+  std::vector<std::thread> threads_;
+};
+
+} // namespace cad::adapters::prefetch
@@ -0,0 +1,384 @@
+#include "cpp/cad/adapters/part-table-writer/arrow/ArrowPartTableWriterAdapter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+using cad::ports::PartTableBatch;
+using cad::ports::StringColumn;
+
+namespace cad::adapters::arrow {
+
+namespace {
+
+constexpr std::size_t kAlignment = 64; // of every body buffer, as Arrow recommends
+constexpr char kMagic[8] = {'A', 'R', 'R', 'O', 'W', '1', 0, 0};
+constexpr std::uint32_t kContinuation = 0xFFFFFFFF;
+
+// Values from the Arrow flatbuffers schemas (Schema.fbs, Message.fbs)
+constexpr std::int16_t kMetadataV5 = 4;
+constexpr std::uint8_t kHeaderSchema = 1;
+constexpr std::uint8_t kHeaderDictionaryBatch = 2;
+constexpr std::uint8_t kHeaderRecordBatch = 3;
+constexpr std::uint8_t kTypeInt = 2;
+constexpr std::uint8_t kTypeUtf8 = 5;
+constexpr std::int64_t kPathDictionary = 0;
+
+// Structs of the schemas, laid out as flatbuffers lays them out. Arrow files
+// are little-endian, as are the platforms we build for.
+struct FieldNode {
+  std::int64_t length;
+  std::int64_t nullCount;
+};
+struct Buffer {
+  std::int64_t offset;
+  std::int64_t length;
+};
+static_assert(sizeof(FieldNode) == 16 && sizeof(Buffer) == 16);
+
+std::size_t aligned(std::size_t size) { return (size + kAlignment - 1) / kAlignment * kAlignment; }
+
+// Just enough of a flatbuffers builder for Arrow metadata. As in the
+// reference builder, objects are written back to front, children before
+// their parents, and referred to by their distance from the end of the
+// buffer; the bytes are kept reversed until finish().
+class FlatBuilder {
+public:
+  using Ref = std::uint32_t;
+
+  Ref string(std::string_view text) {
+    prep(4, text.size() + 1);
+    bytes_.push_back(0);
+    pushBytes(text.data(), text.size());
+    push(static_cast<std::uint32_t>(text.size()));
+    return size();
+  }
+
+  template <typename Struct> Ref structVector(const std::vector<Struct> &items) {
+    const std::size_t bytes = sizeof(Struct) * items.size();
+    prep(4, bytes);
+    prep(alignof(Struct), bytes);
+    pushBytes(items.data(), bytes);
+    push(static_cast<std::uint32_t>(items.size()));
+    return size();
+  }
+
+  Ref refVector(const std::vector<Ref> &refs) {
+    prep(4, 4 * refs.size());
+    for (auto it = refs.rbegin(); it != refs.rend(); ++it) {
+      pushRef(*it);
+    }
+    push(static_cast<std::uint32_t>(refs.size()));
+    return size();
+  }
+
+  // Tables are built one at a time: their children must already exist
+  void startTable() {
+    fields_.clear();
+    tableStart_ = size();
+  }
+
+  template <typename T> void add(int slot, T value) {
+    prep(sizeof(T), 0);
+    push(value);
+    fields_.push_back({slot, size()});
+  }
+
+  void addRef(int slot, Ref ref) {
+    prep(4, 0);
+    pushRef(ref);
+    fields_.push_back({slot, size()});
+  }
+
+  Ref endTable() {
+    prep(4, 0);
+    push(std::int32_t{0}); // to the vtable, set below
+    const Ref table = size();
+
+    int slots = 0;
+    for (const Field &field : fields_) {
+      slots = std::max(slots, field.slot + 1);
+    }
+    std::vector<std::uint16_t> vtable(2 + static_cast<std::size_t>(slots), 0);
+    vtable[0] = static_cast<std::uint16_t>(2 * vtable.size());
+    vtable[1] = static_cast<std::uint16_t>(table - tableStart_);
+    for (const Field &field : fields_) {
+      vtable[2 + static_cast<std::size_t>(field.slot)] =
+          static_cast<std::uint16_t>(table - field.at);
+    }
+    for (auto it = vtable.rbegin(); it != vtable.rend(); ++it) {
+      push(*it);
+    }
+
+    // The vtable sits just before the table, which points back to it
+    const auto back = static_cast<std::int32_t>(size() - table);
+    for (std::size_t i = 0; i < sizeof(back); ++i) {
+      bytes_[table - 1 - i] = static_cast<char>((back >> (8 * i)) & 0xFF);
+    }
+    return table;
+  }
+
+  std::string finish(Ref root) {
+    prep(maxAlign_, 4);
+    pushRef(root);
+    return std::string(bytes_.rbegin(), bytes_.rend());
+  }
+
+private:
+  struct Field {
+    int slot;
+    Ref at;
+  };
+
+  Ref size() const { return static_cast<Ref>(bytes_.size()); }
+
+  // Pads so that after `additional` more bytes the size is a multiple of
+  // `alignment`, which aligns them once the buffer is complete
+  void prep(std::size_t alignment, std::size_t additional) {
+    maxAlign_ = std::max(maxAlign_, alignment);
+    const std::size_t padding = (0 - (bytes_.size() + additional)) & (alignment - 1);
+    bytes_.append(padding, '\0');
+  }
+
+  void pushBytes(const void *data, std::size_t size) {
+    const auto *begin = static_cast<const char *>(data);
+    bytes_.append(std::make_reverse_iterator(begin + size), std::make_reverse_iterator(begin));
+  }
+
+  template <typename T> void push(T value) { pushBytes(&value, sizeof(value)); }
+
+  void pushRef(Ref ref) { push(static_cast<std::uint32_t>(size() + 4 - ref)); }
+
+  std::string bytes_; // reversed
+  std::vector<Field> fields_;
+  Ref tableStart_ = 0;
+  std::size_t maxAlign_ = 1;
+};
+
+FlatBuilder::Ref intType(FlatBuilder &b) {
+  b.startTable();
+  b.add(0, std::int32_t{32}); // bitWidth
+  b.add(1, std::uint8_t{1});  // is_signed
+  return b.endTable();
+}
+
+FlatBuilder::Ref field(FlatBuilder &b, std::string_view name, std::uint8_t type,
+                       bool dictionaryEncoded = false) {
+  const auto nameRef = b.string(name);
+  FlatBuilder::Ref typeRef;
+  if (type == kTypeInt) {
+    typeRef = intType(b);
+  } else {
+    b.startTable(); // Utf8 has no fields
+    typeRef = b.endTable();
+  }
+  FlatBuilder::Ref dictionary = 0;
+  if (dictionaryEncoded) {
+    const auto indexType = intType(b);
+    b.startTable();
+    b.add(0, kPathDictionary); // id
+    b.addRef(1, indexType);
+    dictionary = b.endTable();
+  }
+  const auto children = b.refVector({});
+
+  b.startTable();
+  b.addRef(0, nameRef);
+  b.add(1, std::uint8_t{0}); // nullable
+  b.add(2, type);
+  b.addRef(3, typeRef);
+  if (dictionaryEncoded) {
+    b.addRef(4, dictionary);
+  }
+  b.addRef(5, children);
+  return b.endTable();
+}
+
+FlatBuilder::Ref schema(FlatBuilder &b) {
+  std::vector<FlatBuilder::Ref> fields{
+      field(b, "id", kTypeUtf8), field(b, "name", kTypeUtf8),
+      field(b, "path", kTypeUtf8, true), field(b, "depth", kTypeInt),
+      field(b, "instance_count", kTypeInt)};
+  const auto fieldsRef = b.refVector(fields);
+  b.startTable();
+  b.add(0, std::int16_t{0}); // endianness: little
+  b.addRef(1, fieldsRef);
+  return b.endTable();
+}
+
+FlatBuilder::Ref recordBatch(FlatBuilder &b, std::int64_t length,
+                             const std::vector<FieldNode> &nodes,
+                             const std::vector<Buffer> &buffers) {
+  const auto nodesRef = b.structVector(nodes);
+  const auto buffersRef = b.structVector(buffers);
+  b.startTable();
+  b.add(0, length);
+  b.addRef(1, nodesRef);
+  b.addRef(2, buffersRef);
+  return b.endTable();
+}
+
+std::string message(FlatBuilder &b, std::uint8_t headerType, FlatBuilder::Ref header,
+                    std::int64_t bodyLength) {
+  b.startTable();
+  b.add(0, kMetadataV5);
+  b.add(1, headerType);
+  b.addRef(2, header);
+  b.add(3, bodyLength);
+  return b.finish(b.endTable());
+}
+
+// Body layout: where each piece starts, each on a kAlignment boundary.
+// Absent validity bitmaps are empty pieces.
+std::int64_t layOut(const std::vector<std::size_t> &sizes, std::vector<Buffer> &buffers) {
+  std::size_t offset = 0;
+  for (std::size_t size : sizes) {
+    buffers.push_back({static_cast<std::int64_t>(offset), static_cast<std::int64_t>(size)});
+    offset += aligned(size);
+  }
+  return static_cast<std::int64_t>(offset);
+}
+
+template <typename T> std::size_t bytesOf(const std::vector<T> &values) {
+  return sizeof(T) * values.size();
+}
+
+} // namespace
+
+ArrowPartTableWriterAdapter::ArrowPartTableWriterAdapter(std::ostream &out) : out_(out) {}
+
+void ArrowPartTableWriterAdapter::begin(const StringColumn &paths) {
+  if (begun_) {
+    throw std::logic_error("ArrowPartTableWriterAdapter: begin() called twice");
+  }
+  begun_ = true;
+  write(kMagic, sizeof(kMagic));
+
+  FlatBuilder schemaMessage;
+  writeMessage(message(schemaMessage, kHeaderSchema, schema(schemaMessage), 0), {});
+
+  const std::vector<BodyPiece> body{
+      {nullptr, 0},
+      {paths.offsets.data(), bytesOf(paths.offsets)},
+      {paths.bytes.data(), paths.bytes.size()}};
+  std::vector<Buffer> buffers;
+  std::vector<std::size_t> sizes;
+  for (const BodyPiece &piece : body) {
+    sizes.push_back(piece.size);
+  }
+  const std::int64_t bodyLength = layOut(sizes, buffers);
+  const auto rows = static_cast<std::int64_t>(paths.size());
+
+  FlatBuilder b;
+  const auto data = recordBatch(b, rows, {{rows, 0}}, buffers);
+  b.startTable();
+  b.add(0, kPathDictionary); // id
+  b.addRef(1, data);
+  const auto dictionary = b.endTable();
+  dictionaries_.push_back(
+      writeMessage(message(b, kHeaderDictionaryBatch, dictionary, bodyLength), body));
+}
+
+void ArrowPartTableWriterAdapter::addBatch(const PartTableBatch &batch) {
+  if (!begun_ || finished_) {
+    throw std::logic_error("ArrowPartTableWriterAdapter: addBatch() outside begin()/finish()");
+  }
+  // Buffers column by column: validity (absent), then offsets and bytes for
+  // strings, values for the rest
+  const std::vector<BodyPiece> body{
+      {nullptr, 0},
+      {batch.ids.offsets.data(), bytesOf(batch.ids.offsets)},
+      {batch.ids.bytes.data(), batch.ids.bytes.size()},
+      {nullptr, 0},
+      {batch.names.offsets.data(), bytesOf(batch.names.offsets)},
+      {batch.names.bytes.data(), batch.names.bytes.size()},
+      {nullptr, 0},
+      {batch.paths.data(), bytesOf(batch.paths)},
+      {nullptr, 0},
+      {batch.depths.data(), bytesOf(batch.depths)},
+      {nullptr, 0},
+      {batch.instanceCounts.data(), bytesOf(batch.instanceCounts)}};
+  std::vector<std::size_t> sizes;
+  for (const BodyPiece &piece : body) {
+    sizes.push_back(piece.size);
+  }
+  std::vector<Buffer> buffers;
+  const std::int64_t bodyLength = layOut(sizes, buffers);
+  const auto rows = static_cast<std::int64_t>(batch.rows());
+
+  FlatBuilder b;
+  const auto header = recordBatch(b, rows, std::vector<FieldNode>(5, {rows, 0}), buffers);
+  recordBatches_.push_back(
+      writeMessage(message(b, kHeaderRecordBatch, header, bodyLength), body));
+}
+
+void ArrowPartTableWriterAdapter::finish() {
+  if (finished_) {
+    return;
+  }
+  if (!begun_) {
+    begin(StringColumn{});
+  }
+  finished_ = true;
+
+  // End of stream, for readers that read the file as a stream
+  const std::uint32_t endOfStream[2] = {kContinuation, 0};
+  write(endOfStream, sizeof(endOfStream));
+
+  FlatBuilder b;
+  const auto schemaRef = schema(b);
+  const auto dictionaries = b.structVector(dictionaries_);
+  const auto recordBatches = b.structVector(recordBatches_);
+  b.startTable();
+  b.add(0, kMetadataV5);
+  b.addRef(1, schemaRef);
+  b.addRef(2, dictionaries);
+  b.addRef(3, recordBatches);
+  const std::string footer = b.finish(b.endTable());
+  write(footer.data(), footer.size());
+  const auto footerLength = static_cast<std::int32_t>(footer.size());
+  write(&footerLength, sizeof(footerLength));
+  write(kMagic, 6);
+  out_.flush();
+  if (!out_) {
+    throw std::runtime_error("ArrowPartTableWriterAdapter: write failed");
+  }
+}
+
+// An encapsulated message: continuation marker, metadata length, the
+// metadata padded so that the body starts on a kAlignment boundary, then
+// the body pieces, each padded to the boundary too.
+ArrowPartTableWriterAdapter::Block
+ArrowPartTableWriterAdapter::writeMessage(const std::string &metadata,
+                                          const std::vector<BodyPiece> &body) {
+  Block block{static_cast<std::int64_t>(position_), 0, 0, 0};
+  const std::size_t prefix = 2 * sizeof(std::uint32_t);
+  const std::size_t padding = aligned(position_ + prefix + metadata.size()) -
+                              (position_ + prefix + metadata.size());
+  const auto metadataLength = static_cast<std::int32_t>(metadata.size() + padding);
+  write(&kContinuation, sizeof(kContinuation));
+  write(&metadataLength, sizeof(metadataLength));
+  write(metadata.data(), metadata.size());
+  pad(padding);
+  block.metadataLength = static_cast<std::int32_t>(prefix) + metadataLength;
+
+  for (const BodyPiece &piece : body) {
+    write(piece.data, piece.size);
+    pad(aligned(piece.size) - piece.size);
+    block.bodyLength += static_cast<std::int64_t>(aligned(piece.size));
+  }
+  return block;
+}
+
+void ArrowPartTableWriterAdapter::write(const void *data, std::size_t size) {
+  out_.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+  position_ += size;
+}
+
+void ArrowPartTableWriterAdapter::pad(std::size_t size) {
+  static constexpr char kZeros[kAlignment] = {};
+  write(kZeros, size);
+}
+
+} // namespace cad::adapters::arrow
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/core/ports/PartTableWriterPort.hpp"
+
+namespace cad::adapters::arrow {
+
+// Writes the part table as an Apache Arrow IPC file (.arrow, also read as
+// Feather v2) with the non-null columns
+//
+//   id, name        utf8
+//   path            dictionary<int32, utf8>, the dictionary written once
+//   depth           int32
+//   instance_count  int32
+//
+// and one record batch per batch. Column buffers are written as they are,
+// each starting on a 64-byte boundary of the file, so a reader that maps the
+// file uses them in place. The Arrow metadata (flatbuffers) is encoded here
+// and kept to what the format requires; no Arrow library is needed.
+class ArrowPartTableWriterAdapter final : public cad::ports::PartTableWriterPort {
+public:
+  explicit ArrowPartTableWriterAdapter(std::ostream &out);
+
+  void begin(const cad::ports::StringColumn &paths) override;
+  void addBatch(const cad::ports::PartTableBatch &batch) override;
+  void finish() override;
+
+private:
+  // Where a message sits in the file, for the footer
+  struct Block {
+    std::int64_t offset;
+    std::int32_t metadataLength;
+    std::int32_t padding;
+    std::int64_t bodyLength;
+  };
+  struct BodyPiece {
+    const void *data;
+    std::size_t size;
+  };
+
+  Block writeMessage(const std::string &metadata, const std::vector<BodyPiece> &body);
+  void write(const void *data, std::size_t size);
+  void pad(std::size_t size);
+
+  std::ostream &out_;
+  std::uint64_t position_ = 0;
+  std::vector<Block> dictionaries_;
+  std::vector<Block> recordBatches_;
+  bool begun_ = false;
+  bool finished_ = false;
+};
+
+} // namespace cad::adapters::arrow
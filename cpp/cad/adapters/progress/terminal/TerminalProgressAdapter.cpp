@@ -0,0 +1,52 @@
+#include "cpp/cad/adapters/progress/terminal/TerminalProgressAdapter.hpp"
+
+#include <cstdio>
+
+namespace cad::adapters::terminal {
+
+TerminalProgressAdapter::TerminalProgressAdapter(std::ostream &out,
+                                                 std::chrono::milliseconds interval)
+    : out_(out), interval_(interval) {}
+
+TerminalProgressAdapter::~TerminalProgressAdapter() {
+  if (shown_) {
+    out_ << "\r\x1b[K" << std::flush;
+  }
+}
+
+std::string TerminalProgressAdapter::format(std::string_view phase,
+                                            std::uint64_t done,
+                                            std::uint64_t total) {
+  char text[96];
+  if (phase == "bytes") {
+    const double mb = 1024.0 * 1024.0;
+    if (total != 0) {
+      std::snprintf(text, sizeof(text), "%.1f/%.1f MB (%d%%)", done / mb,
+                    total / mb, static_cast<int>(done * 100 / total));
+    } else {
+      std::snprintf(text, sizeof(text), "%.1f MB", done / mb);
+    }
+  } else if (total != 0) {
+    std::snprintf(text, sizeof(text), "%llu/%llu (%d%%)",
+                  static_cast<unsigned long long>(done),
+                  static_cast<unsigned long long>(total),
+                  static_cast<int>(done * 100 / total));
+  } else {
+    std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(done));
+  }
+  return std::string(phase) + " " + text;
+}
+
+void TerminalProgressAdapter::report(std::string_view phase, std::uint64_t done,
+                                     std::uint64_t total) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto now = std::chrono::steady_clock::now();
+  if (shown_ && now - lastShown_ < interval_) {
+    return;
+  }
+  lastShown_ = now;
+  shown_ = true;
+  out_ << "\r\x1b[K" << format(phase, done, total) << std::flush;
+}
+
+} // namespace cad::adapters::terminal
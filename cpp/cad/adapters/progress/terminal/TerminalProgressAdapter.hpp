@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+
+namespace cad::adapters::terminal {
+
+// Live one-line progress display. Each report rewrites the line on `out`
+// (stderr, from the CLI), but at most once per `interval`, so readers can
+// report every chunk cheaply. Never cancels by itself; wrap it in a
+// CancellableProgress for deadlines.
+class TerminalProgressAdapter final : public cad::ports::ProgressPort {
+public:
+  explicit TerminalProgressAdapter(
+      std::ostream &out,
+      std::chrono::milliseconds interval = std::chrono::milliseconds(100));
+  // Clears the line if anything was shown
+  ~TerminalProgressAdapter() override;
+
+  void report(std::string_view phase, std::uint64_t done,
+              std::uint64_t total) override;
+  bool cancelled() override { return false; }
+
+  // "bytes 12.5/50.0 MB (25%)", "entities 4096", ...
+  static std::string format(std::string_view phase, std::uint64_t done,
+                            std::uint64_t total);
+
+private:
+  std::mutex mutex_;
+  std::ostream &out_;
+  std::chrono::milliseconds interval_;
+  std::chrono::steady_clock::time_point lastShown_;
+  bool shown_ = false;
+};
+
+} // namespace cad::adapters::terminal
@@ -1,27 +1,116 @@
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
-#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
-#include "cpp/cad/adapters/cad-model-reader/json/JsonCadModelReaderAdapter.hpp"
-#include "cpp/cad/adapters/cad-model-reader/opencascade/OpenCascadeCadModelReaderAdapter.hpp"
+#include <unistd.h>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include "cpp/cad/adapters/common/TempFileMemoryResource.hpp"
+#include "cpp/cad/adapters/listing-writer/json/JsonListingWriterAdapter.hpp"
 #include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
 #include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
-#include "cpp/cad/adapters/model-data-source/json/JsonModelDataSourceAdapter.hpp"
-#include "cpp/cad/adapters/model-data-source/file/FileModelDataSourceAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/prefetch/PrefetchingModelDataSourceAdapter.hpp"
 #include "cpp/cad/adapters/logger/spdlog/SpdlogAdapter.hpp"
+#include "cpp/cad/adapters/mesh-writer/gltf/GlbMeshWriterAdapter.hpp"
+#include "cpp/cad/adapters/part-table-writer/arrow/ArrowPartTableWriterAdapter.hpp"
+#include "cpp/cad/adapters/progress/terminal/TerminalProgressAdapter.hpp"
+#include "cpp/cad/app/plugin/AdapterRegistry.hpp"
+#include "cpp/cad/app/plugin/BuiltinAdapters.hpp"
+#include "cpp/cad/core/usecase/BrowseModelUseCase.hpp"
+#include "cpp/cad/core/usecase/DiffModelsUseCase.hpp"
+#include "cpp/cad/core/usecase/ExportMeshUseCase.hpp"
+#include "cpp/cad/core/usecase/ExportPartTableUseCase.hpp"
+#include "cpp/cad/core/usecase/FindDuplicateGeometryUseCase.hpp"
 #include "cpp/cad/core/usecase/ListModelPartsUseCase.hpp"
+#include "cpp/cad/core/usecase/MeasureModelPartsUseCase.hpp"
+#include "cpp/cad/core/usecase/ResolveReferencesUseCase.hpp"
 #include "cpp/cad/app/cli/Formatter.hpp"
+#include "cpp/cad/core/concurrency/CancellableProgress.hpp"
+#include "cpp/cad/core/concurrency/MemoryBudget.hpp"
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+
+namespace {
+
+const char kUsage[] =
+    "Usage: cad-cli [--logger=fake|spdlog] [--data-source=fake|text|json|opencascade|auto] [--threads=N] [--timeout=SECONDS] [--prefetch=BYTES] [--memory-budget=BYTES [--spill-dir=DIR] [--unknown-read-size=BYTES]] [--resolve-references] [--format=text|ndjson|json] list <locator>\n"
+    "       cad-cli --data-source=opencascade|auto [--step-profile=structure|names|full] list <locator>\n"
+    "       cad-cli [--threads=N] [options] diff <before-locator> <after-locator>\n"
+    "       cad-cli --data-source=json|opencascade browse <locator> [<assembly>...]\n"
+    "       cad-cli --data-source=opencascade [--threads=N] measure <locator>\n"
+    "       cad-cli --data-source=opencascade [--threads=N] [--linear-deflection=D] [--angular-deflection=A] export <locator> <out.glb>\n"
+    "       cad-cli [--memory-budget=BYTES [--spill-dir=DIR]] [options] table <locator> <out.arrow>\n"
+    "       cad-cli --data-source=opencascade [--threads=N] [--tolerance=T] [--share] duplicates <locator>\n"
+    "\n"
+    "  --memory-budget=BYTES  admit each read against BYTES of estimated memory; a read over\n"
+    "                         it runs alone with its model spilled to --spill-dir. Only the\n"
+    "                         model is spilled: parse state (the JSON DOM) and interned names\n"
+    "                         stay on the heap. Interned names are kept for the whole run and\n"
+    "                         count against BYTES\n"
+    "  --unknown-read-size=BYTES  memory assumed for a read whose size cannot be judged\n"
+    "                         (input decompressed by the data source, pipes); default 64 MiB,\n"
+    "                         0 runs such reads alone\n";
+
+const std::size_t kMaxThreads = 4096;
+
+void logMemoryBudget(cad::ports::LoggerPort &logger, const cad::concurrency::MemoryBudget &budget,
+                     const cad::adapters::common::TempFileMemoryResource &spill) {
+  const auto stats = budget.stats();
+  logger.log(cad::ports::LogLevel::Info,
+             "Memory budget: peak " + std::to_string(stats.peakBytes) + " of " +
+                 std::to_string(stats.limitBytes) + " bytes (" +
+                 std::to_string(stats.residentBytes) + " held by interned names), " +
+                 std::to_string(stats.admitted) + " admitted (" +
+                 std::to_string(stats.queued) + " queued), " +
+                 std::to_string(stats.rejected) + " rejected; peak spilled " +
+                 std::to_string(spill.peakBytes()) + " bytes");
+}
+
+// Parses the whole of a flag value as a count. from_chars takes no sign for
+// unsigned types, so a negative value is rejected instead of wrapping.
+bool parseCount(std::string_view value, std::size_t &count) {
+  const char *end = value.data() + value.size();
+  const auto [next, ec] = std::from_chars(value.data(), end, count);
+  return !value.empty() && ec == std::errc() && next == end;
+}
+
+// Parses the whole of a flag value as a finite number; NaN and infinities
+// are rejected, as no option means anything by them.
+bool parseNumber(std::string_view value, double &number) {
+  const char *end = value.data() + value.size();
+  const auto [next, ec] = std::from_chars(value.data(), end, number);
+  return !value.empty() && ec == std::errc() && next == end && std::isfinite(number);
+}
+
+} // namespace
 
 int main(int argc, char **argv) {
   if (argc < 3) {
-    std::cerr << "Usage: cad-cli [--logger=fake|spdlog] [--data-source=fake|json|opencascade] list <locator>\n";
+    std::cerr << kUsage;
     return 1;
   }
 
   // Parse arguments
   std::string loggerType = "fake"; // default
   std::string dataSourceType = "fake"; // default
+  std::size_t threads = 1; // 0 = one per core
+  cad::ports::TessellationOptions tessellation;
+  cad::usecase::DuplicateGeometryOptions duplicates;
+  double timeoutSeconds = 0; // 0 = no limit
+  bool resolveReferences = false;
+  std::size_t prefetchBytes = 0; // 0 = no read-ahead
+  std::size_t memoryBudgetBytes = 0; // 0 = no admission control
+  std::size_t unknownReadBytes = cad::usecase::kDefaultUnknownReadBytes;
+  std::string spillDirectory = cad::adapters::common::TempFileMemoryResource::defaultDirectory();
+  std::string stepProfile; // empty = the reader's default (full)
+  std::string format = "text"; // of list output
   int argIndex = 1;
   
   // Parse optional flags
@@ -31,45 +120,141 @@ int main(int argc, char **argv) {
       loggerType = flag.substr(9); // Remove "--logger=" prefix
     } else if (flag.rfind("--data-source=", 0) == 0) {
       dataSourceType = flag.substr(14); // Remove "--data-source=" prefix
+    } else if (flag.rfind("--threads=", 0) == 0) {
+      // Each thread gets a queue up front, so a count no machine has is a typo
+      if (!parseCount(flag.substr(10), threads) || threads > kMaxThreads) {
+        std::cerr << "Invalid thread count: " << flag.substr(10) << "\n" << kUsage;
+        return 1;
+      }
+    } else if (flag.rfind("--timeout=", 0) == 0) {
+      if (!parseNumber(flag.substr(10), timeoutSeconds) || timeoutSeconds < 0) {
+        std::cerr << "Invalid timeout: " << flag.substr(10) << "\n" << kUsage;
+        return 1;
+      }
+    } else if (flag.rfind("--step-profile=", 0) == 0) {
+      stepProfile = flag.substr(15); // Remove "--step-profile=" prefix
+      if (stepProfile != "structure" && stepProfile != "names" && stepProfile != "full") {
+        std::cerr << "Unknown STEP profile: " << stepProfile << "\n";
+        return 1;
+      }
+    } else if (flag.rfind("--format=", 0) == 0) {
+      format = flag.substr(9); // Remove "--format=" prefix
+      if (format != "text" && format != "ndjson" && format != "json") {
+        std::cerr << "Unknown format: " << format << "\n";
+        return 1;
+      }
+    } else if (flag.rfind("--prefetch=", 0) == 0) {
+      if (!parseCount(flag.substr(11), prefetchBytes)) { // Remove "--prefetch=" prefix
+        std::cerr << "Invalid prefetch size: " << flag.substr(11) << "\n" << kUsage;
+        return 1;
+      }
+    } else if (flag.rfind("--memory-budget=", 0) == 0) {
+      if (!parseCount(flag.substr(16), memoryBudgetBytes)) { // Remove "--memory-budget=" prefix
+        std::cerr << "Invalid memory budget: " << flag.substr(16) << "\n" << kUsage;
+        return 1;
+      }
+    } else if (flag.rfind("--unknown-read-size=", 0) == 0) {
+      if (!parseCount(flag.substr(20), unknownReadBytes)) { // Remove "--unknown-read-size=" prefix
+        std::cerr << "Invalid unknown read size: " << flag.substr(20) << "\n" << kUsage;
+        return 1;
+      }
+    } else if (flag.rfind("--spill-dir=", 0) == 0) {
+      spillDirectory = flag.substr(12); // Remove "--spill-dir=" prefix
+    } else if (flag == "--resolve-references") {
+      resolveReferences = true;
+    } else if (flag == "--share") {
+      duplicates.share = true;
+    } else if (flag.rfind("--linear-deflection=", 0) == 0) {
+      // The mesher needs a positive deflection to know when to stop refining
+      if (!parseNumber(flag.substr(20), tessellation.linearDeflection) ||
+          tessellation.linearDeflection <= 0) {
+        std::cerr << "Invalid linear deflection: " << flag.substr(20) << "\n" << kUsage;
+        return 1;
+      }
+    } else if (flag.rfind("--angular-deflection=", 0) == 0) {
+      if (!parseNumber(flag.substr(21), tessellation.angularDeflection) ||
+          tessellation.angularDeflection <= 0) {
+        std::cerr << "Invalid angular deflection: " << flag.substr(21) << "\n" << kUsage;
+        return 1;
+      }
+    } else if (flag.rfind("--tolerance=", 0) == 0) {
+      if (!parseNumber(flag.substr(12), duplicates.tolerance) || // Remove "--tolerance=" prefix
+          duplicates.tolerance < 0) {
+        std::cerr << "Invalid tolerance: " << flag.substr(12) << "\n" << kUsage;
+        return 1;
+      }
     }
     argIndex++;
   }
   
   if (argc <= argIndex + 1) {
-    std::cerr << "Usage: cad-cli [--logger=fake|spdlog] [--data-source=fake|json|opencascade] list <locator>\n";
+    std::cerr << kUsage;
     return 1;
   }
 
   std::string command = argv[argIndex];
   std::string locator = argv[argIndex + 1];
 
-  if (command != "list") {
+  if (command != "list" && command != "diff" && command != "measure" &&
+      command != "export" && command != "browse" && command != "table" &&
+      command != "duplicates") {
     std::cerr << "Unknown command: " << command << "\n";
     return 1;
   }
+  if (format != "text" && (command != "list" || resolveReferences)) {
+    std::cerr << "--format applies to plain list only\n";
+    return 1;
+  }
+  if (duplicates.share && command != "duplicates") {
+    std::cerr << "--share applies to duplicates only\n";
+    return 1;
+  }
+  if (timeoutSeconds > 0 && command == "browse") {
+    // Opening a lazy model reports no progress, so it cannot be stopped
+    std::cerr << "--timeout does not apply to browse\n";
+    return 1;
+  }
+  if (command == "diff" && argc <= argIndex + 2) {
+    std::cerr << "Usage: cad-cli [options] diff <before-locator> <after-locator>\n";
+    return 1;
+  }
+  if (command == "export" && argc <= argIndex + 2) {
+    std::cerr << "Usage: cad-cli [options] export <locator> <out.glb>\n";
+    return 1;
+  }
+  if (command == "table" && argc <= argIndex + 2) {
+    std::cerr << "Usage: cad-cli [options] table <locator> <out.arrow>\n";
+    return 1;
+  }
 
-  // Create adapters based on type
-  std::unique_ptr<cad::ports::ModelDataSourcePort> source;
-  std::unique_ptr<cad::ports::CadModelReaderPort> reader;
-  std::unique_ptr<cad::ports::LoggerPort> logger;
-  
-  // Create data source and reader based on type
-  if (dataSourceType == "json") {
-    source = std::make_unique<cad::adapters::json::JsonModelDataSourceAdapter>();
-    reader = std::make_unique<cad::adapters::json::JsonCadModelReaderAdapter>();
-  } else if (dataSourceType == "opencascade") {
-    source = std::make_unique<cad::adapters::file::FileModelDataSourceAdapter>(); // Use file data source for direct file access
-    reader = std::make_unique<cad::adapters::opencascade::OpenCascadeCadModelReaderAdapter>();
-  } else {
-    source = std::make_unique<cad::adapters::fake::FakeModelDataSourceAdapter>();
-    reader = std::make_unique<cad::adapters::fake::FakeCadModelReaderAdapter>();
+  // Create data source and reader based on type. Adapters that are not linked
+  // in are loaded from their plugin module only when selected, so options for
+  // them travel through the environment, like CAD_STEP_CACHE_DIR.
+  if (!stepProfile.empty()) {
+    setenv("CAD_STEP_PROFILE", stepProfile.c_str(), 1);
   }
-  
-  // Create logger based on type
+  cad::app::plugin::AdapterRegistry registry(
+      cad::app::plugin::AdapterRegistry::defaultPluginDirectory());
+  cad::app::plugin::registerBuiltinAdapters(registry);
+
+  std::string error;
+  cad::app::plugin::AdapterSet adapters = registry.create(dataSourceType, error);
+  if (!adapters.source || !adapters.reader) {
+    std::cerr << "Unknown data source: " << dataSourceType << " (" << error << ")\n";
+    return 1;
+  }
+  std::unique_ptr<cad::ports::ModelDataSourcePort> baseSource = std::move(adapters.source);
+  std::unique_ptr<cad::ports::CadModelReaderPort> reader = std::move(adapters.reader);
+  std::unique_ptr<cad::ports::LoggerPort> logger;
+
+  // Create logger based on type. Structured output owns stdout, so its
+  // runs log to stderr.
   if (loggerType == "spdlog") {
-    logger = std::make_unique<cad::adapters::spdlog::SpdlogAdapter>();
+    logger = std::make_unique<cad::adapters::spdlog::SpdlogAdapter>(
+        format == "text" ? nullptr : ::spdlog::stderr_color_mt("cad_logger_stderr"));
   } else {
-    logger = std::make_unique<cad::adapters::fake::FakeLoggerAdapter>();
+    logger = std::make_unique<cad::adapters::fake::FakeLoggerAdapter>(
+        format == "text" ? std::cout : std::cerr);
   }
 
   // For demo: if the locator starts with "mem:" and using fake source, register inline content
@@ -78,12 +263,149 @@ int main(int argc, char **argv) {
     std::string content =
         "Assembly: Engine\nPart: Piston\nPart: Valve\nEndAssembly\nAssembly: "
         "Frame\nPart: Bolt\nEndAssembly\n";
-    static_cast<cad::adapters::fake::FakeModelDataSourceAdapter*>(source.get())->registerContent(locator, content);
+    static_cast<cad::adapters::fake::FakeModelDataSourceAdapter*>(baseSource.get())->registerContent(locator, content);
   }
 
-  cad::usecase::ListModelPartsUseCase usecase(*source, *reader, *logger);
+  // Files the commands announce (revisions to diff, referenced files) are
+  // read ahead on I/O threads while earlier ones are parsed
+  std::unique_ptr<cad::ports::ModelDataSourcePort> prefetching;
+  if (prefetchBytes > 0) {
+    prefetching = std::make_unique<cad::adapters::prefetch::PrefetchingModelDataSourceAdapter>(
+        *baseSource, prefetchBytes);
+  }
+  cad::ports::ModelDataSourcePort *source = prefetching ? prefetching.get() : baseSource.get();
+
+  // Reads show a live progress line on a terminal and stop cleanly once the
+  // timeout passes
+  std::unique_ptr<cad::adapters::terminal::TerminalProgressAdapter> display;
+  if (isatty(STDERR_FILENO)) {
+    display = std::make_unique<cad::adapters::terminal::TerminalProgressAdapter>(std::cerr);
+  }
+  cad::concurrency::CancellableProgress progress(display.get());
+  if (timeoutSeconds > 0) {
+    progress.setTimeout(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(timeoutSeconds)));
+  }
+
+  // Reads that would take the model past the budget run alone, with the
+  // model in file-backed pages the kernel can reclaim, rather than letting
+  // one large input exhaust a memory-limited worker
+  std::unique_ptr<cad::concurrency::MemoryBudget> memoryBudget;
+  std::unique_ptr<cad::adapters::common::TempFileMemoryResource> spill;
+  cad::usecase::ReadBudget readBudget;
+  if (memoryBudgetBytes > 0) {
+    memoryBudget = std::make_unique<cad::concurrency::MemoryBudget>(memoryBudgetBytes);
+    spill = std::make_unique<cad::adapters::common::TempFileMemoryResource>(spillDirectory);
+    readBudget = {memoryBudget.get(), spill.get(), unknownReadBytes};
+  }
 
-  auto lines = usecase.list(locator);
+  std::vector<std::string> lines;
+  if (command == "measure") {
+    // Only readers that know the geometry behind each part can measure
+    auto *geometry = dynamic_cast<cad::ports::GeometricPropertiesPort *>(reader.get());
+    if (!geometry) {
+      std::cerr << "Data source " << dataSourceType << " cannot measure geometry\n";
+      return 1;
+    }
+    cad::concurrency::ThreadPool pool(threads);
+    cad::usecase::MeasureModelPartsUseCase usecase(*source, *geometry, *logger, pool);
+    lines = usecase.measure(locator, &progress);
+  } else if (command == "duplicates") {
+    // Only readers that keep the shapes behind each part can compare them
+    auto *geometry = dynamic_cast<cad::ports::PrototypeGeometryPort *>(reader.get());
+    if (!geometry) {
+      std::cerr << "Data source " << dataSourceType << " cannot compare geometry\n";
+      return 1;
+    }
+    cad::concurrency::ThreadPool pool(threads);
+    cad::usecase::FindDuplicateGeometryUseCase usecase(*source, *geometry, *logger, pool);
+    lines = usecase.find(locator, duplicates, &progress);
+  } else if (command == "export") {
+    // Only readers that know the geometry behind each part can mesh it
+    auto *tessellator = dynamic_cast<cad::ports::TessellationPort *>(reader.get());
+    if (!tessellator) {
+      std::cerr << "Data source " << dataSourceType << " cannot tessellate geometry\n";
+      return 1;
+    }
+    std::ofstream out(argv[argIndex + 2], std::ios::binary);
+    if (!out) {
+      std::cerr << "Cannot write " << argv[argIndex + 2] << "\n";
+      return 1;
+    }
+    cad::adapters::gltf::GlbMeshWriterAdapter writer(out);
+    cad::concurrency::ThreadPool pool(threads);
+    cad::usecase::ExportMeshUseCase usecase(*source, *tessellator, *logger, pool);
+    lines = usecase.exportMesh(locator, tessellation, writer, &progress);
+  } else if (command == "table") {
+    std::ofstream out(argv[argIndex + 2], std::ios::binary);
+    if (!out) {
+      std::cerr << "Cannot write " << argv[argIndex + 2] << "\n";
+      return 1;
+    }
+    cad::adapters::arrow::ArrowPartTableWriterAdapter writer(out);
+    cad::concurrency::ThreadPool pool(threads);
+    cad::usecase::ExportPartTableUseCase usecase(
+        *source, *reader, *logger, pool,
+        cad::usecase::ExportPartTableUseCase::kDefaultBatchRows, readBudget);
+    lines = usecase.exportTable(locator, writer, &progress);
+  } else if (command == "browse") {
+    // Only readers that can open a model without building it browse it
+    auto *lazy = dynamic_cast<cad::ports::LazyModelReaderPort *>(reader.get());
+    if (!lazy) {
+      std::cerr << "Data source " << dataSourceType << " cannot open models lazily\n";
+      return 1;
+    }
+    cad::usecase::BrowseModelUseCase usecase(*source, *lazy, *logger);
+    lines = usecase.browse(locator, std::vector<std::string>(argv + argIndex + 2, argv + argc));
+  } else if (command == "diff") {
+    // Large revisions are hashed in parallel when more than one thread is
+    // requested
+    std::unique_ptr<cad::concurrency::ThreadPool> pool;
+    if (threads != 1) {
+      pool = std::make_unique<cad::concurrency::ThreadPool>(threads);
+    }
+    cad::usecase::DiffModelsUseCase usecase(*source, *reader, *logger, pool.get());
+    lines = usecase.diff(locator, argv[argIndex + 2], &progress);
+  } else if (resolveReferences) {
+    // Files referenced by the model are read in parallel and stitched in
+    cad::concurrency::ThreadPool pool(threads);
+    cad::usecase::ResolveReferencesUseCase usecase(*source, *reader, *logger, pool);
+    lines = usecase.list(locator, &progress);
+  } else {
+    // Large models are rendered in parallel when more than one thread is
+    // requested; the output does not change.
+    std::unique_ptr<cad::concurrency::ThreadPool> pool;
+    if (threads != 1) {
+      pool = std::make_unique<cad::concurrency::ThreadPool>(threads);
+    }
+    cad::usecase::ListModelPartsUseCase usecase(*source, *reader, *logger, pool.get(),
+                                                readBudget);
+    if (format == "text") {
+      lines = usecase.list(locator, &progress);
+    } else {
+      // Records go to stdout as the model is traversed; only an error
+      // line is left to print
+      cad::adapters::json::JsonListingWriterAdapter writer(
+          std::cout, format == "ndjson" ? cad::adapters::json::JsonListingWriterAdapter::Layout::Lines
+                                        : cad::adapters::json::JsonListingWriterAdapter::Layout::Array);
+      lines = usecase.write(locator, writer, &progress);
+      if (memoryBudget) {
+        logMemoryBudget(*logger, *memoryBudget, *spill);
+      }
+      if (lines.empty()) {
+        display.reset();
+        return progress.timedOut() ? 124 : 0;
+      }
+    }
+  }
+  if (memoryBudget && format == "text") {
+    logMemoryBudget(*logger, *memoryBudget, *spill);
+  }
+  display.reset(); // clear the progress line before printing
   std::cout << cad::app::cli::Formatter::joinLines(lines) << std::endl;
+  if (progress.timedOut()) {
+    std::cerr << "Timed out after " << timeoutSeconds << " s\n";
+    return 124; // as timeout(1)
+  }
   return 0;
 }
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+
+#include "cpp/cad/core/ports/CadModelReaderPort.hpp"
+#include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
+
+namespace cad::app::plugin {
+
+// The data source and reader selected together by `--data-source=<name>`.
+struct AdapterSet {
+  std::unique_ptr<cad::ports::ModelDataSourcePort> source;
+  std::unique_ptr<cad::ports::CadModelReaderPort> reader;
+};
+
+using AdapterFactory = AdapterSet (*)();
+
+// Plugin modules pass C++ objects across the dlopen boundary, so they must be
+// built with the same compiler and standard library as cad_cli (they are built
+// from this tree). They also resolve cad_core against cad_cli, which exports
+// it, and so only load into that executable. The ABI version guards against
+// stale modules on disk.
+inline constexpr int kAdapterPluginAbiVersion = 1;
+
+struct AdapterPluginInfo {
+  int abiVersion;
+  const char *name;
+  AdapterFactory create;
+};
+
+} // namespace cad::app::plugin
+
+#define CAD_ADAPTER_PLUGIN_ENTRY_SYMBOL "cad_adapter_plugin_v1"
+
+// Exports `factory` under `name` when the file is compiled as a plugin module
+// (CAD_ADAPTER_PLUGIN_MODULE); expands to nothing in static builds.
+#ifdef CAD_ADAPTER_PLUGIN_MODULE
+#define CAD_EXPORT_ADAPTER_PLUGIN(name, factory)                               \
+  extern "C" __attribute__((visibility("default")))                            \
+  const cad::app::plugin::AdapterPluginInfo *                                  \
+  cad_adapter_plugin_v1() {                                                    \
+    static const cad::app::plugin::AdapterPluginInfo info{                     \
+        cad::app::plugin::kAdapterPluginAbiVersion, name, factory};            \
+    return &info;                                                              \
+  }
+#else
+#define CAD_EXPORT_ADAPTER_PLUGIN(name, factory)
+#endif
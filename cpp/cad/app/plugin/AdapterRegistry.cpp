@@ -0,0 +1,95 @@
+#include "cpp/cad/app/plugin/AdapterRegistry.hpp"
+
+#include <cstdlib>
+#include <dlfcn.h>
+#include <filesystem>
+#include <utility>
+
+#ifndef CAD_PLUGIN_PREFIX
+#define CAD_PLUGIN_PREFIX "lib"
+#endif
+#ifndef CAD_PLUGIN_SUFFIX
+#define CAD_PLUGIN_SUFFIX ".so"
+#endif
+
+namespace cad::app::plugin {
+
+AdapterRegistry::AdapterRegistry(std::string pluginDirectory)
+    : pluginDirectory_(std::move(pluginDirectory)) {}
+
+AdapterRegistry::~AdapterRegistry() {
+  // Deliberately not dlclose()d: adapters handed out by create() may outlive
+  // the registry in callers that keep them around until exit. The handles
+  // are dropped and the modules stay mapped until the process exits.
+}
+
+void AdapterRegistry::add(const std::string &name,
+                          std::function<AdapterSet()> factory) {
+  factories_[name] = std::move(factory);
+}
+
+AdapterSet AdapterRegistry::create(const std::string &name,
+                                   std::string &error) {
+  auto it = factories_.find(name);
+  if (it == factories_.end()) {
+    if (!load(name, error)) {
+      return {};
+    }
+    it = factories_.find(name);
+  }
+  return it->second();
+}
+
+bool AdapterRegistry::load(const std::string &name, std::string &error) {
+  std::filesystem::path path =
+      std::filesystem::path(pluginDirectory_) /
+      (CAD_PLUGIN_PREFIX "cad_adapter_" + name + CAD_PLUGIN_SUFFIX);
+
+  void *module = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!module) {
+    const char *reason = dlerror();
+    error = "cannot load adapter plugin '" + name + "': " +
+            (reason ? reason : path.string());
+    return false;
+  }
+
+  using Entry = const AdapterPluginInfo *(*)();
+  auto entry = reinterpret_cast<Entry>(
+      dlsym(module, CAD_ADAPTER_PLUGIN_ENTRY_SYMBOL));
+  const AdapterPluginInfo *info = entry ? entry() : nullptr;
+  if (!info || info->abiVersion != kAdapterPluginAbiVersion ||
+      name != info->name || !info->create) {
+    error = "'" + path.string() + "' is not a compatible adapter plugin";
+    dlclose(module);
+    return false;
+  }
+
+  modules_.push_back(module);
+  factories_[name] = info->create;
+  return true;
+}
+
+std::string AdapterRegistry::defaultPluginDirectory() {
+  if (const char *dir = std::getenv("CAD_PLUGIN_DIR")) {
+    return dir;
+  }
+
+  // /proc gives the resolved executable path on Linux; elsewhere fall back to
+  // the image path reported by the dynamic loader.
+  std::error_code ec;
+  std::filesystem::path exe = std::filesystem::read_symlink("/proc/self/exe", ec);
+  if (ec) {
+    Dl_info self{};
+    if (dladdr(reinterpret_cast<void *>(&AdapterRegistry::defaultPluginDirectory),
+               &self) &&
+        self.dli_fname) {
+      exe = std::filesystem::absolute(self.dli_fname, ec);
+    }
+  }
+  if (exe.has_parent_path()) {
+    return exe.parent_path().string();
+  }
+  return ".";
+}
+
+} // namespace cad::app::plugin
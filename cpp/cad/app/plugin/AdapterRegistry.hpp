@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cpp/cad/app/plugin/AdapterPlugin.hpp"
+
+namespace cad::app::plugin {
+
+// Maps `--data-source` names to adapter factories. Names registered with add()
+// are linked into the executable; any other name is looked up on first use as
+// a plugin module "<prefix>cad_adapter_<name><suffix>" in the plugin
+// directory and loaded with dlopen, so unused adapters and their dependencies
+// (OpenCASCADE in particular) are never mapped. Modules carry no copy of
+// cad_core: they bind to the one exported by the executable, so interned
+// Names, thread-locals and typeinfo are shared with everything linked in.
+class AdapterRegistry {
+public:
+  explicit AdapterRegistry(std::string pluginDirectory);
+  ~AdapterRegistry();
+
+  AdapterRegistry(const AdapterRegistry &) = delete;
+  AdapterRegistry &operator=(const AdapterRegistry &) = delete;
+
+  void add(const std::string &name, std::function<AdapterSet()> factory);
+
+  // Returns an empty AdapterSet and fills `error` when `name` is neither
+  // registered nor loadable as a plugin.
+  AdapterSet create(const std::string &name, std::string &error);
+
+  // $CAD_PLUGIN_DIR if set, otherwise the directory holding the executable.
+  static std::string defaultPluginDirectory();
+
+private:
+  bool load(const std::string &name, std::string &error);
+
+  std::string pluginDirectory_;
+  std::unordered_map<std::string, std::function<AdapterSet()>> factories_;
+  // Loaded modules are never dlclose()d, not even by the destructor:
+  // adapters created from them point at their code and vtables and may
+  // outlive the registry, so they stay mapped until the process exits.
+  std::vector<void *> modules_;
+};
+
+} // namespace cad::app::plugin
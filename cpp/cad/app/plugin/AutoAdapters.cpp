@@ -0,0 +1,26 @@
+#include "cpp/cad/adapters/cad-model-reader/auto/AutoDetectingCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/file/FileModelDataSourceAdapter.hpp"
+#include "cpp/cad/app/plugin/BuiltinAdapters.hpp"
+
+using cad::adapters::common::ModelFormat;
+
+namespace cad::app::plugin {
+
+AdapterSet makeAutoAdapters(AdapterRegistry &registry) {
+  auto reader =
+      std::make_unique<cad::adapters::autodetect::AutoDetectingCadModelReaderAdapter>();
+  auto readerFrom = [&registry](std::string name) {
+    return [&registry, name] {
+      std::string error;
+      return registry.create(name, error).reader;
+    };
+  };
+  reader->registerReader(ModelFormat::FakeText, readerFrom("text"));
+  reader->registerReader(ModelFormat::Json, readerFrom("json"));
+  reader->registerReader(ModelFormat::Step, readerFrom("opencascade"));
+
+  return {std::make_unique<cad::adapters::file::FileModelDataSourceAdapter>(),
+          std::move(reader)};
+}
+
+} // namespace cad::app::plugin
@@ -0,0 +1,15 @@
+#include "cpp/cad/app/plugin/BuiltinAdapters.hpp"
+
+namespace cad::app::plugin {
+
+void registerBuiltinAdapters(AdapterRegistry &registry) {
+  registry.add("fake", &makeFakeAdapters);
+  registry.add("text", &makeTextAdapters);
+  registry.add("auto", [&registry] { return makeAutoAdapters(registry); });
+#ifndef CAD_ADAPTER_PLUGINS
+  registry.add("json", &makeJsonAdapters);
+  registry.add("opencascade", &makeOpenCascadeAdapters);
+#endif
+}
+
+} // namespace cad::app::plugin
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "cpp/cad/app/plugin/AdapterPlugin.hpp"
+#include "cpp/cad/app/plugin/AdapterRegistry.hpp"
+
+namespace cad::app::plugin {
+
+AdapterSet makeFakeAdapters();
+// File data source plus the fast reader for the fake text format.
+AdapterSet makeTextAdapters();
+AdapterSet makeJsonAdapters();
+AdapterSet makeOpenCascadeAdapters();
+// File data source plus a reader that detects the format of each input and
+// takes the matching reader (text, json, opencascade) from `registry`.
+AdapterSet makeAutoAdapters(AdapterRegistry &registry);
+
+// Registers the adapters linked into this executable. With
+// CAD_ADAPTER_PLUGINS only "fake", "text" and "auto" are linked in; "json" and
+// "opencascade" are then loaded on demand from their plugin modules.
+void registerBuiltinAdapters(AdapterRegistry &registry);
+
+} // namespace cad::app::plugin
@@ -0,0 +1,14 @@
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/app/plugin/BuiltinAdapters.hpp"
+
+namespace cad::app::plugin {
+
+AdapterSet makeFakeAdapters() {
+  return {std::make_unique<cad::adapters::fake::FakeModelDataSourceAdapter>(),
+          std::make_unique<cad::adapters::fake::FakeCadModelReaderAdapter>()};
+}
+
+} // namespace cad::app::plugin
+
+CAD_EXPORT_ADAPTER_PLUGIN("fake", &cad::app::plugin::makeFakeAdapters)
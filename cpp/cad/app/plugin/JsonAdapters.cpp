@@ -0,0 +1,14 @@
+#include "cpp/cad/adapters/cad-model-reader/json/JsonCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/json/JsonModelDataSourceAdapter.hpp"
+#include "cpp/cad/app/plugin/BuiltinAdapters.hpp"
+
+namespace cad::app::plugin {
+
+AdapterSet makeJsonAdapters() {
+  return {std::make_unique<cad::adapters::json::JsonModelDataSourceAdapter>(),
+          std::make_unique<cad::adapters::json::JsonCadModelReaderAdapter>()};
+}
+
+} // namespace cad::app::plugin
+
+CAD_EXPORT_ADAPTER_PLUGIN("json", &cad::app::plugin::makeJsonAdapters)
@@ -0,0 +1,28 @@
+#include <cstdlib>
+
+#include "cpp/cad/adapters/cad-model-reader/opencascade/OpenCascadeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/file/FileModelDataSourceAdapter.hpp"
+#include "cpp/cad/app/plugin/BuiltinAdapters.hpp"
+
+namespace cad::app::plugin {
+
+AdapterSet makeOpenCascadeAdapters() {
+  using cad::adapters::opencascade::StepReadProfile;
+  // $CAD_STEP_CACHE_DIR keeps transferred STEP documents for fast reloads
+  const char *cacheDirectory = std::getenv("CAD_STEP_CACHE_DIR");
+  // $CAD_STEP_PROFILE (set by --step-profile) trims what a read transfers
+  const char *profileName = std::getenv("CAD_STEP_PROFILE");
+  StepReadProfile profile =
+      cad::adapters::opencascade::parseStepReadProfile(profileName ? profileName : "")
+          .value_or(StepReadProfile::Full);
+  // Use file data source for direct file access
+  return {std::make_unique<cad::adapters::file::FileModelDataSourceAdapter>(),
+          std::make_unique<
+              cad::adapters::opencascade::OpenCascadeCadModelReaderAdapter>(
+              cacheDirectory ? cacheDirectory : "", profile)};
+}
+
+} // namespace cad::app::plugin
+
+CAD_EXPORT_ADAPTER_PLUGIN("opencascade",
+                          &cad::app::plugin::makeOpenCascadeAdapters)
@@ -0,0 +1,14 @@
+#include "cpp/cad/adapters/cad-model-reader/text/TextCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/file/FileModelDataSourceAdapter.hpp"
+#include "cpp/cad/app/plugin/BuiltinAdapters.hpp"
+
+namespace cad::app::plugin {
+
+AdapterSet makeTextAdapters() {
+  return {std::make_unique<cad::adapters::file::FileModelDataSourceAdapter>(),
+          std::make_unique<cad::adapters::text::TextCadModelReaderAdapter>()};
+}
+
+} // namespace cad::app::plugin
+
+CAD_EXPORT_ADAPTER_PLUGIN("text", &cad::app::plugin::makeTextAdapters)
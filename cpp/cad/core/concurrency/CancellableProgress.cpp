@@ -0,0 +1,44 @@
+#include "cpp/cad/core/concurrency/CancellableProgress.hpp"
+
+namespace cad::concurrency {
+
+CancellableProgress::CancellableProgress(cad::ports::ProgressPort *inner)
+    : inner_(inner), deadline_(Clock::time_point::max().time_since_epoch().count()) {}
+
+void CancellableProgress::setTimeout(Clock::duration timeout) {
+  setDeadline(Clock::now() + timeout);
+}
+
+void CancellableProgress::setDeadline(Clock::time_point deadline) {
+  deadline_.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+void CancellableProgress::cancel() {
+  cancelled_.store(true, std::memory_order_relaxed);
+}
+
+void CancellableProgress::report(std::string_view phase, std::uint64_t done,
+                                 std::uint64_t total) {
+  if (inner_) {
+    inner_->report(phase, done, total);
+  }
+}
+
+bool CancellableProgress::cancelled() {
+  if (cancelled_.load(std::memory_order_relaxed)) {
+    return true;
+  }
+  if (Clock::now().time_since_epoch().count() >=
+      deadline_.load(std::memory_order_relaxed)) {
+    timedOut_.store(true, std::memory_order_relaxed);
+    cancelled_.store(true, std::memory_order_relaxed);
+    return true;
+  }
+  if (inner_ && inner_->cancelled()) {
+    cancelled_.store(true, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+} // namespace cad::concurrency
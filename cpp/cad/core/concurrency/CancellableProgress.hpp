@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+
+namespace cad::concurrency {
+
+// ProgressPort for one request: forwards reports to an optional inner port
+// (a progress display, say) and is cancelled once its deadline passes, once
+// cancel() is called from any thread, or when the inner port is cancelled.
+// A scheduler keeps one per job to stop runaway reads; the read unwinds with
+// ReadCancelled and frees what it built.
+class CancellableProgress final : public cad::ports::ProgressPort {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit CancellableProgress(cad::ports::ProgressPort *inner = nullptr);
+
+  // Cancels the request once `timeout` has passed from now.
+  void setTimeout(Clock::duration timeout);
+  void setDeadline(Clock::time_point deadline);
+
+  // Safe to call from any thread, at any time.
+  void cancel();
+
+  // Whether cancellation came from the deadline rather than cancel().
+  bool timedOut() const { return timedOut_.load(std::memory_order_relaxed); }
+
+  void report(std::string_view phase, std::uint64_t done,
+              std::uint64_t total) override;
+  bool cancelled() override;
+
+private:
+  cad::ports::ProgressPort *inner_;
+  std::atomic<Clock::rep> deadline_; // ticks since the clock's epoch
+  std::atomic<bool> cancelled_{false};
+  std::atomic<bool> timedOut_{false};
+};
+
+} // namespace cad::concurrency
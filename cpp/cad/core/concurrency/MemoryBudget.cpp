@@ -0,0 +1,115 @@
+#include "cpp/cad/core/concurrency/MemoryBudget.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace cad::concurrency {
+
+namespace {
+
+// Reservations held by the calling thread, across budgets
+thread_local std::size_t tHeld = 0;
+
+} // namespace
+
+MemoryBudget::Reservation::Reservation(MemoryBudget *budget, std::size_t bytes)
+    : budget_(budget), bytes_(bytes) {
+  ++tHeld;
+}
+
+MemoryBudget::Reservation::Reservation(Reservation &&other) noexcept
+    : budget_(std::exchange(other.budget_, nullptr)), bytes_(std::exchange(other.bytes_, 0)) {}
+
+MemoryBudget::Reservation &MemoryBudget::Reservation::operator=(Reservation &&other) noexcept {
+  if (this != &other) {
+    release();
+    budget_ = std::exchange(other.budget_, nullptr);
+    bytes_ = std::exchange(other.bytes_, 0);
+  }
+  return *this;
+}
+
+MemoryBudget::Reservation::~Reservation() { release(); }
+
+void MemoryBudget::Reservation::release() {
+  if (budget_) {
+    --tHeld;
+    budget_->release(bytes_);
+    budget_ = nullptr;
+    bytes_ = 0;
+  }
+}
+
+MemoryBudget::MemoryBudget(std::size_t limitBytes) : limit_(limitBytes) {
+  stats_.limitBytes = limitBytes;
+}
+
+std::size_t MemoryBudget::capacity() const {
+  std::lock_guard lock(mutex_);
+  return capacityLocked();
+}
+
+std::size_t MemoryBudget::capacityLocked() const {
+  return limit_ > stats_.residentBytes ? limit_ - stats_.residentBytes : 0;
+}
+
+MemoryBudget::Reservation MemoryBudget::admit(std::size_t bytes) {
+  std::unique_lock lock(mutex_);
+  if (bytes == 0) {
+    // Takes nothing from anyone, so it need not queue
+    ++stats_.admitted;
+    return Reservation(this, 0);
+  }
+  const auto fits = [&] { return stats_.reservedBytes + bytes <= capacityLocked(); };
+  if (bytes > capacityLocked() || (tHeld > 0 && !fits())) {
+    ++stats_.rejected;
+    return Reservation();
+  }
+  if (tHeld == 0 && (nextTicket_ != serving_ || !fits())) {
+    // Behind whoever came first, so a large request is not starved by a
+    // stream of small ones
+    const std::uint64_t ticket = nextTicket_++;
+    ++stats_.waiting;
+    released_.wait(lock, [&] {
+      return ticket == serving_ && (fits() || bytes > capacityLocked());
+    });
+    --stats_.waiting;
+    ++serving_;
+    // The next in line may fit in what is left
+    released_.notify_all();
+    if (!fits()) {
+      // The resident bytes grew while we waited; this never fits now
+      ++stats_.rejected;
+      return Reservation();
+    }
+    ++stats_.queued;
+  }
+  stats_.reservedBytes += bytes;
+  stats_.peakBytes = std::max(stats_.peakBytes, stats_.reservedBytes);
+  ++stats_.admitted;
+  return Reservation(this, bytes);
+}
+
+void MemoryBudget::release(std::size_t bytes) {
+  {
+    std::lock_guard lock(mutex_);
+    stats_.reservedBytes -= bytes;
+  }
+  released_.notify_all();
+}
+
+void MemoryBudget::setResident(std::size_t bytes) {
+  {
+    std::lock_guard lock(mutex_);
+    stats_.residentBytes = bytes;
+  }
+  // Waiters may fit now, or never again
+  released_.notify_all();
+}
+
+MemoryBudget::Stats MemoryBudget::stats() const {
+  std::lock_guard lock(mutex_);
+  return stats_;
+}
+
+} // namespace cad::concurrency
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace cad::concurrency {
+
+// Process-wide memory budget for reads. Each read asks for the bytes it
+// expects to need (see CadModelReaderPort::estimateReadBytes) before it
+// starts; requests that fit the limit are admitted, waiting in arrival order
+// while earlier ones hold the budget, and requests larger than the whole
+// limit are rejected at once so the caller can fall back to a lower-memory
+// mode. Estimates are not enforced: the budget keeps the sum of estimates of
+// the reads in flight under the limit.
+//
+// Memory held outside any read but for the life of the process (the
+// interned-name pool, say) is charged with setResident(); reads are admitted
+// against what it leaves of the limit.
+//
+// A thread that already holds a reservation is never made to wait, since it
+// may be the one the queue waits for (a pool worker running a nested read
+// from ThreadPool::await, say): it is admitted if the bytes fit right now
+// and rejected otherwise.
+//
+// Thread safety: every member may be called from any thread.
+class MemoryBudget {
+public:
+  struct Stats {
+    std::size_t limitBytes = 0;
+    std::size_t reservedBytes = 0; // held right now
+    std::size_t peakBytes = 0;     // most held at once
+    std::size_t residentBytes = 0; // charged by setResident()
+    std::size_t waiting = 0;       // requests queued right now
+    std::uint64_t admitted = 0;
+    std::uint64_t queued = 0;   // admitted after waiting
+    std::uint64_t rejected = 0; // larger than the capacity, or would have waited nested
+  };
+
+  // Bytes admitted by admit(); gives them back when destroyed, which must
+  // happen on the thread that took them. An empty reservation (rejected
+  // request) converts to false.
+  class Reservation {
+  public:
+    Reservation() = default;
+    Reservation(Reservation &&other) noexcept;
+    Reservation &operator=(Reservation &&other) noexcept;
+    ~Reservation();
+
+    explicit operator bool() const { return budget_ != nullptr; }
+    std::size_t bytes() const { return bytes_; }
+
+  private:
+    friend class MemoryBudget;
+    Reservation(MemoryBudget *budget, std::size_t bytes);
+    void release();
+
+    MemoryBudget *budget_ = nullptr;
+    std::size_t bytes_ = 0;
+  };
+
+  explicit MemoryBudget(std::size_t limitBytes);
+  MemoryBudget(const MemoryBudget &) = delete;
+  MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+  std::size_t limit() const { return limit_; }
+  // What reservations may hold: the limit less the resident bytes.
+  std::size_t capacity() const;
+
+  // Admits `bytes`, waiting behind earlier requests until they fit; returns
+  // an empty reservation if they never can, including a waiting request the
+  // capacity shrank below. Zero bytes are admitted at once.
+  Reservation admit(std::size_t bytes);
+
+  // Charges `bytes` held outside reservations against the limit, replacing
+  // the previous charge. Reservations already admitted are kept.
+  void setResident(std::size_t bytes);
+
+  Stats stats() const;
+
+private:
+  void release(std::size_t bytes);
+  std::size_t capacityLocked() const;
+
+  const std::size_t limit_;
+  mutable std::mutex mutex_;
+  std::condition_variable released_;
+  Stats stats_;
+  std::uint64_t nextTicket_ = 0; // arrival order of waiting requests
+  std::uint64_t serving_ = 0;    // the waiting request at the head
+};
+
+} // namespace cad::concurrency
@@ -0,0 +1,140 @@
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace cad::concurrency {
+
+namespace {
+
+// The pool and worker index of the calling thread, if it is a worker.
+thread_local const ThreadPool *currentPool = nullptr;
+thread_local std::size_t currentWorker = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  queues_.reserve(threads);
+  for (std::size_t i = 0; i < threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  workers_.reserve(threads);
+  for (std::size_t i = 0; i < threads; ++i) {
+    workers_.emplace_back([this, i] { workerLoop(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stopping_ = true;
+  }
+  ready_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::enqueue(Task task) {
+  Queue &queue =
+      currentPool == this ? *queues_[currentWorker] : injection_;
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  {
+    // Counted under the sleep mutex so a worker about to sleep cannot miss it.
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    queued_.fetch_add(1, std::memory_order_relaxed);
+  }
+  ready_.notify_one();
+  if (awaiting_.load(std::memory_order_relaxed) > 0) {
+    settled_.notify_all();
+  }
+}
+
+bool ThreadPool::popLocal(std::size_t self, Task &task) {
+  Queue &own = *queues_[self];
+  std::lock_guard<std::mutex> lock(own.mutex);
+  if (own.tasks.empty()) {
+    return false;
+  }
+  task = std::move(own.tasks.back());
+  own.tasks.pop_back();
+  return true;
+}
+
+bool ThreadPool::steal(std::size_t self, Task &task) {
+  {
+    std::lock_guard<std::mutex> lock(injection_.mutex);
+    if (!injection_.tasks.empty()) {
+      task = std::move(injection_.tasks.front());
+      injection_.tasks.pop_front();
+      return true;
+    }
+  }
+  // Outside threads (self 0, offset 0) may take from the first worker too.
+  for (std::size_t offset = currentPool == this ? 1 : 0;
+       offset < queues_.size(); ++offset) {
+    Queue &victim = *queues_[(self + offset) % queues_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPool::runPendingTask() {
+  bool isWorker = currentPool == this;
+  return tryRunOne(isWorker ? currentWorker : 0, isWorker);
+}
+
+bool ThreadPool::tryRunOne(std::size_t self, bool isWorker) {
+  Task task;
+  if (!(isWorker && popLocal(self, task)) && !steal(self, task)) {
+    return false;
+  }
+  queued_.fetch_sub(1, std::memory_order_relaxed);
+  task();
+  // The task may have completed a future someone awaits. Pairs with the
+  // fence in sleepUntilQueuedOr: either it sees the result or this sees it
+  // waiting, and taking the mutex means it is not between check and wait.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (awaiting_.load(std::memory_order_relaxed) > 0) {
+    { std::lock_guard<std::mutex> lock(sleepMutex_); }
+    settled_.notify_all();
+  }
+  return true;
+}
+
+void ThreadPool::sleepUntilQueuedOr(const std::function<bool()> &done) {
+  std::unique_lock<std::mutex> lock(sleepMutex_);
+  awaiting_.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  settled_.wait(lock, [&] { return queued_.load(std::memory_order_relaxed) > 0 || done(); });
+  awaiting_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ThreadPool::workerLoop(std::size_t self) {
+  currentPool = this;
+  currentWorker = self;
+  while (true) {
+    if (tryRunOne(self, true)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    ready_.wait(lock, [this] {
+      return stopping_ || queued_.load(std::memory_order_relaxed) > 0;
+    });
+    if (stopping_ && queued_.load(std::memory_order_relaxed) == 0) {
+      return; // stopping and drained
+    }
+  }
+}
+
+} // namespace cad::concurrency
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cad::concurrency {
+
+// Work-stealing pool of worker threads. Each worker owns a deque: tasks it
+// submits itself go to the back and are taken from the back (depth-first,
+// cache-warm), idle workers steal from the front of other deques (oldest,
+// usually largest, work first). Submissions from outside the pool go to a
+// shared injection queue.
+//
+// submit() may be called from any thread, including from inside a task. The
+// destructor runs every task already queued, then joins the workers.
+class ThreadPool {
+public:
+  // 0 picks std::thread::hardware_concurrency() (at least 1).
+  explicit ThreadPool(std::size_t threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  std::size_t size() const { return workers_.size(); }
+
+  // Queues `fn` and returns a future for its result; exceptions thrown by
+  // `fn` are stored in the future.
+  template <typename Fn>
+  std::future<std::invoke_result_t<Fn>> submit(Fn fn) {
+    using Result = std::invoke_result_t<Fn>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::move(fn));
+    std::future<Result> result = task->get_future();
+    enqueue([task] { (*task)(); });
+    return result;
+  }
+
+  // Waits for `future`, running queued tasks in the meantime. Tasks that wait
+  // on tasks they submitted must use this instead of future.get(), or every
+  // worker could end up blocked on work that no one is left to run. With
+  // nothing left to run it sleeps until a task is queued or one finishes.
+  template <typename T> T await(std::future<T> &future) {
+    const auto ready = [&future] {
+      return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+    while (!ready()) {
+      if (!runPendingTask()) {
+        sleepUntilQueuedOr(ready);
+      }
+    }
+    return future.get();
+  }
+
+  // Runs one queued task on the calling thread, if there is one.
+  bool runPendingTask();
+
+private:
+  using Task = std::function<void()>;
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void enqueue(Task task);
+  bool tryRunOne(std::size_t self, bool isWorker);
+  bool popLocal(std::size_t self, Task &task);
+  bool steal(std::size_t self, Task &task);
+  void workerLoop(std::size_t self);
+  void sleepUntilQueuedOr(const std::function<bool()> &done);
+
+  std::vector<std::unique_ptr<Queue>> queues_; // one per worker
+  Queue injection_;
+  std::atomic<std::size_t> queued_{0};
+
+  std::mutex sleepMutex_;
+  std::condition_variable ready_;
+  bool stopping_ = false;
+  // Threads sleeping in await(), woken by settled_ when a task is queued or
+  // finishes
+  std::atomic<std::size_t> awaiting_{0};
+  std::condition_variable settled_;
+
+  std::vector<std::thread> workers_;
+};
+
+} // namespace cad::concurrency
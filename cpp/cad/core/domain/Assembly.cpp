@@ -0,0 +1,42 @@
+#include "cpp/cad/core/domain/Assembly.hpp"
+
+#include <cstdint>
+
+namespace cad::domain {
+
+void Assembly::releaseDescendants() noexcept {
+  bool nested = false;
+  for (const auto &child : children) {
+    nested = nested || !child.children.empty();
+  }
+  if (!nested) {
+    return; // at most one more level; the implicit teardown is fine
+  }
+
+  // Released bottom-up along the last child of each node without any
+  // memory of its own, so teardown cannot fail for want of memory: the way
+  // back up is kept in the subtreeHash of each node entered, which no one
+  // reads any more, and a node is destroyed only once its children are gone.
+  static_assert(sizeof(std::uintptr_t) <= sizeof(subtreeHash));
+  Assembly *node = this;
+  while (true) {
+    if (node->children.empty()) {
+      if (node == this) {
+        return;
+      }
+      auto *parent = reinterpret_cast<Assembly *>(static_cast<std::uintptr_t>(node->subtreeHash));
+      parent->children.pop_back(); // `node`, a leaf now
+      node = parent;
+      continue;
+    }
+    Assembly &last = node->children.back();
+    if (last.children.empty()) {
+      node->children.pop_back();
+      continue;
+    }
+    last.subtreeHash = reinterpret_cast<std::uintptr_t>(node);
+    node = &last;
+  }
+}
+
+} // namespace cad::domain
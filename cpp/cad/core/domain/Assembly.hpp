@@ -2,16 +2,52 @@
 
 #include "cpp/cad/core/domain/Identifiers.hpp"
 #include "cpp/cad/core/domain/Part.hpp"
+#include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace cad::domain {
 
 struct Assembly {
+  using allocator_type = DomainAllocator;
+
   AssemblyId id;
-  std::string name;
-  std::vector<Assembly> children;
-  std::vector<Part> parts;
+  Name name;
+  std::pmr::vector<Assembly> children;
+  std::pmr::vector<Part> parts;
+  // Structural (Merkle) hash of this assembly and everything below it; zero
+  // until computeStructuralHashes() has run. See StructuralHash.hpp.
+  std::uint64_t subtreeHash = 0;
+
+  Assembly() = default;
+  explicit Assembly(const allocator_type &alloc)
+      : children(alloc), parts(alloc) {}
+  Assembly(const Assembly &other, const allocator_type &alloc)
+      : id(other.id), name(other.name),
+        children(other.children, alloc), parts(other.parts, alloc),
+        subtreeHash(other.subtreeHash) {}
+  Assembly(Assembly &&other, const allocator_type &alloc)
+      : id(other.id), name(other.name),
+        children(std::move(other.children), alloc),
+        parts(std::move(other.parts), alloc), subtreeHash(other.subtreeHash) {}
+  Assembly(const Assembly &) = default;
+  Assembly(Assembly &&) noexcept = default;
+  Assembly &operator=(const Assembly &) = default;
+  Assembly &operator=(Assembly &&) = default;
+  // Descendants are released iteratively, and without allocating: the
+  // implicit, recursive teardown of a model nested thousands of levels deep
+  // overflows the stack, and a destructor must not fail for want of memory.
+  ~Assembly() {
+    if (!children.empty()) {
+      releaseDescendants();
+    }
+  }
+
+  allocator_type get_allocator() const { return parts.get_allocator(); }
+
+private:
+  void releaseDescendants() noexcept;
 };
 
 } // namespace cad::domain
@@ -0,0 +1,74 @@
+#include "cpp/cad/core/domain/Geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cad::domain {
+
+void BoundingBox::add(const Point3 &point) {
+  if (empty) {
+    min = max = point;
+    empty = false;
+    return;
+  }
+  for (int i = 0; i < 3; ++i) {
+    min[i] = std::min(min[i], point[i]);
+    max[i] = std::max(max[i], point[i]);
+  }
+}
+
+Point3 Placement::apply(const Point3 &point) const {
+  Point3 out;
+  for (int r = 0; r < 3; ++r) {
+    out[r] = linear[3 * r] * point[0] + linear[3 * r + 1] * point[1] +
+             linear[3 * r + 2] * point[2] + translation[r];
+  }
+  return out;
+}
+
+double Placement::determinant() const {
+  const auto &m = linear;
+  return m[0] * (m[4] * m[8] - m[5] * m[7]) -
+         m[1] * (m[3] * m[8] - m[5] * m[6]) +
+         m[2] * (m[3] * m[7] - m[4] * m[6]);
+}
+
+bool Placement::isIdentity() const {
+  static const Placement identity;
+  return linear == identity.linear && translation == identity.translation;
+}
+
+Placement compose(const Placement &outer, const Placement &inner) {
+  Placement result;
+  for (int r = 0; r < 3; ++r) {
+    for (int c = 0; c < 3; ++c) {
+      result.linear[3 * r + c] = outer.linear[3 * r] * inner.linear[c] +
+                                 outer.linear[3 * r + 1] * inner.linear[3 + c] +
+                                 outer.linear[3 * r + 2] * inner.linear[6 + c];
+    }
+  }
+  result.translation = outer.apply(inner.translation);
+  return result;
+}
+
+GeometricProperties place(const GeometricProperties &prototype,
+                          const Placement &placement) {
+  if (placement.isIdentity()) {
+    return prototype;
+  }
+  GeometricProperties placed;
+  if (!prototype.bounds.empty) {
+    const BoundingBox &box = prototype.bounds;
+    for (int corner = 0; corner < 8; ++corner) {
+      placed.bounds.add(placement.apply({corner & 1 ? box.max[0] : box.min[0],
+                                         corner & 2 ? box.max[1] : box.min[1],
+                                         corner & 4 ? box.max[2] : box.min[2]}));
+    }
+  }
+  double volumeScale = std::abs(placement.determinant());
+  placed.volume = prototype.volume * volumeScale;
+  placed.area = prototype.area * std::cbrt(volumeScale * volumeScale);
+  return placed;
+}
+
+} // namespace cad::domain
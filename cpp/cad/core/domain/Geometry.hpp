@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+
+namespace cad::domain {
+
+using Point3 = std::array<double, 3>;
+
+// Axis-aligned bounding box; empty until a point is added.
+struct BoundingBox {
+  Point3 min{};
+  Point3 max{};
+  bool empty = true;
+
+  void add(const Point3 &point);
+};
+
+// Affine map from a prototype's coordinates into model coordinates:
+// p' = linear * p + translation, with `linear` stored row-major.
+struct Placement {
+  std::array<double, 9> linear{1, 0, 0, 0, 1, 0, 0, 0, 1};
+  Point3 translation{0, 0, 0};
+
+  Point3 apply(const Point3 &point) const;
+  double determinant() const;
+  bool isIdentity() const;
+};
+
+// The placement applying `inner` first, then `outer`: how a part placed by
+// `inner` in a sub-model lands in a model that places the sub-model by
+// `outer`.
+Placement compose(const Placement &outer, const Placement &inner);
+
+// Geometry of a part in model coordinates.
+struct GeometricProperties {
+  BoundingBox bounds;
+  double volume = 0;
+  double area = 0;
+};
+
+// The properties of a prototype instance placed by `placement`. The box
+// bounds the eight transformed corners of the prototype box; volume and area
+// scale with the placement's scale factor, which is exact for the rigid and
+// uniformly scaled placements CAD assemblies use.
+GeometricProperties place(const GeometricProperties &prototype,
+                          const Placement &placement);
+
+} // namespace cad::domain
@@ -1,15 +1,24 @@
 #pragma once
 
-#include <string>
+#include <memory_resource>
+
+#include "cpp/cad/core/domain/Name.hpp"
 
 namespace cad::domain {
 
+// Domain types are allocator-aware: every string and vector in a model takes
+// its memory from the resource the model was built with (see ModelArena).
+// Copies without an explicit allocator use the default resource; moves keep
+// the source's resource. Names and identifiers are interned instead (see
+// Name.hpp) and take no memory from the model.
+using DomainAllocator = std::pmr::polymorphic_allocator<char>;
+
 struct PartId {
-  std::string value;
+  Name value;
 };
 
 struct AssemblyId {
-  std::string value;
+  Name value;
 };
 
 } // namespace cad::domain
@@ -0,0 +1,85 @@
+#include "cpp/cad/core/domain/LazyModel.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#include "cpp/cad/core/domain/Traversal.hpp"
+
+namespace cad::domain {
+
+namespace {
+
+class CompleteModel final : public LazyModel {
+public:
+  explicit CompleteModel(Model &&model) : LazyModel(std::move(model)) {}
+
+private:
+  void expandNode(std::size_t, Assembly &, std::vector<std::size_t> &) override {}
+};
+
+// Expands each assembly as it is entered, so its children can be pushed.
+struct Expander {
+  LazyModel &model;
+
+  bool enter(const Assembly *assembly, std::size_t) {
+    model.expand(*assembly);
+    return true;
+  }
+  template <typename Push> void children(const Assembly *assembly, Push &&push) {
+    for (const auto &child : assembly->children) {
+      push(&child);
+    }
+  }
+  void leave(const Assembly *, std::size_t) {}
+};
+
+} // namespace
+
+LazyModel::LazyModel(const DomainAllocator &alloc, std::size_t rootKey)
+    : model_(alloc) {
+  pending_.emplace(&model_.root, Pending{&model_.root, rootKey});
+}
+
+LazyModel::LazyModel(Model &&model) : model_(std::move(model)) {}
+
+std::unique_ptr<LazyModel> LazyModel::fromModel(Model &&model) {
+  return std::make_unique<CompleteModel>(std::move(model));
+}
+
+void LazyModel::expand(const Assembly &assembly) {
+  auto found = pending_.find(&assembly);
+  if (found == pending_.end()) {
+    return;
+  }
+  Pending pending = found->second;
+
+  childKeys_.clear();
+  try {
+    expandNode(pending.key, *pending.node, childKeys_);
+    if (childKeys_.size() != pending.node->children.size()) {
+      throw std::logic_error("LazyModel: one key per child expected");
+    }
+  } catch (...) {
+    // The node stays pending, and empty, so that a retry rebuilds it rather
+    // than leaving a partly filled assembly that reads as complete
+    pending.node->parts.clear();
+    pending.node->children.clear();
+    throw;
+  }
+  pending_.erase(found);
+  // Children are registered only now that their vector no longer grows
+  for (std::size_t i = 0; i < childKeys_.size(); ++i) {
+    Assembly &child = pending.node->children[i];
+    pending_.emplace(&child, Pending{&child, childKeys_[i]});
+  }
+  ++expanded_;
+}
+
+Model LazyModel::expandAll() && {
+  Expander expander{*this};
+  DepthFirstTraversal<const Assembly *>().run(&model_.root, expander);
+  pending_.clear();
+  return std::move(model_);
+}
+
+} // namespace cad::domain
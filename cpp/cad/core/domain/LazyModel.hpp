@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "cpp/cad/core/domain/Model.hpp"
+
+namespace cad::domain {
+
+// A model whose assemblies are built on first access. Opening one yields
+// just the root, without parts or children; expand() fills in an assembly's
+// parts and its child assemblies, which are in turn unexpanded, and caches
+// them. The model's own memory therefore follows what has been expanded;
+// what a reader keeps to expand the rest is up to the reader.
+//
+// Nodes never move once created, so references from root() and from an
+// expanded assembly's children stay valid for the model's lifetime. An
+// expanded assembly is an ordinary Assembly and reads exactly like the
+// eagerly read one; expandAll() turns the whole model into a Model.
+//
+// Not synchronized: expanding is a write, so one thread (the UI thread,
+// say) uses a model at a time.
+class LazyModel {
+public:
+  virtual ~LazyModel() = default;
+  LazyModel(const LazyModel &) = delete;
+  LazyModel &operator=(const LazyModel &) = delete;
+
+  // A model that is already complete, for readers without a lazy path.
+  static std::unique_ptr<LazyModel> fromModel(Model &&model);
+
+  const Assembly &root() const { return model_.root; }
+
+  // Builds the parts and children of `assembly`, a node of this model, on
+  // the first call; later calls return at once. If building throws, the
+  // assembly is left empty and unexpanded, and the next call tries again.
+  void expand(const Assembly &assembly);
+  bool isExpanded(const Assembly &assembly) const {
+    return pending_.count(&assembly) == 0;
+  }
+  // Assemblies expanded on demand so far.
+  std::size_t expandedCount() const { return expanded_; }
+
+  // Expands every remaining assembly and hands the complete model over.
+  Model expandAll() &&;
+
+protected:
+  // An unexpanded root; `rootKey` identifies it to expandNode().
+  LazyModel(const DomainAllocator &alloc, std::size_t rootKey);
+  explicit LazyModel(Model &&model);
+
+  // The root, for readers to name before it is expanded.
+  Assembly &rootNode() { return model_.root; }
+
+  // Fills in the parts and children of the node the reader knows as `key`
+  // and appends the key of every child, in child order. Children only need
+  // their id and name; they are expanded by later calls.
+  virtual void expandNode(std::size_t key, Assembly &node,
+                          std::vector<std::size_t> &childKeys) = 0;
+
+private:
+  struct Pending {
+    Assembly *node;
+    std::size_t key;
+  };
+
+  Model model_;
+  std::unordered_map<const Assembly *, Pending> pending_;
+  std::vector<std::size_t> childKeys_; // scratch for expandNode
+  std::size_t expanded_ = 0;
+};
+
+} // namespace cad::domain
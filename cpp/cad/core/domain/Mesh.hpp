@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cad::domain {
+
+// Triangle mesh of one prototype, in the prototype's own coordinates.
+struct Mesh {
+  std::vector<float> positions;       // x, y, z per vertex
+  std::vector<std::uint32_t> indices; // three per triangle, outward-facing
+
+  std::size_t vertexCount() const { return positions.size() / 3; }
+  std::size_t triangleCount() const { return indices.size() / 3; }
+};
+
+} // namespace cad::domain
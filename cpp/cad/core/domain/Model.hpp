@@ -5,7 +5,20 @@
 namespace cad::domain {
 
 struct Model {
+  using allocator_type = DomainAllocator;
+
   Assembly root;
+
+  Model() = default;
+  explicit Model(const allocator_type &alloc) : root(alloc) {}
+  Model(const Model &other, const allocator_type &alloc)
+      : root(other.root, alloc) {}
+  Model(const Model &) = default;
+  Model(Model &&) noexcept = default;
+  Model &operator=(const Model &) = default;
+  Model &operator=(Model &&) = default;
+
+  allocator_type get_allocator() const { return root.get_allocator(); }
 };
 
 } // namespace cad::domain
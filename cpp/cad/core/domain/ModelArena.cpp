@@ -0,0 +1,22 @@
+#include "cpp/cad/core/domain/ModelArena.hpp"
+
+#include <new>
+#include <utility>
+
+namespace cad::domain {
+
+ModelArena::ModelArena(std::size_t initialBytes,
+                       std::pmr::memory_resource *upstream)
+    : arena_(initialBytes, upstream) {}
+
+Model &ModelArena::adopt(Model &&model) {
+  void *storage = arena_.allocate(sizeof(Model), alignof(Model));
+  if (model.get_allocator().resource()->is_equal(arena_)) {
+    model_ = new (storage) Model(std::move(model));
+  } else {
+    model_ = new (storage) Model(model, DomainAllocator(&arena_));
+  }
+  return *model_;
+}
+
+} // namespace cad::domain
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+#include "cpp/cad/core/domain/Model.hpp"
+
+namespace cad::domain {
+
+// Owns a monotonic arena and the model placed in it. A reader builds the
+// model straight into resource() (see CadModelReaderPort); adopt() then moves
+// it into arena storage. Destroying the arena releases the whole model by
+// returning its chunks upstream: no per-node destructor or deallocation runs,
+// so teardown costs one free per chunk instead of several per node.
+//
+// One arena per parse; it is not synchronized, so concurrent parses (e.g.
+// batch workers) each use their own and never contend on the global heap
+// for node allocations.
+class ModelArena {
+public:
+  static constexpr std::size_t kDefaultInitialBytes = 64 * 1024;
+
+  explicit ModelArena(
+      std::size_t initialBytes = kDefaultInitialBytes,
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+  ModelArena(const ModelArena &) = delete;
+  ModelArena &operator=(const ModelArena &) = delete;
+
+  std::pmr::memory_resource *resource() { return &arena_; }
+
+  // Takes `model` into the arena: O(1) when it was built from resource(), a
+  // deep copy into the arena otherwise. Adopting again abandons the previous
+  // model; its memory is reclaimed with the arena.
+  Model &adopt(Model &&model);
+
+  // The adopted model, or nullptr.
+  Model *model() { return model_; }
+
+private:
+  std::pmr::monotonic_buffer_resource arena_;
+  // Constructed in arena_ and deliberately never destroyed; see above.
+  Model *model_ = nullptr;
+};
+
+} // namespace cad::domain
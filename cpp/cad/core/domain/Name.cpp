@@ -0,0 +1,103 @@
+#include "cpp/cad/core/domain/Name.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+
+namespace cad::domain {
+
+namespace {
+
+// Enough shards that readers on every core rarely wait for one another.
+constexpr std::size_t kShards = 64;
+
+// Memory held by the whole pool, see Name::poolBytes
+std::atomic<std::size_t> gPoolBytes{0};
+
+// An index entry: a hash node (next pointer, key, value, cached hash) and
+// about one bucket. An estimate; the index is not allocated through us.
+constexpr std::size_t kIndexBytesPerEntry = sizeof(std::string_view) + 4 * sizeof(void *);
+
+// Hands the arena its chunks from the heap and counts them
+class ChunkCounter final : public std::pmr::memory_resource {
+  void *do_allocate(std::size_t size, std::size_t alignment) override {
+    void *p = std::pmr::new_delete_resource()->allocate(size, alignment);
+    gPoolBytes.fetch_add(size, std::memory_order_relaxed);
+    return p;
+  }
+  void do_deallocate(void *p, std::size_t size, std::size_t alignment) override {
+    gPoolBytes.fetch_sub(size, std::memory_order_relaxed);
+    std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+struct Shard {
+  std::mutex mutex;
+  // Keys view the entries' own text
+  std::unordered_map<std::string_view, const Name::Entry *> entries;
+  ChunkCounter chunks;
+  std::pmr::monotonic_buffer_resource storage{&chunks};
+};
+
+std::array<Shard, kShards> &shards() {
+  // Never destroyed: Names may outlive static destruction elsewhere
+  static auto *pool = new std::array<Shard, kShards>();
+  return *pool;
+}
+
+std::uint64_t prefixRank(std::string_view text) {
+  std::uint64_t rank = 0;
+  for (std::size_t i = 0; i < 8; ++i) {
+    rank <<= 8;
+    if (i < text.size()) {
+      rank |= static_cast<unsigned char>(text[i]);
+    }
+  }
+  return rank;
+}
+
+} // namespace
+
+const Name::Entry *Name::intern(std::string_view text) {
+  if (text.empty()) {
+    return &kEmpty;
+  }
+  std::size_t hash = std::hash<std::string_view>()(text);
+  Shard &shard = shards()[(hash >> 7) % kShards];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto found = shard.entries.find(text);
+  if (found != shard.entries.end()) {
+    return found->second;
+  }
+
+  // The entry and its text share one block from the shard's arena
+  void *block = shard.storage.allocate(sizeof(Entry) + text.size() + 1, alignof(Entry));
+  char *data = static_cast<char *>(block) + sizeof(Entry);
+  std::memcpy(data, text.data(), text.size());
+  data[text.size()] = '\0';
+  const Entry *entry = new (block) Entry{prefixRank(text), text.size(), data};
+  shard.entries.emplace(std::string_view(data, text.size()), entry);
+  gPoolBytes.fetch_add(kIndexBytesPerEntry, std::memory_order_relaxed);
+  return entry;
+}
+
+Name::PoolStats Name::poolStats() {
+  PoolStats stats{0, 0};
+  for (Shard &shard : shards()) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    stats.names += shard.entries.size();
+  }
+  stats.bytes = poolBytes();
+  return stats;
+}
+
+std::size_t Name::poolBytes() noexcept { return gPoolBytes.load(std::memory_order_relaxed); }
+
+} // namespace cad::domain
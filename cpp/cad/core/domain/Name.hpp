@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace cad::domain {
+
+// Interned text for part and assembly names and identifiers. Equal strings
+// share one entry in a process-wide pool, so a Name is one pointer: copies
+// are free, equality compares pointers, and the name repeated on every bolt
+// of an assembly is stored once. Constructing a Name interns its text; the
+// pool is sharded and safe to use from any number of threads.
+//
+// Entries live until the process exits, so the pool only grows: by the
+// distinct names of every model read, whether or not the model is still
+// around. A long-running process reading many unrelated models should watch
+// poolStats(); reads under a MemoryBudget count the pool against its limit
+// (see admitRead).
+class Name {
+public:
+  struct Entry {
+    // The first eight bytes, big-endian: ordering by rank agrees with
+    // ordering by text, so most comparisons never touch the characters.
+    std::uint64_t rank;
+    std::size_t size;
+    const char *data; // null-terminated
+  };
+
+  Name() noexcept : entry_(&kEmpty) {}
+  Name(std::string_view text) : entry_(intern(text)) {}
+  Name(const char *text) : Name(std::string_view(text)) {}
+  template <typename Alloc>
+  Name(const std::basic_string<char, std::char_traits<char>, Alloc> &text)
+      : Name(std::string_view(text)) {}
+
+  std::string_view view() const noexcept { return {entry_->data, entry_->size}; }
+  operator std::string_view() const noexcept { return view(); }
+  const char *c_str() const noexcept { return entry_->data; }
+  const char *data() const noexcept { return entry_->data; }
+  std::size_t size() const noexcept { return entry_->size; }
+  bool empty() const noexcept { return entry_->size == 0; }
+  std::uint64_t rank() const noexcept { return entry_->rank; }
+
+  friend bool operator==(Name a, Name b) noexcept { return a.entry_ == b.entry_; }
+  friend bool operator!=(Name a, Name b) noexcept { return a.entry_ != b.entry_; }
+  friend bool operator<(Name a, Name b) noexcept {
+    if (a.entry_->rank != b.entry_->rank) {
+      return a.entry_->rank < b.entry_->rank;
+    }
+    return a.entry_ != b.entry_ && a.view() < b.view();
+  }
+  friend bool operator>(Name a, Name b) noexcept { return b < a; }
+  friend bool operator<=(Name a, Name b) noexcept { return !(b < a); }
+  friend bool operator>=(Name a, Name b) noexcept { return !(a < b); }
+
+  // Comparing with plain text neither interns nor allocates.
+  template <typename Text, typename = std::enable_if_t<
+                               std::is_convertible_v<const Text &, std::string_view> &&
+                               !std::is_same_v<Text, Name>>>
+  friend bool operator==(const Name &a, const Text &b) {
+    return a.view() == std::string_view(b);
+  }
+  template <typename Text, typename = std::enable_if_t<
+                               std::is_convertible_v<const Text &, std::string_view> &&
+                               !std::is_same_v<Text, Name>>>
+  friend bool operator==(const Text &a, const Name &b) {
+    return std::string_view(a) == b.view();
+  }
+  template <typename Text, typename = std::enable_if_t<
+                               std::is_convertible_v<const Text &, std::string_view> &&
+                               !std::is_same_v<Text, Name>>>
+  friend bool operator!=(const Name &a, const Text &b) {
+    return !(a == b);
+  }
+  template <typename Text, typename = std::enable_if_t<
+                               std::is_convertible_v<const Text &, std::string_view> &&
+                               !std::is_same_v<Text, Name>>>
+  friend bool operator!=(const Text &a, const Name &b) {
+    return !(b == a);
+  }
+
+  friend std::ostream &operator<<(std::ostream &out, Name name) {
+    return out << name.view();
+  }
+
+  // Distinct strings interned so far and the memory the pool holds for
+  // them: entries, text, arena chunks and the index.
+  struct PoolStats {
+    std::size_t names;
+    std::size_t bytes;
+  };
+  static PoolStats poolStats();
+  // poolStats().bytes without visiting the shards.
+  static std::size_t poolBytes() noexcept;
+
+private:
+  static const Entry *intern(std::string_view text);
+
+  static constexpr Entry kEmpty{0, 0, ""};
+  const Entry *entry_;
+};
+
+} // namespace cad::domain
+
+template <> struct std::hash<cad::domain::Name> {
+  std::size_t operator()(cad::domain::Name name) const noexcept {
+    return std::hash<const void *>()(name.data());
+  }
+};
@@ -1,13 +1,48 @@
 #pragma once
 
+#include "cpp/cad/core/domain/Geometry.hpp"
 #include "cpp/cad/core/domain/Identifiers.hpp"
+#include <optional>
 #include <string>
+#include <utility>
 
 namespace cad::domain {
 
 struct Part {
+  using allocator_type = DomainAllocator;
+
   PartId id;
-  std::string name;
+  Name name;
+  // Shared geometry this part instantiates; parts with the same prototype
+  // differ only by placement. Empty when the reader has no geometry.
+  std::pmr::string prototypeId;
+  // Where the prototype sits in model coordinates.
+  Placement placement;
+  // Set by MeasureModelPartsUseCase; see Geometry.hpp.
+  std::optional<GeometricProperties> geometry;
+  // Locator of the file that defines this part, relative to the file naming
+  // it; empty for parts defined in place. ResolveReferencesUseCase replaces
+  // such parts with the referenced model.
+  std::pmr::string reference;
+
+  Part() = default;
+  explicit Part(const allocator_type &alloc)
+      : prototypeId(alloc), reference(alloc) {}
+  Part(const Part &other, const allocator_type &alloc)
+      : id(other.id), name(other.name),
+        prototypeId(other.prototypeId, alloc), placement(other.placement),
+        geometry(other.geometry), reference(other.reference, alloc) {}
+  Part(Part &&other, const allocator_type &alloc)
+      : id(other.id), name(other.name),
+        prototypeId(std::move(other.prototypeId), alloc),
+        placement(other.placement), geometry(other.geometry),
+        reference(std::move(other.reference), alloc) {}
+  Part(const Part &) = default;
+  Part(Part &&) noexcept = default;
+  Part &operator=(const Part &) = default;
+  Part &operator=(Part &&) = default;
+
+  allocator_type get_allocator() const { return prototypeId.get_allocator(); }
 };
 
 } // namespace cad::domain
@@ -0,0 +1,178 @@
+#include "cpp/cad/core/domain/StructuralHash.hpp"
+
+#include <algorithm>
+#include <future>
+#include <utility>
+#include <vector>
+
+#include "cpp/cad/core/domain/SubtreeSizes.hpp"
+#include "cpp/cad/core/domain/Traversal.hpp"
+
+namespace cad::domain {
+
+namespace {
+
+constexpr std::uint64_t kPartSeed = 0x5041525400000000ULL;     // "PART"
+constexpr std::uint64_t kAssemblySeed = 0x4153534d00000000ULL; // "ASSM"
+constexpr std::uint64_t kPartsSalt = 0x7061727473ULL;
+constexpr std::uint64_t kChildrenSalt = 0x6368696c64ULL;
+
+// Never split below this many nodes (assemblies plus parts): a task must
+// outweigh its scheduling cost.
+constexpr std::size_t kMinGrain = 2048;
+// Aim for this many tasks per worker so stealing can even out imbalance.
+constexpr std::size_t kTasksPerWorker = 16;
+
+std::uint64_t combineNode(const Assembly &assembly) {
+  std::uint64_t partsSum = 0;
+  for (const auto &part : assembly.parts) {
+    partsSum += hashing::mix(partHash(part));
+  }
+  std::uint64_t childrenSum = 0;
+  for (const auto &child : assembly.children) {
+    childrenSum += hashing::mix(child.subtreeHash);
+  }
+
+  std::uint64_t h = hashing::hashBytes(assembly.id.value, kAssemblySeed);
+  h = hashing::hashBytes(assembly.name, h);
+  h = hashing::mix(h ^ hashing::mix(partsSum ^ kPartsSalt));
+  h = hashing::mix(h ^ hashing::mix(childrenSum ^ kChildrenSalt));
+  return h;
+}
+
+// Children are hashed before their parent, which is the post-order leave.
+struct SubtreeHasher {
+  bool enter(Assembly *, std::size_t) { return true; }
+
+  template <typename Push> void children(Assembly *assembly, Push &&push) {
+    for (auto &child : assembly->children) {
+      push(&child);
+    }
+  }
+
+  void leave(Assembly *assembly, std::size_t) {
+    assembly->subtreeHash = combineNode(*assembly);
+  }
+};
+
+void hashSubtree(Assembly &assembly, DepthFirstTraversal<Assembly *> &traversal) {
+  SubtreeHasher hasher;
+  traversal.run(&assembly, hasher);
+}
+
+// Hashes a large subtree on a pool. As in ParallelLister, the largest large
+// child of each node is continued in this task and every other large child
+// is spawned, so a spawned child is at most half its parent's size and task
+// nesting stays within log2(size / grain); runs of small children are
+// batched into tasks of about `grain` nodes. Nodes on the continued path
+// are combined bottom-up once the tasks below them are done.
+class ParallelHasher {
+public:
+  ParallelHasher(cad::concurrency::ThreadPool &pool, const SubtreeSizes &sizes,
+                 std::size_t grain)
+      : pool_(pool), sizes_(sizes), grain_(grain) {}
+
+  void hash(Assembly &top) {
+    DepthFirstTraversal<Assembly *> traversal;
+    std::vector<std::pair<Assembly *, std::vector<std::future<void>>>> path;
+    try {
+      for (Assembly *node = &top; node;) {
+        Assembly *continuation = nullptr;
+        for (auto &child : node->children) {
+          if (sizes_.atLeast(child, grain_) &&
+              (!continuation || sizes_.sizeOf(child) > sizes_.sizeOf(*continuation))) {
+            continuation = &child;
+          }
+        }
+        path.emplace_back(node, schedule(*node, continuation, traversal));
+        node = continuation;
+      }
+      for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        for (auto &task : it->second) {
+          pool_.await(task);
+        }
+        it->first->subtreeHash = combineNode(*it->first);
+      }
+    } catch (...) {
+      // Tasks still in flight write into the tree; let them finish first
+      for (auto &entry : path) {
+        for (auto &task : entry.second) {
+          if (task.valid()) {
+            try {
+              pool_.await(task);
+            } catch (...) {
+            }
+          }
+        }
+      }
+      throw;
+    }
+  }
+
+private:
+  // Spawns the children of `node` other than `continuation` and hashes a
+  // trailing run of small ones in place.
+  std::vector<std::future<void>> schedule(Assembly &node, Assembly *continuation,
+                                          DepthFirstTraversal<Assembly *> &traversal) {
+    std::vector<std::future<void>> tasks;
+    std::vector<Assembly *> batch;
+    std::size_t batchSize = 0;
+    for (auto &child : node.children) {
+      if (&child == continuation) {
+        continue;
+      }
+      if (sizes_.atLeast(child, grain_)) {
+        tasks.push_back(pool_.submit([this, &child] { hash(child); }));
+        continue;
+      }
+      batch.push_back(&child);
+      batchSize += sizes_.sizeOf(child);
+      if (batchSize >= grain_) {
+        tasks.push_back(pool_.submit([batch = std::move(batch)] {
+          DepthFirstTraversal<Assembly *> batchTraversal;
+          for (Assembly *small : batch) {
+            hashSubtree(*small, batchTraversal);
+          }
+        }));
+        batch.clear();
+        batchSize = 0;
+      }
+    }
+    for (Assembly *small : batch) {
+      hashSubtree(*small, traversal);
+    }
+    return tasks;
+  }
+
+  cad::concurrency::ThreadPool &pool_;
+  const SubtreeSizes &sizes_;
+  const std::size_t grain_;
+};
+
+} // namespace
+
+std::uint64_t partHash(const Part &part) {
+  std::uint64_t h = hashing::hashBytes(part.id.value, kPartSeed);
+  return hashing::hashBytes(part.name, h);
+}
+
+void computeStructuralHashes(Assembly &root) {
+  DepthFirstTraversal<Assembly *> traversal;
+  hashSubtree(root, traversal);
+}
+
+void computeStructuralHashes(Assembly &root, cad::concurrency::ThreadPool &pool) {
+  if (pool.size() < 2) {
+    computeStructuralHashes(root);
+    return;
+  }
+  const SubtreeSizes sizes(root, kMinGrain);
+  const std::size_t grain = std::max(kMinGrain, sizes.total() / (pool.size() * kTasksPerWorker));
+  if (sizes.total() < 2 * grain) {
+    computeStructuralHashes(root);
+    return;
+  }
+  ParallelHasher(pool, sizes, grain).hash(root);
+}
+
+} // namespace cad::domain
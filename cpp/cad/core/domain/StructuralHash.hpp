@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/Assembly.hpp"
+#include "cpp/cad/core/domain/Part.hpp"
+
+namespace cad::domain {
+
+// Structural hashing of a model tree.
+//
+// An assembly's subtreeHash covers its id, its name, its parts and the hashes
+// of its child assemblies. Sibling order does not contribute (siblings are
+// combined commutatively), matching the name-sorted order used for listing,
+// so two subtrees with equal hashes list identically.
+namespace hashing {
+
+// splitmix64 finalizer; spreads combined values over all 64 bits.
+inline std::uint64_t mix(std::uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// FNV-1a over the bytes of `s`, seeded with `seed`. The length is folded in so
+// that ("ab", "c") and ("a", "bc") hash differently when chained.
+inline std::uint64_t hashBytes(std::string_view s, std::uint64_t seed) {
+  std::uint64_t h = seed ^ 0xcbf29ce484222325ULL;
+  for (unsigned char c : s) {
+    h ^= c;
+    h *= 0x100000001b3ULL;
+  }
+  return mix(h ^ s.size());
+}
+
+} // namespace hashing
+
+std::uint64_t partHash(const Part &part);
+
+// Computes subtreeHash for `root` and every assembly below it in a single
+// bottom-up pass.
+void computeStructuralHashes(Assembly &root);
+
+// As above, with large trees split into subtrees hashed as tasks on `pool`;
+// the hashes do not change. The caller may itself be a worker of `pool`.
+void computeStructuralHashes(Assembly &root, cad::concurrency::ThreadPool &pool);
+
+} // namespace cad::domain
@@ -0,0 +1,83 @@
+#include "cpp/cad/core/domain/SubtreeSizes.hpp"
+
+#include <vector>
+
+#include "cpp/cad/core/domain/Traversal.hpp"
+
+namespace cad::domain {
+
+namespace {
+
+std::size_t nodeCount(const Assembly &assembly) {
+  return 1 + assembly.parts.size();
+}
+
+// Post-order visitor recording the size of every subtree with at least
+// `minimum` nodes.
+class SubtreeSizer {
+public:
+  SubtreeSizer(std::size_t minimum,
+               std::unordered_map<const Assembly *, std::size_t> &sizes)
+      : minimum_(minimum), sizes_(sizes) {}
+
+  bool enter(const Assembly *assembly, std::size_t) {
+    open_.push_back(nodeCount(*assembly));
+    return true;
+  }
+
+  template <typename Push>
+  void children(const Assembly *assembly, Push &&push) {
+    for (const auto &child : assembly->children) {
+      push(&child);
+    }
+  }
+
+  void leave(const Assembly *assembly, std::size_t) {
+    std::size_t size = open_.back();
+    open_.pop_back();
+    if (size >= minimum_) {
+      sizes_.emplace(assembly, size);
+    }
+    if (open_.empty()) {
+      total_ = size;
+    } else {
+      open_.back() += size;
+    }
+  }
+
+  std::size_t total() const { return total_; }
+
+private:
+  std::size_t minimum_;
+  std::unordered_map<const Assembly *, std::size_t> &sizes_;
+  std::vector<std::size_t> open_; // running sizes of the entered ancestors
+  std::size_t total_ = 0;
+};
+
+} // namespace
+
+SubtreeSizes::SubtreeSizes(const Assembly &root, std::size_t minimum) {
+  SubtreeSizer sizer(minimum, sizes_);
+  DepthFirstTraversal<const Assembly *>().run(&root, sizer);
+  total_ = sizer.total();
+}
+
+std::size_t SubtreeSizes::sizeOf(const Assembly &assembly) const {
+  auto it = sizes_.find(&assembly);
+  if (it != sizes_.end()) {
+    return it->second;
+  }
+  std::size_t count = 0;
+  std::vector<const Assembly *> pending{&assembly};
+  while (!pending.empty()) {
+    const Assembly *node = pending.back();
+    pending.pop_back();
+    count += nodeCount(*node);
+    for (const auto &child : node->children) {
+      pending.push_back(&child);
+    }
+  }
+  return count;
+}
+
+} // namespace cad::domain
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+
+#include "cpp/cad/core/domain/Assembly.hpp"
+
+namespace cad::domain {
+
+// Sizes of the subtrees of a model, in nodes (assemblies plus parts), for
+// splitting work over a pool. One post-order pass records every subtree of
+// at least `minimum` nodes; smaller ones are counted when asked for, which
+// is cheap as they are small. The model must not change while in use.
+class SubtreeSizes {
+public:
+  SubtreeSizes(const Assembly &root, std::size_t minimum);
+
+  // Nodes in the whole model.
+  std::size_t total() const { return total_; }
+  std::size_t sizeOf(const Assembly &assembly) const;
+  // Whether the subtree has at least `size` nodes, for `size` >= minimum.
+  bool atLeast(const Assembly &assembly, std::size_t size) const {
+    auto it = sizes_.find(&assembly);
+    return it != sizes_.end() && it->second >= size;
+  }
+
+private:
+  std::unordered_map<const Assembly *, std::size_t> sizes_;
+  std::size_t total_ = 0;
+};
+
+} // namespace cad::domain
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace cad::domain {
+
+// Depth-first traversal with an explicit stack, so tree depth is bounded by
+// memory rather than by the call stack. `Node` is a cheap handle (a pointer,
+// an OCCT label, ...). The stack is kept between runs, so a traversal reused
+// across many trees stops allocating once it has seen the deepest one.
+//
+// The visitor provides:
+//
+//   bool enter(const Node &node, std::size_t depth);
+//       Pre-order. Return false to skip the node's children (and its leave).
+//   template <typename Push> void children(const Node &node, Push &&push);
+//       Calls push(child) for each child, in the order they are to be visited.
+//   void leave(const Node &node, std::size_t depth);
+//       Post-order, after every child has been left.
+//
+// Each node costs one push and one pop for enter and, if entered, one more
+// pair for leave; there is no recursion and no per-node allocation.
+template <typename Node> class DepthFirstTraversal {
+public:
+  template <typename Visitor> void run(const Node &root, Visitor &visitor) {
+    stack_.clear();
+    stack_.push_back({root, 0, false});
+    while (!stack_.empty()) {
+      Entry entry = stack_.back();
+      stack_.pop_back();
+      if (entry.leaving) {
+        visitor.leave(entry.node, entry.depth);
+        continue;
+      }
+      if (!visitor.enter(entry.node, entry.depth)) {
+        continue;
+      }
+      stack_.push_back({entry.node, entry.depth, true});
+      std::size_t firstChild = stack_.size();
+      visitor.children(entry.node, [this, &entry](const Node &child) {
+        stack_.push_back({child, entry.depth + 1, false});
+      });
+      // Children were pushed in visiting order; the first must be on top.
+      std::reverse(stack_.begin() + static_cast<std::ptrdiff_t>(firstChild),
+                   stack_.end());
+    }
+  }
+
+private:
+  struct Entry {
+    Node node;
+    std::size_t depth;
+    bool leaving;
+  };
+  std::vector<Entry> stack_;
+};
+
+} // namespace cad::domain
@@ -1,13 +1,65 @@
 #pragma once
 
 #include "cpp/cad/core/domain/Model.hpp"
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+#include <cstddef>
 #include <istream>
+#include <memory_resource>
 
 namespace cad::ports {
 
+// Thread safety: readModelFromStream may be called concurrently on one
+// instance from any number of threads, each with its own stream. Adapters
+// keep no per-call state in members; shared caches are internally
+// synchronized.
 struct CadModelReaderPort {
   virtual ~CadModelReaderPort() = default;
-  virtual cad::domain::Model readModelFromStream(std::istream &stream) = 0;
+
+  // Builds the model with every node allocated from `resource`, so a caller
+  // can place a whole parse in an arena (see cad::domain::ModelArena).
+  // Adapters construct nodes with the model's allocator rather than moving
+  // them in afterwards: a move across resources is a deep copy.
+  virtual cad::domain::Model
+  readModelFromStream(std::istream &stream,
+                      std::pmr::memory_resource *resource) = 0;
+
+  // As above, reporting to `progress` and throwing ReadCancelled once it is
+  // cancelled. Readers that do not override this only check before and
+  // after the whole read.
+  virtual cad::domain::Model
+  readModelFromStream(std::istream &stream, std::pmr::memory_resource *resource,
+                      ProgressPort &progress) {
+    throwIfCancelled(&progress);
+    cad::domain::Model model = readModelFromStream(stream, resource);
+    throwIfCancelled(&progress);
+    return model;
+  }
+
+  cad::domain::Model readModelFromStream(std::istream &stream) {
+    return readModelFromStream(stream, std::pmr::get_default_resource());
+  }
+
+  // Peak bytes a read of `stream` is expected to allocate, model included,
+  // judged from the bytes left in it and the format; 0 when unknown (the
+  // stream cannot seek, say). Used to admit reads against a MemoryBudget.
+  // Leaves the stream where it was.
+  virtual std::size_t estimateReadBytes(std::istream & /*stream*/) { return 0; }
 };
 
+// Bytes from the position of `stream` to its end, or 0 when it cannot seek
+// (pipes, decompressing streams). The position is left unchanged.
+inline std::size_t remainingStreamBytes(std::istream &stream) {
+  std::streambuf *buffer = stream.rdbuf();
+  if (!buffer) {
+    return 0;
+  }
+  const auto here = buffer->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+  if (here == std::streampos(-1)) {
+    return 0;
+  }
+  const auto end = buffer->pubseekoff(0, std::ios_base::end, std::ios_base::in);
+  buffer->pubseekpos(here, std::ios_base::in);
+  return end == std::streampos(-1) || end < here ? 0 : static_cast<std::size_t>(end - here);
+}
+
 } // namespace cad::ports
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <istream>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/Geometry.hpp"
+#include "cpp/cad/core/domain/Model.hpp"
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+
+namespace cad::ports {
+
+struct MeasuredModel {
+  cad::domain::Model model;
+  // Properties of each prototype in its own coordinates, keyed by
+  // Part::prototypeId.
+  std::unordered_map<std::string, cad::domain::GeometricProperties> prototypes;
+};
+
+// Reads a model together with the geometry of its parts. Each distinct
+// prototype is measured once, however many parts instantiate it; placing the
+// result at every instance is left to the caller (MeasureModelPartsUseCase).
+//
+// Thread safety: as CadModelReaderPort.
+struct GeometricPropertiesPort {
+  virtual ~GeometricPropertiesPort() = default;
+
+  // Prototypes are measured concurrently on `pool`. Calling from a worker of
+  // `pool` is allowed; implementations wait with ThreadPool::await.
+  virtual MeasuredModel
+  readMeasuredModel(std::istream &stream, cad::concurrency::ThreadPool &pool,
+                    std::pmr::memory_resource *resource) = 0;
+
+  // As above, reporting to `progress` and throwing ReadCancelled once it is
+  // cancelled. Implementations that do not override this only check before
+  // and after the whole read.
+  virtual MeasuredModel
+  readMeasuredModel(std::istream &stream, cad::concurrency::ThreadPool &pool,
+                    std::pmr::memory_resource *resource, ProgressPort &progress) {
+    throwIfCancelled(&progress);
+    MeasuredModel measured = readMeasuredModel(stream, pool, resource);
+    throwIfCancelled(&progress);
+    return measured;
+  }
+};
+
+} // namespace cad::ports
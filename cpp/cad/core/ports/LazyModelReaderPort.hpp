@@ -0,0 +1,31 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <memory_resource>
+
+#include "cpp/cad/core/domain/LazyModel.hpp"
+
+namespace cad::ports {
+
+// Readers that can open a model without building it; see LazyModel.
+//
+// Thread safety: openLazyModel may be called concurrently, like
+// CadModelReaderPort::readModelFromStream; each returned model is then used
+// by one thread at a time.
+class LazyModelReaderPort {
+public:
+  virtual ~LazyModelReaderPort() = default;
+
+  // Reads `stream` to the end, keeping whatever index the reader needs to
+  // expand assemblies later; the stream is not used afterwards. Expanded
+  // nodes take their memory from `resource`, which must outlive the model.
+  virtual std::unique_ptr<cad::domain::LazyModel>
+  openLazyModel(std::istream &stream, std::pmr::memory_resource *resource) = 0;
+
+  std::unique_ptr<cad::domain::LazyModel> openLazyModel(std::istream &stream) {
+    return openLazyModel(stream, std::pmr::get_default_resource());
+  }
+};
+
+} // namespace cad::ports
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace cad::ports {
+
+// One node of a model listing. Views are valid only during the call.
+struct ListingRecord {
+  enum class Kind { Assembly, Part };
+
+  Kind kind;
+  // Names from the root down to this node, each preceded by '/'
+  std::string_view path;
+  // 0 for the root; a part is one deeper than its assembly
+  std::size_t depth;
+  std::string_view id;
+  std::string_view name;
+};
+
+// Receives a listing record by record, in listing order, as the model is
+// traversed, so nothing is collected in between.
+//
+// Thread safety: none; one writer is fed by one thread.
+struct ListingWriterPort {
+  virtual ~ListingWriterPort() = default;
+
+  virtual void addRecord(const ListingRecord &record) = 0;
+  // Completes the output; nothing may be added afterwards.
+  virtual void finish() = 0;
+};
+
+} // namespace cad::ports
@@ -6,6 +6,8 @@ namespace cad::ports {
 
 enum class LogLevel { Trace, Debug, Info, Warn, Error };
 
+// Thread safety: log may be called concurrently; each message is written
+// whole, never interleaved with another.
 struct LoggerPort {
   virtual ~LoggerPort() = default;
   virtual void log(LogLevel level, const std::string &message) = 0;
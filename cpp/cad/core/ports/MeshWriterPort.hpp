@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+#include "cpp/cad/core/domain/Geometry.hpp"
+#include "cpp/cad/core/domain/Mesh.hpp"
+
+namespace cad::ports {
+
+// Incremental writer of an instanced mesh file. Meshes are written as they
+// arrive and need not be kept; instances refer to a mesh added earlier.
+//
+// Thread safety: none; one writer is fed by one thread.
+struct MeshWriterPort {
+  virtual ~MeshWriterPort() = default;
+
+  virtual void addMesh(const std::string &prototypeId,
+                       const cad::domain::Mesh &mesh) = 0;
+  virtual void addInstance(const std::string &prototypeId,
+                           const std::string &name,
+                           const cad::domain::Placement &placement) = 0;
+  // Completes the file; nothing may be added afterwards.
+  virtual void finish() = 0;
+};
+
+} // namespace cad::ports
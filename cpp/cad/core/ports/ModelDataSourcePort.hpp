@@ -3,12 +3,23 @@
 #include <istream>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace cad::ports {
 
+// Thread safety: open may be called concurrently on one instance. Every call
+// returns an independent stream that the caller owns and that stays valid
+// after the adapter is destroyed. A returned stream itself is used by one
+// thread at a time.
 struct ModelDataSourcePort {
   virtual ~ModelDataSourcePort() = default;
   virtual std::unique_ptr<std::istream> open(const std::string &locator) = 0;
+
+  // Hint that the given locators will be opened soon, in this order, e.g.
+  // the files of a batch or the next level of references. Sources that can
+  // start fetching early do; the hint is never required for correctness,
+  // and the default ignores it. May be called concurrently with open().
+  virtual void prefetch(const std::vector<std::string> &) {}
 };
 
 } // namespace cad::ports
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cad::ports {
+
+// Strings laid out end to end, as columnar formats store them: row i is
+// bytes[offsets[i], offsets[i + 1]). Offsets are 32-bit, so one column holds
+// at most 2 GiB of text.
+struct StringColumn {
+  std::vector<std::int32_t> offsets{0};
+  std::string bytes;
+
+  std::size_t size() const { return offsets.size() - 1; }
+
+  void push_back(std::string_view text) {
+    if (text.size() > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()) -
+                          bytes.size()) {
+      throw std::length_error("string column over 2 GiB");
+    }
+    bytes.append(text);
+    offsets.push_back(static_cast<std::int32_t>(bytes.size()));
+  }
+};
+
+// Consecutive rows of the part table, one per part, stored column by column.
+// `paths` indexes the dictionary of assembly paths given to begin().
+struct PartTableBatch {
+  StringColumn ids;
+  StringColumn names;
+  std::vector<std::int32_t> paths;
+  std::vector<std::int32_t> depths;
+  std::vector<std::int32_t> instanceCounts;
+
+  std::size_t rows() const { return paths.size(); }
+};
+
+// Incremental writer of a columnar part table. The dictionary of assembly
+// paths comes first, then batches in row order.
+//
+// Thread safety: none; one writer is fed by one thread.
+struct PartTableWriterPort {
+  virtual ~PartTableWriterPort() = default;
+
+  virtual void begin(const StringColumn &paths) = 0;
+  virtual void addBatch(const PartTableBatch &batch) = 0;
+  // Completes the table; nothing may be added afterwards.
+  virtual void finish() = 0;
+};
+
+} // namespace cad::ports
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace cad::ports {
+
+// Thrown by a read that stopped because its ProgressPort was cancelled.
+// Everything the read allocated is released while it unwinds.
+class ReadCancelled : public std::runtime_error {
+public:
+  ReadCancelled() : std::runtime_error("read cancelled") {}
+};
+
+// Receives the progress of one read and decides whether it goes on.
+//
+// Thread safety: a read may report from any thread it uses (OCCT transfers
+// run partly in parallel), so implementations synchronize report();
+// cancelled() may be polled concurrently with it.
+struct ProgressPort {
+  virtual ~ProgressPort() = default;
+
+  // `done` of `total` units of `phase` are complete; `total` is 0 when
+  // unknown. Units are phase-specific ("bytes", "entities", ...).
+  virtual void report(std::string_view phase, std::uint64_t done,
+                      std::uint64_t total) = 0;
+
+  // Polled between units of work; once true the read throws ReadCancelled.
+  virtual bool cancelled() = 0;
+};
+
+// Readers report and poll at least once per this many entities.
+inline constexpr std::uint64_t kProgressInterval = 1024;
+
+inline void throwIfCancelled(ProgressPort *progress) {
+  if (progress && progress->cancelled()) {
+    throw ReadCancelled();
+  }
+}
+
+} // namespace cad::ports
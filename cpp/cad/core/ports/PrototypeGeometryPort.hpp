@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/core/domain/Geometry.hpp"
+#include "cpp/cad/core/domain/Model.hpp"
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+
+namespace cad::ports {
+
+// Placement-independent summary of a prototype's shape: equal shapes have
+// equal signatures up to rounding, so only prototypes whose signatures agree
+// need comparing point by point.
+struct ShapeSignature {
+  // Solids, faces, edges and vertices
+  std::array<std::size_t, 4> topology{};
+  // Radii of gyration about the principal axes, ascending: the extent of the
+  // shape in a frame that turns with it, unlike an axis-aligned box
+  std::array<double, 3> extents{};
+  double volume = 0;
+  double area = 0;
+};
+
+// A read model together with the shapes behind its prototypes.
+//
+// Thread safety: signature() and match() may run concurrently as long as no
+// two calls at the same time involve the same prototype.
+class PrototypeGeometry {
+public:
+  virtual ~PrototypeGeometry() = default;
+
+  virtual cad::domain::Model &model() = 0;
+
+  // Every Part::prototypeId with a shape, sorted.
+  virtual std::vector<std::string> prototypeIds() const = 0;
+
+  // std::nullopt when the shape cannot be measured.
+  virtual std::optional<ShapeSignature> signature(const std::string &prototypeId) const = 0;
+
+  // The rigid placement carrying the shape of `from` onto the shape of `to`
+  // to within `tolerance` (model units), or std::nullopt when there is none
+  // or it cannot be found.
+  virtual std::optional<cad::domain::Placement>
+  match(const std::string &from, const std::string &to, double tolerance) const = 0;
+};
+
+// Reads a model and keeps the shapes behind its parts for comparison, e.g.
+// by FindDuplicateGeometryUseCase.
+//
+// Thread safety: as CadModelReaderPort.
+struct PrototypeGeometryPort {
+  virtual ~PrototypeGeometryPort() = default;
+
+  // The model is allocated from `resource`, which must outlive the result.
+  virtual std::unique_ptr<PrototypeGeometry>
+  readPrototypeGeometry(std::istream &stream, std::pmr::memory_resource *resource) = 0;
+
+  // As above, reporting to `progress` and throwing ReadCancelled once it is
+  // cancelled. Implementations that do not override this only check before
+  // and after the whole read.
+  virtual std::unique_ptr<PrototypeGeometry>
+  readPrototypeGeometry(std::istream &stream, std::pmr::memory_resource *resource,
+                        ProgressPort &progress) {
+    throwIfCancelled(&progress);
+    std::unique_ptr<PrototypeGeometry> geometry = readPrototypeGeometry(stream, resource);
+    throwIfCancelled(&progress);
+    return geometry;
+  }
+};
+
+} // namespace cad::ports
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <memory_resource>
+#include <string>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/Mesh.hpp"
+#include "cpp/cad/core/domain/Model.hpp"
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+
+namespace cad::ports {
+
+struct TessellationOptions {
+  // Maximum chord deviation, in model units
+  double linearDeflection = 0.1;
+  // Maximum angle between adjacent facet normals, in radians
+  double angularDeflection = 0.5;
+};
+
+// Reads a model and meshes the geometry behind its parts. Each distinct
+// prototype (Part::prototypeId) is meshed once, however many parts
+// instantiate it.
+//
+// Thread safety: as CadModelReaderPort.
+struct TessellationPort {
+  using MeshSink =
+      std::function<void(const std::string &prototypeId, cad::domain::Mesh &&mesh)>;
+
+  virtual ~TessellationPort() = default;
+
+  // Prototypes are meshed concurrently on `pool`. Each mesh is handed to
+  // `sink` on the calling thread as soon as it is its turn and is not kept
+  // afterwards; implementations bound how many finished meshes wait, so
+  // memory does not grow with the model.
+  virtual cad::domain::Model
+  readTessellatedModel(std::istream &stream, const TessellationOptions &options,
+                       cad::concurrency::ThreadPool &pool, const MeshSink &sink,
+                       std::pmr::memory_resource *resource) = 0;
+
+  // As above, reporting to `progress` and throwing ReadCancelled once it is
+  // cancelled; meshes already handed to `sink` stay with it. Implementations
+  // that do not override this only check before and after the whole read.
+  virtual cad::domain::Model
+  readTessellatedModel(std::istream &stream, const TessellationOptions &options,
+                       cad::concurrency::ThreadPool &pool, const MeshSink &sink,
+                       std::pmr::memory_resource *resource, ProgressPort &progress) {
+    throwIfCancelled(&progress);
+    cad::domain::Model model = readTessellatedModel(stream, options, pool, sink, resource);
+    throwIfCancelled(&progress);
+    return model;
+  }
+};
+
+} // namespace cad::ports
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/Model.hpp"
+#include "cpp/cad/core/ports/ListingWriterPort.hpp"
+#include "cpp/cad/core/ports/LoggerPort.hpp"
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+#include "cpp/cad/core/usecase/ModelListing.hpp"
+#include "cpp/cad/core/usecase/ReadBudget.hpp"
+
+namespace cad::usecase {
+
+// Listing use case composed at compile time. Each parameter is either a port
+// (ModelDataSourcePort, CadModelReaderPort, LoggerPort), giving ordinary
+// virtual dispatch, or a concrete adapter type. Adapters are declared `final`,
+// so with concrete types every call below binds statically and can be
+// inlined:
+//
+//   FakeModelDataSourceAdapter source;
+//   FakeCadModelReaderAdapter reader;
+//   FakeLoggerAdapter logger;
+//   BasicListModelPartsUseCase usecase(source, reader, logger);
+//
+// ListModelPartsUseCase is the port-typed instantiation.
+template <typename Source, typename Reader, typename Logger>
+class BasicListModelPartsUseCase {
+  static_assert(
+      std::is_convertible_v<
+          decltype(std::declval<Source &>().open(std::declval<std::string>())),
+          std::unique_ptr<std::istream>>,
+      "Source must provide open(locator) -> std::unique_ptr<std::istream>");
+  static_assert(
+      std::is_same_v<decltype(std::declval<Reader &>().readModelFromStream(
+                         std::declval<std::istream &>(),
+                         std::declval<std::pmr::memory_resource *>())),
+                     cad::domain::Model>,
+      "Reader must provide readModelFromStream(std::istream&, "
+      "std::pmr::memory_resource*) -> Model");
+  static_assert(
+      std::is_void_v<decltype(std::declval<Logger &>().log(
+          cad::ports::LogLevel::Info, std::declval<std::string>()))>,
+      "Logger must provide log(LogLevel, std::string)");
+
+public:
+  // With `listingPool`, large models are rendered in parallel on it (the
+  // output is identical either way). With a budget, each read is admitted
+  // against it first (see admitRead); the output does not change either.
+  BasicListModelPartsUseCase(Source &source, Reader &reader, Logger &logger,
+                             cad::concurrency::ThreadPool *listingPool = nullptr,
+                             ReadBudget budget = {})
+      : source_(source), reader_(reader), logger_(logger),
+        listingPool_(listingPool), budget_(budget) {}
+
+  // With `progress`, the read reports to it and stops once it is cancelled
+  // (by a deadline, say); the partial model is freed and an ERROR line
+  // returned.
+  std::vector<std::string> list(const std::string &locator,
+                                cad::ports::ProgressPort *progress = nullptr) const {
+    std::vector<std::string> lines;
+    std::string error = withModel(locator, progress, [&](const cad::domain::Model &model) {
+      lines = listingPool_ ? listModelLines(model, *listingPool_) : listModelLines(model);
+    });
+    if (!error.empty()) {
+      return {error};
+    }
+    return lines;
+  }
+
+  // Streams the listing to `writer` as records, in list() order, and
+  // finishes it. Returns nothing on success, else the ERROR line list()
+  // would return; the writer is then left unfinished.
+  std::vector<std::string> write(const std::string &locator,
+                                 cad::ports::ListingWriterPort &writer,
+                                 cad::ports::ProgressPort *progress = nullptr) const {
+    std::string error = withModel(locator, progress, [&](const cad::domain::Model &model) {
+      writeModelListing(model, writer);
+      writer.finish();
+    });
+    if (!error.empty()) {
+      return {error};
+    }
+    return {};
+  }
+
+private:
+  // readWithinBudget with this use case's ports and budget
+  template <typename Use>
+  std::string withModel(const std::string &locator, cad::ports::ProgressPort *progress,
+                        Use &&use) const {
+    return readWithinBudget(budget_, source_, reader_, logger_, locator, progress,
+                            std::forward<Use>(use));
+  }
+
+  Source &source_;
+  Reader &reader_;
+  Logger &logger_;
+  cad::concurrency::ThreadPool *listingPool_;
+  ReadBudget budget_;
+};
+
+} // namespace cad::usecase
@@ -0,0 +1,84 @@
+#include "cpp/cad/core/usecase/BrowseModelUseCase.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#include "cpp/cad/core/domain/ModelArena.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Part;
+using cad::ports::LogLevel;
+
+namespace cad::usecase {
+
+namespace {
+
+// Sorted exactly as ModelListing sorts siblings, ties included
+template <typename Node>
+std::vector<const Node *> sortedByName(const std::pmr::vector<Node> &nodes) {
+  std::vector<const Node *> sorted;
+  sorted.reserve(nodes.size());
+  for (const auto &node : nodes) {
+    sorted.push_back(&node);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+                   [](const Node *a, const Node *b) { return a->name < b->name; });
+  return sorted;
+}
+
+} // namespace
+
+BrowseModelUseCase::BrowseModelUseCase(cad::ports::ModelDataSourcePort &source,
+                                       cad::ports::LazyModelReaderPort &reader,
+                                       cad::ports::LoggerPort &logger)
+    : source_(source), reader_(reader), logger_(logger) {}
+
+std::vector<std::string>
+BrowseModelUseCase::browse(const std::string &locator,
+                           const std::vector<std::string> &path) const {
+  logger_.log(LogLevel::Info, std::string("Opening locator: ") + locator);
+  auto stream = source_.open(locator);
+  if (!stream || !(*stream)) {
+    logger_.log(LogLevel::Error, "Failed to open locator: " + locator);
+    return {"ERROR: failed to open locator"};
+  }
+
+  try {
+    cad::domain::ModelArena arena;
+    auto model = reader_.openLazyModel(*stream, arena.resource());
+    const Assembly *assembly = &model->root();
+    for (const auto &name : path) {
+      model->expand(*assembly);
+      auto children = sortedByName(assembly->children);
+      auto child = std::find_if(children.begin(), children.end(),
+                                [&name](const Assembly *c) { return c->name == name; });
+      if (child == children.end()) {
+        logger_.log(LogLevel::Error, "No assembly named " + name + " in " +
+                                         std::string(assembly->name));
+        return {"ERROR: no assembly named " + name};
+      }
+      assembly = *child;
+    }
+    model->expand(*assembly);
+    logger_.log(LogLevel::Debug, "Expanded " + std::to_string(model->expandedCount()) +
+                                     " assemblies");
+
+    std::vector<std::string> lines;
+    lines.push_back("Assembly: ");
+    lines.back() += assembly->name;
+    for (const Part *part : sortedByName(assembly->parts)) {
+      lines.push_back("  Part: ");
+      lines.back() += part->name;
+    }
+    for (const Assembly *child : sortedByName(assembly->children)) {
+      lines.push_back("  Assembly: ");
+      lines.back() += child->name;
+    }
+    return lines;
+  } catch (const std::exception &e) {
+    logger_.log(LogLevel::Error, "Failed to read locator: " + locator + ": " + e.what());
+    return {"ERROR: failed to read model"};
+  }
+}
+
+} // namespace cad::usecase
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cpp/cad/core/ports/LazyModelReaderPort.hpp"
+#include "cpp/cad/core/ports/LoggerPort.hpp"
+#include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
+
+namespace cad::usecase {
+
+// Shows one assembly of a model, as a browser expanding a single node does.
+// The model is opened lazily, so only the assemblies on the path to the
+// shown one are built, whatever the size of the model.
+class BrowseModelUseCase {
+public:
+  BrowseModelUseCase(cad::ports::ModelDataSourcePort &source,
+                     cad::ports::LazyModelReaderPort &reader,
+                     cad::ports::LoggerPort &logger);
+
+  // The assembly reached from the root through child assemblies named by
+  // `path` (the first in listing order where names repeat), then its parts
+  // and child assemblies sorted as ListModelPartsUseCase sorts them; or an
+  // ERROR line.
+  std::vector<std::string> browse(const std::string &locator,
+                                  const std::vector<std::string> &path) const;
+
+private:
+  cad::ports::ModelDataSourcePort &source_;
+  cad::ports::LazyModelReaderPort &reader_;
+  cad::ports::LoggerPort &logger_;
+};
+
+} // namespace cad::usecase
@@ -0,0 +1,360 @@
+#include "cpp/cad/core/usecase/DiffModelsUseCase.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "cpp/cad/core/domain/ModelArena.hpp"
+#include "cpp/cad/core/domain/StructuralHash.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::Part;
+using cad::ports::LogLevel;
+
+namespace cad::usecase {
+
+namespace {
+
+// Keys are interned, so matching hashes and compares pointers, not text.
+cad::domain::Name keyOf(const Part &part) {
+  return part.id.value.empty() ? part.name : part.id.value;
+}
+
+cad::domain::Name keyOf(const Assembly &assembly) {
+  return assembly.id.value.empty() ? assembly.name : assembly.id.value;
+}
+
+std::uint64_t hashOf(const Part &part) { return cad::domain::partHash(part); }
+
+std::uint64_t hashOf(const Assembly &assembly) { return assembly.subtreeHash; }
+
+ModelChange::Node nodeKindOf(const Part &) { return ModelChange::Node::Part; }
+
+ModelChange::Node nodeKindOf(const Assembly &) {
+  return ModelChange::Node::Assembly;
+}
+
+std::string joinPath(const std::string &parent, std::string_view name) {
+  std::string path = parent;
+  if (!path.empty()) {
+    path += '/';
+  }
+  path += name;
+  return path;
+}
+
+// A node that lost its match among its siblings; it may still turn out to
+// have moved elsewhere in the tree.
+template <typename Node> struct Unmatched {
+  const Node *node;
+  std::string parentPath;
+};
+
+template <typename Node>
+using UnmatchedByKey =
+    std::unordered_map<cad::domain::Name, std::vector<Unmatched<Node>>>;
+
+class Differ {
+public:
+  ModelDiff run(const Assembly &before, const Assembly &after) {
+    compareAssemblies(before, after, "", "", true);
+    drain();
+    resolveMoves();
+    reportLeftovers(removedAssemblies_, ModelChange::Kind::Removed);
+    reportLeftovers(addedAssemblies_, ModelChange::Kind::Added);
+    reportLeftovers(removedParts_, ModelChange::Kind::Removed);
+    reportLeftovers(addedParts_, ModelChange::Kind::Added);
+    return std::move(diff_);
+  }
+
+private:
+  // A pair of matched assemblies whose subtrees still have to be compared.
+  struct Pending {
+    const Assembly *before;
+    const Assembly *after;
+    std::string beforeParent;
+    std::string afterParent;
+    bool reportRename;
+  };
+
+  // Queues a comparison; drain() works through the queue with an explicit
+  // stack, so deeply nested changes cannot overflow the call stack.
+  void compareAssemblies(const Assembly &before, const Assembly &after,
+                         const std::string &beforeParent,
+                         const std::string &afterParent, bool reportRename) {
+    if (before.subtreeHash == after.subtreeHash) {
+      return;
+    }
+    pending_.push_back({&before, &after, beforeParent, afterParent, reportRename});
+  }
+
+  void drain() {
+    while (!pending_.empty()) {
+      Pending next = std::move(pending_.back());
+      pending_.pop_back();
+      expand(*next.before, *next.after, next.beforeParent, next.afterParent,
+             next.reportRename);
+    }
+  }
+
+  void expand(const Assembly &before, const Assembly &after,
+              const std::string &beforeParent, const std::string &afterParent,
+              bool reportRename) {
+    ++diff_.expandedAssemblies;
+
+    if (reportRename && before.name != after.name) {
+      emit(ModelChange::Kind::Renamed, after, before.name, afterParent,
+           beforeParent);
+    }
+
+    std::string beforePath = joinPath(beforeParent, before.name);
+    std::string afterPath = joinPath(afterParent, after.name);
+
+    matchSiblings(before.parts, after.parts, beforePath, afterPath,
+                  removedParts_, addedParts_,
+                  [&](const Part &b, const Part &a) {
+                    // Same key, same name: only an identifier came or went
+                    if (b.name != a.name) {
+                      emit(ModelChange::Kind::Renamed, a, b.name, afterPath,
+                           beforePath);
+                    }
+                  });
+    matchSiblings(before.children, after.children, beforePath, afterPath,
+                  removedAssemblies_, addedAssemblies_,
+                  [&](const Assembly &b, const Assembly &a) {
+                    compareAssemblies(b, a, beforePath, afterPath, true);
+                  });
+  }
+
+  // Pairs up siblings by key. Pairs with equal hashes are identical and
+  // dropped; other pairs go to `onChanged`. Whatever stays unpaired is parked
+  // in the removed/added maps for move detection.
+  template <typename Node, typename OnChanged>
+  void matchSiblings(const std::pmr::vector<Node> &before,
+                     const std::pmr::vector<Node> &after,
+                     const std::string &beforePath,
+                     const std::string &afterPath,
+                     UnmatchedByKey<Node> &removed, UnmatchedByKey<Node> &added,
+                     OnChanged onChanged) {
+    std::unordered_map<cad::domain::Name, std::vector<std::size_t>> afterByKey;
+    afterByKey.reserve(after.size());
+    for (std::size_t i = 0; i < after.size(); ++i) {
+      afterByKey[keyOf(after[i])].push_back(i);
+    }
+
+    std::vector<bool> afterMatched(after.size(), false);
+    for (const auto &b : before) {
+      auto it = afterByKey.find(keyOf(b));
+      if (it == afterByKey.end() || it->second.empty()) {
+        removed[keyOf(b)].push_back({&b, beforePath});
+        continue;
+      }
+
+      // With duplicate keys prefer an identical candidate so that unchanged
+      // duplicates pair with each other.
+      auto &candidates = it->second;
+      std::uint64_t hb = hashOf(b);
+      auto pick = std::find_if(
+          candidates.begin(), candidates.end(),
+          [&](std::size_t i) { return hashOf(after[i]) == hb; });
+      if (pick == candidates.end()) {
+        pick = candidates.begin();
+      }
+      std::size_t index = *pick;
+      candidates.erase(pick);
+      afterMatched[index] = true;
+
+      if (hashOf(after[index]) != hb) {
+        onChanged(b, after[index]);
+      }
+    }
+
+    for (std::size_t i = 0; i < after.size(); ++i) {
+      if (!afterMatched[i]) {
+        added[keyOf(after[i])].push_back({&after[i], afterPath});
+      }
+    }
+  }
+
+  // Nodes removed in one place and added in another under the same key have
+  // moved. Comparing a moved assembly can uncover further unmatched nodes, so
+  // keep pairing until nothing new turns up.
+  void resolveMoves() {
+    bool progressed = true;
+    while (progressed) {
+      progressed = resolveMoves(removedParts_, addedParts_, [](auto &, auto &) {});
+      progressed |= resolveMoves(
+          removedAssemblies_, addedAssemblies_,
+          [this](const Unmatched<Assembly> &b, const Unmatched<Assembly> &a) {
+            compareAssemblies(*b.node, *a.node, b.parentPath, a.parentPath,
+                              false);
+          });
+      drain();
+    }
+  }
+
+  template <typename Node, typename OnMoved>
+  bool resolveMoves(UnmatchedByKey<Node> &removed, UnmatchedByKey<Node> &added,
+                    OnMoved onMoved) {
+    std::vector<std::pair<Unmatched<Node>, Unmatched<Node>>> moves;
+    for (auto &[key, removedNodes] : removed) {
+      auto it = added.find(key);
+      if (it == added.end()) {
+        continue;
+      }
+      auto &addedNodes = it->second;
+      while (!removedNodes.empty() && !addedNodes.empty()) {
+        moves.emplace_back(removedNodes.back(), addedNodes.back());
+        removedNodes.pop_back();
+        addedNodes.pop_back();
+      }
+    }
+
+    for (const auto &[b, a] : moves) {
+      emit(ModelChange::Kind::Moved, *a.node,
+           b.node->name != a.node->name ? std::string(b.node->name)
+                                        : std::string(),
+           a.parentPath, b.parentPath);
+      onMoved(b, a);
+    }
+    return !moves.empty();
+  }
+
+  template <typename Node>
+  void reportLeftovers(const UnmatchedByKey<Node> &nodes,
+                       ModelChange::Kind kind) {
+    for (const auto &[key, entries] : nodes) {
+      for (const auto &entry : entries) {
+        if (kind == ModelChange::Kind::Removed) {
+          emit(kind, *entry.node, "", "", entry.parentPath);
+        } else {
+          emit(kind, *entry.node, "", entry.parentPath, "");
+        }
+      }
+    }
+  }
+
+  template <typename Node>
+  void emit(ModelChange::Kind kind, const Node &node,
+            std::string_view previousName, std::string path,
+            std::string previousPath) {
+    ModelChange change{kind,
+                       nodeKindOf(node),
+                       std::string(keyOf(node)),
+                       std::string(node.name),
+                       std::string(previousName),
+                       std::move(path),
+                       std::move(previousPath)};
+    diff_.changes.push_back(std::move(change));
+  }
+
+  ModelDiff diff_;
+  std::vector<Pending> pending_;
+  UnmatchedByKey<Part> removedParts_;
+  UnmatchedByKey<Part> addedParts_;
+  UnmatchedByKey<Assembly> removedAssemblies_;
+  UnmatchedByKey<Assembly> addedAssemblies_;
+};
+
+const std::string &displayPath(const ModelChange &change) {
+  return change.kind == ModelChange::Kind::Removed ? change.previousPath
+                                                   : change.path;
+}
+
+} // namespace
+
+DiffModelsUseCase::DiffModelsUseCase(cad::ports::ModelDataSourcePort &source,
+                                     cad::ports::CadModelReaderPort &reader,
+                                     cad::ports::LoggerPort &logger,
+                                     cad::concurrency::ThreadPool *hashingPool)
+    : source_(source), reader_(reader), logger_(logger), hashingPool_(hashingPool) {}
+
+ModelDiff DiffModelsUseCase::compare(const Model &before, const Model &after) {
+  ModelDiff diff = Differ().run(before.root, after.root);
+  std::sort(diff.changes.begin(), diff.changes.end(),
+            [](const ModelChange &a, const ModelChange &b) {
+              return std::tie(displayPath(a), a.node, a.name, a.kind) <
+                     std::tie(displayPath(b), b.node, b.name, b.kind);
+            });
+  return diff;
+}
+
+std::string DiffModelsUseCase::formatChange(const ModelChange &change) {
+  std::string node =
+      change.node == ModelChange::Node::Assembly ? "Assembly: " : "Part: ";
+  switch (change.kind) {
+  case ModelChange::Kind::Added:
+    return "Added " + node + change.name + " (" + change.path + ")";
+  case ModelChange::Kind::Removed:
+    return "Removed " + node + change.name + " (" + change.previousPath + ")";
+  case ModelChange::Kind::Renamed:
+    return "Renamed " + node + change.previousName + " -> " + change.name +
+           " (" + change.path + ")";
+  case ModelChange::Kind::Moved: {
+    std::string name = change.previousName.empty()
+                           ? change.name
+                           : change.previousName + " -> " + change.name;
+    return "Moved " + node + name + " (" + change.previousPath + " -> " +
+           change.path + ")";
+  }
+  }
+  return "";
+}
+
+std::vector<std::string>
+DiffModelsUseCase::diff(const std::string &beforeLocator,
+                        const std::string &afterLocator,
+                        cad::ports::ProgressPort *progress) const {
+  // Both revisions are dropped wholesale once the diff is formatted
+  cad::domain::ModelArena arenas[2];
+  Model *models[2] = {nullptr, nullptr};
+  const std::string *locators[2] = {&beforeLocator, &afterLocator};
+  // The second revision can be fetched while the first is parsed
+  source_.prefetch({beforeLocator, afterLocator});
+  for (int i = 0; i < 2; ++i) {
+    logger_.log(LogLevel::Info, std::string("Opening locator: ") + *locators[i]);
+    auto stream = source_.open(*locators[i]);
+    if (!stream || !(*stream)) {
+      logger_.log(LogLevel::Error, "Failed to open locator: " + *locators[i]);
+      return {"ERROR: failed to open locator"};
+    }
+    try {
+      models[i] = &arenas[i].adopt(
+          progress ? reader_.readModelFromStream(*stream, arenas[i].resource(), *progress)
+                   : reader_.readModelFromStream(*stream, arenas[i].resource()));
+    } catch (const cad::ports::ReadCancelled &) {
+      logger_.log(LogLevel::Warn, "Cancelled reading locator: " + *locators[i]);
+      return {"ERROR: read cancelled"};
+    } catch (const std::exception &e) {
+      logger_.log(LogLevel::Error, "Failed to read locator: " + *locators[i] +
+                                       ": " + e.what());
+      return {"ERROR: failed to read model"};
+    }
+    if (hashingPool_) {
+      cad::domain::computeStructuralHashes(models[i]->root, *hashingPool_);
+    } else {
+      cad::domain::computeStructuralHashes(models[i]->root);
+    }
+  }
+
+  ModelDiff result = compare(*models[0], *models[1]);
+  logger_.log(LogLevel::Debug, "Expanded " +
+                                   std::to_string(result.expandedAssemblies) +
+                                   " changed assemblies");
+  if (result.empty()) {
+    return {"No differences"};
+  }
+
+  std::vector<std::string> lines;
+  lines.reserve(result.changes.size());
+  for (const auto &change : result.changes) {
+    lines.push_back(formatChange(change));
+  }
+  return lines;
+}
+
+} // namespace cad::usecase
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/Model.hpp"
+#include "cpp/cad/core/ports/CadModelReaderPort.hpp"
+#include "cpp/cad/core/ports/LoggerPort.hpp"
+#include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+
+namespace cad::usecase {
+
+struct ModelChange {
+  enum class Kind { Added, Removed, Renamed, Moved };
+  enum class Node { Assembly, Part };
+
+  Kind kind;
+  Node node;
+  // Identity used to match nodes across revisions: the id when the reader
+  // provides one, otherwise the name.
+  std::string key;
+  std::string name;
+  std::string previousName; // Renamed, and Moved when the name also changed
+  std::string path;         // parent path in the "after" model
+  std::string previousPath; // parent path in the "before" model
+};
+
+struct ModelDiff {
+  std::vector<ModelChange> changes;
+  // Number of assembly pairs whose hashes differed and had to be expanded.
+  // Identical subtrees are skipped without being counted.
+  std::size_t expandedAssemblies = 0;
+
+  bool empty() const { return changes.empty(); }
+};
+
+class DiffModelsUseCase {
+public:
+  // With `hashingPool`, the structural hashes of large models are computed
+  // on it; the result does not change.
+  DiffModelsUseCase(cad::ports::ModelDataSourcePort &source,
+                    cad::ports::CadModelReaderPort &reader,
+                    cad::ports::LoggerPort &logger,
+                    cad::concurrency::ThreadPool *hashingPool = nullptr);
+
+  // Reads both revisions and returns one line per change, ordered by path.
+  // Both reads report to `progress`, if given, and stop once it is cancelled.
+  std::vector<std::string> diff(const std::string &beforeLocator,
+                                const std::string &afterLocator,
+                                cad::ports::ProgressPort *progress = nullptr) const;
+
+  // Compares two models whose structural hashes have already been computed
+  // (see cad::domain::computeStructuralHashes). Subtrees with equal hashes
+  // are skipped, so the cost follows the changed paths, not the model size.
+  static ModelDiff compare(const cad::domain::Model &before,
+                           const cad::domain::Model &after);
+
+  static std::string formatChange(const ModelChange &change);
+
+private:
+  cad::ports::ModelDataSourcePort &source_;
+  cad::ports::CadModelReaderPort &reader_;
+  cad::ports::LoggerPort &logger_;
+  cad::concurrency::ThreadPool *hashingPool_;
+};
+
+} // namespace cad::usecase
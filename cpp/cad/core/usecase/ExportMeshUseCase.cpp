@@ -0,0 +1,105 @@
+#include "cpp/cad/core/usecase/ExportMeshUseCase.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <string_view>
+#include <unordered_set>
+
+#include "cpp/cad/core/domain/ModelArena.hpp"
+#include "cpp/cad/core/domain/Traversal.hpp"
+
+using cad::domain::Assembly;
+using cad::ports::LogLevel;
+
+namespace cad::usecase {
+
+namespace {
+
+// Adds an instance for every part whose prototype has a mesh.
+struct InstanceWriter {
+  cad::ports::MeshWriterPort &writer;
+  const std::unordered_set<std::string_view> &meshed;
+  std::size_t instances = 0;
+
+  bool enter(const Assembly *assembly, std::size_t) {
+    for (const auto &part : assembly->parts) {
+      const std::string_view prototypeId(part.prototypeId);
+      if (!prototypeId.empty() && meshed.count(prototypeId) != 0) {
+        writer.addInstance(std::string(prototypeId), std::string(part.name),
+                           part.placement);
+        ++instances;
+      }
+    }
+    return true;
+  }
+
+  template <typename Push> void children(const Assembly *assembly, Push &&push) {
+    for (const auto &child : assembly->children) {
+      push(&child);
+    }
+  }
+
+  void leave(const Assembly *, std::size_t) {}
+};
+
+} // namespace
+
+ExportMeshUseCase::ExportMeshUseCase(cad::ports::ModelDataSourcePort &source,
+                                     cad::ports::TessellationPort &tessellation,
+                                     cad::ports::LoggerPort &logger,
+                                     cad::concurrency::ThreadPool &pool)
+    : source_(source), tessellation_(tessellation), logger_(logger), pool_(pool) {}
+
+std::vector<std::string>
+ExportMeshUseCase::exportMesh(const std::string &locator,
+                              const cad::ports::TessellationOptions &options,
+                              cad::ports::MeshWriterPort &writer,
+                              cad::ports::ProgressPort *progress) const {
+  logger_.log(LogLevel::Info, std::string("Opening locator: ") + locator);
+  auto stream = source_.open(locator);
+  if (!stream || !(*stream)) {
+    logger_.log(LogLevel::Error, "Failed to open locator: " + locator);
+    return {"ERROR: failed to open locator"};
+  }
+
+  // The reader's prototype ids only live for the call, so they are copied
+  // once each; parts look them up by view
+  std::deque<std::string> meshedIds;
+  std::unordered_set<std::string_view> meshed;
+  std::size_t triangles = 0;
+  const cad::ports::TessellationPort::MeshSink sink =
+      [&](const std::string &prototypeId, cad::domain::Mesh &&mesh) {
+        if (mesh.triangleCount() == 0) {
+          return;
+        }
+        triangles += mesh.triangleCount();
+        writer.addMesh(prototypeId, mesh);
+        meshed.insert(meshedIds.emplace_back(prototypeId));
+      };
+  try {
+    cad::domain::ModelArena arena;
+    const cad::domain::Model &model = arena.adopt(
+        progress ? tessellation_.readTessellatedModel(*stream, options, pool_, sink,
+                                                      arena.resource(), *progress)
+                 : tessellation_.readTessellatedModel(*stream, options, pool_, sink,
+                                                      arena.resource()));
+
+    InstanceWriter instances{writer, meshed};
+    cad::domain::DepthFirstTraversal<const Assembly *>().run(&model.root, instances);
+    writer.finish();
+
+    return {"Exported " + std::to_string(meshed.size()) + " meshes, " +
+            std::to_string(instances.instances) + " instances, " +
+            std::to_string(triangles) + " triangles"};
+  } catch (const cad::ports::ReadCancelled &) {
+    logger_.log(LogLevel::Warn, "Cancelled exporting locator: " + locator);
+    return {"ERROR: read cancelled"};
+  } catch (const std::exception &e) {
+    logger_.log(LogLevel::Error,
+                "Failed to export locator: " + locator + ": " + e.what());
+    return {"ERROR: failed to export mesh"};
+  }
+}
+
+} // namespace cad::usecase
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/ports/LoggerPort.hpp"
+#include "cpp/cad/core/ports/MeshWriterPort.hpp"
+#include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+#include "cpp/cad/core/ports/TessellationPort.hpp"
+
+namespace cad::usecase {
+
+// Converts a model to an instanced mesh file. Prototypes are meshed in
+// parallel on `pool` and streamed to the writer one at a time; every part
+// then becomes an instance of its prototype's mesh, so shared geometry is
+// written once.
+class ExportMeshUseCase {
+public:
+  ExportMeshUseCase(cad::ports::ModelDataSourcePort &source,
+                    cad::ports::TessellationPort &tessellation,
+                    cad::ports::LoggerPort &logger,
+                    cad::concurrency::ThreadPool &pool);
+
+  // Returns a one-line summary, or an ERROR line. With `progress`, the read
+  // and the meshing report to it and stop once it is cancelled, leaving the
+  // output unfinished.
+  std::vector<std::string>
+  exportMesh(const std::string &locator,
+             const cad::ports::TessellationOptions &options,
+             cad::ports::MeshWriterPort &writer,
+             cad::ports::ProgressPort *progress = nullptr) const;
+
+private:
+  cad::ports::ModelDataSourcePort &source_;
+  cad::ports::TessellationPort &tessellation_;
+  cad::ports::LoggerPort &logger_;
+  cad::concurrency::ThreadPool &pool_;
+};
+
+} // namespace cad::usecase
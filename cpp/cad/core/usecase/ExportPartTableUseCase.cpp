@@ -0,0 +1,203 @@
+#include "cpp/cad/core/usecase/ExportPartTableUseCase.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <string_view>
+#include <unordered_map>
+
+#include "cpp/cad/core/domain/Traversal.hpp"
+#include "cpp/cad/core/usecase/ModelPath.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::ports::LogLevel;
+using cad::ports::PartTableBatch;
+using cad::ports::StringColumn;
+
+namespace cad::usecase {
+
+namespace {
+
+// An assembly that owns parts: the dictionary entry of its path, the depth
+// of its parts and the first of their rows
+struct Span {
+  const Assembly *assembly;
+  std::int32_t path;
+  std::int32_t depth;
+  std::size_t firstRow;
+};
+
+// Prototypes numbered in order of first use, the number of each row's
+// prototype (-1 for none) and the parts per prototype. Prototype ids are
+// hashed once per row, here, rather than again for every batch.
+struct Instances {
+  std::vector<std::int32_t> prototypeOfRow;
+  std::vector<std::int32_t> counts;
+};
+
+// Pre-order visitor giving every assembly that owns parts a path in the
+// dictionary and a span of rows, with the listing's paths.
+class SpanCollector {
+public:
+  StringColumn paths;
+  std::vector<Span> spans;
+  std::size_t rows = 0;
+
+  bool enter(const Assembly *assembly, std::size_t depth) {
+    const std::string_view path = path_.enter(assembly->name, depth);
+    if (!assembly->parts.empty()) {
+      spans.push_back({assembly, static_cast<std::int32_t>(paths.size()),
+                       static_cast<std::int32_t>(depth + 1), rows});
+      paths.push_back(path);
+      rows += assembly->parts.size();
+    }
+    return true;
+  }
+
+  template <typename Push> void children(const Assembly *assembly, Push &&push) {
+    for (const auto &child : assembly->children) {
+      push(&child);
+    }
+  }
+
+  void leave(const Assembly *, std::size_t) {}
+
+private:
+  ModelPath path_;
+};
+
+Instances countInstances(const std::vector<Span> &spans, std::size_t rows) {
+  Instances instances;
+  instances.prototypeOfRow.reserve(rows);
+  std::unordered_map<std::string_view, std::int32_t> numbers; // views into the model
+  for (const Span &span : spans) {
+    for (const auto &part : span.assembly->parts) {
+      std::int32_t number = -1;
+      if (!part.prototypeId.empty()) {
+        auto [it, added] = numbers.try_emplace(std::string_view(part.prototypeId),
+                                               static_cast<std::int32_t>(numbers.size()));
+        if (added) {
+          instances.counts.push_back(0);
+        }
+        number = it->second;
+        ++instances.counts[static_cast<std::size_t>(number)];
+      }
+      instances.prototypeOfRow.push_back(number);
+    }
+  }
+  return instances;
+}
+
+// Rows [begin, end), read straight from the parts they describe
+PartTableBatch fillBatch(const std::vector<Span> &spans, const Instances &instances,
+                         std::size_t begin, std::size_t end) {
+  PartTableBatch batch;
+  const std::size_t rows = end - begin;
+  batch.ids.offsets.reserve(rows + 1);
+  batch.names.offsets.reserve(rows + 1);
+  batch.paths.reserve(rows);
+  batch.depths.reserve(rows);
+  batch.instanceCounts.reserve(rows);
+
+  // The span holding `begin`: the last one starting at or before it
+  auto span = std::upper_bound(spans.begin(), spans.end(), begin,
+                               [](std::size_t row, const Span &s) { return row < s.firstRow; }) -
+              1;
+  for (std::size_t row = begin; row < end; ++span) {
+    const auto &parts = span->assembly->parts;
+    const std::size_t last = std::min(parts.size(), end - span->firstRow);
+    for (std::size_t i = row - span->firstRow; i < last; ++i) {
+      const auto &part = parts[i];
+      batch.ids.push_back(part.id.value.view());
+      batch.names.push_back(part.name.view());
+      batch.paths.push_back(span->path);
+      batch.depths.push_back(span->depth);
+      const std::int32_t prototype = instances.prototypeOfRow[span->firstRow + i];
+      batch.instanceCounts.push_back(
+          prototype < 0 ? 1 : instances.counts[static_cast<std::size_t>(prototype)]);
+    }
+    row = span->firstRow + last;
+  }
+  return batch;
+}
+
+} // namespace
+
+ExportPartTableUseCase::ExportPartTableUseCase(cad::ports::ModelDataSourcePort &source,
+                                               cad::ports::CadModelReaderPort &reader,
+                                               cad::ports::LoggerPort &logger,
+                                               cad::concurrency::ThreadPool &pool,
+                                               std::size_t batchRows,
+                                               ReadBudget budget)
+    : source_(source), reader_(reader), logger_(logger), pool_(pool),
+      batchRows_(std::max<std::size_t>(batchRows, 1)), budget_(budget) {}
+
+std::vector<std::string>
+ExportPartTableUseCase::exportTable(const std::string &locator,
+                                    cad::ports::PartTableWriterPort &writer,
+                                    cad::ports::ProgressPort *progress) const {
+  std::vector<std::string> lines;
+  const std::string error = readWithinBudget(
+      budget_, source_, reader_, logger_, locator, progress, [&](const Model &model) {
+        try {
+          const std::size_t rows = writeTable(model, writer);
+          const std::size_t batches = (rows + batchRows_ - 1) / batchRows_;
+          lines = {"Exported " + std::to_string(rows) + " parts in " +
+                   std::to_string(batches) + " batches"};
+        } catch (const std::exception &e) {
+          logger_.log(LogLevel::Error,
+                      "Failed to export locator: " + locator + ": " + e.what());
+          lines = {"ERROR: failed to export part table"};
+        }
+      });
+  if (!error.empty()) {
+    return {error};
+  }
+  return lines;
+}
+
+std::size_t ExportPartTableUseCase::writeTable(const Model &model,
+                                               cad::ports::PartTableWriterPort &writer) const {
+  SpanCollector collector;
+  cad::domain::DepthFirstTraversal<const Assembly *>().run(&model.root, collector);
+  const Instances instances = countInstances(collector.spans, collector.rows);
+  writer.begin(collector.paths);
+
+  // Batches are filled a couple per worker ahead of the writer. Tasks refer
+  // to the spans and instances above, so none may outlive this call, even when
+  // the writer throws.
+  std::deque<std::future<PartTableBatch>> pending;
+  const std::size_t ahead = 2 * pool_.size();
+  std::size_t next = 0;
+  try {
+    while (next < collector.rows || !pending.empty()) {
+      while (next < collector.rows && pending.size() < ahead) {
+        const std::size_t end = std::min(collector.rows, next + batchRows_);
+        pending.push_back(pool_.submit([&spans = collector.spans, &instances, next, end] {
+          return fillBatch(spans, instances, next, end);
+        }));
+        next = end;
+      }
+      PartTableBatch batch = pool_.await(pending.front());
+      pending.pop_front();
+      writer.addBatch(batch);
+    }
+  } catch (...) {
+    for (auto &future : pending) {
+      try {
+        if (future.valid()) {
+          pool_.await(future);
+        }
+      } catch (...) {
+      }
+    }
+    throw;
+  }
+  writer.finish();
+  return collector.rows;
+}
+
+} // namespace cad::usecase
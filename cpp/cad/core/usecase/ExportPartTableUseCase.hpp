@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/Model.hpp"
+#include "cpp/cad/core/ports/CadModelReaderPort.hpp"
+#include "cpp/cad/core/ports/LoggerPort.hpp"
+#include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
+#include "cpp/cad/core/ports/PartTableWriterPort.hpp"
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+#include "cpp/cad/core/usecase/ReadBudget.hpp"
+
+namespace cad::usecase {
+
+// Flattens a model into a part table for analytics: one row per part with
+// its id, name, the path of its assembly ("/Root/Engine", dictionary
+// encoded), its depth and how many parts in the model instantiate the same
+// prototype (1 for parts without one). Rows are in model order.
+//
+// One traversal collects the assemblies and their paths; the rows are then
+// cut into batches of `batchRows` whose columns are filled in parallel on
+// `pool`, straight from the model, and handed to the writer in order. At
+// most a few batches per worker are held at once. With a budget, the read
+// is admitted against it first (see admitRead).
+class ExportPartTableUseCase {
+public:
+  static constexpr std::size_t kDefaultBatchRows = 64 * 1024;
+
+  ExportPartTableUseCase(cad::ports::ModelDataSourcePort &source,
+                         cad::ports::CadModelReaderPort &reader,
+                         cad::ports::LoggerPort &logger,
+                         cad::concurrency::ThreadPool &pool,
+                         std::size_t batchRows = kDefaultBatchRows,
+                         ReadBudget budget = {});
+
+  // Returns a one-line summary, or an ERROR line.
+  std::vector<std::string>
+  exportTable(const std::string &locator, cad::ports::PartTableWriterPort &writer,
+              cad::ports::ProgressPort *progress = nullptr) const;
+
+  // The table of `model`, written and finished; returns the number of rows.
+  std::size_t writeTable(const cad::domain::Model &model,
+                         cad::ports::PartTableWriterPort &writer) const;
+
+private:
+  cad::ports::ModelDataSourcePort &source_;
+  cad::ports::CadModelReaderPort &reader_;
+  cad::ports::LoggerPort &logger_;
+  cad::concurrency::ThreadPool &pool_;
+  std::size_t batchRows_;
+  ReadBudget budget_;
+};
+
+} // namespace cad::usecase
@@ -0,0 +1,408 @@
+#include "cpp/cad/core/usecase/FindDuplicateGeometryUseCase.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cpp/cad/core/domain/ModelArena.hpp"
+#include "cpp/cad/core/domain/Traversal.hpp"
+#include "cpp/cad/core/usecase/ModelPath.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::Placement;
+using cad::ports::LogLevel;
+using cad::ports::PrototypeGeometry;
+using cad::ports::ShapeSignature;
+
+namespace cad::usecase {
+
+namespace {
+
+// A prototype's place in a grid of extent cells, one grid per topology
+using CellKey = std::pair<std::array<std::size_t, 4>, std::array<std::int64_t, 3>>;
+
+// Index of the cell holding `value` in a grid of `cell`-sized steps.
+std::int64_t cellOf(double value, double cell) {
+  // Clamped so that huge or infinite values stay representable
+  return static_cast<std::int64_t>(std::clamp(std::floor(value / cell), -1e18, 1e18));
+}
+
+// Whether two shapes within `tolerance` of each other could have these
+// signatures. Every point moves by at most the tolerance and the centroid
+// with them, so radii of gyration differ by at most twice that; the surface
+// sweeps at most the tolerance times its area, which bounds the volume.
+// Area itself is not compared: a surface wrinkled within the tolerance can
+// differ in area by any amount.
+bool compatible(const ShapeSignature &a, const ShapeSignature &b, double tolerance) {
+  if (a.topology != b.topology) {
+    return false;
+  }
+  for (std::size_t i = 0; i < a.extents.size(); ++i) {
+    if (!(std::abs(a.extents[i] - b.extents[i]) <= 2 * tolerance)) {
+      return false;
+    }
+  }
+  return std::abs(a.volume - b.volume) <= tolerance * std::max(a.area, b.area);
+}
+
+// Union-find over prototype indices; the root of a set is its smallest index.
+std::size_t findSet(std::vector<std::size_t> &parent, std::size_t i) {
+  while (parent[i] != i) {
+    i = parent[i] = parent[parent[i]];
+  }
+  return i;
+}
+
+void unite(std::vector<std::size_t> &parent, std::size_t a, std::size_t b) {
+  a = findSet(parent, a);
+  b = findSet(parent, b);
+  if (a != b) {
+    parent[std::max(a, b)] = std::min(a, b);
+  }
+}
+
+// Splits the signed prototypes into buckets, each holding every prototype
+// compatible with one of its members, in id order. Extents are placed in
+// cells twice the tolerance wide, so compatible extents lie in the same or
+// a neighbouring cell and only those 27 cells are searched.
+std::vector<std::vector<const std::string *>>
+bucketPrototypes(const std::vector<std::string> &ids,
+                 const std::vector<std::optional<ShapeSignature>> &signatures,
+                 double tolerance) {
+  const double cell = std::max(2 * tolerance, std::numeric_limits<double>::min());
+  std::map<CellKey, std::vector<std::size_t>> cells;
+  std::vector<std::size_t> parent(ids.size());
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    parent[i] = i;
+    if (!signatures[i]) {
+      continue;
+    }
+    const ShapeSignature &signature = *signatures[i];
+    CellKey key{signature.topology, {}};
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      key.second[axis] = cellOf(signature.extents[axis], cell);
+    }
+    for (int offset = 0; offset < 27; ++offset) {
+      CellKey neighbour = key;
+      for (int axis = 0, rest = offset; axis < 3; ++axis, rest /= 3) {
+        neighbour.second[axis] += rest % 3 - 1;
+      }
+      auto found = cells.find(neighbour);
+      if (found == cells.end()) {
+        continue;
+      }
+      for (std::size_t j : found->second) {
+        if (findSet(parent, i) != findSet(parent, j) &&
+            compatible(signature, *signatures[j], tolerance)) {
+          unite(parent, i, j);
+        }
+      }
+    }
+    cells[key].push_back(i);
+  }
+
+  std::map<std::size_t, std::vector<const std::string *>> sets;
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    if (signatures[i]) {
+      sets[findSet(parent, i)].push_back(&ids[i]);
+    }
+  }
+  std::vector<std::vector<const std::string *>> buckets;
+  for (auto &set : sets) {
+    if (set.second.size() > 1) {
+      buckets.push_back(std::move(set.second));
+    }
+  }
+  return buckets;
+}
+
+// Waits for every task, in order, before returning or rethrowing the first
+// error: the tasks refer to the caller's locals. Each finished task counts
+// towards `phase`.
+template <typename T>
+std::vector<T> awaitAll(cad::concurrency::ThreadPool &pool,
+                        std::vector<std::future<T>> &pending,
+                        cad::ports::ProgressPort *progress, std::string_view phase) {
+  std::vector<T> results;
+  results.reserve(pending.size());
+  std::exception_ptr error;
+  for (auto &future : pending) {
+    try {
+      results.push_back(pool.await(future));
+      if (progress) {
+        progress->report(phase, results.size(), pending.size());
+      }
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return results;
+}
+
+// Greedy grouping of one bucket: the first remaining member is matched
+// against the others, and whatever it does not match is tried again without
+// it. Members are in id order, so representatives are the smallest ids.
+std::vector<DuplicateGroup> matchBucket(const PrototypeGeometry &geometry,
+                                        std::vector<const std::string *> members,
+                                        double tolerance) {
+  std::vector<DuplicateGroup> groups;
+  while (members.size() > 1) {
+    DuplicateGroup group{*members.front(), {}};
+    std::vector<const std::string *> rest;
+    for (auto it = members.begin() + 1; it != members.end(); ++it) {
+      if (auto placement = geometry.match(*members.front(), **it, tolerance)) {
+        group.duplicates.emplace_back(**it, *placement);
+      } else {
+        rest.push_back(*it);
+      }
+    }
+    if (!group.duplicates.empty()) {
+      groups.push_back(std::move(group));
+    }
+    members = std::move(rest);
+  }
+  return groups;
+}
+
+// Collects the paths of the parts of every group.
+struct GroupPartCollector {
+  const std::unordered_map<std::string_view, std::size_t> &groupOf; // by prototype id
+  std::vector<std::vector<std::string>> &parts;                      // by group
+  ModelPath path;
+
+  bool enter(const Assembly *assembly, std::size_t depth) {
+    path.enter(assembly->name, depth);
+    for (const auto &part : assembly->parts) {
+      auto it = groupOf.find(std::string_view(part.prototypeId));
+      if (it != groupOf.end()) {
+        parts[it->second].emplace_back(path.part(part.name));
+      }
+    }
+    return true;
+  }
+
+  template <typename Push> void children(const Assembly *assembly, Push &&push) {
+    for (const auto &child : assembly->children) {
+      push(&child);
+    }
+  }
+
+  void leave(const Assembly *, std::size_t) {}
+};
+
+// Representative and placement by duplicate id, viewing the groups' strings
+using SharingTargets =
+    std::unordered_map<std::string_view, std::pair<const std::string *, const Placement *>>;
+
+struct DuplicateSharer {
+  const SharingTargets &targets;
+  std::size_t changed = 0;
+
+  bool enter(Assembly *assembly, std::size_t) {
+    for (auto &part : assembly->parts) {
+      auto it = targets.find(std::string_view(part.prototypeId));
+      if (it != targets.end()) {
+        part.prototypeId = *it->second.first;
+        part.placement = cad::domain::compose(part.placement, *it->second.second);
+        ++changed;
+      }
+    }
+    return true;
+  }
+
+  template <typename Push> void children(Assembly *assembly, Push &&push) {
+    for (auto &child : assembly->children) {
+      push(&child);
+    }
+  }
+
+  void leave(Assembly *, std::size_t) {}
+};
+
+// Collects the distinct prototypes the parts use.
+struct PrototypeCounter {
+  std::unordered_set<std::string> prototypes;
+
+  bool enter(const Assembly *assembly, std::size_t) {
+    for (const auto &part : assembly->parts) {
+      if (!part.prototypeId.empty()) {
+        prototypes.emplace(std::string_view(part.prototypeId));
+      }
+    }
+    return true;
+  }
+
+  template <typename Push> void children(const Assembly *assembly, Push &&push) {
+    for (const auto &child : assembly->children) {
+      push(&child);
+    }
+  }
+
+  void leave(const Assembly *, std::size_t) {}
+};
+
+std::size_t countPrototypes(const Model &model) {
+  PrototypeCounter counter;
+  cad::domain::DepthFirstTraversal<const Assembly *>().run(&model.root, counter);
+  return counter.prototypes.size();
+}
+
+std::vector<std::string> formatGroups(const Model &model,
+                                      const std::vector<DuplicateGroup> &groups) {
+  std::unordered_map<std::string_view, std::size_t> groupOf;
+  std::size_t duplicates = 0;
+  for (std::size_t g = 0; g < groups.size(); ++g) {
+    groupOf.emplace(groups[g].representative, g);
+    for (const auto &duplicate : groups[g].duplicates) {
+      groupOf.emplace(duplicate.first, g);
+    }
+    duplicates += groups[g].duplicates.size();
+  }
+  std::vector<std::vector<std::string>> parts(groups.size());
+  GroupPartCollector collector{groupOf, parts, {}};
+  cad::domain::DepthFirstTraversal<const Assembly *>().run(&model.root, collector);
+
+  std::vector<std::string> lines;
+  std::size_t partCount = 0;
+  for (std::size_t g = 0; g < groups.size(); ++g) {
+    std::sort(parts[g].begin(), parts[g].end());
+    lines.push_back("Group: " + groups[g].representative + " (" +
+                    std::to_string(groups[g].duplicates.size() + 1) + " prototypes, " +
+                    std::to_string(parts[g].size()) + " parts)");
+    for (auto &path : parts[g]) {
+      lines.push_back("  Part: " + std::move(path));
+    }
+    partCount += parts[g].size();
+  }
+  lines.push_back("Total: " + std::to_string(groups.size()) + " groups, " +
+                  std::to_string(duplicates) + " duplicate prototypes, " +
+                  std::to_string(partCount) + " parts");
+  return lines;
+}
+
+} // namespace
+
+FindDuplicateGeometryUseCase::FindDuplicateGeometryUseCase(
+    cad::ports::ModelDataSourcePort &source, cad::ports::PrototypeGeometryPort &geometry,
+    cad::ports::LoggerPort &logger, cad::concurrency::ThreadPool &pool)
+    : source_(source), geometry_(geometry), logger_(logger), pool_(pool) {}
+
+std::vector<DuplicateGroup>
+FindDuplicateGeometryUseCase::findGroups(const PrototypeGeometry &geometry,
+                                         double tolerance,
+                                         cad::ports::ProgressPort *progress) const {
+  // Once cancelled, tasks not yet started give up straight away
+  const std::vector<std::string> ids = geometry.prototypeIds();
+  std::vector<std::future<std::optional<ShapeSignature>>> signing;
+  signing.reserve(ids.size());
+  for (const auto &id : ids) {
+    signing.push_back(pool_.submit([&geometry, &id, progress] {
+      cad::ports::throwIfCancelled(progress);
+      return geometry.signature(id);
+    }));
+  }
+  const std::vector<std::optional<ShapeSignature>> signatures =
+      awaitAll(pool_, signing, progress, "signature");
+
+  const std::vector<std::vector<const std::string *>> buckets =
+      bucketPrototypes(ids, signatures, tolerance);
+
+  std::vector<std::future<std::vector<DuplicateGroup>>> matching;
+  for (const auto &members : buckets) {
+    matching.push_back(pool_.submit([&geometry, &members, tolerance, progress] {
+      cad::ports::throwIfCancelled(progress);
+      return matchBucket(geometry, members, tolerance);
+    }));
+  }
+  std::vector<DuplicateGroup> groups;
+  for (auto &found : awaitAll(pool_, matching, progress, "compare")) {
+    std::move(found.begin(), found.end(), std::back_inserter(groups));
+  }
+  std::sort(groups.begin(), groups.end(),
+            [](const DuplicateGroup &a, const DuplicateGroup &b) {
+              return a.representative < b.representative;
+            });
+  logger_.log(LogLevel::Debug, "Compared " + std::to_string(ids.size()) + " prototypes in " +
+                                   std::to_string(matching.size()) + " buckets");
+  return groups;
+}
+
+std::size_t FindDuplicateGeometryUseCase::shareDuplicates(
+    Model &model, const std::vector<DuplicateGroup> &groups) {
+  SharingTargets targets;
+  for (const auto &group : groups) {
+    for (const auto &[id, placement] : group.duplicates) {
+      targets.emplace(id, std::make_pair(&group.representative, &placement));
+    }
+  }
+  DuplicateSharer sharer{targets, 0};
+  cad::domain::DepthFirstTraversal<Assembly *>().run(&model.root, sharer);
+  return sharer.changed;
+}
+
+std::vector<std::string>
+FindDuplicateGeometryUseCase::find(const std::string &locator,
+                                   const DuplicateGeometryOptions &options,
+                                   cad::ports::ProgressPort *progress) const {
+  logger_.log(LogLevel::Info, std::string("Opening locator: ") + locator);
+  auto stream = source_.open(locator);
+  if (!stream || !(*stream)) {
+    logger_.log(LogLevel::Error, "Failed to open locator: " + locator);
+    return {"ERROR: failed to open locator"};
+  }
+
+  // Declared first: the model in `geometry` lives in the arena
+  cad::domain::ModelArena arena;
+  std::unique_ptr<PrototypeGeometry> geometry;
+  try {
+    geometry = progress ? geometry_.readPrototypeGeometry(*stream, arena.resource(), *progress)
+                        : geometry_.readPrototypeGeometry(*stream, arena.resource());
+  } catch (const cad::ports::ReadCancelled &) {
+    logger_.log(LogLevel::Warn, "Cancelled reading locator: " + locator);
+    return {"ERROR: read cancelled"};
+  } catch (const std::exception &e) {
+    logger_.log(LogLevel::Error, "Failed to read locator: " + locator + ": " + e.what());
+    return {"ERROR: failed to read model"};
+  }
+
+  std::vector<DuplicateGroup> groups;
+  try {
+    groups = findGroups(*geometry, options.tolerance, progress);
+  } catch (const cad::ports::ReadCancelled &) {
+    logger_.log(LogLevel::Warn, "Cancelled comparing geometry: " + locator);
+    return {"ERROR: read cancelled"};
+  } catch (const std::exception &e) {
+    logger_.log(LogLevel::Error, "Failed to compare geometry: " + locator + ": " + e.what());
+    return {"ERROR: failed to compare geometry"};
+  }
+
+  std::vector<std::string> lines = formatGroups(geometry->model(), groups);
+  if (options.share) {
+    Model &model = geometry->model();
+    const std::size_t before = countPrototypes(model);
+    const std::size_t changed = shareDuplicates(model, groups);
+    lines.push_back("Shared: " + std::to_string(changed) + " parts, " +
+                    std::to_string(countPrototypes(model)) + " of " + std::to_string(before) +
+                    " prototypes in use");
+  }
+  return lines;
+}
+
+} // namespace cad::usecase
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/Geometry.hpp"
+#include "cpp/cad/core/domain/Model.hpp"
+#include "cpp/cad/core/ports/LoggerPort.hpp"
+#include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+#include "cpp/cad/core/ports/PrototypeGeometryPort.hpp"
+
+namespace cad::usecase {
+
+// Prototypes with the same shape: each duplicate with the placement carrying
+// the representative onto it.
+struct DuplicateGroup {
+  std::string representative;
+  std::vector<std::pair<std::string, cad::domain::Placement>> duplicates;
+};
+
+struct DuplicateGeometryOptions {
+  // Largest distance between matched points, in model units
+  double tolerance = 1e-4;
+  // Also point the parts of each duplicate at its representative (see
+  // shareDuplicates) and report how many prototypes the model then uses
+  bool share = false;
+};
+
+// Finds prototypes that are copies of one another, e.g. the same bolt
+// exported once per assembly. Every prototype gets a signature in parallel
+// on `pool`. Prototypes whose signatures could belong to shapes within the
+// tolerance of each other (same topology, extents and volume close enough)
+// share a bucket, found through a grid of tolerance-sized extent cells and
+// their neighbours; only buckets with more than one member are compared
+// point by point, one bucket per task.
+class FindDuplicateGeometryUseCase {
+public:
+  FindDuplicateGeometryUseCase(cad::ports::ModelDataSourcePort &source,
+                               cad::ports::PrototypeGeometryPort &geometry,
+                               cad::ports::LoggerPort &logger,
+                               cad::concurrency::ThreadPool &pool);
+
+  // Per group a "Group:" line and its parts ordered by path, then a totals
+  // line; with `options.share`, a "Shared:" line for the rewritten model
+  // last. With `progress`, the read and the comparison report to it and
+  // stop once it is cancelled.
+  std::vector<std::string> find(const std::string &locator,
+                                const DuplicateGeometryOptions &options = {},
+                                cad::ports::ProgressPort *progress = nullptr) const;
+
+  // Groups ordered by representative; duplicates ordered by id. Throws
+  // ReadCancelled once `progress` is cancelled.
+  std::vector<DuplicateGroup> findGroups(const cad::ports::PrototypeGeometry &geometry,
+                                         double tolerance,
+                                         cad::ports::ProgressPort *progress = nullptr) const;
+
+  // Points every part of a duplicate at its representative, placed so that
+  // the part stays where it was, for callers that go on to write the model;
+  // returns how many parts changed.
+  static std::size_t shareDuplicates(cad::domain::Model &model,
+                                     const std::vector<DuplicateGroup> &groups);
+
+private:
+  cad::ports::ModelDataSourcePort &source_;
+  cad::ports::PrototypeGeometryPort &geometry_;
+  cad::ports::LoggerPort &logger_;
+  cad::concurrency::ThreadPool &pool_;
+};
+
+} // namespace cad::usecase
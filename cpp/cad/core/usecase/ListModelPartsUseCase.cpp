@@ -1,55 +1,50 @@
 #include "cpp/cad/core/usecase/ListModelPartsUseCase.hpp"
 
-#include <algorithm>
-#include <sstream>
-
-using cad::domain::Assembly;
-using cad::domain::Model;
-using cad::domain::Part;
-using cad::ports::LogLevel;
-
 namespace cad::usecase {
 
 ListModelPartsUseCase::ListModelPartsUseCase(
     cad::ports::ModelDataSourcePort &source,
-    cad::ports::CadModelReaderPort &reader, cad::ports::LoggerPort &logger)
-    : source_(source), reader_(reader), logger_(logger) {}
-
-static void collectLines(const Assembly &assembly,
-                         std::vector<std::string> &out, int depth) {
-  std::string indent(static_cast<size_t>(depth) * 2, ' ');
-  out.push_back(indent + "Assembly: " + assembly.name);
+    cad::ports::CadModelReaderPort &reader, cad::ports::LoggerPort &logger,
+    cad::concurrency::ThreadPool *listingPool, ReadBudget budget)
+    : impl_(source, reader, logger, listingPool, budget) {}
 
-  std::vector<Part> parts = assembly.parts;
-  std::sort(parts.begin(), parts.end(),
-            [](const Part &a, const Part &b) { return a.name < b.name; });
-  for (const auto &p : parts) {
-    out.push_back(indent + "  Part: " + p.name);
-  }
-
-  std::vector<Assembly> children = assembly.children;
-  std::sort(
-      children.begin(), children.end(),
-      [](const Assembly &a, const Assembly &b) { return a.name < b.name; });
-  for (const auto &child : children) {
-    collectLines(child, out, depth + 1);
-  }
+std::vector<std::string>
+ListModelPartsUseCase::list(const std::string &locator,
+                            cad::ports::ProgressPort *progress) const {
+  return impl_.list(locator, progress);
 }
 
 std::vector<std::string>
-ListModelPartsUseCase::list(const std::string &locator) const {
-  logger_.log(LogLevel::Info, std::string("Opening locator: ") + locator);
-  auto stream = source_.open(locator);
-  if (!stream || !(*stream)) {
-    logger_.log(LogLevel::Error, "Failed to open locator: " + locator);
-    return {"ERROR: failed to open locator"};
-  }
+ListModelPartsUseCase::write(const std::string &locator,
+                             cad::ports::ListingWriterPort &writer,
+                             cad::ports::ProgressPort *progress) const {
+  return impl_.write(locator, writer, progress);
+}
 
-  Model model = reader_.readModelFromStream(*stream);
+std::future<std::vector<std::string>>
+ListModelPartsUseCase::listAsync(const std::string &locator,
+                                 cad::concurrency::ThreadPool &pool) const {
+  // Tasks run on workers of `pool`; if it is also the listing pool, the
+  // listing waits on its subtasks with ThreadPool::await and cannot deadlock.
+  return pool.submit([this, locator] { return list(locator); });
+}
 
-  std::vector<std::string> lines;
-  collectLines(model.root, lines, 0);
-  return lines;
+std::vector<std::vector<std::string>>
+ListModelPartsUseCase::listAll(const std::vector<std::string> &locators,
+                               cad::concurrency::ThreadPool &pool) const {
+  std::vector<std::future<std::vector<std::string>>> pending;
+  pending.reserve(locators.size());
+  for (const auto &locator : locators) {
+    pending.push_back(listAsync(locator, pool));
+  }
+  std::vector<std::vector<std::string>> results;
+  results.reserve(pending.size());
+  // The caller may itself be a worker of `pool`; waiting with await() runs
+  // the queued listings instead of blocking the worker they need
+  for (auto &result : pending) {
+    results.push_back(pool.await(result));
+  }
+  return results;
 }
 
 } // namespace cad::usecase
@@ -1,26 +1,57 @@
 #pragma once
 
+#include <future>
 #include <string>
 #include <vector>
 
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+
 #include "cpp/cad/core/ports/CadModelReaderPort.hpp"
 #include "cpp/cad/core/ports/LoggerPort.hpp"
 #include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
+#include "cpp/cad/core/usecase/BasicListModelPartsUseCase.hpp"
 
 namespace cad::usecase {
 
+// Runtime-composed listing use case; adapters are bound through the ports.
+// See BasicListModelPartsUseCase for the statically dispatched variant.
+//
+// list() is reentrant: one instance may serve any number of threads at once,
+// given adapters that honour the port thread-safety contracts. Batch workers
+// sharing a ReadBudget queue their reads on it instead of overcommitting
+// memory together.
 class ListModelPartsUseCase {
 public:
   ListModelPartsUseCase(cad::ports::ModelDataSourcePort &source,
                         cad::ports::CadModelReaderPort &reader,
-                        cad::ports::LoggerPort &logger);
+                        cad::ports::LoggerPort &logger,
+                        cad::concurrency::ThreadPool *listingPool = nullptr,
+                        ReadBudget budget = {});
+
+  // See BasicListModelPartsUseCase::list for `progress`.
+  std::vector<std::string> list(const std::string &locator,
+                                cad::ports::ProgressPort *progress = nullptr) const;
+
+  // See BasicListModelPartsUseCase::write.
+  std::vector<std::string> write(const std::string &locator,
+                                 cad::ports::ListingWriterPort &writer,
+                                 cad::ports::ProgressPort *progress = nullptr) const;
+
+  // Runs list(locator) on `pool`. The use case must outlive the future.
+  std::future<std::vector<std::string>>
+  listAsync(const std::string &locator,
+            cad::concurrency::ThreadPool &pool) const;
 
-  std::vector<std::string> list(const std::string &locator) const;
+  // Lists every locator on `pool` and returns the results in input order.
+  std::vector<std::vector<std::string>>
+  listAll(const std::vector<std::string> &locators,
+          cad::concurrency::ThreadPool &pool) const;
 
 private:
-  cad::ports::ModelDataSourcePort &source_;
-  cad::ports::CadModelReaderPort &reader_;
-  cad::ports::LoggerPort &logger_;
+  BasicListModelPartsUseCase<cad::ports::ModelDataSourcePort,
+                             cad::ports::CadModelReaderPort,
+                             cad::ports::LoggerPort>
+      impl_;
 };
 
 } // namespace cad::usecase
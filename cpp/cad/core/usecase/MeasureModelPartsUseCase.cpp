@@ -0,0 +1,184 @@
+#include "cpp/cad/core/usecase/MeasureModelPartsUseCase.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "cpp/cad/core/domain/ModelArena.hpp"
+#include "cpp/cad/core/domain/Traversal.hpp"
+#include "cpp/cad/core/usecase/ModelPath.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::GeometricProperties;
+using cad::domain::Model;
+using cad::domain::Part;
+using cad::ports::LogLevel;
+
+namespace cad::usecase {
+
+namespace {
+
+using Prototypes = std::unordered_map<std::string, GeometricProperties>;
+// Views into the keys of a Prototypes map, so parts look up their pmr
+// prototype ids without copying them
+using PrototypesById = std::unordered_map<std::string_view, const GeometricProperties *>;
+
+struct GeometryAttacher {
+  const PrototypesById &prototypes;
+  std::size_t attached = 0;
+
+  bool enter(Assembly *assembly, std::size_t) {
+    for (auto &part : assembly->parts) {
+      if (part.prototypeId.empty()) {
+        continue;
+      }
+      auto it = prototypes.find(std::string_view(part.prototypeId));
+      if (it != prototypes.end()) {
+        part.geometry = cad::domain::place(*it->second, part.placement);
+        ++attached;
+      }
+    }
+    return true;
+  }
+
+  template <typename Push> void children(Assembly *assembly, Push &&push) {
+    for (auto &child : assembly->children) {
+      push(&child);
+    }
+  }
+
+  void leave(Assembly *, std::size_t) {}
+};
+
+// Collects (path, part) pairs.
+struct PartCollector {
+  std::vector<std::pair<std::string, const Part *>> &out;
+  ModelPath path;
+
+  bool enter(const Assembly *assembly, std::size_t depth) {
+    path.enter(assembly->name, depth);
+    for (const auto &part : assembly->parts) {
+      out.emplace_back(path.part(part.name), &part);
+    }
+    return true;
+  }
+
+  template <typename Push> void children(const Assembly *assembly, Push &&push) {
+    for (const auto &child : assembly->children) {
+      push(&child);
+    }
+  }
+
+  void leave(const Assembly *, std::size_t) {}
+};
+
+std::string formatNumber(double value) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.6g", value);
+  return buffer;
+}
+
+std::string formatGeometry(const GeometricProperties &geometry) {
+  std::string line;
+  if (!geometry.bounds.empty) {
+    const auto &box = geometry.bounds;
+    line += " bbox=[" + formatNumber(box.min[0]) + " " + formatNumber(box.min[1]) +
+            " " + formatNumber(box.min[2]) + "; " + formatNumber(box.max[0]) +
+            " " + formatNumber(box.max[1]) + " " + formatNumber(box.max[2]) + "]";
+  }
+  line += " volume=" + formatNumber(geometry.volume) +
+          " area=" + formatNumber(geometry.area);
+  return line;
+}
+
+} // namespace
+
+MeasureModelPartsUseCase::MeasureModelPartsUseCase(
+    cad::ports::ModelDataSourcePort &source,
+    cad::ports::GeometricPropertiesPort &geometry,
+    cad::ports::LoggerPort &logger, cad::concurrency::ThreadPool &pool)
+    : source_(source), geometry_(geometry), logger_(logger), pool_(pool) {}
+
+std::size_t MeasureModelPartsUseCase::attachGeometry(Model &model,
+                                                     const Prototypes &prototypes) {
+  PrototypesById byId;
+  byId.reserve(prototypes.size());
+  for (const auto &[id, properties] : prototypes) {
+    byId.emplace(id, &properties);
+  }
+  GeometryAttacher attacher{byId};
+  cad::domain::DepthFirstTraversal<Assembly *>().run(&model.root, attacher);
+  return attacher.attached;
+}
+
+std::vector<std::string>
+MeasureModelPartsUseCase::formatMeasurements(const Model &model) {
+  std::vector<std::pair<std::string, const Part *>> parts;
+  PartCollector collector{parts, {}};
+  cad::domain::DepthFirstTraversal<const Assembly *>().run(&model.root, collector);
+  std::stable_sort(parts.begin(), parts.end(),
+                   [](const auto &a, const auto &b) { return a.first < b.first; });
+
+  std::vector<std::string> lines;
+  lines.reserve(parts.size() + 1);
+  std::size_t measured = 0;
+  double volume = 0;
+  double area = 0;
+  for (const auto &[path, part] : parts) {
+    std::string line = "Part: " + path;
+    if (part->geometry) {
+      line += formatGeometry(*part->geometry);
+      ++measured;
+      volume += part->geometry->volume;
+      area += part->geometry->area;
+    } else {
+      line += " (no geometry)";
+    }
+    lines.push_back(std::move(line));
+  }
+  lines.push_back("Total: " + std::to_string(parts.size()) + " parts, " +
+                  std::to_string(measured) + " measured, volume=" +
+                  formatNumber(volume) + " area=" + formatNumber(area));
+  return lines;
+}
+
+std::vector<std::string>
+MeasureModelPartsUseCase::measure(const std::string &locator,
+                                  cad::ports::ProgressPort *progress) const {
+  logger_.log(LogLevel::Info, std::string("Opening locator: ") + locator);
+  auto stream = source_.open(locator);
+  if (!stream || !(*stream)) {
+    logger_.log(LogLevel::Error, "Failed to open locator: " + locator);
+    return {"ERROR: failed to open locator"};
+  }
+
+  cad::domain::ModelArena arena;
+  // Constructed in place: assigning would move the model across resources,
+  // which copies it
+  std::optional<cad::ports::MeasuredModel> measured;
+  try {
+    measured.emplace(progress
+                         ? geometry_.readMeasuredModel(*stream, pool_, arena.resource(), *progress)
+                         : geometry_.readMeasuredModel(*stream, pool_, arena.resource()));
+  } catch (const cad::ports::ReadCancelled &) {
+    logger_.log(LogLevel::Warn, "Cancelled reading locator: " + locator);
+    return {"ERROR: read cancelled"};
+  } catch (const std::exception &e) {
+    logger_.log(LogLevel::Error,
+                "Failed to read locator: " + locator + ": " + e.what());
+    return {"ERROR: failed to read model"};
+  }
+  Model &model = arena.adopt(std::move(measured->model));
+  std::size_t attached = attachGeometry(model, measured->prototypes);
+  logger_.log(LogLevel::Debug, "Measured " +
+                                   std::to_string(measured->prototypes.size()) +
+                                   " prototypes for " + std::to_string(attached) +
+                                   " parts");
+  return formatMeasurements(model);
+}
+
+} // namespace cad::usecase
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/Model.hpp"
+#include "cpp/cad/core/ports/GeometricPropertiesPort.hpp"
+#include "cpp/cad/core/ports/LoggerPort.hpp"
+#include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+
+namespace cad::usecase {
+
+// Per-part bounding boxes, volumes and surface areas, e.g. for packing and
+// costing. Prototype geometry is measured once by the adapter, in parallel on
+// `pool`, and placed at each instance here.
+class MeasureModelPartsUseCase {
+public:
+  MeasureModelPartsUseCase(cad::ports::ModelDataSourcePort &source,
+                           cad::ports::GeometricPropertiesPort &geometry,
+                           cad::ports::LoggerPort &logger,
+                           cad::concurrency::ThreadPool &pool);
+
+  // One line per part, ordered by path, then a totals line. With
+  // `progress`, the read and the measuring report to it and stop once it is
+  // cancelled.
+  std::vector<std::string> measure(const std::string &locator,
+                                   cad::ports::ProgressPort *progress = nullptr) const;
+
+  // Sets Part::geometry on every part whose prototype was measured and
+  // returns how many parts received geometry.
+  static std::size_t
+  attachGeometry(cad::domain::Model &model,
+                 const std::unordered_map<std::string,
+                                          cad::domain::GeometricProperties>
+                     &prototypes);
+
+  static std::vector<std::string>
+  formatMeasurements(const cad::domain::Model &model);
+
+private:
+  cad::ports::ModelDataSourcePort &source_;
+  cad::ports::GeometricPropertiesPort &geometry_;
+  cad::ports::LoggerPort &logger_;
+  cad::concurrency::ThreadPool &pool_;
+};
+
+} // namespace cad::usecase
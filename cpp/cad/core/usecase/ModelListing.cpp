@@ -0,0 +1,328 @@
+#include "cpp/cad/core/usecase/ModelListing.hpp"
+
+#include <algorithm>
+#include <future>
+#include <utility>
+
+#include "cpp/cad/core/domain/SubtreeSizes.hpp"
+#include "cpp/cad/core/domain/Traversal.hpp"
+#include "cpp/cad/core/usecase/ModelPath.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::Part;
+
+namespace cad::usecase {
+
+namespace {
+
+// Never split below this many nodes (assemblies plus parts): a task must
+// outweigh its scheduling and splicing cost.
+constexpr std::size_t kMinGrain = 2048;
+// Aim for this many tasks per worker so stealing can even out imbalance.
+constexpr std::size_t kTasksPerWorker = 16;
+
+// Siblings are sorted through pointers; std::sort applies the same
+// comparisons to the same initial order as sorting copies would, so the
+// resulting order (including ties) matches the original copy-and-sort.
+void sortChildren(const Assembly &assembly,
+                  std::vector<const Assembly *> &children) {
+  children.clear();
+  for (const auto &c : assembly.children) {
+    children.push_back(&c);
+  }
+  std::sort(children.begin(), children.end(),
+            [](const Assembly *a, const Assembly *b) { return a->name < b->name; });
+}
+
+void sortParts(const Assembly &assembly, std::vector<const Part *> &parts) {
+  parts.clear();
+  for (const auto &p : assembly.parts) {
+    parts.push_back(&p);
+  }
+  std::sort(parts.begin(), parts.end(),
+            [](const Part *a, const Part *b) { return a->name < b->name; });
+}
+
+// Appends the assembly line and its sorted part lines; `parts` is scratch.
+void appendNodeLines(const Assembly &assembly, std::size_t depth,
+                     std::vector<std::string> &out,
+                     std::vector<const Part *> &parts) {
+  sortParts(assembly, parts);
+
+  std::string indent(depth * 2, ' ');
+  out.push_back(indent + "Assembly: ");
+  out.back() += assembly.name;
+  for (const Part *p : parts) {
+    out.push_back(indent + "  Part: ");
+    out.back() += p->name;
+  }
+}
+
+using Traversal = cad::domain::DepthFirstTraversal<const Assembly *>;
+
+// Pre-order visitor producing the listing lines of one subtree.
+class LineCollector {
+public:
+  LineCollector(std::vector<std::string> &out, std::size_t baseDepth)
+      : out_(out), baseDepth_(baseDepth) {}
+
+  bool enter(const Assembly *assembly, std::size_t depth) {
+    appendNodeLines(*assembly, baseDepth_ + depth, out_, parts_);
+    return true;
+  }
+
+  template <typename Push>
+  void children(const Assembly *assembly, Push &&push) {
+    sortChildren(*assembly, children_);
+    for (const Assembly *child : children_) {
+      push(child);
+    }
+  }
+
+  void leave(const Assembly *, std::size_t) {}
+
+private:
+  std::vector<std::string> &out_;
+  std::size_t baseDepth_;
+  std::vector<const Part *> parts_;
+  std::vector<const Assembly *> children_;
+};
+
+void collectLines(const Assembly &assembly, std::vector<std::string> &out,
+                  std::size_t depth, Traversal &traversal) {
+  LineCollector collector(out, depth);
+  traversal.run(&assembly, collector);
+}
+
+// Lines rendered by one task, with the output of tasks it spawned to be
+// spliced in before lines[index].
+struct Buffer {
+  std::vector<std::string> lines;
+  std::vector<std::pair<std::size_t, std::future<Buffer>>> splices;
+};
+
+// Splice nesting follows task nesting, which is logarithmic in the model
+// size (see ParallelLister::render), so the recursion here is shallow.
+void spliceInto(Buffer &buffer, std::vector<std::string> &out,
+                cad::concurrency::ThreadPool &pool) {
+  std::size_t from = 0;
+  for (auto &[index, pending] : buffer.splices) {
+    std::move(buffer.lines.begin() + from, buffer.lines.begin() + index,
+              std::back_inserter(out));
+    from = index;
+    Buffer child = pool.await(pending);
+    spliceInto(child, out, pool);
+  }
+  std::move(buffer.lines.begin() + from, buffer.lines.end(),
+            std::back_inserter(out));
+}
+
+class ParallelLister {
+public:
+  ParallelLister(cad::concurrency::ThreadPool &pool,
+                 const cad::domain::SubtreeSizes &sizes, std::size_t grain)
+      : pool_(pool), sizes_(sizes), grain_(grain) {}
+
+  Buffer renderRoot(const Assembly &root) {
+    Buffer buffer;
+    render(root, 0, buffer);
+    return buffer;
+  }
+
+private:
+  // A child's output: a task to splice in, or a small subtree to render in
+  // place.
+  struct Piece {
+    std::future<Buffer> task;
+    const Assembly *subtree = nullptr;
+  };
+
+  std::size_t sizeOf(const Assembly &assembly) const {
+    return sizes_.sizeOf(assembly);
+  }
+
+  bool isLarge(const Assembly &assembly) const {
+    return sizes_.atLeast(assembly, grain_);
+  }
+
+  // Turns a run of siblings into pieces: large children become tasks, runs
+  // of small children are batched into tasks of about `grain_` nodes, and a
+  // trailing run smaller than that is left to render in place.
+  std::vector<Piece> schedule(const Assembly *const *begin,
+                              const Assembly *const *end, std::size_t depth) {
+    std::vector<Piece> pieces;
+    std::vector<const Assembly *> batch;
+    std::size_t batchSize = 0;
+    auto flush = [&] {
+      if (batch.empty()) {
+        return;
+      }
+      pieces.push_back({pool_.submit([batch = std::move(batch), depth] {
+        Buffer out;
+        Traversal traversal;
+        for (const Assembly *child : batch) {
+          collectLines(*child, out.lines, depth, traversal);
+        }
+        return out;
+      })});
+      batch.clear();
+      batchSize = 0;
+    };
+
+    for (auto it = begin; it != end; ++it) {
+      const Assembly *child = *it;
+      if (isLarge(*child)) {
+        flush();
+        pieces.push_back({pool_.submit([this, child, depth] {
+          Buffer out;
+          render(*child, depth, out);
+          return out;
+        })});
+        continue;
+      }
+      batch.push_back(child);
+      batchSize += sizeOf(*child);
+      if (batchSize >= grain_) {
+        flush();
+      }
+    }
+    for (const Assembly *child : batch) {
+      pieces.push_back({{}, child});
+    }
+    return pieces;
+  }
+
+  void place(std::vector<Piece> &pieces, std::size_t depth, Buffer &buffer,
+             Traversal &traversal) {
+    for (auto &piece : pieces) {
+      if (piece.task.valid()) {
+        buffer.splices.emplace_back(buffer.lines.size(), std::move(piece.task));
+      } else {
+        collectLines(*piece.subtree, buffer.lines, depth, traversal);
+      }
+    }
+  }
+
+  // Renders a large subtree into `buffer`. The largest large child of each
+  // node is continued in this task rather than spawned, so chains and
+  // caterpillars do not nest tasks; every spawned child is at most half its
+  // parent's size, which bounds task nesting by log2(size / grain). Siblings
+  // after the continued child are scheduled right away, but their output is
+  // placed once the continued subtree is complete.
+  void render(const Assembly &top, std::size_t topDepth, Buffer &buffer) {
+    Traversal traversal;
+    std::vector<const Part *> parts;
+    std::vector<const Assembly *> children;
+    std::vector<std::pair<std::size_t, std::vector<Piece>>> tails;
+
+    const Assembly *node = &top;
+    std::size_t depth = topDepth;
+    while (node) {
+      appendNodeLines(*node, depth, buffer.lines, parts);
+      sortChildren(*node, children);
+
+      const Assembly *continuation = nullptr;
+      for (const Assembly *child : children) {
+        if (isLarge(*child) &&
+            (!continuation || sizeOf(*child) > sizeOf(*continuation))) {
+          continuation = child;
+        }
+      }
+      const Assembly *const *first = children.data();
+      const Assembly *const *last = first + children.size();
+      const Assembly *const *split = std::find(first, last, continuation);
+
+      auto before = schedule(first, split, depth + 1);
+      place(before, depth + 1, buffer, traversal);
+      if (continuation) {
+        tails.emplace_back(depth + 1, schedule(split + 1, last, depth + 1));
+      }
+      node = continuation;
+      ++depth;
+    }
+    while (!tails.empty()) {
+      place(tails.back().second, tails.back().first, buffer, traversal);
+      tails.pop_back();
+    }
+  }
+
+  cad::concurrency::ThreadPool &pool_;
+  const cad::domain::SubtreeSizes &sizes_;
+  const std::size_t grain_;
+};
+
+// Pre-order visitor handing every node to a ListingWriterPort in listing
+// order. The path and the scratch vectors are reused, so after the first
+// few nodes nothing is allocated.
+class RecordEmitter {
+public:
+  explicit RecordEmitter(cad::ports::ListingWriterPort &writer) : writer_(writer) {}
+
+  bool enter(const Assembly *assembly, std::size_t depth) {
+    writer_.addRecord({Kind::Assembly, path_.enter(assembly->name, depth), depth,
+                       assembly->id.value.view(), assembly->name.view()});
+
+    sortParts(*assembly, parts_);
+    for (const Part *part : parts_) {
+      writer_.addRecord({Kind::Part, path_.part(part->name), depth + 1,
+                         part->id.value.view(), part->name.view()});
+    }
+    return true;
+  }
+
+  template <typename Push>
+  void children(const Assembly *assembly, Push &&push) {
+    sortChildren(*assembly, children_);
+    for (const Assembly *child : children_) {
+      push(child);
+    }
+  }
+
+  void leave(const Assembly *, std::size_t) {}
+
+private:
+  using Kind = cad::ports::ListingRecord::Kind;
+
+  cad::ports::ListingWriterPort &writer_;
+  ModelPath path_;
+  std::vector<const Part *> parts_;
+  std::vector<const Assembly *> children_;
+};
+
+} // namespace
+
+void writeModelListing(const Model &model, cad::ports::ListingWriterPort &writer) {
+  RecordEmitter emitter(writer);
+  Traversal().run(&model.root, emitter);
+}
+
+std::vector<std::string> listModelLines(const Model &model) {
+  std::vector<std::string> lines;
+  Traversal traversal;
+  collectLines(model.root, lines, 0, traversal);
+  return lines;
+}
+
+std::vector<std::string> listModelLines(const Model &model,
+                                        cad::concurrency::ThreadPool &pool) {
+  if (pool.size() < 2) {
+    return listModelLines(model);
+  }
+  const cad::domain::SubtreeSizes sizes(model.root, kMinGrain);
+  std::size_t total = sizes.total();
+  std::size_t grain =
+      std::max(kMinGrain, total / (pool.size() * kTasksPerWorker));
+  if (total < 2 * grain) {
+    return listModelLines(model);
+  }
+
+  ParallelLister lister(pool, sizes, grain);
+  Buffer root = lister.renderRoot(model.root);
+  std::vector<std::string> lines;
+  lines.reserve(total);
+  spliceInto(root, lines, pool);
+  return lines;
+}
+
+} // namespace cad::usecase
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/Model.hpp"
+#include "cpp/cad/core/ports/ListingWriterPort.hpp"
+
+namespace cad::usecase {
+
+// Renders a model as indented "Assembly: " / "Part: " lines with siblings
+// sorted by name. Shared by every variant of the listing use case so their
+// output stays identical.
+std::vector<std::string> listModelLines(const cad::domain::Model &model);
+
+// Same output, byte for byte, rendered on `pool`. Subtrees and batches of
+// small sibling subtrees above a size threshold become tasks that fill their
+// own buffers; the buffers are spliced back in sorted order. Small models are
+// rendered serially.
+std::vector<std::string> listModelLines(const cad::domain::Model &model,
+                                        cad::concurrency::ThreadPool &pool);
+
+// The same nodes in the same order as records, streamed to `writer` during
+// one traversal; finish() is left to the caller.
+void writeModelListing(const cad::domain::Model &model,
+                       cad::ports::ListingWriterPort &writer);
+
+} // namespace cad::usecase
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cad::usecase {
+
+// Node paths such as "/Root/Engine/Piston", built during a pre-order
+// traversal. Every output naming nodes by path (listing records, the part
+// table, measurements, duplicate groups) uses this one format. The buffer is
+// reused, so after the first few nodes a path costs one append.
+class ModelPath {
+public:
+  // Moves to the assembly `name` entered at `depth` and returns its path,
+  // valid until the next call.
+  std::string_view enter(std::string_view name, std::size_t depth) {
+    // Back to the parent's path, then down to this assembly
+    ends_.resize(depth);
+    path_.resize(depth == 0 ? 0 : ends_.back());
+    path_ += '/';
+    path_ += name;
+    ends_.push_back(path_.size());
+    return path_;
+  }
+
+  // The path of the part `name` of the assembly entered last, valid until
+  // the next call.
+  std::string_view part(std::string_view name) {
+    path_.resize(ends_.back());
+    path_ += '/';
+    path_ += name;
+    return path_;
+  }
+
+private:
+  std::string path_;
+  std::vector<std::size_t> ends_; // path length of each entered ancestor
+};
+
+} // namespace cad::usecase
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <memory_resource>
+#include <string>
+
+#include "cpp/cad/core/concurrency/MemoryBudget.hpp"
+#include "cpp/cad/core/domain/Model.hpp"
+#include "cpp/cad/core/domain/ModelArena.hpp"
+#include "cpp/cad/core/domain/Name.hpp"
+#include "cpp/cad/core/ports/LoggerPort.hpp"
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+
+namespace cad::usecase {
+
+// What ReadBudget assumes of a read of unknown size by default
+inline constexpr std::size_t kDefaultUnknownReadBytes = std::size_t(64) << 20;
+
+// Memory admission for use cases that read whole models. Without a budget
+// reads run as they come.
+struct ReadBudget {
+  cad::concurrency::MemoryBudget *budget = nullptr;
+  // Upstream of the model arena for reads over budget, e.g. a file-backed
+  // resource; nullptr leaves them on the heap. Only the model goes there:
+  // what a reader builds while parsing (the JSON DOM, say) and interned
+  // names stay on the heap. The name pool is still counted, see admitRead.
+  std::pmr::memory_resource *spill = nullptr;
+  // Bytes assumed for a read whose reader cannot estimate it, e.g. from a
+  // stream that cannot seek such as input the data source decompresses. 0
+  // treats such reads like reads over budget: they run alone.
+  std::size_t unknownReadBytes = kDefaultUnknownReadBytes;
+};
+
+// Spilled arenas start with chunks this large, so the spill resource sees
+// few, large allocations
+inline constexpr std::size_t kSpillArenaInitialBytes = std::size_t(1) << 20;
+
+struct AdmittedRead {
+  cad::concurrency::MemoryBudget::Reservation reservation;
+  bool spilled = false; // the model goes to ReadBudget::spill
+};
+
+// Admits a read expected to need `estimate` bytes (0: unknown, see
+// ReadBudget::unknownReadBytes for what readWithinBudget assumes). The
+// interned-name pool, which never shrinks, is charged to the budget as
+// resident first. A read that fits what is left is admitted, waiting its
+// turn. Any other read is spilled and waits for the whole capacity, so it
+// runs alone; a nested read that cannot have it (see MemoryBudget), or any
+// read once the pool has taken the whole limit, runs spilled without a
+// reservation.
+inline AdmittedRead admitRead(const ReadBudget &budget, std::size_t estimate) {
+  AdmittedRead admitted;
+  if (!budget.budget) {
+    return admitted;
+  }
+  budget.budget->setResident(cad::domain::Name::poolBytes());
+  if (estimate > 0) {
+    admitted.reservation = budget.budget->admit(estimate);
+  }
+  if (!admitted.reservation) {
+    admitted.spilled = true;
+    if (const std::size_t capacity = budget.budget->capacity(); capacity > 0) {
+      admitted.reservation = budget.budget->admit(capacity);
+    }
+  }
+  return admitted;
+}
+
+// Opens `locator`, admits its read against `budget`, reads the model into
+// an arena (spilled when over budget) and hands it to `use`. Returns an
+// ERROR line if the model could not be opened or read, else an empty
+// string; exceptions from `use` propagate. With `progress`, the read
+// reports to it and stops once it is cancelled. Source, Reader and Logger
+// are ports or concrete adapters, as in BasicListModelPartsUseCase.
+template <typename Source, typename Reader, typename Logger, typename Use>
+std::string readWithinBudget(const ReadBudget &budget, Source &source, Reader &reader,
+                             Logger &logger, const std::string &locator,
+                             cad::ports::ProgressPort *progress, Use &&use) {
+  logger.log(cad::ports::LogLevel::Info, std::string("Opening locator: ") + locator);
+  auto stream = source.open(locator);
+  if (!stream || !(*stream)) {
+    logger.log(cad::ports::LogLevel::Error, "Failed to open locator: " + locator);
+    return "ERROR: failed to open locator";
+  }
+
+  // Admitted before anything is parsed; a read over budget builds its
+  // model in the spill resource and runs alone
+  AdmittedRead admitted;
+  if (budget.budget) {
+    const std::size_t estimate = reader.estimateReadBytes(*stream);
+    admitted = admitRead(budget, estimate > 0 ? estimate : budget.unknownReadBytes);
+    const std::string spilling = budget.spill ? " and spilling: " : ": ";
+    if (estimate == 0 && admitted.spilled) {
+      logger.log(cad::ports::LogLevel::Warn,
+                 budget.unknownReadBytes > 0
+                     ? "Read size unknown, assumed over the memory budget, reading alone" + spilling +
+                           locator
+                     : "Read size unknown, reading alone" + spilling + locator);
+    } else if (estimate == 0) {
+      logger.log(cad::ports::LogLevel::Info,
+                 "Read size unknown, assuming " + std::to_string(budget.unknownReadBytes) +
+                     " bytes: " + locator);
+    } else if (admitted.spilled) {
+      logger.log(cad::ports::LogLevel::Warn,
+                 "Over the memory budget, reading alone" + spilling + locator);
+    }
+  }
+
+  // The model only lives for `use`: parse it into an arena and drop it in
+  // one go instead of freeing it node by node.
+  const bool spill = admitted.spilled && budget.spill;
+  cad::domain::ModelArena arena(
+      spill ? kSpillArenaInitialBytes : cad::domain::ModelArena::kDefaultInitialBytes,
+      spill ? budget.spill : std::pmr::get_default_resource());
+  const cad::domain::Model *model = nullptr;
+  try {
+    model = &arena.adopt(progress
+                             ? reader.readModelFromStream(*stream, arena.resource(), *progress)
+                             : reader.readModelFromStream(*stream, arena.resource()));
+  } catch (const cad::ports::ReadCancelled &) {
+    logger.log(cad::ports::LogLevel::Warn, "Cancelled reading locator: " + locator);
+    return "ERROR: read cancelled";
+  } catch (const std::exception &e) {
+    // e.g. corrupt compressed input reported by the stream buffer
+    logger.log(cad::ports::LogLevel::Error,
+               "Failed to read locator: " + locator + ": " + e.what());
+    return "ERROR: failed to read model";
+  }
+  if (stream->bad()) {
+    // A reader that stopped at a stream error as if at the end of the
+    // input; the model is incomplete
+    logger.log(cad::ports::LogLevel::Error,
+               "Failed to read locator: " + locator + ": stream error");
+    return "ERROR: failed to read model";
+  }
+  use(*model);
+  return {};
+}
+
+} // namespace cad::usecase
@@ -0,0 +1,324 @@
+#include "cpp/cad/core/usecase/ResolveReferencesUseCase.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+#include "cpp/cad/core/domain/Traversal.hpp"
+#include "cpp/cad/core/usecase/ModelListing.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::Part;
+using cad::ports::LogLevel;
+
+namespace cad::usecase {
+
+namespace {
+
+// One referenced file, read into its own arena so that files can be read in
+// parallel; the stitched model copies out of it.
+struct LoadedFile {
+  std::unique_ptr<cad::domain::ModelArena> arena;
+  const Model *model = nullptr;
+};
+
+// Collects the resolved locators of every reference below an assembly.
+struct ReferenceCollector {
+  const std::string &base;
+  std::set<std::string> &found;
+
+  bool enter(const Assembly *assembly, std::size_t) {
+    for (const auto &part : assembly->parts) {
+      if (!part.reference.empty()) {
+        found.insert(ResolveReferencesUseCase::resolveLocator(base, part.reference));
+      }
+    }
+    return true;
+  }
+  template <typename Push> void children(const Assembly *assembly, Push &&push) {
+    for (const auto &child : assembly->children) {
+      push(&child);
+    }
+  }
+  void leave(const Assembly *, std::size_t) {}
+};
+
+// Moves a copied sub-model into place: composes every placement with the
+// referencing part's and qualifies prototype ids by the defining file, since
+// ids (OCCT label entries, say) are only unique within one file.
+struct SubModelPlacer {
+  const cad::domain::Placement &placement;
+  const std::string &locator;
+
+  bool enter(Assembly *assembly, std::size_t) {
+    for (auto &part : assembly->parts) {
+      part.placement = cad::domain::compose(placement, part.placement);
+      if (!part.prototypeId.empty()) {
+        part.prototypeId.insert(0, locator + "#");
+      }
+    }
+    return true;
+  }
+  template <typename Push> void children(Assembly *assembly, Push &&push) {
+    for (auto &child : assembly->children) {
+      push(&child);
+    }
+  }
+  void leave(Assembly *, std::size_t) {}
+};
+
+// The chain of files leading to an assembly, to stop reference cycles.
+struct FileChain {
+  std::string locator;
+  const FileChain *parent;
+
+  bool contains(const std::string &other) const {
+    for (const FileChain *file = this; file; file = file->parent) {
+      if (file->locator == other) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+struct GraftNode {
+  Assembly *assembly;
+  const FileChain *file;
+};
+
+// Replaces referencing parts with copies of the referenced models, top-down,
+// so references inside a copied sub-model are resolved when it is entered.
+class Grafter {
+public:
+  Grafter(const std::map<std::string, LoadedFile> &files,
+          cad::ports::LoggerPort &logger, ResolveReferencesUseCase::Stats &stats)
+      : files_(files), logger_(logger), stats_(stats) {}
+
+  bool enter(const GraftNode &node, std::size_t) {
+    Assembly &assembly = *node.assembly;
+    grafted_.clear();
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < assembly.parts.size(); ++i) {
+      Part &part = assembly.parts[i];
+      if (!part.reference.empty() && graft(node, part)) {
+        continue;
+      }
+      if (kept != i) {
+        assembly.parts[kept] = std::move(part);
+      }
+      ++kept;
+    }
+    assembly.parts.erase(assembly.parts.begin() + static_cast<std::ptrdiff_t>(kept),
+                         assembly.parts.end());
+    return true;
+  }
+
+  template <typename Push> void children(const GraftNode &node, Push &&push) {
+    // Grafted sub-models were appended last; everything before them belongs
+    // to the same file as the parent
+    auto &children = node.assembly->children;
+    std::size_t own = children.size() - grafted_.size();
+    for (std::size_t i = 0; i < children.size(); ++i) {
+      push(GraftNode{&children[i], i < own ? node.file : grafted_[i - own]});
+    }
+  }
+
+  void leave(const GraftNode &, std::size_t) {}
+
+private:
+  bool graft(const GraftNode &node, const Part &part) {
+    std::string locator =
+        ResolveReferencesUseCase::resolveLocator(node.file->locator, part.reference);
+    if (node.file->contains(locator)) {
+      logger_.log(LogLevel::Warn, "Reference cycle through " + locator + " in " +
+                                      node.file->locator);
+      ++stats_.unresolved;
+      return false;
+    }
+    auto file = files_.find(locator);
+    if (file == files_.end() || !file->second.model) {
+      ++stats_.unresolved;
+      return false;
+    }
+    // Copied with the arena's allocator, as the parent's children vector
+    // constructs it in place
+    Assembly &child = node.assembly->children.emplace_back(file->second.model->root);
+    child.name = part.name;
+    SubModelPlacer placer{part.placement, locator};
+    cad::domain::DepthFirstTraversal<Assembly *>().run(&child, placer);
+    chains_.push_back(FileChain{std::move(locator), node.file});
+    grafted_.push_back(&chains_.back());
+    ++stats_.resolved;
+    return true;
+  }
+
+  const std::map<std::string, LoadedFile> &files_;
+  cad::ports::LoggerPort &logger_;
+  ResolveReferencesUseCase::Stats &stats_;
+  std::deque<FileChain> chains_;            // stable addresses
+  std::vector<const FileChain *> grafted_;  // for the node just entered
+};
+
+} // namespace
+
+ResolveReferencesUseCase::ResolveReferencesUseCase(
+    cad::ports::ModelDataSourcePort &source, cad::ports::CadModelReaderPort &reader,
+    cad::ports::LoggerPort &logger, cad::concurrency::ThreadPool &pool)
+    : source_(source), reader_(reader), logger_(logger), pool_(pool) {}
+
+std::string ResolveReferencesUseCase::resolveLocator(std::string_view base,
+                                                     std::string_view reference) {
+  std::filesystem::path path(std::string{reference});
+  if (path.is_absolute()) {
+    return path.generic_string();
+  }
+  return (std::filesystem::path(std::string{base}).parent_path() / path)
+      .lexically_normal()
+      .generic_string();
+}
+
+const Model &ResolveReferencesUseCase::load(const std::string &locator,
+                                            cad::domain::ModelArena &arena,
+                                            Stats *stats,
+                                            cad::ports::ProgressPort *progress) const {
+  auto stream = source_.open(locator);
+  if (!stream || !(*stream)) {
+    throw std::runtime_error("failed to open locator: " + locator);
+  }
+  return load(locator, *stream, arena, stats, progress);
+}
+
+const Model &ResolveReferencesUseCase::load(const std::string &locator,
+                                            std::istream &stream,
+                                            cad::domain::ModelArena &arena,
+                                            Stats *stats,
+                                            cad::ports::ProgressPort *progress) const {
+  Stats counts;
+  auto read = [this, progress](std::istream &in, cad::domain::ModelArena &into) -> Model & {
+    return into.adopt(progress ? reader_.readModelFromStream(in, into.resource(), *progress)
+                               : reader_.readModelFromStream(in, into.resource()));
+  };
+  // A cancelled read stops the whole load rather than leaving one
+  // reference unresolved
+  auto readFile = [this, read](const std::string &fileLocator) {
+    LoadedFile loaded;
+    auto stream = source_.open(fileLocator);
+    if (!stream || !(*stream)) {
+      logger_.log(LogLevel::Warn, "Failed to open referenced file: " + fileLocator);
+      return loaded;
+    }
+    try {
+      loaded.arena = std::make_unique<cad::domain::ModelArena>();
+      loaded.model = &read(*stream, *loaded.arena);
+    } catch (const cad::ports::ReadCancelled &) {
+      throw;
+    } catch (const std::exception &e) {
+      logger_.log(LogLevel::Warn,
+                  "Failed to read referenced file: " + fileLocator + ": " + e.what());
+      loaded.model = nullptr;
+    }
+    return loaded;
+  };
+
+  // The top-level file goes straight into the caller's arena
+  Model &model = read(stream, arena);
+  ++counts.filesRead;
+
+  // Referenced files, one level of nesting per round; each round runs in
+  // parallel and files already seen are never read again
+  std::map<std::string, LoadedFile> files;
+  std::set<std::string> next;
+  ReferenceCollector top{locator, next};
+  cad::domain::DepthFirstTraversal<const Assembly *> traversal;
+  traversal.run(&model.root, top);
+  next.erase(locator);
+  while (!next.empty()) {
+    // The source may start fetching the whole level while the first files
+    // are parsed
+    source_.prefetch(std::vector<std::string>(next.begin(), next.end()));
+    std::vector<std::pair<std::string, std::future<LoadedFile>>> pending;
+    for (const auto &fileLocator : next) {
+      files.emplace(fileLocator, LoadedFile{});
+      pending.emplace_back(fileLocator, pool_.submit([readFile, fileLocator] {
+                             return readFile(fileLocator);
+                           }));
+    }
+    next.clear();
+    try {
+      for (auto &[fileLocator, future] : pending) {
+        LoadedFile &loaded = files[fileLocator] = pool_.await(future);
+        if (!loaded.model) {
+          continue;
+        }
+        ++counts.filesRead;
+        ReferenceCollector collector{fileLocator, next};
+        traversal.run(&loaded.model->root, collector);
+      }
+    } catch (...) {
+      // The other reads of the level are cancelled too; let them unwind
+      // before the source and the arenas they use go away
+      for (auto &task : pending) {
+        if (task.second.valid()) {
+          try {
+            pool_.await(task.second);
+          } catch (...) {
+          }
+        }
+      }
+      throw;
+    }
+    for (auto it = next.begin(); it != next.end();) {
+      it = files.count(*it) != 0 || *it == locator ? next.erase(it) : std::next(it);
+    }
+  }
+
+  FileChain root{locator, nullptr};
+  Grafter grafter(files, logger_, counts);
+  cad::domain::DepthFirstTraversal<GraftNode>().run(GraftNode{&model.root, &root},
+                                                    grafter);
+  logger_.log(LogLevel::Debug, "Read " + std::to_string(counts.filesRead) +
+                                   " files, resolved " +
+                                   std::to_string(counts.resolved) + " references");
+  if (stats) {
+    *stats = counts;
+  }
+  return model;
+}
+
+std::vector<std::string>
+ResolveReferencesUseCase::list(const std::string &locator,
+                               cad::ports::ProgressPort *progress) const {
+  logger_.log(LogLevel::Info, std::string("Opening locator: ") + locator);
+  auto stream = source_.open(locator);
+  if (!stream || !(*stream)) {
+    logger_.log(LogLevel::Error, "Failed to open locator: " + locator);
+    return {"ERROR: failed to open locator"};
+  }
+  cad::domain::ModelArena arena;
+  try {
+    Stats stats;
+    const Model &model = load(locator, *stream, arena, &stats, progress);
+    if (stats.unresolved != 0) {
+      logger_.log(LogLevel::Warn, std::to_string(stats.unresolved) +
+                                      " references could not be resolved");
+    }
+    return listModelLines(model);
+  } catch (const cad::ports::ReadCancelled &) {
+    logger_.log(LogLevel::Warn, "Cancelled reading locator: " + locator);
+    return {"ERROR: read cancelled"};
+  } catch (const std::exception &e) {
+    logger_.log(LogLevel::Error, "Failed to read locator: " + locator + ": " + e.what());
+    return {"ERROR: failed to read model"};
+  }
+}
+
+} // namespace cad::usecase
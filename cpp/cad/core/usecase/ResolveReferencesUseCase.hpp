@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/Model.hpp"
+#include "cpp/cad/core/domain/ModelArena.hpp"
+#include "cpp/cad/core/ports/CadModelReaderPort.hpp"
+#include "cpp/cad/core/ports/LoggerPort.hpp"
+#include "cpp/cad/core/ports/ModelDataSourcePort.hpp"
+#include "cpp/cad/core/ports/ProgressPort.hpp"
+
+namespace cad::usecase {
+
+// Loads assemblies split over many files. Parts with a Part::reference are
+// defined by another file, opened through the data source relative to the
+// file naming it. Referenced files are read concurrently on `pool`, one
+// level of nesting at a time, and each file is read once however often it
+// is referenced. Every reference is then replaced by an assembly holding a
+// copy of the referenced model, with placements composed and prototype ids
+// qualified by the defining file.
+class ResolveReferencesUseCase {
+public:
+  ResolveReferencesUseCase(cad::ports::ModelDataSourcePort &source,
+                           cad::ports::CadModelReaderPort &reader,
+                           cad::ports::LoggerPort &logger,
+                           cad::concurrency::ThreadPool &pool);
+
+  struct Stats {
+    std::size_t filesRead = 0;  // including the top-level file
+    std::size_t resolved = 0;   // references replaced by their model
+    std::size_t unresolved = 0; // missing, unreadable or cyclic; left as parts
+  };
+
+  // Builds the stitched model in `arena`. Throws std::runtime_error if the
+  // top-level file cannot be opened; problems with referenced files are
+  // logged and counted instead. Every file read reports to `progress`, if
+  // given, and once it is cancelled the load throws ReadCancelled.
+  const cad::domain::Model &load(const std::string &locator,
+                                 cad::domain::ModelArena &arena,
+                                 Stats *stats = nullptr,
+                                 cad::ports::ProgressPort *progress = nullptr) const;
+
+  // load() rendered like ListModelPartsUseCase::list, or an ERROR line.
+  std::vector<std::string> list(const std::string &locator,
+                                cad::ports::ProgressPort *progress = nullptr) const;
+
+  // `reference` relative to the directory of `base`; absolute references
+  // are returned unchanged.
+  static std::string resolveLocator(std::string_view base,
+                                    std::string_view reference);
+
+private:
+  const cad::domain::Model &load(const std::string &locator, std::istream &stream,
+                                 cad::domain::ModelArena &arena, Stats *stats,
+                                 cad::ports::ProgressPort *progress) const;
+
+  cad::ports::ModelDataSourcePort &source_;
+  cad::ports::CadModelReaderPort &reader_;
+  cad::ports::LoggerPort &logger_;
+  cad::concurrency::ThreadPool &pool_;
+};
+
+} // namespace cad::usecase
@@ -0,0 +1,148 @@
+#include <catch2/catch_all.hpp>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <zlib.h>
+
+#include "cpp/cad/adapters/cad-model-reader/auto/AutoDetectingCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/json/JsonCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/common/FormatProbe.hpp"
+
+using cad::adapters::autodetect::AutoDetectingCadModelReaderAdapter;
+using cad::adapters::common::ModelFormat;
+using cad::adapters::common::parseStepHeader;
+using cad::adapters::common::probeFormat;
+
+namespace {
+
+const char *kStepHeader =
+    "ISO-10303-21;\n"
+    "HEADER;\n"
+    "/* Generated by software containing ST-Developer */\n"
+    "FILE_DESCRIPTION(('CAx-IF Rec.Pracs.', 'it''s a test'),'2;1');\n"
+    "FILE_NAME('0.75 INCH BALL VALVE','2019-03-11T14:22:05',('Author'),\n"
+    "  ('Org'),'ST-DEVELOPER v18','SOLIDWORKS 2018','');\n"
+    "FILE_SCHEMA(('AP242_MANAGED_MODEL_BASED_3D_ENGINEERING_MIM_LF'));\n"
+    "ENDSEC;\n"
+    "DATA;\n";
+
+const char *kJsonModel = R"({
+  "assemblies": [{"id": "root", "name": "Valve", "parent_id": null}],
+  "parts": [{"id": "stem", "name": "Stem", "assembly_id": "root"}]
+})";
+
+std::string gzip(const std::string &plain) {
+  z_stream zs{};
+  REQUIRE(deflateInit2(&zs, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8,
+                       Z_DEFAULT_STRATEGY) == Z_OK);
+  std::string out(deflateBound(&zs, plain.size()), '\0');
+  zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(plain.data()));
+  zs.avail_in = static_cast<uInt>(plain.size());
+  zs.next_out = reinterpret_cast<Bytef *>(out.data());
+  zs.avail_out = static_cast<uInt>(out.size());
+  REQUIRE(deflate(&zs, Z_FINISH) == Z_STREAM_END);
+  out.resize(zs.total_out);
+  deflateEnd(&zs);
+  return out;
+}
+
+// A streambuf that refuses to seek, like a pipe.
+class PipeStreamBuf : public std::stringbuf {
+public:
+  explicit PipeStreamBuf(const std::string &content) : std::stringbuf(content) {}
+
+protected:
+  pos_type seekoff(off_type, std::ios_base::seekdir,
+                   std::ios_base::openmode) override {
+    return pos_type(off_type(-1));
+  }
+  pos_type seekpos(pos_type, std::ios_base::openmode) override {
+    return pos_type(off_type(-1));
+  }
+};
+
+void registerReaders(AutoDetectingCadModelReaderAdapter &reader,
+                     int &jsonReadersCreated) {
+  reader.registerReader(ModelFormat::FakeText, [] {
+    return std::make_unique<cad::adapters::fake::FakeCadModelReaderAdapter>();
+  });
+  reader.registerReader(ModelFormat::Json, [&jsonReadersCreated] {
+    ++jsonReadersCreated;
+    return std::make_unique<cad::adapters::json::JsonCadModelReaderAdapter>();
+  });
+}
+
+} // namespace
+
+TEST_CASE("probeFormat classifies inputs by their first bytes") {
+  REQUIRE(probeFormat(kStepHeader).format == ModelFormat::Step);
+  REQUIRE(probeFormat(std::string("\xef\xbb\xbf  ") + kStepHeader).format ==
+          ModelFormat::Step);
+  REQUIRE(probeFormat(kJsonModel).format == ModelFormat::Json);
+  REQUIRE(probeFormat("Assembly: A\nPart: B\nEndAssembly\n").format ==
+          ModelFormat::FakeText);
+  REQUIRE(probeFormat(gzip("anything")).format == ModelFormat::Gzip);
+  REQUIRE(probeFormat(std::string("\x28\xb5\x2f\xfd\x00", 5)).format ==
+          ModelFormat::Zstd);
+  REQUIRE(probeFormat("PK\x03\x04").format == ModelFormat::Unknown);
+  REQUIRE(probeFormat("").format == ModelFormat::Unknown);
+}
+
+TEST_CASE("parseStepHeader extracts the HEADER section") {
+  auto header = parseStepHeader(kStepHeader);
+  REQUIRE(header.complete);
+  REQUIRE(header.name == "0.75 INCH BALL VALVE");
+  REQUIRE(header.originatingSystem == "SOLIDWORKS 2018");
+  REQUIRE(header.description ==
+          std::vector<std::string>{"CAx-IF Rec.Pracs.", "it's a test"});
+  REQUIRE(header.schemas ==
+          std::vector<std::string>{
+              "AP242_MANAGED_MODEL_BASED_3D_ENGINEERING_MIM_LF"});
+
+  SECTION("A truncated prefix yields what was parsed so far") {
+    std::string text = kStepHeader;
+    auto partial = parseStepHeader(text.substr(0, text.find("FILE_SCHEMA")));
+    REQUIRE_FALSE(partial.complete);
+    REQUIRE(partial.name == "0.75 INCH BALL VALVE");
+    REQUIRE(partial.schemas.empty());
+  }
+}
+
+TEST_CASE("AutoDetectingCadModelReaderAdapter dispatches on content") {
+  int jsonReadersCreated = 0;
+  AutoDetectingCadModelReaderAdapter reader;
+  registerReaders(reader, jsonReadersCreated);
+
+  SECTION("Fake text") {
+    std::istringstream stream("Assembly: Frame\nPart: Bolt\nEndAssembly\n");
+    auto model = reader.readModelFromStream(stream);
+    REQUIRE(model.root.children.size() == 1);
+    REQUIRE(model.root.children[0].parts[0].name == "Bolt");
+    REQUIRE(jsonReadersCreated == 0);
+  }
+
+  SECTION("JSON, created once and reused") {
+    for (int i = 0; i < 2; ++i) {
+      std::istringstream stream(kJsonModel);
+      auto model = reader.readModelFromStream(stream);
+      REQUIRE(model.root.name == "Valve");
+      REQUIRE(model.root.parts.size() == 1);
+    }
+    REQUIRE(jsonReadersCreated == 1);
+  }
+
+  SECTION("Gzip-wrapped JSON from a non-seekable stream") {
+    PipeStreamBuf pipe(gzip(kJsonModel));
+    std::istream stream(&pipe);
+    auto model = reader.readModelFromStream(stream);
+    REQUIRE(model.root.name == "Valve");
+    REQUIRE(model.root.parts[0].name == "Stem");
+  }
+
+  SECTION("Formats without a registered reader") {
+    std::istringstream stream(kStepHeader);
+    auto model = reader.readModelFromStream(stream);
+    REQUIRE(model.root.name == "No reader for model format: step");
+  }
+}
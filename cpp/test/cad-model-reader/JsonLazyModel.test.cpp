@@ -0,0 +1,277 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstddef>
+#include <fstream>
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/adapters/cad-model-reader/json/JsonCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/lazy/ExpandingCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/domain/LazyModel.hpp"
+#include "cpp/cad/core/usecase/BrowseModelUseCase.hpp"
+#include "cpp/cad/core/usecase/ListModelPartsUseCase.hpp"
+#include "cpp/test/support/CountingResource.hpp"
+#include "cpp/test/support/GeneratedModels.hpp"
+
+using cad::adapters::json::JsonCadModelReaderAdapter;
+using cad::domain::Assembly;
+using cad::test::CountingResource;
+using cad::test::makeJsonModel;
+
+namespace {
+
+// Every node with its id, prototype and reference, in model order
+void describe(const Assembly &assembly, const std::string &indent,
+              std::vector<std::string> &lines) {
+  lines.push_back(indent + "A " + std::string(assembly.id.value) + " " +
+                  std::string(assembly.name));
+  for (const auto &part : assembly.parts) {
+    lines.push_back(indent + "  P " + std::string(part.id.value) + " " +
+                    std::string(part.name) + " " + std::string(part.reference));
+  }
+  for (const auto &child : assembly.children) {
+    describe(child, indent + "  ", lines);
+  }
+}
+
+std::vector<std::string> describe(const Assembly &root) {
+  std::vector<std::string> lines;
+  describe(root, "", lines);
+  return lines;
+}
+
+std::string readTestData(const std::string &name) {
+  for (const std::string prefix : {"../test-data/", "test-data/", "../../test-data/"}) {
+    std::ifstream file(prefix + name);
+    if (file) {
+      std::ostringstream content;
+      content << file.rdbuf();
+      return content.str();
+    }
+  }
+  return {};
+}
+
+// A root with one part and one child whose first expansion fails halfway,
+// as a reader does on a malformed child or a kernel exception
+class FailingOnceModel final : public cad::domain::LazyModel {
+public:
+  FailingOnceModel() : LazyModel(cad::domain::DomainAllocator{}, 0) {
+    rootNode().name = "Root";
+  }
+  int calls = 0;
+
+private:
+  void expandNode(std::size_t key, Assembly &node, std::vector<std::size_t> &childKeys) override {
+    ++calls;
+    if (key != 0) {
+      return;
+    }
+    node.parts.emplace_back().name = "Bolt";
+    if (calls == 1) {
+      throw std::runtime_error("malformed child");
+    }
+    node.children.emplace_back().name = "Frame";
+    childKeys.push_back(1);
+  }
+};
+
+} // namespace
+
+TEST_CASE("A failed expansion leaves the assembly to be rebuilt", "[lazy]") {
+  FailingOnceModel model;
+  REQUIRE_THROWS_AS(model.expand(model.root()), std::runtime_error);
+  REQUIRE(!model.isExpanded(model.root()));
+  REQUIRE(model.root().parts.empty());
+  REQUIRE(model.root().children.empty());
+  REQUIRE(model.expandedCount() == 0);
+
+  model.expand(model.root());
+  REQUIRE(model.calls == 2);
+  REQUIRE(model.isExpanded(model.root()));
+  REQUIRE(model.root().parts.size() == 1);
+  REQUIRE(model.root().children.size() == 1);
+  REQUIRE(!model.isExpanded(model.root().children[0]));
+  REQUIRE(model.expandedCount() == 1);
+}
+
+TEST_CASE("Lazily opened JSON models expand to the read model", "[lazy]") {
+  JsonCadModelReaderAdapter reader;
+  auto check = [&](const std::string &content) {
+    std::istringstream eagerStream(content);
+    std::vector<std::string> expected = describe(reader.readModelFromStream(eagerStream).root);
+    std::istringstream lazyStream(content);
+    REQUIRE(describe(std::move(*reader.openLazyModel(lazyStream)).expandAll().root) ==
+            expected);
+  };
+
+  SECTION("Sample files") {
+    for (const char *name : {"simple_model.json", "complex_model.json",
+                             "assembly/line.json", "assembly/press.json"}) {
+      std::string content = readTestData(name);
+      if (!content.empty()) {
+        check(content);
+      }
+    }
+  }
+
+  SECTION("Duplicate ids, orphans and unknown owners") {
+    check(R"({
+      "assemblies": [
+        {"id": "root", "name": "Root", "parent_id": null},
+        {"id": "a", "name": "First", "parent_id": "root"},
+        {"id": "a", "name": "Second", "parent_id": "root"},
+        {"id": "orphan", "name": "Orphan"},
+        {"id": "b", "name": "B", "parent_id": "missing"},
+        {"id": "nameless", "parent_id": "root"}
+      ],
+      "parts": [
+        {"id": "p1", "name": "P1", "assembly_id": "a"},
+        {"id": "p2", "name": "P2", "assembly_id": "nowhere"},
+        {"id": "p3", "name": "P3", "assembly_id": "root", "reference": "other.json"}
+      ]
+    })");
+  }
+
+  SECTION("Assemblies only named as parents") {
+    check(R"({
+      "assemblies": [
+        {"id": "k", "name": "K", "parent_id": "ghost"},
+        {"id": "ghost", "parent_id": "root"},
+        {"id": "leaf", "name": "Leaf", "parent_id": "k"}
+      ]
+    })");
+  }
+
+  SECTION("Cycles and a missing root") {
+    check(R"({
+      "assemblies": [
+        {"id": "x", "name": "X", "parent_id": "y"},
+        {"id": "y", "name": "Y", "parent_id": "x"},
+        {"id": "z", "name": "Z"}
+      ]
+    })");
+  }
+
+  SECTION("Malformed content") {
+    check("{ invalid json }");
+    check("{}");
+    check(R"({"assemblies": [{"id": 7, "name": "Seven"}]})");
+    check(R"({"assemblies": [{"id": "root", "name": "Root"}], "assemblies": []})");
+  }
+}
+
+TEST_CASE("Lazily opened JSON models build only expanded assemblies", "[lazy]") {
+  JsonCadModelReaderAdapter reader;
+  CountingResource resource;
+  std::istringstream stream(makeJsonModel(100, 10).text);
+  auto model = reader.openLazyModel(stream, &resource);
+
+  const std::size_t opened = resource.bytes;
+  REQUIRE(model->root().name == "Root");
+  REQUIRE(!model->isExpanded(model->root()));
+  REQUIRE(model->root().children.empty());
+  REQUIRE(model->expandedCount() == 0);
+
+  model->expand(model->root());
+  REQUIRE(model->root().children.size() == 100);
+  REQUIRE(model->root().children[0].parts.empty());
+  const std::size_t rootExpanded = resource.bytes;
+
+  const Assembly &first = model->root().children[0];
+  model->expand(first);
+  model->expand(first); // cached
+  REQUIRE(first.parts.size() == 10);
+  REQUIRE(model->expandedCount() == 2);
+  REQUIRE(model->isExpanded(first));
+  REQUIRE(!model->isExpanded(model->root().children[1]));
+  const std::size_t oneChildExpanded = resource.bytes;
+
+  Assembly complete = std::move(*model).expandAll().root;
+  REQUIRE(complete.children[99].parts.size() == 10);
+  CHECK(opened < rootExpanded);
+  CHECK(oneChildExpanded - rootExpanded < (resource.bytes - rootExpanded) / 10);
+}
+
+TEST_CASE("Lazily opened JSON models intern names only as assemblies expand", "[lazy]") {
+  // Names no other test uses, as the pool is shared by the whole process
+  std::string text = R"({"assemblies": [{"id": "span-root", "name": "Span Root"})";
+  std::string parts;
+  for (int a = 0; a < 50; ++a) {
+    const std::string id = "span-a" + std::to_string(a);
+    text += R"(, {"id": ")" + id + R"(", "name": "Span A)" + std::to_string(a) +
+            R"(", "parent_id": "span-root"})";
+    for (int p = 0; p < 4; ++p) {
+      parts += std::string(parts.empty() ? "" : ", ") + R"({"id": ")" + id + "p" +
+               std::to_string(p) + R"(", "name": "Span Part )" + std::to_string(a) + "." +
+               std::to_string(p) + R"(", "assembly_id": ")" + id + R"("})";
+    }
+  }
+  text += R"(], "parts": [)" + parts + "]}";
+
+  JsonCadModelReaderAdapter reader;
+  std::istringstream stream(text);
+  const std::size_t before = cad::domain::Name::poolStats().names;
+  auto model = reader.openLazyModel(stream);
+  REQUIRE(cad::domain::Name::poolStats().names == before + 2); // the root's id and name
+
+  model->expand(model->root());
+  REQUIRE(cad::domain::Name::poolStats().names == before + 2 + 100);
+  model->expand(model->root().children[0]);
+  REQUIRE(model->root().children[0].parts[3].name == "Span Part 0.3");
+  REQUIRE(cad::domain::Name::poolStats().names == before + 2 + 100 + 8);
+}
+
+TEST_CASE("Listing through an expanding reader matches the eager listing", "[lazy]") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  JsonCadModelReaderAdapter reader;
+  cad::adapters::lazy::ExpandingCadModelReaderAdapter expanding(reader);
+
+  std::string content = readTestData("complex_model.json");
+  if (content.empty()) {
+    content = makeJsonModel(5, 3).text;
+  }
+  source.registerContent("mem:model", content);
+
+  cad::usecase::ListModelPartsUseCase eager(source, reader, logger);
+  cad::usecase::ListModelPartsUseCase lazy(source, expanding, logger);
+  REQUIRE(lazy.list("mem:model") == eager.list("mem:model"));
+}
+
+TEST_CASE("BrowseModelUseCase shows one assembly", "[lazy]") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  JsonCadModelReaderAdapter reader;
+  source.registerContent("mem:model", R"({
+    "assemblies": [
+      {"id": "root", "name": "Car", "parent_id": null},
+      {"id": "engine", "name": "Engine", "parent_id": "root"},
+      {"id": "body", "name": "Body", "parent_id": "root"},
+      {"id": "head", "name": "Head", "parent_id": "engine"}
+    ],
+    "parts": [
+      {"id": "p2", "name": "Piston", "assembly_id": "engine"},
+      {"id": "p1", "name": "Crank", "assembly_id": "engine"},
+      {"id": "v1", "name": "Valve", "assembly_id": "head"}
+    ]
+  })");
+  cad::usecase::BrowseModelUseCase usecase(source, reader, logger);
+
+  REQUIRE(usecase.browse("mem:model", {}) ==
+          std::vector<std::string>{"Assembly: Car", "  Assembly: Body", "  Assembly: Engine"});
+  REQUIRE(usecase.browse("mem:model", {"Engine"}) ==
+          std::vector<std::string>{"Assembly: Engine", "  Part: Crank", "  Part: Piston",
+                                   "  Assembly: Head"});
+  REQUIRE(usecase.browse("mem:model", {"Engine", "Head"}) ==
+          std::vector<std::string>{"Assembly: Head", "  Part: Valve"});
+  REQUIRE(usecase.browse("mem:model", {"Wheel"}) ==
+          std::vector<std::string>{"ERROR: no assembly named Wheel"});
+  REQUIRE(usecase.browse("mem:missing", {}) ==
+          std::vector<std::string>{"ERROR: failed to open locator"});
+}
@@ -1,6 +1,12 @@
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
 #include <sstream>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "cpp/cad/adapters/cad-model-reader/opencascade/OpenCascadeCadModelReaderAdapter.hpp"
@@ -8,6 +14,121 @@
 using cad::adapters::opencascade::OpenCascadeCadModelReaderAdapter;
 using cad::domain::Model;
 
+namespace {
+
+// Opens the ball valve from one of the usual working directories
+bool openBallValve(std::ifstream& stepFile) {
+  for (const char* path : {"../test-data/ExampleBallValve.step",
+                           "test-data/ExampleBallValve.step",
+                           "../../test-data/ExampleBallValve.step"}) {
+    stepFile.open(path);
+    if (stepFile.is_open()) {
+      return true;
+    }
+    stepFile.clear();
+  }
+  return false;
+}
+
+// Every node as "path|prototype|translation", in reading order
+std::vector<std::string> flatten(const cad::domain::Assembly& root) {
+  std::vector<std::string> nodes;
+  std::function<void(const cad::domain::Assembly&, const std::string&)> visit =
+      [&](const cad::domain::Assembly& assembly, const std::string& parent) {
+        std::string path = parent + "/" + std::string(assembly.name);
+        nodes.push_back(path);
+        for (const auto& part : assembly.parts) {
+          const auto& t = part.placement.translation;
+          nodes.push_back(path + "/" + std::string(part.name) + "|" +
+                          std::string(part.prototypeId) + "|" + std::to_string(t[0]) +
+                          "," + std::to_string(t[1]) + "," + std::to_string(t[2]));
+        }
+        for (const auto& child : assembly.children) {
+          visit(child, path);
+        }
+      };
+  visit(root, "");
+  return nodes;
+}
+
+// An assembly of two products both named "Bolt", each defined in a file of
+// its own: left.step and right.step
+const char kSameNamedReferences[] = R"(ISO-10303-21;
+HEADER;
+FILE_DESCRIPTION((''),'2;1');
+FILE_NAME('bolts.step','2024-01-01T00:00:00',(''),(''),'','','');
+FILE_SCHEMA(('AUTOMOTIVE_DESIGN { 1 0 10303 214 1 1 1 1 }'));
+ENDSEC;
+DATA;
+#1=APPLICATION_CONTEXT('automotive design');
+#2=APPLICATION_PROTOCOL_DEFINITION('international standard','automotive_design',2000,#1);
+#3=PRODUCT_CONTEXT('',#1,'mechanical');
+#4=PRODUCT_DEFINITION_CONTEXT('part definition',#1,'design');
+#5=(LENGTH_UNIT()NAMED_UNIT(*)SI_UNIT(.MILLI.,.METRE.));
+#6=(NAMED_UNIT(*)PLANE_ANGLE_UNIT()SI_UNIT($,.RADIAN.));
+#7=(NAMED_UNIT(*)SI_UNIT($,.STERADIAN.)SOLID_ANGLE_UNIT());
+#8=UNCERTAINTY_MEASURE_WITH_UNIT(LENGTH_MEASURE(1.E-07),#5,'distance_accuracy_value','');
+#9=(GEOMETRIC_REPRESENTATION_CONTEXT(3)GLOBAL_UNCERTAINTY_ASSIGNED_CONTEXT((#8))GLOBAL_UNIT_ASSIGNED_CONTEXT((#5,#6,#7))REPRESENTATION_CONTEXT('',''));
+#10=CARTESIAN_POINT('',(0.,0.,0.));
+#11=DIRECTION('',(0.,0.,1.));
+#12=DIRECTION('',(1.,0.,0.));
+#13=AXIS2_PLACEMENT_3D('',#10,#11,#12);
+#14=CARTESIAN_POINT('',(50.,0.,0.));
+#15=AXIS2_PLACEMENT_3D('',#14,#11,#12);
+#16=DOCUMENT_TYPE('');
+#20=PRODUCT('Top','Top','',(#3));
+#21=PRODUCT_DEFINITION_FORMATION('','',#20);
+#22=PRODUCT_DEFINITION('design','',#21,#4);
+#23=PRODUCT_DEFINITION_SHAPE('','',#22);
+#24=SHAPE_REPRESENTATION('',(#13,#15),#9);
+#25=SHAPE_DEFINITION_REPRESENTATION(#23,#24);
+#30=PRODUCT('Bolt','Bolt','',(#3));
+#31=PRODUCT_DEFINITION_FORMATION('','',#30);
+#32=DOCUMENT_FILE('left.step','','',#16,'',$);
+#33=PRODUCT_DEFINITION_WITH_ASSOCIATED_DOCUMENTS('design','',#31,#4,(#32));
+#34=PRODUCT_DEFINITION_SHAPE('','',#33);
+#35=SHAPE_REPRESENTATION('',(#13),#9);
+#36=SHAPE_DEFINITION_REPRESENTATION(#34,#35);
+#37=NEXT_ASSEMBLY_USAGE_OCCURRENCE('1','left','',#22,#33,$);
+#38=PRODUCT_DEFINITION_SHAPE('','',#37);
+#39=ITEM_DEFINED_TRANSFORMATION('','',#13,#13);
+#40=(REPRESENTATION_RELATIONSHIP('','',#35,#24)REPRESENTATION_RELATIONSHIP_WITH_TRANSFORMATION(#39)SHAPE_REPRESENTATION_RELATIONSHIP());
+#41=CONTEXT_DEPENDENT_SHAPE_REPRESENTATION(#40,#38);
+#50=PRODUCT('Bolt','Bolt','',(#3));
+#51=PRODUCT_DEFINITION_FORMATION('','',#50);
+#52=DOCUMENT_FILE('right.step','','',#16,'',$);
+#53=PRODUCT_DEFINITION_WITH_ASSOCIATED_DOCUMENTS('design','',#51,#4,(#52));
+#54=PRODUCT_DEFINITION_SHAPE('','',#53);
+#55=SHAPE_REPRESENTATION('',(#13),#9);
+#56=SHAPE_DEFINITION_REPRESENTATION(#54,#55);
+#57=NEXT_ASSEMBLY_USAGE_OCCURRENCE('2','right','',#22,#53,$);
+#58=PRODUCT_DEFINITION_SHAPE('','',#57);
+#59=ITEM_DEFINED_TRANSFORMATION('','',#13,#15);
+#60=(REPRESENTATION_RELATIONSHIP('','',#55,#24)REPRESENTATION_RELATIONSHIP_WITH_TRANSFORMATION(#59)SHAPE_REPRESENTATION_RELATIONSHIP());
+#61=CONTEXT_DEPENDENT_SHAPE_REPRESENTATION(#60,#58);
+ENDSEC;
+END-ISO-10303-21;
+)";
+
+// The reference of every part, sorted
+std::vector<std::string> references(const cad::domain::Assembly& root) {
+  std::vector<std::string> found;
+  std::function<void(const cad::domain::Assembly&)> visit =
+      [&](const cad::domain::Assembly& assembly) {
+        for (const auto& part : assembly.parts) {
+          found.emplace_back(part.reference);
+        }
+        for (const auto& child : assembly.children) {
+          visit(child);
+        }
+      };
+  visit(root);
+  std::sort(found.begin(), found.end());
+  return found;
+}
+
+} // namespace
+
 TEST_CASE("OpenCascadeCadModelReaderAdapter can handle empty stream", "[opencascade]") {
   OpenCascadeCadModelReaderAdapter adapter;
   std::istringstream emptyStream("");
@@ -31,25 +152,8 @@ TEST_CASE("OpenCascadeCadModelReaderAdapter handles invalid STEP content", "[ope
 TEST_CASE("OpenCascadeCadModelReaderAdapter processes valid STEP file", "[opencascade]") {
   OpenCascadeCadModelReaderAdapter adapter;
   
-  // Try multiple possible paths for the STEP file
   std::ifstream stepFile;
-  std::vector<std::string> possiblePaths = {
-    "../test-data/ExampleBallValve.step",
-    "test-data/ExampleBallValve.step",
-    "../../test-data/ExampleBallValve.step"
-  };
-  
-  bool fileFound = false;
-  for (const auto& path : possiblePaths) {
-    stepFile.open(path);
-    if (stepFile.is_open()) {
-      fileFound = true;
-      break;
-    }
-    stepFile.clear(); // Clear error flags for next attempt
-  }
-  
-  if (!fileFound) {
+  if (!openBallValve(stepFile)) {
     // Skip this test if we can't find the STEP file
     SKIP("STEP test file not found in expected locations");
     return;
@@ -58,14 +162,14 @@ TEST_CASE("OpenCascadeCadModelReaderAdapter processes valid STEP file", "[openca
   Model model = adapter.readModelFromStream(stepFile);
   
   // With the enhanced adapter, we should get real part names and counts
-  REQUIRE(model.root.name.find("STEP Model") == 0);
+  REQUIRE(model.root.name.view().find("STEP Model") == 0);
   REQUIRE(!model.root.parts.empty());
   
   // Check that we got actual part names, not generic ones
   bool hasRealNames = false;
   for (const auto& part : model.root.parts) {
     if (part.name != "Shape_1" && part.name != "STEP_Content" && 
-        part.name.find("Entity_") != 0) {
+        part.name.view().find("Entity_") != 0) {
       hasRealNames = true;
       break;
     }
@@ -83,7 +187,223 @@ TEST_CASE("OpenCascadeCadModelReaderAdapter handles stream exceptions", "[openca
   Model model = adapter.readModelFromStream(stream);
   
   // The adapter should handle this gracefully with meaningful error messages
-  REQUIRE((model.root.name.find("Exception reading STEP file") == 0 || 
+  REQUIRE((model.root.name.view().find("Exception reading STEP file") == 0 || 
            model.root.name == "Error reading STEP file" ||
            model.root.name == "Empty STEP file"));
 }
+
+TEST_CASE("OpenCascadeCadModelReaderAdapter measures every prototype once", "[opencascade]") {
+  OpenCascadeCadModelReaderAdapter adapter;
+  std::ifstream stepFile;
+  if (!openBallValve(stepFile)) {
+    SKIP("STEP test file not found in expected locations");
+    return;
+  }
+
+  cad::concurrency::ThreadPool pool(4);
+  cad::ports::MeasuredModel measured =
+      adapter.readMeasuredModel(stepFile, pool, std::pmr::get_default_resource());
+
+  REQUIRE(!measured.prototypes.empty());
+  for (const auto& [id, properties] : measured.prototypes) {
+    CAPTURE(id);
+    REQUIRE(!properties.bounds.empty);
+    REQUIRE(properties.volume > 0);
+    REQUIRE(properties.area > 0);
+  }
+
+  // Every simple-shape part refers to a measured prototype, and instances
+  // outnumber or equal the prototypes they share
+  std::size_t instances = 0;
+  std::function<void(const cad::domain::Assembly&)> visit =
+      [&](const cad::domain::Assembly& assembly) {
+        for (const auto& part : assembly.parts) {
+          if (!part.prototypeId.empty()) {
+            ++instances;
+            REQUIRE(measured.prototypes.count(std::string(part.prototypeId)) == 1);
+          }
+        }
+        for (const auto& child : assembly.children) {
+          visit(child);
+        }
+      };
+  visit(measured.model.root);
+  REQUIRE(instances >= measured.prototypes.size());
+}
+
+TEST_CASE("OpenCascadeCadModelReaderAdapter reloads cached documents identically", "[opencascade]") {
+  std::ifstream stepFile;
+  if (!openBallValve(stepFile)) {
+    SKIP("STEP test file not found in expected locations");
+    return;
+  }
+  std::ostringstream content;
+  content << stepFile.rdbuf();
+
+  std::filesystem::path cache =
+      std::filesystem::temp_directory_path() / "cad_step_cache_test";
+  std::filesystem::remove_all(cache);
+  OpenCascadeCadModelReaderAdapter uncached;
+  OpenCascadeCadModelReaderAdapter adapter(cache.string());
+
+  std::istringstream original(content.str());
+  std::vector<std::string> expected = flatten(uncached.readModelFromStream(original).root);
+
+  std::istringstream first(content.str());
+  REQUIRE(flatten(adapter.readModelFromStream(first).root) == expected);
+  std::size_t entries = 0;
+  for (const auto& entry : std::filesystem::directory_iterator(cache)) {
+    REQUIRE(entry.path().extension() == ".xbf");
+    ++entries;
+  }
+  REQUIRE(entries == 1);
+
+  // The second read comes from the cache and must not differ
+  std::istringstream second(content.str());
+  REQUIRE(flatten(adapter.readModelFromStream(second).root) == expected);
+
+  // Prototype geometry survives the round trip
+  cad::concurrency::ThreadPool pool(2);
+  std::istringstream third(content.str());
+  REQUIRE(!adapter.readMeasuredModel(third, pool, std::pmr::get_default_resource())
+               .prototypes.empty());
+
+  std::filesystem::remove_all(cache);
+}
+
+TEST_CASE("OpenCascadeCadModelReaderAdapter profiles keep the hierarchy", "[opencascade]") {
+  using cad::adapters::opencascade::StepReadProfile;
+  std::ifstream stepFile;
+  if (!openBallValve(stepFile)) {
+    SKIP("STEP test file not found in expected locations");
+    return;
+  }
+  std::stringstream content;
+  content << stepFile.rdbuf();
+
+  auto read = [&](StepReadProfile profile) {
+    OpenCascadeCadModelReaderAdapter adapter("", profile);
+    std::istringstream stream(content.str());
+    return adapter.readModelFromStream(stream);
+  };
+  Model full = read(StepReadProfile::Full);
+  Model names = read(StepReadProfile::Names);
+  Model structure = read(StepReadProfile::Structure);
+
+  // Names drops attributes the model does not carry, so nothing changes
+  CHECK(flatten(names.root) == flatten(full.root));
+
+  // Structure keeps the same shapes in the same places under generated names
+  std::vector<std::string> fullNodes = flatten(full.root);
+  std::vector<std::string> structureNodes = flatten(structure.root);
+  REQUIRE(structureNodes.size() == fullNodes.size());
+  auto withoutPath = [](const std::string& node) {
+    std::size_t bar = node.find('|');
+    return bar == std::string::npos ? std::string() : node.substr(bar);
+  };
+  for (std::size_t i = 0; i < fullNodes.size(); ++i) {
+    CHECK(withoutPath(structureNodes[i]) == withoutPath(fullNodes[i]));
+  }
+
+  CHECK(cad::adapters::opencascade::parseStepReadProfile("names") == StepReadProfile::Names);
+  CHECK(!cad::adapters::opencascade::parseStepReadProfile("everything"));
+}
+
+TEST_CASE("OpenCascadeCadModelReaderAdapter expands lazily opened models like reads", "[opencascade]") {
+  std::ifstream stepFile;
+  if (!openBallValve(stepFile)) {
+    SKIP("STEP test file not found in expected locations");
+    return;
+  }
+  std::stringstream content;
+  content << stepFile.rdbuf();
+
+  OpenCascadeCadModelReaderAdapter adapter;
+  std::istringstream eagerStream(content.str());
+  Model eager = adapter.readModelFromStream(eagerStream);
+
+  std::istringstream lazyStream(content.str());
+  auto lazy = adapter.openLazyModel(lazyStream);
+  REQUIRE(lazy->root().name == eager.root.name);
+  REQUIRE(!lazy->isExpanded(lazy->root()));
+  REQUIRE(lazy->root().children.empty());
+
+  lazy->expand(lazy->root());
+  CHECK(lazy->expandedCount() == 1);
+  CHECK(lazy->root().children.size() == eager.root.children.size());
+  CHECK(lazy->root().parts.size() == eager.root.parts.size());
+
+  // Same names, shapes and places, unnamed shapes included
+  REQUIRE(flatten(std::move(*lazy).expandAll().root) == flatten(eager.root));
+}
+
+TEST_CASE("OpenCascadeCadModelReaderAdapter names unnamed shapes alike in every profile", "[opencascade]") {
+  std::ifstream stepFile;
+  if (!openBallValve(stepFile)) {
+    SKIP("STEP test file not found in expected locations");
+    return;
+  }
+  std::stringstream content;
+  content << stepFile.rdbuf();
+
+  // Without names every shape falls back to its label entry
+  OpenCascadeCadModelReaderAdapter adapter("", cad::adapters::opencascade::StepReadProfile::Structure);
+  std::istringstream eagerStream(content.str());
+  const std::vector<std::string> eager = flatten(adapter.readModelFromStream(eagerStream).root);
+  std::istringstream lazyStream(content.str());
+  REQUIRE(flatten(std::move(*adapter.openLazyModel(lazyStream)).expandAll().root) == eager);
+  CHECK(std::any_of(eager.begin(), eager.end(), [](const std::string& node) {
+    return node.find("/Entity_0:") != std::string::npos;
+  }));
+}
+
+TEST_CASE("OpenCascadeCadModelReaderAdapter matches prototypes against themselves", "[opencascade]") {
+  OpenCascadeCadModelReaderAdapter adapter;
+  std::ifstream stepFile;
+  if (!openBallValve(stepFile)) {
+    SKIP("STEP test file not found in expected locations");
+    return;
+  }
+
+  std::unique_ptr<cad::ports::PrototypeGeometry> geometry =
+      adapter.readPrototypeGeometry(stepFile, std::pmr::get_default_resource());
+  const std::vector<std::string> ids = geometry->prototypeIds();
+  REQUIRE(!ids.empty());
+  REQUIRE(!geometry->model().root.children.empty());
+  REQUIRE_FALSE(geometry->signature("no such prototype"));
+
+  for (const auto& id : ids) {
+    CAPTURE(id);
+    auto signature = geometry->signature(id);
+    REQUIRE(signature);
+    REQUIRE(signature->topology[1] > 0);
+    REQUIRE(signature->extents[0] <= signature->extents[1]);
+    REQUIRE(signature->extents[1] <= signature->extents[2]);
+
+    // A shape matches itself where it is
+    auto placement = geometry->match(id, id, 1e-6);
+    REQUIRE(placement);
+    for (double t : placement->translation) {
+      REQUIRE(std::abs(t) < 1e-6);
+    }
+  }
+
+  // Shapes with different topology never match
+  for (const auto& other : ids) {
+    if (geometry->signature(other)->topology != geometry->signature(ids.front())->topology) {
+      REQUIRE_FALSE(geometry->match(ids.front(), other, 1e-6));
+    }
+  }
+}
+
+TEST_CASE("OpenCascadeCadModelReaderAdapter tells same-named external products apart", "[opencascade]") {
+  OpenCascadeCadModelReaderAdapter adapter;
+  const std::vector<std::string> expected = {"left.step", "right.step"};
+
+  std::istringstream eagerStream(kSameNamedReferences);
+  REQUIRE(references(adapter.readModelFromStream(eagerStream).root) == expected);
+
+  std::istringstream lazyStream(kSameNamedReferences);
+  REQUIRE(references(std::move(*adapter.openLazyModel(lazyStream)).expandAll().root) ==
+          expected);
+}
@@ -0,0 +1,71 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+#include "cpp/cad/adapters/cad-model-reader/auto/AutoDetectingCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/json/JsonCadModelReaderAdapter.hpp"
+#include "cpp/test/support/AllocationCounter.hpp"
+#include "cpp/test/support/GeneratedModels.hpp"
+
+using cad::domain::Model;
+using cad::ports::CadModelReaderPort;
+using cad::test::GeneratedModel;
+using cad::test::makeFakeModel;
+using cad::test::makeJsonModel;
+using cad::test::Nesting;
+
+namespace {
+
+double allocationsPerNode(CadModelReaderPort &reader, const GeneratedModel &input) {
+  std::istringstream stream(input.text);
+  Model model;
+  std::size_t count = cad::test::countAllocations(
+      [&] { model = reader.readModelFromStream(stream); });
+  REQUIRE(!model.root.name.empty());
+  return static_cast<double>(count) / static_cast<double>(input.nodes);
+}
+
+} // namespace
+
+// Deep copies of subtrees show up as allocations growing faster than the
+// node count, worst in deeply nested models. Each case checks a flat and a
+// nested model at two sizes against a fixed per-node bound.
+TEST_CASE("Fake reader allocations per node stay bounded") {
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+  for (bool nested : {false, true}) {
+    for (int count : {500, 2000}) {
+      CAPTURE(nested, count);
+      const Nesting nesting = nested ? Nesting::Chain : Nesting::Flat;
+      double perNode = allocationsPerNode(reader, makeFakeModel(count, 4, nesting));
+      REQUIRE(perNode < 2.5);
+    }
+  }
+}
+
+TEST_CASE("JSON reader allocations per node stay bounded") {
+  cad::adapters::json::JsonCadModelReaderAdapter reader;
+  for (bool nested : {false, true}) {
+    for (int count : {500, 2000}) {
+      CAPTURE(nested, count);
+      const Nesting nesting = nested ? Nesting::Chain : Nesting::Flat;
+      double perNode = allocationsPerNode(reader, makeJsonModel(count, 4, nesting));
+      REQUIRE(perNode < 12.0);
+    }
+  }
+}
+
+TEST_CASE("Auto-detecting reader adds no per-node allocations") {
+  cad::adapters::autodetect::AutoDetectingCadModelReaderAdapter reader;
+  reader.registerReader(cad::adapters::common::ModelFormat::FakeText, [] {
+    return std::make_unique<cad::adapters::fake::FakeCadModelReaderAdapter>();
+  });
+  for (bool nested : {false, true}) {
+    CAPTURE(nested);
+    const Nesting nesting = nested ? Nesting::Chain : Nesting::Flat;
+    double perNode = allocationsPerNode(reader, makeFakeModel(2000, 4, nesting));
+    REQUIRE(perNode < 2.5);
+  }
+}
@@ -0,0 +1,123 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/text/TextCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/memory/SpanStreamBuf.hpp"
+
+using cad::adapters::text::TextCadModelReaderAdapter;
+using cad::domain::Assembly;
+
+namespace {
+
+void describe(const Assembly &assembly, const std::string &indent,
+              std::vector<std::string> &lines) {
+  lines.push_back(indent + "[" + std::string(assembly.name) + "]");
+  for (const auto &part : assembly.parts) {
+    lines.push_back(indent + "  <" + std::string(part.name) + ">");
+  }
+  for (const auto &child : assembly.children) {
+    describe(child, indent + "  ", lines);
+  }
+}
+
+std::vector<std::string> describe(const Assembly &root) {
+  std::vector<std::string> lines;
+  describe(root, "", lines);
+  return lines;
+}
+
+// The fake reader defines the format; the fast one must agree with it
+void checkSameAsFake(const std::string &content) {
+  std::istringstream fakeStream(content);
+  std::vector<std::string> expected = describe(
+      cad::adapters::fake::FakeCadModelReaderAdapter().readModelFromStream(fakeStream).root);
+
+  std::istringstream stream(content);
+  CHECK(describe(TextCadModelReaderAdapter().readModelFromStream(stream).root) == expected);
+  cad::adapters::memory::SpanIStream span(content);
+  CHECK(describe(TextCadModelReaderAdapter().readModelFromStream(span).root) == expected);
+}
+
+class CountingProgress final : public cad::ports::ProgressPort {
+public:
+  explicit CountingProgress(std::size_t limit) : limit_(limit) {}
+  std::size_t reports = 0;
+  std::uint64_t lastDone = 0;
+
+  void report(std::string_view, std::uint64_t done, std::uint64_t) override {
+    ++reports;
+    lastDone = done;
+  }
+  bool cancelled() override { return reports >= limit_; }
+
+private:
+  std::size_t limit_;
+};
+
+} // namespace
+
+TEST_CASE("TextCadModelReaderAdapter reads the fake text format", "[text]") {
+  SECTION("Nested assemblies") {
+    checkSameAsFake("Assembly: Engine\nPart: Piston\nAssembly: Head\nPart: Valve\n"
+                    "EndAssembly\nPart: Crank\nEndAssembly\nPart: Loose\n");
+  }
+  SECTION("Whitespace, CRLF and a missing final newline") {
+    checkSameAsFake("  Assembly:   Engine  \r\n\tPart:Piston\r\n\r\n   \nEndAssembly\r\nPart: Tail");
+  }
+  SECTION("Unmatched and unclosed assemblies") {
+    checkSameAsFake("EndAssembly\nAssembly: A\nAssembly: B\nPart: P\n");
+    checkSameAsFake("Assembly: A\nEndAssembly\nEndAssembly\nPart: Root part\n");
+  }
+  SECTION("Empty names and unknown lines") {
+    checkSameAsFake("Assembly:\nPart:\nAssemblyX\nPartial: no\nEnd\nEndAssembly  \n");
+    checkSameAsFake("");
+    checkSameAsFake("\n\n\n");
+  }
+  SECTION("Lines across block boundaries and longer than a block") {
+    std::string content;
+    for (int a = 0; a < 200; ++a) {
+      content += "Assembly: Assembly " + std::to_string(a) + "\n";
+      for (int p = 0; p < 500; ++p) {
+        content += "Part: Part " + std::to_string(p) + "\n";
+      }
+      content += "EndAssembly\n";
+    }
+    content += "Part: " + std::string(3 << 20, 'x') + "\n";
+    checkSameAsFake(content);
+  }
+}
+
+TEST_CASE("TextCadModelReaderAdapter reads in-memory streams from their position", "[text]") {
+  std::string content = "Part: Skipped\nPart: Kept\n";
+  cad::adapters::memory::SpanIStream span(content);
+  span.seekg(14);
+  auto model = TextCadModelReaderAdapter().readModelFromStream(span);
+  REQUIRE(model.root.parts.size() == 1);
+  REQUIRE(model.root.parts[0].name == "Kept");
+}
+
+TEST_CASE("TextCadModelReaderAdapter reports bytes and stops when cancelled", "[text]") {
+  std::string content;
+  for (int p = 0; p < 10000; ++p) {
+    content += "Part: P\n";
+  }
+
+  CountingProgress unlimited(SIZE_MAX);
+  std::istringstream stream(content);
+  auto model = TextCadModelReaderAdapter().readModelFromStream(
+      stream, std::pmr::get_default_resource(), unlimited);
+  REQUIRE(model.root.parts.size() == 10000);
+  REQUIRE(unlimited.reports == 10000 / cad::ports::kProgressInterval);
+  REQUIRE(unlimited.lastDone == 8 * cad::ports::kProgressInterval * unlimited.reports);
+
+  CountingProgress cancelling(2);
+  cad::adapters::memory::SpanIStream span(content);
+  REQUIRE_THROWS_AS(TextCadModelReaderAdapter().readModelFromStream(
+                        span, std::pmr::get_default_resource(), cancelling),
+                    cad::ports::ReadCancelled);
+}
@@ -0,0 +1,126 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstddef>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/json/JsonCadModelReaderAdapter.hpp"
+#include "cpp/cad/core/domain/ModelArena.hpp"
+#include "cpp/cad/core/usecase/ModelListing.hpp"
+#include "cpp/test/support/CountingResource.hpp"
+#include "cpp/test/support/GeneratedModels.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::ModelArena;
+using cad::test::CountingResource;
+using cad::test::makeFakeModel;
+
+namespace {
+
+// Installs `resource` as the default for the scope, to catch nodes that
+// escape the arena.
+class DefaultResourceScope {
+public:
+  explicit DefaultResourceScope(std::pmr::memory_resource *resource)
+      : previous_(std::pmr::set_default_resource(resource)) {}
+  ~DefaultResourceScope() { std::pmr::set_default_resource(previous_); }
+
+private:
+  std::pmr::memory_resource *previous_;
+};
+
+// Whether every node, string and vector of the subtree uses `resource`;
+// names and ids are interned and owned by no model.
+bool allocatedFrom(const Assembly &assembly, std::pmr::memory_resource *resource) {
+  if (assembly.children.get_allocator().resource() != resource ||
+      assembly.parts.get_allocator().resource() != resource) {
+    return false;
+  }
+  for (const auto &part : assembly.parts) {
+    if (part.prototypeId.get_allocator().resource() != resource ||
+        part.reference.get_allocator().resource() != resource) {
+      return false;
+    }
+  }
+  for (const auto &child : assembly.children) {
+    if (!allocatedFrom(child, resource)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("Fake reader builds the whole model in the arena") {
+  const std::string content = makeFakeModel(2000, 10).text;
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+
+  std::istringstream reference(content);
+  auto expected = cad::usecase::listModelLines(reader.readModelFromStream(reference));
+
+  CountingResource upstream;
+  CountingResource fallback;
+  {
+    DefaultResourceScope scope(&fallback);
+    ModelArena arena(ModelArena::kDefaultInitialBytes, &upstream);
+    std::istringstream stream(content);
+    Model &model = arena.adopt(reader.readModelFromStream(stream, arena.resource()));
+
+    REQUIRE(allocatedFrom(model.root, arena.resource()));
+    REQUIRE(cad::usecase::listModelLines(model) == expected);
+    // Nothing escaped to the default resource
+    REQUIRE(fallback.allocations == 0);
+    // 22k nodes and their strings come from a handful of geometrically
+    // growing chunks
+    REQUIRE(upstream.allocations < 32);
+  }
+  // Dropping the arena hands every chunk back at once
+  REQUIRE(upstream.deallocations == upstream.allocations);
+}
+
+TEST_CASE("JSON reader builds the whole model in the arena") {
+  const std::string content = R"({
+    "assemblies": [
+      {"id": "root", "name": "Root Assembly", "parent_id": null},
+      {"id": "engine", "name": "Engine", "parent_id": "root"},
+      {"id": "valves", "name": "Valve Train", "parent_id": "engine"}
+    ],
+    "parts": [
+      {"id": "p1", "name": "Piston", "assembly_id": "engine"},
+      {"id": "p2", "name": "Intake Valve", "assembly_id": "valves"},
+      {"id": "p3", "name": "Chassis", "assembly_id": "root"}
+    ]
+  })";
+  cad::adapters::json::JsonCadModelReaderAdapter reader;
+
+  std::istringstream reference(content);
+  auto expected = cad::usecase::listModelLines(reader.readModelFromStream(reference));
+
+  CountingResource fallback;
+  DefaultResourceScope scope(&fallback);
+  ModelArena arena(ModelArena::kDefaultInitialBytes, std::pmr::new_delete_resource());
+  std::istringstream stream(content);
+  Model &model = arena.adopt(reader.readModelFromStream(stream, arena.resource()));
+
+  REQUIRE(allocatedFrom(model.root, arena.resource()));
+  REQUIRE(cad::usecase::listModelLines(model) == expected);
+  REQUIRE(fallback.allocations == 0);
+}
+
+TEST_CASE("Adopting a model from another resource copies it into the arena") {
+  std::istringstream stream(makeFakeModel(50, 3).text);
+  Model outside = cad::adapters::fake::FakeCadModelReaderAdapter().readModelFromStream(stream);
+  auto expected = cad::usecase::listModelLines(outside);
+
+  ModelArena arena;
+  REQUIRE(arena.model() == nullptr);
+  Model &adopted = arena.adopt(std::move(outside));
+
+  REQUIRE(arena.model() == &adopted);
+  REQUIRE(allocatedFrom(adopted.root, arena.resource()));
+  REQUIRE(cad::usecase::listModelLines(adopted) == expected);
+}
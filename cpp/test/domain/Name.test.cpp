@@ -0,0 +1,106 @@
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpp/cad/core/domain/Name.hpp"
+
+using cad::domain::Name;
+
+TEST_CASE("Equal text interns to one entry", "[domain][name]") {
+  std::string text = "Hex Bolt M6";
+  Name a(text);
+  Name b("Hex Bolt M6");
+  Name c(std::string_view(text).substr(0, 8));
+
+  CHECK(a == b);
+  CHECK(a.data() == b.data());
+  CHECK(a != c);
+  CHECK(c == "Hex Bolt");
+  CHECK("Hex Bolt M6" == a);
+  CHECK(a == text);
+  CHECK(a.view() == text);
+  CHECK(std::string(a.c_str()) == text);
+
+  Name::PoolStats before = Name::poolStats();
+  Name again(std::string("Hex Bolt M6"));
+  CHECK(Name::poolStats().names == before.names);
+  CHECK(Name::poolStats().bytes == before.bytes);
+
+  // A new name grows the pool for good (its text may fit a chunk the arena
+  // already holds, its index entry does not)
+  Name fresh("Hex Bolt M6, interned once");
+  CHECK(Name::poolStats().names == before.names + 1);
+  CHECK(Name::poolBytes() > before.bytes);
+
+  std::ostringstream out;
+  out << a;
+  CHECK(out.str() == text);
+}
+
+TEST_CASE("Empty names need no entry", "[domain][name]") {
+  Name empty;
+  CHECK(empty.empty());
+  CHECK(empty == Name(""));
+  CHECK(empty == "");
+  CHECK(empty.c_str()[0] == '\0');
+  CHECK(empty < Name("a"));
+}
+
+TEST_CASE("Names order as their text", "[domain][name]") {
+  // Shared prefixes longer than the rank, prefixes of one another, bytes
+  // above 0x7f and embedded zeros
+  std::vector<std::string> texts = {
+      "", "a", "ab", "abc", "b", "Bolt", "Bolt M6", "Bolt M8", "bolt",
+      "Hex Bolt M6 x 20", "Hex Bolt M6 x 25", "Hex Bolt", "Hex Bolt M6",
+      "\xc3\xa9tau", "zz", std::string("ab\0c", 4), std::string("ab\0", 3)};
+  std::mt19937 random(7);
+  for (int i = 0; i < 200; ++i) {
+    std::string text;
+    std::size_t length = random() % 12;
+    for (std::size_t c = 0; c < length; ++c) {
+      text += static_cast<char>("aAb\x80\xff"[random() % 5]);
+    }
+    texts.push_back(text);
+  }
+
+  for (const auto &x : texts) {
+    for (const auto &y : texts) {
+      INFO(x << " vs " << y);
+      CHECK((Name(x) < Name(y)) == (x < y));
+      CHECK((Name(x) == Name(y)) == (x == y));
+    }
+  }
+}
+
+TEST_CASE("Concurrent interning agrees on entries", "[domain][name]") {
+  constexpr int kThreads = 8;
+  constexpr int kNames = 2000;
+  std::vector<std::vector<Name>> seen(kThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&seen, t] {
+      for (int i = 0; i < kNames; ++i) {
+        // Every thread interns the same names in a different order
+        int n = (i * 7 + t * 131) % kNames;
+        seen[t].push_back(Name("Concurrent part " + std::to_string(n)));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::set<const char *> entries;
+  for (const auto &names : seen) {
+    for (Name name : names) {
+      entries.insert(name.data());
+    }
+  }
+  CHECK(entries.size() == kNames);
+}
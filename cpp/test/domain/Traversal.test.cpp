@@ -0,0 +1,216 @@
+#include <catch2/catch_all.hpp>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/json/JsonCadModelReaderAdapter.hpp"
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/StructuralHash.hpp"
+#include "cpp/cad/core/domain/Traversal.hpp"
+#include "cpp/cad/core/usecase/ModelListing.hpp"
+#include "cpp/test/support/CountingResource.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::DepthFirstTraversal;
+using cad::domain::Model;
+using cad::domain::Part;
+
+namespace {
+
+constexpr std::size_t kDeep = 1000000;
+
+Assembly named(const std::string &name) {
+  Assembly a;
+  a.name = name;
+  return a;
+}
+
+// Records the visiting order; subtrees named "skip" are not descended into.
+struct Recorder {
+  std::vector<std::string> events;
+
+  bool enter(const Assembly *a, std::size_t depth) {
+    events.push_back("enter " + std::string(a->name) + "@" + std::to_string(depth));
+    return a->name != "skip";
+  }
+  template <typename Push> void children(const Assembly *a, Push &&push) {
+    for (const auto &c : a->children) {
+      push(&c);
+    }
+  }
+  void leave(const Assembly *a, std::size_t) {
+    events.push_back("leave " + std::string(a->name));
+  }
+};
+
+struct DepthCounter {
+  std::size_t entered = 0;
+  std::size_t left = 0;
+  std::size_t maxDepth = 0;
+
+  bool enter(const Assembly *, std::size_t depth) {
+    ++entered;
+    maxDepth = std::max(maxDepth, depth);
+    return true;
+  }
+  template <typename Push> void children(const Assembly *a, Push &&push) {
+    for (const auto &c : a->children) {
+      push(&c);
+    }
+  }
+  void leave(const Assembly *, std::size_t) { ++left; }
+};
+
+// A chain of `depth` nested assemblies with one part at the bottom, built
+// from the leaf up so that nothing recurses.
+Model makeChain(std::size_t depth, const std::string &leafPart) {
+  Assembly current = named("L");
+  Part part;
+  part.name = leafPart;
+  current.parts.push_back(part);
+  for (std::size_t i = 1; i < depth; ++i) {
+    Assembly parent = named("L");
+    parent.children.push_back(std::move(current));
+    current = std::move(parent);
+  }
+  Model model;
+  model.root = std::move(current);
+  return model;
+}
+
+} // namespace
+
+TEST_CASE("DepthFirstTraversal visits in pre- and post-order") {
+  Assembly root = named("root");
+  Assembly a = named("a");
+  a.children.push_back(named("a1"));
+  a.children.push_back(named("a2"));
+  Assembly skip = named("skip");
+  skip.children.push_back(named("hidden"));
+  root.children.push_back(a);
+  root.children.push_back(skip);
+  root.children.push_back(named("b"));
+
+  Recorder recorder;
+  DepthFirstTraversal<const Assembly *> traversal;
+  traversal.run(&root, recorder);
+
+  REQUIRE(recorder.events ==
+          std::vector<std::string>{"enter root@0", "enter a@1", "enter a1@2",
+                                   "leave a1", "enter a2@2", "leave a2",
+                                   "leave a", "enter skip@1", "enter b@1",
+                                   "leave b", "leave root"});
+
+  SECTION("A traversal can be reused") {
+    Recorder again;
+    traversal.run(&root.children[0], again);
+    REQUIRE(again.events.front() == "enter a@0");
+    REQUIRE(again.events.back() == "leave a");
+  }
+}
+
+TEST_CASE("Models nested 1,000,000 levels deep are traversed without "
+          "recursion") {
+  Model model = makeChain(kDeep, "Bolt");
+
+  DepthCounter counter;
+  DepthFirstTraversal<const Assembly *>().run(&model.root, counter);
+  REQUIRE(counter.entered == kDeep);
+  REQUIRE(counter.left == kDeep);
+  REQUIRE(counter.maxDepth == kDeep - 1);
+
+  cad::domain::computeStructuralHashes(model.root);
+  Model other = makeChain(kDeep, "Nut");
+  cad::domain::computeStructuralHashes(other.root);
+  REQUIRE(model.root.subtreeHash != 0);
+  REQUIRE(model.root.subtreeHash != other.root.subtreeHash);
+
+  // The pool continues the chain in one task instead of nesting a task per
+  // level
+  const std::uint64_t serial = model.root.subtreeHash;
+  model.root.subtreeHash = 0;
+  cad::concurrency::ThreadPool pool(4);
+  cad::domain::computeStructuralHashes(model.root, pool);
+  REQUIRE(model.root.subtreeHash == serial);
+  // Both models are torn down iteratively at the end of this scope.
+}
+
+TEST_CASE("Deep, branching models are torn down without allocating") {
+  cad::test::CountingResource resource;
+  auto model = std::make_unique<Model>(cad::domain::DomainAllocator(&resource));
+  Assembly *node = &model->root;
+  for (std::size_t i = 0; i < 100000; ++i) {
+    node->children.emplace_back().name = "Leaf";
+    node->children.emplace_back().children.emplace_back().name = "Nested";
+    node = &node->children.emplace_back();
+    node->parts.emplace_back().name = "Bolt";
+  }
+
+  const std::size_t allocations = resource.allocations;
+  model.reset();
+  REQUIRE(resource.allocations == allocations);
+  REQUIRE(resource.outstanding == 0);
+}
+
+TEST_CASE("Readers build 1,000,000-level hierarchies") {
+  SECTION("Fake text reader") {
+    std::string text;
+    for (std::size_t i = 0; i < kDeep; ++i) {
+      text += "Assembly: L\n";
+    }
+    text += "Part: Bolt\n";
+    for (std::size_t i = 0; i < kDeep; ++i) {
+      text += "EndAssembly\n";
+    }
+    std::istringstream stream(text);
+    Model model =
+        cad::adapters::fake::FakeCadModelReaderAdapter().readModelFromStream(stream);
+
+    DepthCounter counter;
+    DepthFirstTraversal<const Assembly *>().run(&model.root, counter);
+    REQUIRE(counter.maxDepth == kDeep);
+  }
+
+  SECTION("JSON reader") {
+    std::string json = R"({"assemblies": [{"id": "a0", "name": "L", "parent_id": null})";
+    for (std::size_t i = 1; i < kDeep; ++i) {
+      json += R"(, {"id": "a)" + std::to_string(i) + R"(", "name": "L", "parent_id": "a)" +
+              std::to_string(i - 1) + R"("})";
+    }
+    json += R"(], "parts": [{"id": "p", "name": "Bolt", "assembly_id": "a)" +
+            std::to_string(kDeep - 1) + R"("}]})";
+    std::istringstream stream(json);
+    Model model =
+        cad::adapters::json::JsonCadModelReaderAdapter().readModelFromStream(stream);
+
+    DepthCounter counter;
+    DepthFirstTraversal<const Assembly *>().run(&model.root, counter);
+    REQUIRE(counter.entered == kDeep);
+    REQUIRE(counter.maxDepth == kDeep - 1);
+  }
+}
+
+// Listing output grows with the square of the depth (indentation), so deep
+// listings are checked at a depth whose output still fits in memory.
+TEST_CASE("Deep caterpillar trees list identically in parallel") {
+  Assembly current = named("Bottom");
+  for (int i = 0; i < 3000; ++i) {
+    Assembly parent = named("Level");
+    Part part;
+    part.name = "Part";
+    parent.parts.push_back(part);
+    parent.parts.push_back(part);
+    parent.children.push_back(named("Leaf"));
+    parent.children.push_back(std::move(current));
+    current = std::move(parent);
+  }
+  Model model;
+  model.root = std::move(current);
+
+  cad::concurrency::ThreadPool pool(4);
+  auto serial = cad::usecase::listModelLines(model);
+  REQUIRE(serial.size() == 1 + 3000 * 4);
+  REQUIRE(cad::usecase::listModelLines(model, pool) == serial);
+}
@@ -0,0 +1,93 @@
+#include <catch2/catch_all.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/adapters/listing-writer/json/JsonListingWriterAdapter.hpp"
+
+using cad::adapters::json::JsonListingWriterAdapter;
+using cad::ports::ListingRecord;
+
+namespace {
+
+std::vector<std::string> splitLines(const std::string &text) {
+  std::vector<std::string> lines;
+  std::istringstream stream(text);
+  for (std::string line; std::getline(stream, line);) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+} // namespace
+
+TEST_CASE("JsonListingWriterAdapter writes one object per line", "[listing]") {
+  std::ostringstream out;
+  JsonListingWriterAdapter writer(out, JsonListingWriterAdapter::Layout::Lines);
+  writer.addRecord({ListingRecord::Kind::Assembly, "/Root", 0, "root", "Root"});
+  writer.addRecord({ListingRecord::Kind::Part, "/Root/Bolt", 1, "", "Bolt"});
+  REQUIRE(out.str().empty()); // buffered until finish
+  writer.finish();
+
+  REQUIRE(splitLines(out.str()) ==
+          std::vector<std::string>{
+              R"({"path":"/Root","depth":0,"kind":"assembly","id":"root","name":"Root"})",
+              R"({"path":"/Root/Bolt","depth":1,"kind":"part","id":"","name":"Bolt"})"});
+}
+
+TEST_CASE("JsonListingWriterAdapter writes an array", "[listing]") {
+  std::ostringstream empty;
+  JsonListingWriterAdapter(empty, JsonListingWriterAdapter::Layout::Array).finish();
+  REQUIRE(nlohmann::json::parse(empty.str()) == nlohmann::json::array());
+
+  std::ostringstream out;
+  JsonListingWriterAdapter writer(out, JsonListingWriterAdapter::Layout::Array);
+  writer.addRecord({ListingRecord::Kind::Assembly, "/Root", 0, "r", "Root"});
+  writer.addRecord({ListingRecord::Kind::Part, "/Root/P", 1, "p", "P"});
+  writer.finish();
+  nlohmann::json parsed = nlohmann::json::parse(out.str());
+  REQUIRE(parsed.size() == 2);
+  REQUIRE(parsed[1]["kind"] == "part");
+  REQUIRE(parsed[1]["depth"] == 1);
+  REQUIRE(splitLines(out.str()).size() == 4); // brackets and one line per record
+}
+
+TEST_CASE("JsonListingWriterAdapter escapes strings", "[listing]") {
+  const std::string name = std::string("quote \" backslash \\ tab \t newline \n nul ") +
+                           '\0' + " bell \x07 utf-8 \xc3\xa9";
+  std::ostringstream out;
+  JsonListingWriterAdapter writer(out, JsonListingWriterAdapter::Layout::Lines);
+  writer.addRecord({ListingRecord::Kind::Part, "/" + name, 7, name, name});
+  writer.finish();
+
+  std::vector<std::string> lines = splitLines(out.str());
+  REQUIRE(lines.size() == 1);
+  REQUIRE(lines[0].find("\\u0000") != std::string::npos);
+  REQUIRE(lines[0].find("\\u0007") != std::string::npos);
+  nlohmann::json parsed = nlohmann::json::parse(lines[0]);
+  REQUIRE(parsed["name"] == name);
+  REQUIRE(parsed["id"] == name);
+  REQUIRE(parsed["path"] == "/" + name);
+  REQUIRE(parsed["depth"] == 7);
+}
+
+TEST_CASE("JsonListingWriterAdapter streams output larger than its buffer", "[listing]") {
+  std::ostringstream out;
+  JsonListingWriterAdapter writer(out, JsonListingWriterAdapter::Layout::Lines);
+  const std::string longName(3 << 20, 'x');
+  for (int i = 0; i < 50000; ++i) {
+    std::string name = "Part " + std::to_string(i);
+    writer.addRecord({ListingRecord::Kind::Part, "/Root/" + name, 1, "", name});
+  }
+  writer.addRecord({ListingRecord::Kind::Part, "/Root", 1, "", longName});
+  REQUIRE(!out.str().empty()); // full buffers were written already
+  writer.finish();
+
+  std::vector<std::string> lines = splitLines(out.str());
+  REQUIRE(lines.size() == 50001);
+  REQUIRE(nlohmann::json::parse(lines[12345])["name"] == "Part 12345");
+  REQUIRE(nlohmann::json::parse(lines.back())["name"] == longName);
+}
@@ -0,0 +1,114 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "cpp/cad/adapters/mesh-writer/gltf/GlbMeshWriterAdapter.hpp"
+
+using cad::adapters::gltf::GlbMeshWriterAdapter;
+using cad::domain::Mesh;
+using cad::domain::Placement;
+
+namespace {
+
+std::uint32_t u32(const std::string &bytes, std::size_t offset) {
+  std::uint32_t value;
+  std::memcpy(&value, bytes.data() + offset, sizeof(value));
+  return value;
+}
+
+// Splits a GLB file into its JSON document and binary chunk, checking the
+// framing on the way.
+struct Glb {
+  nlohmann::json document;
+  std::string binary;
+
+  explicit Glb(const std::string &bytes) {
+    REQUIRE(bytes.size() >= 20);
+    REQUIRE(u32(bytes, 0) == 0x46546C67);
+    REQUIRE(u32(bytes, 4) == 2);
+    REQUIRE(u32(bytes, 8) == bytes.size());
+    std::uint32_t jsonLength = u32(bytes, 12);
+    REQUIRE(jsonLength % 4 == 0);
+    REQUIRE(u32(bytes, 16) == 0x4E4F534A);
+    document = nlohmann::json::parse(bytes.substr(20, jsonLength));
+    std::size_t next = 20 + jsonLength;
+    if (next < bytes.size()) {
+      REQUIRE(u32(bytes, next + 4) == 0x004E4942);
+      binary = bytes.substr(next + 8, u32(bytes, next));
+      REQUIRE(next + 8 + binary.size() == bytes.size());
+    }
+  }
+};
+
+Mesh quad() {
+  Mesh mesh;
+  mesh.positions = {0, 0, 0, 2, 0, 0, 2, 1, 0, 0, 1, 0};
+  mesh.indices = {0, 1, 2, 0, 2, 3};
+  return mesh;
+}
+
+} // namespace
+
+TEST_CASE("GlbMeshWriterAdapter writes shared meshes once and instances as nodes") {
+  std::ostringstream out;
+  GlbMeshWriterAdapter writer(out);
+  writer.addMesh("plate", quad());
+  Placement moved;
+  moved.translation = {5, 6, 7};
+  writer.addInstance("plate", "Plate", Placement());
+  writer.addInstance("plate", "Plate", moved);
+  writer.finish();
+
+  Glb glb(out.str());
+  const auto &doc = glb.document;
+  REQUIRE(doc["asset"]["version"] == "2.0");
+  REQUIRE(doc["meshes"].size() == 1);
+  REQUIRE(doc["meshes"][0]["name"] == "plate");
+  REQUIRE(doc["nodes"].size() == 2);
+  REQUIRE(doc["nodes"][0]["mesh"] == 0);
+  REQUIRE_FALSE(doc["nodes"][0].contains("matrix"));
+  REQUIRE(doc["nodes"][1]["matrix"][12] == 5.0);
+  REQUIRE(doc["nodes"][1]["matrix"][14] == 7.0);
+  REQUIRE(doc["scenes"][0]["nodes"] == nlohmann::json::array({0, 1}));
+
+  REQUIRE(doc["buffers"][0]["byteLength"] == glb.binary.size());
+  REQUIRE(glb.binary.size() == 4 * 3 * sizeof(float) + 6 * sizeof(std::uint32_t));
+
+  const auto &positions = doc["accessors"][0];
+  REQUIRE(positions["count"] == 4);
+  REQUIRE(positions["max"] == nlohmann::json::array({2.0, 1.0, 0.0}));
+  const auto &indices = doc["accessors"][1];
+  REQUIRE(indices["count"] == 6);
+  const auto &indexView = doc["bufferViews"][indices["bufferView"].get<int>()];
+  std::uint32_t third;
+  std::memcpy(&third,
+              glb.binary.data() + indexView["byteOffset"].get<std::size_t>() +
+                  2 * sizeof(std::uint32_t),
+              sizeof(third));
+  REQUIRE(third == 2);
+}
+
+TEST_CASE("GlbMeshWriterAdapter rejects instances of unknown prototypes") {
+  std::ostringstream out;
+  GlbMeshWriterAdapter writer(out);
+  REQUIRE_THROWS_AS(writer.addInstance("missing", "Part", Placement()),
+                    std::invalid_argument);
+
+  SECTION("An empty file is still valid glTF") {
+    writer.finish();
+    Glb glb(out.str());
+    REQUIRE(glb.binary.empty());
+    // Top-level arrays, when present, need at least one item
+    for (const char *key : {"meshes", "nodes", "accessors", "bufferViews", "buffers"}) {
+      REQUIRE_FALSE(glb.document.contains(key));
+    }
+    REQUIRE(glb.document["scenes"].size() == 1);
+    REQUIRE_FALSE(glb.document["scenes"][0].contains("nodes"));
+  }
+}
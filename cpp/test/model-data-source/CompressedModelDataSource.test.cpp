@@ -0,0 +1,173 @@
+#include <catch2/catch_all.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#ifdef CAD_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/compressed/CompressedModelDataSourceAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/compressed/DecompressingStream.hpp"
+#include "cpp/cad/adapters/model-data-source/file/FileModelDataSourceAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/json/JsonModelDataSourceAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/memory/MemoryModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/usecase/ListModelPartsUseCase.hpp"
+
+using cad::adapters::compressed::Compression;
+
+namespace {
+
+std::string gzip(const std::string &plain) {
+  z_stream zs{};
+  // 15 window bits + 16 writes a gzip wrapper.
+  REQUIRE(deflateInit2(&zs, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8,
+                       Z_DEFAULT_STRATEGY) == Z_OK);
+  std::string out(deflateBound(&zs, plain.size()), '\0');
+  zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(plain.data()));
+  zs.avail_in = static_cast<uInt>(plain.size());
+  zs.next_out = reinterpret_cast<Bytef *>(out.data());
+  zs.avail_out = static_cast<uInt>(out.size());
+  REQUIRE(deflate(&zs, Z_FINISH) == Z_STREAM_END);
+  out.resize(zs.total_out);
+  deflateEnd(&zs);
+  return out;
+}
+
+std::string readAll(std::istream &stream) {
+  return std::string((std::istreambuf_iterator<char>(stream)),
+                     std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string &path, const std::string &bytes) {
+  std::ofstream file(path, std::ios::binary);
+  file << bytes;
+}
+
+// Large and repetitive, like a STEP export: spans many decoder chunks.
+std::string makeLargeText() {
+  std::string text;
+  for (int i = 0; i < 200000; ++i) {
+    text += "#" + std::to_string(i) + "=CARTESIAN_POINT('',(0.,1.,2.));\n";
+  }
+  return text;
+}
+
+} // namespace
+
+TEST_CASE("detectCompression uses magic bytes only") {
+  REQUIRE(cad::adapters::compressed::detectCompression("\x1f\x8b\x08") ==
+          Compression::Gzip);
+  REQUIRE(cad::adapters::compressed::detectCompression("\x28\xb5\x2f\xfd") ==
+          Compression::Zstd);
+  REQUIRE(cad::adapters::compressed::detectCompression("ISO-10303-21;") ==
+          Compression::None);
+  REQUIRE(cad::adapters::compressed::detectCompression("") == Compression::None);
+}
+
+TEST_CASE("FileModelDataSourceAdapter decodes gzip transparently") {
+  cad::adapters::file::FileModelDataSourceAdapter adapter;
+  const std::string text = makeLargeText();
+
+  SECTION("Single gzip member, file name without a .gz suffix") {
+    writeFile("temp_compressed.step", gzip(text));
+    auto stream = adapter.open("temp_compressed.step");
+    REQUIRE(stream != nullptr);
+    REQUIRE(readAll(*stream) == text);
+    std::filesystem::remove("temp_compressed.step");
+  }
+
+  SECTION("Concatenated gzip members") {
+    std::string half = text.substr(0, text.size() / 2);
+    std::string rest = text.substr(text.size() / 2);
+    writeFile("temp_members.gz", gzip(half) + gzip(rest));
+    auto stream = adapter.open("temp_members.gz");
+    REQUIRE(readAll(*stream) == text);
+    std::filesystem::remove("temp_members.gz");
+  }
+
+  SECTION("Uncompressed files pass through") {
+    writeFile("temp_plain.step", "ISO-10303-21;\n");
+    auto stream = adapter.open("temp_plain.step");
+    REQUIRE(readAll(*stream) == "ISO-10303-21;\n");
+    std::filesystem::remove("temp_plain.step");
+  }
+
+  SECTION("Truncated input is reported as an error") {
+    std::string compressed = gzip(text);
+    writeFile("temp_truncated.gz", compressed.substr(0, compressed.size() / 2));
+    auto stream = adapter.open("temp_truncated.gz");
+    std::string line;
+    while (std::getline(*stream, line)) {
+    }
+    REQUIRE(stream->bad());
+    std::filesystem::remove("temp_truncated.gz");
+  }
+}
+
+TEST_CASE("A truncated compressed model fails the read instead of listing part of it") {
+  cad::adapters::file::FileModelDataSourceAdapter source;
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+  std::string text;
+  for (int i = 0; i < 20000; ++i) {
+    text += "Assembly: Engine " + std::to_string(i) + "\nPart: Piston\nEndAssembly\n";
+  }
+  std::string compressed = gzip(text);
+  writeFile("temp_truncated_model.gz", compressed.substr(0, compressed.size() / 2));
+
+  SECTION("The reader throws") {
+    auto stream = source.open("temp_truncated_model.gz");
+    REQUIRE_THROWS_AS(reader.readModelFromStream(*stream), std::runtime_error);
+  }
+
+  SECTION("The listing reports an error") {
+    std::ostringstream log;
+    cad::adapters::fake::FakeLoggerAdapter logger(log);
+    cad::usecase::ListModelPartsUseCase usecase(source, reader, logger);
+    REQUIRE(usecase.list("temp_truncated_model.gz") ==
+            std::vector<std::string>{"ERROR: failed to read model"});
+  }
+  std::filesystem::remove("temp_truncated_model.gz");
+}
+
+TEST_CASE("JsonModelDataSourceAdapter opens compressed JSON") {
+  cad::adapters::json::JsonModelDataSourceAdapter adapter;
+  const std::string json = R"({"assemblies": [], "parts": []})";
+  writeFile("temp_model.json.gz", gzip(json));
+
+  auto stream = adapter.open("temp_model.json.gz");
+  REQUIRE(stream != nullptr);
+  REQUIRE(readAll(*stream) == json);
+  std::filesystem::remove("temp_model.json.gz");
+}
+
+TEST_CASE("CompressedModelDataSourceAdapter wraps any data source") {
+  cad::adapters::memory::MemoryModelDataSourceAdapter memory;
+  cad::adapters::compressed::CompressedModelDataSourceAdapter adapter(memory);
+  const std::string compressed = gzip("Assembly: Engine\nEndAssembly\n");
+  memory.registerView("mem:upload", compressed);
+
+  auto stream = adapter.open("mem:upload");
+  REQUIRE(readAll(*stream) == "Assembly: Engine\nEndAssembly\n");
+  REQUIRE(adapter.open("mem:missing") == nullptr);
+}
+
+#ifdef CAD_HAVE_ZSTD
+TEST_CASE("FileModelDataSourceAdapter decodes zstd transparently") {
+  cad::adapters::file::FileModelDataSourceAdapter adapter;
+  const std::string text = makeLargeText();
+  std::string compressed(ZSTD_compressBound(text.size()), '\0');
+  compressed.resize(ZSTD_compress(compressed.data(), compressed.size(),
+                                  text.data(), text.size(), 3));
+  writeFile("temp_compressed.zst", compressed);
+
+  auto stream = adapter.open("temp_compressed.zst");
+  REQUIRE(readAll(*stream) == text);
+  std::filesystem::remove("temp_compressed.zst");
+}
+#endif
@@ -0,0 +1,107 @@
+#include <catch2/catch_all.hpp>
+#include <atomic>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpp/cad/adapters/model-data-source/memory/MemoryModelDataSourceAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/memory/SpanStreamBuf.hpp"
+
+using cad::adapters::memory::MemoryModelDataSourceAdapter;
+using cad::adapters::memory::SpanIStream;
+
+TEST_CASE("MemoryModelDataSourceAdapter serves buffers without copying") {
+  MemoryModelDataSourceAdapter adapter;
+  const std::string upload = "Assembly: Engine\nPart: Piston\nEndAssembly\n";
+
+  SECTION("Returns null for unknown locators") {
+    REQUIRE(adapter.open("mem:missing") == nullptr);
+    REQUIRE_FALSE(adapter.view("mem:missing").has_value());
+  }
+
+  SECTION("Streams read straight from the caller-owned bytes") {
+    adapter.registerView("mem:upload", upload);
+
+    auto stream = adapter.open("mem:upload");
+    REQUIRE(stream != nullptr);
+    auto *span = dynamic_cast<SpanIStream *>(stream.get());
+    REQUIRE(span != nullptr);
+    REQUIRE(span->view().data() == upload.data());
+
+    std::string content((std::istreambuf_iterator<char>(*stream)),
+                        std::istreambuf_iterator<char>());
+    REQUIRE(content == upload);
+
+    auto view = adapter.view("mem:upload");
+    REQUIRE(view.has_value());
+    REQUIRE(view->bytes.data() == upload.data());
+    REQUIRE(view->bytes.size() == upload.size());
+  }
+
+  SECTION("Streams support seeking") {
+    adapter.registerView("mem:upload", upload);
+    auto stream = adapter.open("mem:upload");
+
+    std::string word;
+    *stream >> word;
+    REQUIRE(word == "Assembly:");
+    stream->seekg(0, std::ios::end);
+    REQUIRE(static_cast<std::size_t>(stream->tellg()) == upload.size());
+    stream->seekg(10);
+    *stream >> word;
+    REQUIRE(word == "Engine");
+  }
+
+  SECTION("Ref-counted buffers outlive unregistration while streams are open") {
+    auto shared = std::make_shared<const std::string>(upload);
+    std::weak_ptr<const std::string> watch = shared;
+    adapter.registerBuffer("mem:shared", std::move(shared));
+
+    auto stream = adapter.open("mem:shared");
+    REQUIRE(adapter.unregister("mem:shared"));
+    REQUIRE(adapter.open("mem:shared") == nullptr);
+    REQUIRE_FALSE(watch.expired());
+
+    std::string line;
+    std::getline(*stream, line);
+    REQUIRE(line == "Assembly: Engine");
+
+    stream.reset();
+    REQUIRE(watch.expired());
+  }
+}
+
+TEST_CASE("MemoryModelDataSourceAdapter handles concurrent opens") {
+  MemoryModelDataSourceAdapter adapter;
+  std::vector<std::string> uploads;
+  for (int i = 0; i < 16; ++i) {
+    uploads.push_back(std::string(4096, static_cast<char>('a' + i)));
+  }
+  for (int i = 0; i < 16; ++i) {
+    adapter.registerView("mem:" + std::to_string(i), uploads[i]);
+  }
+
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t] {
+      for (int round = 0; round < 200; ++round) {
+        int i = (t + round) % 16;
+        auto stream = adapter.open("mem:" + std::to_string(i));
+        std::string content((std::istreambuf_iterator<char>(*stream)),
+                            std::istreambuf_iterator<char>());
+        if (content != uploads[i]) {
+          ++mismatches;
+        }
+        if (round % 50 == 0) {
+          adapter.registerView("mem:extra" + std::to_string(t), uploads[i]);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  REQUIRE(mismatches == 0);
+}
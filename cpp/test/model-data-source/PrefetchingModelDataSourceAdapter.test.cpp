@@ -0,0 +1,223 @@
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpp/cad/adapters/model-data-source/memory/MemoryModelDataSourceAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/prefetch/PrefetchingModelDataSourceAdapter.hpp"
+
+using cad::adapters::memory::MemoryModelDataSourceAdapter;
+using cad::adapters::prefetch::PrefetchingModelDataSourceAdapter;
+
+namespace {
+
+// Memory source counting opens per locator; while held, opens block, like
+// reads from slow storage
+class RecordingSource final : public cad::ports::ModelDataSourcePort {
+public:
+  MemoryModelDataSourceAdapter memory;
+
+  std::unique_ptr<std::istream> open(const std::string &locator) override {
+    std::unique_lock lock(mutex_);
+    ++opens_[locator];
+    changed_.notify_all();
+    changed_.wait(lock, [this] { return !held_; });
+    lock.unlock();
+    return memory.open(locator);
+  }
+
+  int opens(const std::string &locator) {
+    std::lock_guard lock(mutex_);
+    return opens_[locator];
+  }
+
+  int totalOpens() {
+    std::lock_guard lock(mutex_);
+    int total = 0;
+    for (const auto &entry : opens_) {
+      total += entry.second;
+    }
+    return total;
+  }
+
+  void hold(bool held) {
+    std::lock_guard lock(mutex_);
+    held_ = held;
+    changed_.notify_all();
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::map<std::string, int> opens_;
+  bool held_ = false;
+};
+
+std::string readAll(std::istream &stream) {
+  return std::string((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+}
+
+// Polls `condition` for up to five seconds
+template <typename Condition> bool eventually(Condition condition) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("PrefetchingModelDataSourceAdapter serves hinted locators from read-ahead buffers") {
+  RecordingSource inner;
+  inner.memory.registerBuffer("mem:a", std::make_shared<const std::string>("Assembly: A\n"));
+  inner.memory.registerBuffer("mem:b", std::make_shared<const std::string>("Assembly: B\n"));
+  inner.memory.registerBuffer("mem:c", std::make_shared<const std::string>("Assembly: C\n"));
+  PrefetchingModelDataSourceAdapter adapter(inner);
+
+  adapter.prefetch({"mem:a", "mem:b"});
+  REQUIRE(eventually([&] { return inner.totalOpens() == 2; }));
+
+  for (const char *name : {"a", "b", "c"}) {
+    auto stream = adapter.open(std::string("mem:") + name);
+    REQUIRE(stream != nullptr);
+    REQUIRE(readAll(*stream) == std::string("Assembly: ") + char(name[0] - 'a' + 'A') + "\n");
+  }
+  // Hinted locators were read once, by the adapter
+  REQUIRE(inner.opens("mem:a") == 1);
+  REQUIRE(inner.opens("mem:b") == 1);
+  REQUIRE(adapter.stats().hits == 2);
+  REQUIRE(adapter.stats().misses == 1);
+
+  // A buffer is handed over once; opening again reads through
+  auto again = adapter.open("mem:a");
+  REQUIRE(readAll(*again) == "Assembly: A\n");
+  REQUIRE(inner.opens("mem:a") == 2);
+  REQUIRE(adapter.stats().misses == 2);
+}
+
+TEST_CASE("PrefetchingModelDataSourceAdapter stops reading ahead at the budget") {
+  RecordingSource inner;
+  for (const char *locator : {"mem:a", "mem:b", "mem:c"}) {
+    inner.memory.registerBuffer(locator, std::make_shared<const std::string>(1000, 'x'));
+  }
+  PrefetchingModelDataSourceAdapter adapter(inner, 1500, 1);
+
+  // The second file passes the budget; the third waits for a buffer to go
+  adapter.prefetch({"mem:a", "mem:b", "mem:c"});
+  REQUIRE(eventually([&] { return adapter.heldBytes() >= 2000; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  REQUIRE(inner.totalOpens() == 2);
+
+  auto a = adapter.open("mem:a");
+  REQUIRE(readAll(*a).size() == 1000);
+  REQUIRE(inner.totalOpens() == 2); // still held by the stream
+  a.reset();
+  REQUIRE(eventually([&] { return inner.totalOpens() == 3; }));
+
+  REQUIRE(readAll(*adapter.open("mem:b")).size() == 1000);
+  REQUIRE(readAll(*adapter.open("mem:c")).size() == 1000);
+  REQUIRE(adapter.stats().hits == 3);
+  REQUIRE(adapter.stats().peakBytes >= 2000);
+  REQUIRE(adapter.stats().peakBytes < 3000);
+  REQUIRE(eventually([&] { return adapter.heldBytes() == 0; }));
+}
+
+TEST_CASE("PrefetchingModelDataSourceAdapter drops skipped hints to keep reading ahead") {
+  RecordingSource inner;
+  for (const char *locator : {"mem:a", "mem:b", "mem:c", "mem:d", "mem:e"}) {
+    inner.memory.registerBuffer(locator, std::make_shared<const std::string>(1000, 'x'));
+  }
+  PrefetchingModelDataSourceAdapter adapter(inner, 1500, 1);
+
+  // a and b fill the budget and are never opened
+  adapter.prefetch({"mem:a", "mem:b"});
+  REQUIRE(eventually([&] { return adapter.heldBytes() >= 2000; }));
+  adapter.prefetch({"mem:c", "mem:d", "mem:e"});
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  REQUIRE(inner.totalOpens() == 2);
+
+  // Opening c passes a and b over; their buffers make room for d and e
+  REQUIRE(readAll(*adapter.open("mem:c")).size() == 1000);
+  REQUIRE(eventually([&] { return inner.opens("mem:e") == 1; }));
+  REQUIRE(adapter.stats().dropped == 2);
+  REQUIRE(readAll(*adapter.open("mem:d")).size() == 1000);
+  REQUIRE(readAll(*adapter.open("mem:e")).size() == 1000);
+  REQUIRE(adapter.stats().hits == 2);
+  REQUIRE(adapter.stats().peakBytes < 3000);
+
+  // A dropped hint opens through the inner source
+  REQUIRE(readAll(*adapter.open("mem:a")).size() == 1000);
+  REQUIRE(inner.opens("mem:a") == 2);
+  REQUIRE(eventually([&] { return adapter.heldBytes() == 0; }));
+}
+
+TEST_CASE("PrefetchingModelDataSourceAdapter waits for a read in progress") {
+  RecordingSource inner;
+  inner.memory.registerBuffer("mem:slow", std::make_shared<const std::string>("slow"));
+  PrefetchingModelDataSourceAdapter adapter(inner);
+
+  inner.hold(true);
+  adapter.prefetch({"mem:slow"});
+  REQUIRE(eventually([&] { return inner.opens("mem:slow") == 1; }));
+  auto opened = std::async(std::launch::async, [&] { return adapter.open("mem:slow"); });
+  REQUIRE(opened.wait_for(std::chrono::milliseconds(20)) == std::future_status::timeout);
+  inner.hold(false);
+
+  auto stream = opened.get();
+  REQUIRE(readAll(*stream) == "slow");
+  REQUIRE(inner.opens("mem:slow") == 1);
+  REQUIRE(adapter.stats().hits == 1);
+}
+
+TEST_CASE("PrefetchingModelDataSourceAdapter passes failures and queued locators through") {
+  RecordingSource inner;
+  inner.memory.registerBuffer("mem:a", std::make_shared<const std::string>("a"));
+  inner.memory.registerBuffer("mem:b", std::make_shared<const std::string>("b"));
+  PrefetchingModelDataSourceAdapter adapter(inner, 1 << 20, 1);
+
+  SECTION("Missing locators open as null") {
+    adapter.prefetch({"mem:missing"});
+    REQUIRE(eventually([&] { return inner.opens("mem:missing") == 1; }));
+    REQUIRE(adapter.open("mem:missing") == nullptr);
+    REQUIRE(adapter.stats().misses == 1);
+  }
+
+  SECTION("A locator not started yet skips the queue") {
+    inner.hold(true);
+    adapter.prefetch({"mem:a", "mem:b"});
+    REQUIRE(eventually([&] { return inner.opens("mem:a") == 1; }));
+    // The only I/O thread is stuck on a; b is opened straight through
+    auto b = std::async(std::launch::async, [&] { return readAll(*adapter.open("mem:b")); });
+    REQUIRE(eventually([&] { return inner.opens("mem:b") == 1; }));
+    inner.hold(false);
+    REQUIRE(b.get() == "b");
+    REQUIRE(readAll(*adapter.open("mem:a")) == "a");
+    REQUIRE(inner.opens("mem:b") == 1);
+  }
+}
+
+TEST_CASE("PrefetchingModelDataSourceAdapter streams outlive the adapter") {
+  RecordingSource inner;
+  inner.memory.registerBuffer("mem:a", std::make_shared<const std::string>("kept"));
+  std::unique_ptr<std::istream> stream;
+  {
+    PrefetchingModelDataSourceAdapter adapter(inner);
+    adapter.prefetch({"mem:a"});
+    REQUIRE(eventually([&] { return adapter.heldBytes() > 0; }));
+    stream = adapter.open("mem:a");
+    adapter.prefetch({"mem:never-opened"});
+  }
+  REQUIRE(readAll(*stream) == "kept");
+}
@@ -0,0 +1,235 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cpp/cad/adapters/part-table-writer/arrow/ArrowPartTableWriterAdapter.hpp"
+
+using cad::adapters::arrow::ArrowPartTableWriterAdapter;
+using cad::ports::PartTableBatch;
+using cad::ports::StringColumn;
+
+namespace {
+
+template <typename T> T load(std::string_view bytes, std::size_t offset) {
+  REQUIRE(offset + sizeof(T) <= bytes.size());
+  T value;
+  std::memcpy(&value, bytes.data() + offset, sizeof(value));
+  return value;
+}
+
+// Reads a flatbuffers table of `buffer` at `position`, enough to follow the
+// Arrow metadata back
+struct Table {
+  std::string_view buffer;
+  std::size_t position;
+
+  static Table root(std::string_view buffer) { return {buffer, load<std::uint32_t>(buffer, 0)}; }
+
+  // Offset of the field in `slot` from the table, 0 when absent
+  std::size_t field(int slot) const {
+    const std::size_t vtable = position - load<std::int32_t>(buffer, position);
+    const std::size_t entry = 4 + 2 * static_cast<std::size_t>(slot);
+    return entry < load<std::uint16_t>(buffer, vtable) ? load<std::uint16_t>(buffer, vtable + entry)
+                                                       : 0;
+  }
+  template <typename T> T scalar(int slot, T fallback = T()) const {
+    const std::size_t offset = field(slot);
+    return offset ? load<T>(buffer, position + offset) : fallback;
+  }
+  // Position of the object a reference field points to
+  std::size_t target(int slot) const {
+    const std::size_t at = position + field(slot);
+    REQUIRE(at != position);
+    return at + load<std::uint32_t>(buffer, at);
+  }
+  Table table(int slot) const { return {buffer, target(slot)}; }
+  std::string_view string(int slot) const {
+    const std::size_t at = target(slot);
+    return buffer.substr(at + 4, load<std::uint32_t>(buffer, at));
+  }
+  std::size_t length(int slot) const { return load<std::uint32_t>(buffer, target(slot)); }
+  Table element(int slot, std::size_t i) const {
+    const std::size_t at = target(slot) + 4 + 4 * i;
+    return {buffer, at + load<std::uint32_t>(buffer, at)};
+  }
+  // The i-th struct of a struct vector, as raw bytes at its position
+  std::size_t structAt(int slot, std::size_t i, std::size_t size) const {
+    return target(slot) + 4 + size * i;
+  }
+};
+
+// One record batch or dictionary batch read back through its metadata
+struct Message {
+  Table header;
+  std::size_t body;
+  std::uint8_t type;
+
+  Message(std::string_view file, std::size_t offset) : header{file, 0} {
+    REQUIRE(offset % 8 == 0);
+    REQUIRE(load<std::uint32_t>(file, offset) == 0xFFFFFFFF);
+    const auto metadataLength = load<std::int32_t>(file, offset + 4);
+    body = offset + 8 + static_cast<std::size_t>(metadataLength);
+    REQUIRE(body % 64 == 0);
+    Table message = Table::root(file.substr(offset + 8, static_cast<std::size_t>(metadataLength)));
+    REQUIRE(message.scalar<std::int16_t>(0) == 4); // V5
+    type = message.scalar<std::uint8_t>(1);
+    header = message.table(2);
+  }
+
+  // Offset and length of buffer `i`, relative to the file
+  std::pair<std::size_t, std::size_t> buffer(const Table &batch, std::size_t i) const {
+    const std::size_t at = batch.structAt(2, i, 16);
+    return {body + static_cast<std::size_t>(load<std::int64_t>(batch.buffer, at)),
+            static_cast<std::size_t>(load<std::int64_t>(batch.buffer, at + 8))};
+  }
+};
+
+std::vector<std::int32_t> ints(std::string_view file, std::pair<std::size_t, std::size_t> buffer) {
+  REQUIRE(buffer.first % 64 == 0);
+  std::vector<std::int32_t> values(buffer.second / 4);
+  std::memcpy(values.data(), file.data() + buffer.first, buffer.second);
+  return values;
+}
+
+std::vector<std::string> strings(std::string_view file, std::pair<std::size_t, std::size_t> offsets,
+                                 std::pair<std::size_t, std::size_t> bytes) {
+  std::vector<std::int32_t> ends = ints(file, offsets);
+  std::vector<std::string> values;
+  for (std::size_t i = 0; i + 1 < ends.size(); ++i) {
+    values.emplace_back(file.substr(bytes.first + static_cast<std::size_t>(ends[i]),
+                                    static_cast<std::size_t>(ends[i + 1] - ends[i])));
+  }
+  return values;
+}
+
+StringColumn column(const std::vector<std::string> &values) {
+  StringColumn column;
+  for (const auto &value : values) {
+    column.push_back(value);
+  }
+  return column;
+}
+
+PartTableBatch batch(const std::vector<std::string> &ids, const std::vector<std::int32_t> &paths) {
+  PartTableBatch batch;
+  batch.ids = column(ids);
+  batch.names = column(ids);
+  batch.paths = paths;
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    batch.depths.push_back(static_cast<std::int32_t>(i + 1));
+    batch.instanceCounts.push_back(2);
+  }
+  return batch;
+}
+
+} // namespace
+
+TEST_CASE("ArrowPartTableWriterAdapter writes an Arrow IPC file") {
+  std::ostringstream out;
+  ArrowPartTableWriterAdapter writer(out);
+  writer.begin(column({"/Root", "/Root/Frame"}));
+  writer.addBatch(batch({"b0", "n\xC3\xBCt"}, {0, 1}));
+  writer.addBatch(batch({"b1"}, {1}));
+  writer.finish();
+  const std::string bytes = out.str();
+  const std::string_view file(bytes);
+
+  REQUIRE(file.substr(0, 8) == std::string_view("ARROW1\0\0", 8));
+  REQUIRE(file.substr(file.size() - 6) == "ARROW1");
+  const auto footerLength = static_cast<std::size_t>(load<std::int32_t>(file, file.size() - 10));
+  const std::size_t footerStart = file.size() - 10 - footerLength;
+  REQUIRE(footerStart % 8 == 0);
+  // The stream ends before the footer
+  REQUIRE(load<std::uint32_t>(file, footerStart - 8) == 0xFFFFFFFF);
+  REQUIRE(load<std::uint32_t>(file, footerStart - 4) == 0);
+  Table footer = Table::root(file.substr(footerStart, footerLength));
+
+  SECTION("Schema") {
+    Table schema = footer.table(1);
+    REQUIRE(schema.length(1) == 5);
+    const char *names[] = {"id", "name", "path", "depth", "instance_count"};
+    const std::uint8_t types[] = {5, 5, 5, 2, 2}; // Utf8, Int
+    for (std::size_t i = 0; i < 5; ++i) {
+      Table field = schema.element(1, i);
+      REQUIRE(field.string(0) == names[i]);
+      REQUIRE(field.scalar<std::uint8_t>(1, 1) == 0); // not nullable
+      REQUIRE(field.scalar<std::uint8_t>(2) == types[i]);
+      REQUIRE(field.length(5) == 0); // no children
+      if (types[i] == 2) {
+        REQUIRE(field.table(3).scalar<std::int32_t>(0) == 32);
+      }
+    }
+    Table dictionary = schema.element(1, 2).table(4);
+    REQUIRE(dictionary.scalar<std::int64_t>(0, -1) == 0);
+    REQUIRE(dictionary.table(1).scalar<std::int32_t>(0) == 32);
+  }
+
+  SECTION("Path dictionary") {
+    REQUIRE(footer.length(2) == 1);
+    const auto offset = static_cast<std::size_t>(load<std::int64_t>(file, footer.structAt(2, 0, 24) + footerStart));
+    Message message(file, offset);
+    REQUIRE(message.type == 2);
+    Table data = message.header.table(1);
+    REQUIRE(data.scalar<std::int64_t>(0) == 2);
+    REQUIRE(strings(file, message.buffer(data, 1), message.buffer(data, 2)) ==
+            std::vector<std::string>{"/Root", "/Root/Frame"});
+  }
+
+  SECTION("Record batches") {
+    REQUIRE(footer.length(3) == 2);
+    std::vector<std::string> ids;
+    std::vector<std::int32_t> paths;
+    std::vector<std::int32_t> depths;
+    for (std::size_t b = 0; b < 2; ++b) {
+      const std::size_t block = footer.structAt(3, b, 24) + footerStart;
+      Message message(file, static_cast<std::size_t>(load<std::int64_t>(file, block)));
+      REQUIRE(message.type == 3);
+      REQUIRE(message.body - static_cast<std::size_t>(load<std::int64_t>(file, block)) ==
+              static_cast<std::size_t>(load<std::int32_t>(file, block + 8)));
+      Table data = message.header;
+      REQUIRE(data.length(1) == 5);
+      REQUIRE(data.length(2) == 12);
+      for (const auto &id : strings(file, message.buffer(data, 1), message.buffer(data, 2))) {
+        ids.push_back(id);
+      }
+      REQUIRE(strings(file, message.buffer(data, 4), message.buffer(data, 5)) ==
+              strings(file, message.buffer(data, 1), message.buffer(data, 2)));
+      for (auto path : ints(file, message.buffer(data, 7))) {
+        paths.push_back(path);
+      }
+      for (auto depth : ints(file, message.buffer(data, 9))) {
+        depths.push_back(depth);
+      }
+      REQUIRE(ints(file, message.buffer(data, 11)) ==
+              std::vector<std::int32_t>(static_cast<std::size_t>(data.scalar<std::int64_t>(0)), 2));
+    }
+    REQUIRE(ids == std::vector<std::string>{"b0", "n\xC3\xBCt", "b1"});
+    REQUIRE(paths == std::vector<std::int32_t>{0, 1, 1});
+    REQUIRE(depths == std::vector<std::int32_t>{1, 2, 1});
+  }
+}
+
+TEST_CASE("ArrowPartTableWriterAdapter writes an empty table") {
+  std::ostringstream out;
+  ArrowPartTableWriterAdapter writer(out);
+  writer.finish();
+  const std::string bytes = out.str();
+  const std::string_view file(bytes);
+  const auto footerLength = static_cast<std::size_t>(load<std::int32_t>(file, file.size() - 10));
+  Table footer = Table::root(file.substr(file.size() - 10 - footerLength, footerLength));
+  REQUIRE(footer.length(2) == 1);
+  REQUIRE(footer.length(3) == 0);
+  REQUIRE(footer.table(1).length(1) == 5);
+}
+
+TEST_CASE("StringColumn rejects more than 2 GiB of text") {
+  StringColumn column;
+  column.bytes.resize(1);
+  REQUIRE_THROWS_AS(column.push_back(std::string_view(column.bytes.data(), 0x7FFFFFFF)),
+                    std::length_error);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace cad::test {
+
+// Number of global operator new calls so far in this process. Provided by
+// AllocationCounter.cpp, which replaces the global allocation functions; link
+// it into test executables that assert allocation bounds.
+std::size_t allocationCount();
+
+// Allocations made while running `f`.
+template <typename F> std::size_t countAllocations(F &&f) {
+  std::size_t before = allocationCount();
+  std::forward<F>(f)();
+  return allocationCount() - before;
+}
+
+} // namespace cad::test
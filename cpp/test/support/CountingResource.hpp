@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace cad::test {
+
+// Forwards to `upstream` and counts what passes through, e.g. to tell what a
+// read or an arena takes, or that a cancelled read gave everything back.
+class CountingResource final : public std::pmr::memory_resource {
+public:
+  explicit CountingResource(
+      std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+      : upstream_(upstream) {}
+
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  std::size_t bytes = 0;       // handed out so far
+  std::size_t outstanding = 0; // handed out and not yet returned
+
+private:
+  void *do_allocate(std::size_t size, std::size_t alignment) override {
+    void *p = upstream_->allocate(size, alignment);
+    ++allocations;
+    bytes += size;
+    outstanding += size;
+    return p;
+  }
+  void do_deallocate(void *p, std::size_t size, std::size_t alignment) override {
+    ++deallocations;
+    outstanding -= size;
+    upstream_->deallocate(p, size, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource *upstream_;
+};
+
+} // namespace cad::test
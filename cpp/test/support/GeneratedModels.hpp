@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace cad::test {
+
+// Generated model files for reader and use-case tests: `assemblies`
+// assemblies of `partsPerAssembly` parts each, either side by side under the
+// root or each nested in the previous one. Names are numbered and longer
+// than the small-string buffer.
+struct GeneratedModel {
+  std::string text;
+  std::size_t nodes = 1; // assemblies, root included, and parts
+};
+
+enum class Nesting { Flat, Chain };
+
+inline std::string generatedAssemblyName(int a) {
+  return "Assembly with a long name " + std::to_string(a);
+}
+
+inline std::string generatedPartName(int p) {
+  return "Part with a long name " + std::to_string(p);
+}
+
+// In the fake reader's "Assembly:" / "Part:" / "EndAssembly" format.
+inline GeneratedModel makeFakeModel(int assemblies, int partsPerAssembly,
+                                    Nesting nesting = Nesting::Flat) {
+  GeneratedModel model;
+  for (int a = 0; a < assemblies; ++a) {
+    model.text += "Assembly: " + generatedAssemblyName(a) + "\n";
+    for (int p = 0; p < partsPerAssembly; ++p) {
+      model.text += "Part: " + generatedPartName(p) + "\n";
+    }
+    if (nesting == Nesting::Flat) {
+      model.text += "EndAssembly\n";
+    }
+    model.nodes += 1 + partsPerAssembly;
+  }
+  return model;
+}
+
+// In the JSON reader's format, with a root assembly "Root" and ids "a<N>"
+// for assemblies and "a<N>p<M>" for parts.
+inline GeneratedModel makeJsonModel(int assemblies, int partsPerAssembly,
+                                    Nesting nesting = Nesting::Flat) {
+  GeneratedModel model;
+  model.text = R"({"assemblies": [{"id": "root", "name": "Root", "parent_id": null})";
+  std::string parts;
+  for (int a = 0; a < assemblies; ++a) {
+    const std::string id = "a" + std::to_string(a);
+    const std::string parent =
+        nesting == Nesting::Chain && a > 0 ? "a" + std::to_string(a - 1) : "root";
+    model.text += R"(, {"id": ")" + id + R"(", "name": ")" + generatedAssemblyName(a) +
+                  R"(", "parent_id": ")" + parent + R"("})";
+    for (int p = 0; p < partsPerAssembly; ++p) {
+      parts += std::string(parts.empty() ? "" : ", ") + R"({"id": ")" + id + "p" +
+               std::to_string(p) + R"(", "name": ")" + generatedPartName(p) +
+               R"(", "assembly_id": ")" + id + R"("})";
+    }
+    model.nodes += 1 + partsPerAssembly;
+  }
+  model.text += R"(], "parts": [)" + parts + "]}";
+  return model;
+}
+
+} // namespace cad::test
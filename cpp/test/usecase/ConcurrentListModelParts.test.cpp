@@ -0,0 +1,292 @@
+#include <catch2/catch_all.hpp>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpp/cad/adapters/cad-model-reader/auto/AutoDetectingCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/json/JsonCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/json/JsonModelDataSourceAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/memory/MemoryModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/usecase/ListModelPartsUseCase.hpp"
+#include "cpp/cad/core/usecase/ModelListing.hpp"
+
+using cad::concurrency::ThreadPool;
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::Part;
+using cad::usecase::ListModelPartsUseCase;
+
+// These tests are most useful under ThreadSanitizer:
+//   cmake -B build-tsan -DCAD_ENABLE_TSAN=ON   (or `mask test:tsan`)
+
+namespace {
+
+// Counts messages instead of printing them; log() is called from many
+// threads at once.
+class CountingLogger final : public cad::ports::LoggerPort {
+public:
+  void log(cad::ports::LogLevel, const std::string &) override { ++count; }
+  std::atomic<int> count{0};
+};
+
+std::string fakeModel(int i) {
+  return "Assembly: Frame " + std::to_string(i) + "\nPart: Bolt " +
+         std::to_string(i) + "\nEndAssembly\n";
+}
+
+std::vector<std::string> expectedListing(int i) {
+  return {"Assembly: Root", "  Assembly: Frame " + std::to_string(i),
+          "    Part: Bolt " + std::to_string(i)};
+}
+
+constexpr int kLocators = 64;
+constexpr int kRounds = 20;
+
+// `fanout` children per level, `parts` parts per assembly. Names come from a
+// small pool so that ties exercise the sort order.
+void grow(Assembly &assembly, int depth, int fanout, int parts,
+          std::mt19937 &random) {
+  std::uniform_int_distribution<int> name(0, 9);
+  for (int p = 0; p < parts; ++p) {
+    Part part;
+    part.name = "P" + std::to_string(name(random));
+    assembly.parts.push_back(part);
+  }
+  if (depth == 0) {
+    return;
+  }
+  for (int c = 0; c < fanout; ++c) {
+    Assembly child;
+    child.name = "A" + std::to_string(name(random));
+    grow(child, depth - 1, fanout, parts, random);
+    assembly.children.push_back(std::move(child));
+  }
+}
+
+Model makeTree(int depth, int fanout, int parts, unsigned seed) {
+  std::mt19937 random(seed);
+  Model model;
+  model.root.name = "Root";
+  grow(model.root, depth, fanout, parts, random);
+  return model;
+}
+
+std::string fakeTree(int depth, int fanout) {
+  if (depth == 0) {
+    return "Part: leaf\n";
+  }
+  std::string content;
+  for (int c = 0; c < fanout; ++c) {
+    content += "Assembly: A" + std::to_string(c) + "\n" +
+               fakeTree(depth - 1, fanout) + "EndAssembly\n";
+  }
+  return content;
+}
+
+} // namespace
+
+TEST_CASE("ThreadPool runs tasks and propagates results and exceptions") {
+  ThreadPool pool(4);
+  REQUIRE(pool.size() == 4);
+
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 100; ++i) {
+    results.push_back(pool.submit([i] { return i * i; }));
+  }
+  for (int i = 0; i < 100; ++i) {
+    REQUIRE(results[i].get() == i * i);
+  }
+
+  auto failing = pool.submit([]() -> int { throw std::runtime_error("boom"); });
+  REQUIRE_THROWS_AS(failing.get(), std::runtime_error);
+}
+
+TEST_CASE("ThreadPool::await sleeps while the awaited task runs") {
+  ThreadPool pool(1);
+  auto slow = pool.submit([] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    return 7;
+  });
+
+  // Nothing is left to run, so the waiting thread should barely use the CPU
+  timespec before{}, after{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &before);
+  REQUIRE(pool.await(slow) == 7);
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &after);
+  const double cpuSeconds =
+      double(after.tv_sec - before.tv_sec) + double(after.tv_nsec - before.tv_nsec) / 1e9;
+  REQUIRE(cpuSeconds < 0.1);
+}
+
+TEST_CASE("ListModelPartsUseCase serves concurrent calls on one instance") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+  CountingLogger logger;
+
+  std::vector<std::string> locators;
+  for (int i = 0; i < kLocators; ++i) {
+    locators.push_back("mem:" + std::to_string(i));
+    source.registerContent(locators.back(), fakeModel(i));
+  }
+  locators.push_back("mem:missing");
+
+  ListModelPartsUseCase usecase(source, reader, logger);
+  ThreadPool pool(8);
+
+  for (int round = 0; round < kRounds; ++round) {
+    auto results = usecase.listAll(locators, pool);
+    REQUIRE(results.size() == locators.size());
+    for (int i = 0; i < kLocators; ++i) {
+      REQUIRE(results[i] == expectedListing(i));
+    }
+    REQUIRE(results.back() ==
+            std::vector<std::string>{"ERROR: failed to open locator"});
+  }
+  // "Opening locator" per call, plus one error for each missing locator.
+  REQUIRE(logger.count == kRounds * (kLocators + 2));
+}
+
+TEST_CASE("listAll called from a worker of its own pool does not deadlock") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+  CountingLogger logger;
+
+  std::vector<std::string> locators;
+  for (int i = 0; i < 4; ++i) {
+    locators.push_back("mem:" + std::to_string(i));
+    source.registerContent(locators.back(), fakeModel(i));
+  }
+
+  ListModelPartsUseCase usecase(source, reader, logger);
+  ThreadPool pool(1);
+  auto outer = pool.submit([&] { return usecase.listAll(locators, pool); });
+  REQUIRE(outer.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+  const auto results = outer.get();
+  REQUIRE(results.size() == locators.size());
+  for (int i = 0; i < 4; ++i) {
+    REQUIRE(results[i] == expectedListing(i));
+  }
+}
+
+TEST_CASE("Adapters are reentrant under concurrent use") {
+  CountingLogger logger;
+  ThreadPool pool(8);
+
+  SECTION("Memory source registering while auto-detecting reads run") {
+    cad::adapters::memory::MemoryModelDataSourceAdapter source;
+    cad::adapters::autodetect::AutoDetectingCadModelReaderAdapter reader;
+    reader.registerReader(cad::adapters::common::ModelFormat::FakeText, [] {
+      return std::make_unique<cad::adapters::fake::FakeCadModelReaderAdapter>();
+    });
+    for (int i = 0; i < kLocators; ++i) {
+      source.registerBuffer("mem:" + std::to_string(i),
+                            std::make_shared<const std::string>(fakeModel(i)));
+    }
+
+    ListModelPartsUseCase usecase(source, reader, logger);
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+      for (int n = 0; !done; ++n) {
+        source.registerBuffer("mem:extra",
+                              std::make_shared<const std::string>(fakeModel(n)));
+      }
+    });
+
+    std::vector<std::future<std::vector<std::string>>> pending;
+    for (int round = 0; round < kRounds; ++round) {
+      for (int i = 0; i < kLocators; ++i) {
+        pending.push_back(usecase.listAsync("mem:" + std::to_string(i), pool));
+      }
+    }
+    for (std::size_t n = 0; n < pending.size(); ++n) {
+      REQUIRE(pending[n].get() == expectedListing(n % kLocators));
+    }
+    done = true;
+    writer.join();
+  }
+
+  SECTION("JSON source and reader share no per-call state") {
+    auto path = std::filesystem::temp_directory_path() /
+                "cad_concurrent_list.json";
+    {
+      std::ofstream out(path);
+      out << R"({"assemblies": [{"id": "root", "name": "Valve", "parent_id": null}],
+                 "parts": [{"id": "stem", "name": "Stem", "assembly_id": "root"}]})";
+    }
+    cad::adapters::json::JsonModelDataSourceAdapter source;
+    cad::adapters::json::JsonCadModelReaderAdapter reader;
+    ListModelPartsUseCase usecase(source, reader, logger);
+
+    std::vector<std::string> locators(kLocators, path.string());
+    auto results = usecase.listAll(locators, pool);
+    for (const auto &lines : results) {
+      REQUIRE(lines == std::vector<std::string>{"Assembly: Valve",
+                                                "  Part: Stem"});
+    }
+    std::filesystem::remove(path);
+  }
+}
+
+TEST_CASE("Parallel listing is byte-identical to the serial listing") {
+  ThreadPool pool(8);
+
+  SECTION("Balanced tree with duplicate names") {
+    Model model = makeTree(6, 6, 3, 1); // ~56k assemblies, ~168k parts
+    REQUIRE(cad::usecase::listModelLines(model, pool) ==
+            cad::usecase::listModelLines(model));
+  }
+
+  SECTION("Wide flat tree") {
+    Model model = makeTree(1, 50000, 1, 2);
+    REQUIRE(cad::usecase::listModelLines(model, pool) ==
+            cad::usecase::listModelLines(model));
+  }
+
+  SECTION("Single-child chain above a wide level") {
+    Model model = makeTree(4, 12, 2, 3);
+    for (int i = 0; i < 100; ++i) {
+      Assembly parent;
+      parent.name = "Chain";
+      parent.children.push_back(std::move(model.root));
+      model.root = std::move(parent);
+    }
+    REQUIRE(cad::usecase::listModelLines(model, pool) ==
+            cad::usecase::listModelLines(model));
+  }
+
+  SECTION("Small models take the serial path") {
+    Model model = makeTree(2, 3, 1, 4);
+    REQUIRE(cad::usecase::listModelLines(model, pool) ==
+            cad::usecase::listModelLines(model));
+  }
+}
+
+TEST_CASE("Concurrent list calls may share the pool with parallel listing") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+  CountingLogger logger;
+  source.registerContent("mem:large", fakeTree(5, 8)); // ~37k assemblies
+
+  ThreadPool pool(4);
+  ListModelPartsUseCase serial(source, reader, logger);
+  ListModelPartsUseCase parallel(source, reader, logger, &pool);
+
+  // Every worker runs a list call that splits its own listing onto the same
+  // workers; ThreadPool::await keeps this from deadlocking.
+  std::vector<std::string> locators(8, "mem:large");
+  auto expected = serial.list("mem:large");
+  for (const auto &lines : parallel.listAll(locators, pool)) {
+    REQUIRE(lines == expected);
+  }
+}
@@ -0,0 +1,243 @@
+#include <catch2/catch_all.hpp>
+
+#include <functional>
+
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/concurrency/ThreadPool.hpp"
+#include "cpp/cad/core/domain/StructuralHash.hpp"
+#include "cpp/cad/core/usecase/DiffModelsUseCase.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::Part;
+using cad::usecase::DiffModelsUseCase;
+
+namespace {
+
+Part makePart(const std::string &id, const std::string &name) {
+  Part p;
+  p.id.value = id;
+  p.name = name;
+  return p;
+}
+
+Assembly makeAssembly(const std::string &id, const std::string &name) {
+  Assembly a;
+  a.id.value = id;
+  a.name = name;
+  return a;
+}
+
+// Root
+//   Engine: Piston, Valve
+//   Frame:  Bolt
+//     Door: Hinge
+Model makeVehicle() {
+  Model model;
+  model.root = makeAssembly("root", "Vehicle");
+  Assembly engine = makeAssembly("engine", "Engine");
+  engine.parts.push_back(makePart("piston", "Piston"));
+  engine.parts.push_back(makePart("valve", "Valve"));
+  Assembly frame = makeAssembly("frame", "Frame");
+  frame.parts.push_back(makePart("bolt", "Bolt"));
+  Assembly door = makeAssembly("door", "Door");
+  door.parts.push_back(makePart("hinge", "Hinge"));
+  frame.children.push_back(door);
+  model.root.children.push_back(engine);
+  model.root.children.push_back(frame);
+  return model;
+}
+
+std::vector<std::string> diffLines(Model before, Model after) {
+  cad::domain::computeStructuralHashes(before.root);
+  cad::domain::computeStructuralHashes(after.root);
+  std::vector<std::string> lines;
+  for (const auto &change : DiffModelsUseCase::compare(before, after).changes) {
+    lines.push_back(DiffModelsUseCase::formatChange(change));
+  }
+  return lines;
+}
+
+} // namespace
+
+TEST_CASE("Structural hashes ignore sibling order but not content") {
+  Model a = makeVehicle();
+  Model b = makeVehicle();
+  std::swap(b.root.children[0], b.root.children[1]);
+  std::swap(b.root.children[1].parts[0], b.root.children[1].parts[1]);
+  Model c = makeVehicle();
+  c.root.children[1].children[0].parts[0].name = "Latch";
+
+  cad::domain::computeStructuralHashes(a.root);
+  cad::domain::computeStructuralHashes(b.root);
+  cad::domain::computeStructuralHashes(c.root);
+
+  REQUIRE(a.root.subtreeHash != 0);
+  REQUIRE(a.root.subtreeHash == b.root.subtreeHash);
+  REQUIRE(a.root.subtreeHash != c.root.subtreeHash);
+  REQUIRE(a.root.children[0].subtreeHash == c.root.children[0].subtreeHash);
+}
+
+TEST_CASE("Structural hashes on a pool match the serial hashes") {
+  // A root with two large children, each a mix of large and small subtrees,
+  // so that the pool has to split below the first level
+  Model model;
+  model.root = makeAssembly("root", "Root");
+  for (int half = 0; half < 2; ++half) {
+    Assembly &side = model.root.children.emplace_back(
+        makeAssembly("side" + std::to_string(half), "Side"));
+    for (int group = 0; group < 40; ++group) {
+      Assembly &branch = side.children.emplace_back(
+          makeAssembly("g" + std::to_string(half) + "." + std::to_string(group), "Group"));
+      const int leaves = group % 4 == 0 ? 400 : 20;
+      for (int leaf = 0; leaf < leaves; ++leaf) {
+        Assembly &node = branch.children.emplace_back(makeAssembly(
+            std::string(branch.id.value.view()) + "." + std::to_string(leaf), "Leaf " + std::to_string(leaf)));
+        node.parts.push_back(makePart("p", "Bolt"));
+        node.parts.push_back(makePart("q", "Nut " + std::to_string(group)));
+      }
+    }
+  }
+  Model serial = model;
+  cad::domain::computeStructuralHashes(serial.root);
+
+  cad::concurrency::ThreadPool pool(4);
+  cad::domain::computeStructuralHashes(model.root, pool);
+
+  // Every node, not just the root, gets its serial hash
+  std::function<void(const Assembly &, const Assembly &)> same =
+      [&same](const Assembly &a, const Assembly &b) {
+        REQUIRE(a.subtreeHash == b.subtreeHash);
+        for (std::size_t i = 0; i < a.children.size(); ++i) {
+          same(a.children[i], b.children[i]);
+        }
+      };
+  same(model.root, serial.root);
+
+  // Also from a worker of the same pool
+  Model nested = serial;
+  nested.root.subtreeHash = 0;
+  auto done = pool.submit([&] { cad::domain::computeStructuralHashes(nested.root, pool); });
+  pool.await(done);
+  REQUIRE(nested.root.subtreeHash == serial.root.subtreeHash);
+}
+
+TEST_CASE("DiffModelsUseCase reports nothing for identical models") {
+  Model before = makeVehicle();
+  Model after = makeVehicle();
+  cad::domain::computeStructuralHashes(before.root);
+  cad::domain::computeStructuralHashes(after.root);
+
+  auto diff = DiffModelsUseCase::compare(before, after);
+  REQUIRE(diff.empty());
+  REQUIRE(diff.expandedAssemblies == 0);
+}
+
+TEST_CASE("DiffModelsUseCase reports added, removed, renamed and moved nodes") {
+  Model before = makeVehicle();
+
+  SECTION("Added and removed parts") {
+    Model after = makeVehicle();
+    after.root.children[0].parts.pop_back();
+    after.root.children[0].parts.push_back(makePart("ring", "Ring"));
+    REQUIRE(diffLines(before, after) ==
+            std::vector<std::string>{"Added Part: Ring (Vehicle/Engine)",
+                                     "Removed Part: Valve (Vehicle/Engine)"});
+  }
+
+  SECTION("Renamed part and assembly") {
+    Model after = makeVehicle();
+    after.root.children[0].name = "Motor";
+    after.root.children[0].parts[0].name = "Plunger";
+    REQUIRE(diffLines(before, after) ==
+            std::vector<std::string>{
+                "Renamed Assembly: Engine -> Motor (Vehicle)",
+                "Renamed Part: Piston -> Plunger (Vehicle/Motor)"});
+  }
+
+  SECTION("A part that only gains an identifier is unchanged") {
+    Model after = makeVehicle();
+    before.root.children[0].parts[0].id.value = "";
+    after.root.children[0].parts[0].id.value = "Piston";
+    REQUIRE(diffLines(before, after).empty());
+  }
+
+  SECTION("Moved part and assembly") {
+    Model after = makeVehicle();
+    Assembly door = after.root.children[1].children[0];
+    after.root.children[1].children.clear();
+    after.root.children.push_back(door);
+    Part bolt = after.root.children[1].parts[0];
+    after.root.children[1].parts.clear();
+    after.root.children[0].parts.push_back(bolt);
+    REQUIRE(diffLines(before, after) ==
+            std::vector<std::string>{
+                "Moved Assembly: Door (Vehicle/Frame -> Vehicle)",
+                "Moved Part: Bolt (Vehicle/Frame -> Vehicle/Engine)"});
+  }
+
+  SECTION("Moved and renamed assembly with an inner change") {
+    Model after = makeVehicle();
+    Assembly door = after.root.children[1].children[0];
+    after.root.children[1].children.clear();
+    door.name = "Hatch";
+    door.parts.push_back(makePart("seal", "Seal"));
+    after.root.children[0].children.push_back(door);
+    REQUIRE(diffLines(before, after) ==
+            std::vector<std::string>{
+                "Moved Assembly: Door -> Hatch (Vehicle/Frame -> Vehicle/Engine)",
+                "Added Part: Seal (Vehicle/Engine/Hatch)"});
+  }
+}
+
+TEST_CASE("DiffModelsUseCase skips identical subtrees of large models") {
+  Model before;
+  before.root = makeAssembly("root", "Root");
+  for (int i = 0; i < 200; ++i) {
+    Assembly group = makeAssembly("g" + std::to_string(i), "Group");
+    for (int j = 0; j < 50; ++j) {
+      Assembly leaf = makeAssembly("g" + std::to_string(i) + "l" +
+                                       std::to_string(j),
+                                   "Leaf");
+      leaf.parts.push_back(makePart("p" + std::to_string(i * 50 + j), "Bolt"));
+      group.children.push_back(leaf);
+    }
+    before.root.children.push_back(group);
+  }
+  Model after = before;
+  after.root.children[123].children[7].parts[0].name = "Screw";
+
+  cad::domain::computeStructuralHashes(before.root);
+  cad::domain::computeStructuralHashes(after.root);
+  auto diff = DiffModelsUseCase::compare(before, after);
+
+  REQUIRE(diff.changes.size() == 1);
+  REQUIRE(diff.changes[0].kind == cad::usecase::ModelChange::Kind::Renamed);
+  REQUIRE(diff.changes[0].path == "Root/Group/Leaf");
+  // Only the changed path is expanded: root, one group and one leaf.
+  REQUIRE(diff.expandedAssemblies == 3);
+}
+
+TEST_CASE("DiffModelsUseCase diffs two locators by name") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+
+  source.registerContent("mem:v1", "Assembly: A\nPart: A1\nEndAssembly\n"
+                                   "Assembly: B\nPart: B1\nEndAssembly\n");
+  source.registerContent("mem:v2", "Assembly: A\nPart: A1\nPart: B1\n"
+                                   "EndAssembly\nAssembly: B\nEndAssembly\n");
+
+  DiffModelsUseCase usecase(source, reader, logger);
+
+  REQUIRE(usecase.diff("mem:v1", "mem:v1") ==
+          std::vector<std::string>{"No differences"});
+  REQUIRE(usecase.diff("mem:v1", "mem:v2") ==
+          std::vector<std::string>{"Moved Part: B1 (Root/B -> Root/A)"});
+
+  auto missing = usecase.diff("mem:v1", "mem:missing");
+  REQUIRE(missing.size() == 1);
+  REQUIRE(missing[0].find("ERROR") != std::string::npos);
+}
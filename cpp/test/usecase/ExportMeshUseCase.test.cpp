@@ -0,0 +1,116 @@
+#include <catch2/catch_all.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/usecase/ExportMeshUseCase.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Mesh;
+using cad::domain::Model;
+using cad::domain::Part;
+using cad::domain::Placement;
+using cad::usecase::ExportMeshUseCase;
+
+namespace {
+
+Mesh triangle() {
+  Mesh mesh;
+  mesh.positions = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+  mesh.indices = {0, 1, 2};
+  return mesh;
+}
+
+// Root: Bolt (bolt), Frame: Bolt (bolt, moved), Label (no prototype),
+// Sketch (sketch, no triangles)
+class StubTessellationAdapter final : public cad::ports::TessellationPort {
+public:
+  cad::ports::TessellationOptions seen;
+
+  Model readTessellatedModel(std::istream &, const cad::ports::TessellationOptions &options,
+                             cad::concurrency::ThreadPool &pool, const MeshSink &sink,
+                             std::pmr::memory_resource *resource) override {
+    seen = options;
+    Model model(cad::domain::DomainAllocator{resource});
+    model.root.name = "Root";
+    addPart(model.root, "Bolt", "bolt", Placement());
+    Assembly &frame = model.root.children.emplace_back();
+    frame.name = "Frame";
+    Placement moved;
+    moved.translation = {10, 0, 0};
+    addPart(frame, "Bolt", "bolt", moved);
+    addPart(frame, "Label", "", Placement());
+    addPart(frame, "Sketch", "sketch", Placement());
+
+    auto bolt = pool.submit(triangle);
+    auto sketch = pool.submit([] { return Mesh(); });
+    sink("bolt", pool.await(bolt));
+    sink("sketch", pool.await(sketch));
+    return model;
+  }
+
+private:
+  static void addPart(Assembly &assembly, const char *name, const char *prototype,
+                      const Placement &placement) {
+    Part &part = assembly.parts.emplace_back();
+    part.name = name;
+    part.prototypeId = prototype;
+    part.placement = placement;
+  }
+};
+
+class RecordingMeshWriter final : public cad::ports::MeshWriterPort {
+public:
+  std::vector<std::pair<std::string, std::size_t>> meshes; // id, triangles
+  std::vector<std::pair<std::string, double>> instances;   // name, x offset
+  bool finished = false;
+
+  void addMesh(const std::string &prototypeId, const Mesh &mesh) override {
+    meshes.emplace_back(prototypeId, mesh.triangleCount());
+  }
+  void addInstance(const std::string &, const std::string &name,
+                   const Placement &placement) override {
+    instances.emplace_back(name, placement.translation[0]);
+  }
+  void finish() override { finished = true; }
+};
+
+} // namespace
+
+TEST_CASE("ExportMeshUseCase writes each prototype once and every part as an instance") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  StubTessellationAdapter tessellation;
+  RecordingMeshWriter writer;
+  cad::concurrency::ThreadPool pool(2);
+  source.registerContent("mem:frame", "unused");
+
+  ExportMeshUseCase usecase(source, tessellation, logger, pool);
+  cad::ports::TessellationOptions options;
+  options.linearDeflection = 0.01;
+
+  REQUIRE(usecase.exportMesh("mem:frame", options, writer) ==
+          std::vector<std::string>{"Exported 1 meshes, 2 instances, 1 triangles"});
+  REQUIRE(tessellation.seen.linearDeflection == 0.01);
+  REQUIRE(writer.meshes == std::vector<std::pair<std::string, std::size_t>>{{"bolt", 1}});
+  REQUIRE(writer.instances ==
+          std::vector<std::pair<std::string, double>>{{"Bolt", 0}, {"Bolt", 10}});
+  REQUIRE(writer.finished);
+}
+
+TEST_CASE("ExportMeshUseCase reports unreadable locators") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  StubTessellationAdapter tessellation;
+  RecordingMeshWriter writer;
+  cad::concurrency::ThreadPool pool(1);
+
+  ExportMeshUseCase usecase(source, tessellation, logger, pool);
+  auto lines = usecase.exportMesh("mem:missing", {}, writer);
+  REQUIRE(lines.size() == 1);
+  REQUIRE(lines[0].find("ERROR") != std::string::npos);
+  REQUIRE_FALSE(writer.finished);
+}
@@ -0,0 +1,154 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/usecase/ExportPartTableUseCase.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::Part;
+using cad::ports::PartTableBatch;
+using cad::ports::StringColumn;
+using cad::usecase::ExportPartTableUseCase;
+
+namespace {
+
+// Root: Bolt (bolt)
+//   Frame: Bolt (bolt), Label (no prototype), Nut (nut)
+//     Empty
+//       Hinge: Bolt (bolt)
+class StubReader final : public cad::ports::CadModelReaderPort {
+public:
+  using CadModelReaderPort::readModelFromStream;
+  Model readModelFromStream(std::istream &, std::pmr::memory_resource *resource) override {
+    Model model(cad::domain::DomainAllocator{resource});
+    model.root.name = "Root";
+    addPart(model.root, "b0", "Bolt", "bolt");
+    Assembly &frame = model.root.children.emplace_back();
+    frame.name = "Frame";
+    addPart(frame, "b1", "Bolt", "bolt");
+    addPart(frame, "l1", "Label", "");
+    addPart(frame, "n1", "Nut", "nut");
+    Assembly &empty = frame.children.emplace_back();
+    empty.name = "Empty";
+    Assembly &hinge = empty.children.emplace_back();
+    hinge.name = "Hinge";
+    addPart(hinge, "b2", "Bolt", "bolt");
+    return model;
+  }
+
+private:
+  static void addPart(Assembly &assembly, const char *id, const char *name,
+                      const char *prototype) {
+    Part &part = assembly.parts.emplace_back();
+    part.id.value = id;
+    part.name = name;
+    part.prototypeId = prototype;
+  }
+};
+
+std::vector<std::string> strings(const StringColumn &column) {
+  std::vector<std::string> out;
+  for (std::size_t i = 0; i < column.size(); ++i) {
+    out.emplace_back(column.bytes.substr(static_cast<std::size_t>(column.offsets[i]),
+                                         static_cast<std::size_t>(column.offsets[i + 1] -
+                                                                  column.offsets[i])));
+  }
+  return out;
+}
+
+// Keeps the batches and joins them back into one table
+class RecordingPartTableWriter final : public cad::ports::PartTableWriterPort {
+public:
+  std::vector<std::string> paths;
+  std::vector<std::size_t> batchRows;
+  std::vector<std::string> ids;
+  std::vector<std::string> names;
+  std::vector<std::int32_t> pathIndices;
+  std::vector<std::int32_t> depths;
+  std::vector<std::int32_t> instanceCounts;
+  bool finished = false;
+
+  void begin(const StringColumn &dictionary) override { paths = strings(dictionary); }
+  void addBatch(const PartTableBatch &batch) override {
+    batchRows.push_back(batch.rows());
+    for (const auto &id : strings(batch.ids)) {
+      ids.push_back(id);
+    }
+    for (const auto &name : strings(batch.names)) {
+      names.push_back(name);
+    }
+    pathIndices.insert(pathIndices.end(), batch.paths.begin(), batch.paths.end());
+    depths.insert(depths.end(), batch.depths.begin(), batch.depths.end());
+    instanceCounts.insert(instanceCounts.end(), batch.instanceCounts.begin(),
+                          batch.instanceCounts.end());
+  }
+  void finish() override { finished = true; }
+};
+
+} // namespace
+
+TEST_CASE("ExportPartTableUseCase writes one row per part in model order") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  StubReader reader;
+  source.registerContent("mem:frame", "unused");
+
+  // Batches cut through assemblies; the table is the same for any cut and
+  // any number of workers
+  for (std::size_t batchRows : {1, 2, 3, 64}) {
+    for (std::size_t threads : {1, 4}) {
+      cad::concurrency::ThreadPool pool(threads);
+      RecordingPartTableWriter writer;
+      ExportPartTableUseCase usecase(source, reader, logger, pool, batchRows);
+      const std::size_t batches = (5 + batchRows - 1) / batchRows;
+
+      REQUIRE(usecase.exportTable("mem:frame", writer) ==
+              std::vector<std::string>{"Exported 5 parts in " + std::to_string(batches) +
+                                       " batches"});
+      REQUIRE(writer.finished);
+      REQUIRE(writer.batchRows.size() == batches);
+      REQUIRE(writer.paths ==
+              std::vector<std::string>{"/Root", "/Root/Frame", "/Root/Frame/Empty/Hinge"});
+      REQUIRE(writer.ids == std::vector<std::string>{"b0", "b1", "l1", "n1", "b2"});
+      REQUIRE(writer.names == std::vector<std::string>{"Bolt", "Bolt", "Label", "Nut", "Bolt"});
+      REQUIRE(writer.pathIndices == std::vector<std::int32_t>{0, 1, 1, 1, 2});
+      REQUIRE(writer.depths == std::vector<std::int32_t>{1, 2, 2, 2, 4});
+      REQUIRE(writer.instanceCounts == std::vector<std::int32_t>{3, 3, 1, 1, 3});
+    }
+  }
+}
+
+TEST_CASE("ExportPartTableUseCase writes an empty table for a model without parts") {
+  cad::concurrency::ThreadPool pool(2);
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  StubReader reader;
+  RecordingPartTableWriter writer;
+  Model model;
+  model.root.name = "Root";
+  model.root.children.emplace_back().name = "Empty";
+
+  ExportPartTableUseCase usecase(source, reader, logger, pool);
+  REQUIRE(usecase.writeTable(model, writer) == 0);
+  REQUIRE(writer.finished);
+  REQUIRE(writer.paths.empty());
+  REQUIRE(writer.batchRows.empty());
+}
+
+TEST_CASE("ExportPartTableUseCase reports unreadable locators") {
+  cad::concurrency::ThreadPool pool(1);
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  StubReader reader;
+  RecordingPartTableWriter writer;
+
+  ExportPartTableUseCase usecase(source, reader, logger, pool);
+  REQUIRE(usecase.exportTable("mem:missing", writer) ==
+          std::vector<std::string>{"ERROR: failed to open locator"});
+  REQUIRE_FALSE(writer.finished);
+}
@@ -0,0 +1,309 @@
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/usecase/FindDuplicateGeometryUseCase.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::Part;
+using cad::domain::Placement;
+using cad::ports::ShapeSignature;
+using cad::usecase::DuplicateGroup;
+using cad::usecase::FindDuplicateGeometryUseCase;
+
+namespace {
+
+Placement translation(double x, double y, double z) {
+  Placement placement;
+  placement.translation = {x, y, z};
+  return placement;
+}
+
+Placement quarterTurn() {
+  Placement placement;
+  placement.linear = {0, -1, 0, 1, 0, 0, 0, 0, 1};
+  return placement;
+}
+
+ShapeSignature makeSignature(std::size_t faces, double volume, double thinnest = 0.5) {
+  ShapeSignature signature;
+  signature.topology = {1, faces, 3 * faces, 2 * faces};
+  signature.extents = {thinnest, 2, 3};
+  signature.volume = volume;
+  signature.area = 40;
+  return signature;
+}
+
+// Prototypes:
+//   a, b  equal (b is a moved by 10 along x; its volume differs by noise)
+//   c     a's signature, but a mirror image that matches nothing
+//   d     a's topology, twice the volume; would match a if it were asked
+//   e, f  flat and equal (f is e turned a quarter about z)
+//   g     cannot be measured
+class StubGeometry final : public cad::ports::PrototypeGeometry {
+public:
+  mutable std::atomic<int> signatureCalls{0};
+  mutable std::atomic<int> matchCalls{0};
+
+  explicit StubGeometry(Model model) : model_(std::move(model)) {
+    signatures_ = {{"a", makeSignature(6, 12)},
+                   {"b", makeSignature(6, 12 * (1 + 1e-9))},
+                   {"c", makeSignature(6, 12)},
+                   {"d", makeSignature(6, 24)},
+                   {"e", makeSignature(4, 0, 1e-12)},
+                   {"f", makeSignature(4, 0, 3e-13)}};
+    matches_ = {{{"a", "b"}, translation(10, 0, 0)},
+                {{"a", "d"}, Placement()},
+                {{"e", "f"}, quarterTurn()}};
+  }
+
+  Model &model() override { return model_; }
+
+  std::vector<std::string> prototypeIds() const override {
+    return {"a", "b", "c", "d", "e", "f", "g"};
+  }
+
+  std::optional<ShapeSignature> signature(const std::string &prototypeId) const override {
+    ++signatureCalls;
+    auto it = signatures_.find(prototypeId);
+    if (it == signatures_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  std::optional<Placement> match(const std::string &from, const std::string &to,
+                                 double) const override {
+    ++matchCalls;
+    auto it = matches_.find({from, to});
+    if (it == matches_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+private:
+  Model model_;
+  std::map<std::string, ShapeSignature> signatures_;
+  std::map<std::pair<std::string, std::string>, Placement> matches_;
+};
+
+void addPart(Assembly &assembly, const char *name, const char *prototype,
+             const Placement &placement = Placement()) {
+  Part &part = assembly.parts.emplace_back();
+  part.id.value = name;
+  part.name = name;
+  part.prototypeId = prototype;
+  part.placement = placement;
+}
+
+// Root: BoltA (a), BoltB (b)
+//   Sub: BoltC (b), Mirror (c), Large (d), Nut1 (e), Nut2 (f), Odd (g)
+Model makeModel(std::pmr::memory_resource *resource) {
+  Model model(cad::domain::DomainAllocator{resource});
+  model.root.name = "Root";
+  addPart(model.root, "BoltA", "a");
+  addPart(model.root, "BoltB", "b", translation(0, 5, 0));
+  Assembly &sub = model.root.children.emplace_back();
+  sub.name = "Sub";
+  addPart(sub, "BoltC", "b");
+  addPart(sub, "Mirror", "c");
+  addPart(sub, "Large", "d");
+  addPart(sub, "Nut1", "e");
+  addPart(sub, "Nut2", "f", translation(1, 2, 3));
+  addPart(sub, "Odd", "g");
+  return model;
+}
+
+// Prototypes with the given signatures, each matching every other
+class SignedShapes final : public cad::ports::PrototypeGeometry {
+public:
+  mutable std::atomic<int> matchCalls{0};
+
+  explicit SignedShapes(std::map<std::string, ShapeSignature> signatures)
+      : model_(makeModel(std::pmr::get_default_resource())),
+        signatures_(std::move(signatures)) {}
+
+  Model &model() override { return model_; }
+
+  std::vector<std::string> prototypeIds() const override {
+    std::vector<std::string> ids;
+    for (const auto &entry : signatures_) {
+      ids.push_back(entry.first);
+    }
+    return ids;
+  }
+
+  std::optional<ShapeSignature> signature(const std::string &prototypeId) const override {
+    return signatures_.at(prototypeId);
+  }
+
+  std::optional<Placement> match(const std::string &, const std::string &,
+                                 double) const override {
+    ++matchCalls;
+    return Placement();
+  }
+
+private:
+  Model model_;
+  std::map<std::string, ShapeSignature> signatures_;
+};
+
+class StubPort final : public cad::ports::PrototypeGeometryPort {
+public:
+  std::unique_ptr<cad::ports::PrototypeGeometry>
+  readPrototypeGeometry(std::istream &, std::pmr::memory_resource *resource) override {
+    return std::make_unique<StubGeometry>(makeModel(resource));
+  }
+};
+
+const Part *findPart(const Assembly &assembly, const std::string &name) {
+  for (const auto &part : assembly.parts) {
+    if (part.name == name) {
+      return &part;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+TEST_CASE("FindDuplicateGeometryUseCase groups prototypes that match") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  StubPort port;
+
+  for (std::size_t threads : {1, 4}) {
+    cad::concurrency::ThreadPool pool(threads);
+    FindDuplicateGeometryUseCase usecase(source, port, logger, pool);
+    StubGeometry geometry(makeModel(std::pmr::get_default_resource()));
+
+    const std::vector<DuplicateGroup> groups = usecase.findGroups(geometry, 1e-4);
+    REQUIRE(groups.size() == 2);
+    REQUIRE(groups[0].representative == "a");
+    REQUIRE(groups[0].duplicates.size() == 1);
+    REQUIRE(groups[0].duplicates[0].first == "b");
+    REQUIRE(groups[0].duplicates[0].second.translation == cad::domain::Point3{10, 0, 0});
+    REQUIRE(groups[1].representative == "e");
+    REQUIRE(groups[1].duplicates.size() == 1);
+    REQUIRE(groups[1].duplicates[0].first == "f");
+
+    // Every prototype is signed once; d is never compared, and neither is c
+    // once a has taken b and only c is left
+    REQUIRE(geometry.signatureCalls == 7);
+    REQUIRE(geometry.matchCalls == 3);
+  }
+}
+
+TEST_CASE("FindDuplicateGeometryUseCase buckets by tolerance, not by rounding") {
+  cad::concurrency::ThreadPool pool(2);
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  StubPort port;
+  FindDuplicateGeometryUseCase usecase(source, port, logger, pool);
+
+  // p and q are 2e-5 apart but straddle a step of four significant digits;
+  // r is 0.01 away from both
+  ShapeSignature p = makeSignature(6, 12);
+  p.extents = {0.5, 2, 1.00049};
+  ShapeSignature q = p;
+  q.extents[2] = 1.00051;
+  ShapeSignature r = p;
+  r.extents[2] = 1.01049;
+
+  SECTION("Fine tolerance") {
+    SignedShapes geometry({{"p", p}, {"q", q}, {"r", r}});
+    const std::vector<DuplicateGroup> groups = usecase.findGroups(geometry, 1e-4);
+    REQUIRE(groups.size() == 1);
+    REQUIRE(groups[0].representative == "p");
+    REQUIRE(groups[0].duplicates.size() == 1);
+    REQUIRE(groups[0].duplicates[0].first == "q");
+    REQUIRE(geometry.matchCalls == 1);
+  }
+
+  SECTION("Coarse tolerance") {
+    SignedShapes geometry({{"p", p}, {"q", q}, {"r", r}});
+    const std::vector<DuplicateGroup> groups = usecase.findGroups(geometry, 0.01);
+    REQUIRE(groups.size() == 1);
+    REQUIRE(groups[0].duplicates.size() == 2);
+    REQUIRE(geometry.matchCalls == 2);
+  }
+}
+
+TEST_CASE("FindDuplicateGeometryUseCase reports the parts of each group") {
+  cad::concurrency::ThreadPool pool(2);
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  StubPort port;
+  source.registerContent("mem:model", "unused");
+  FindDuplicateGeometryUseCase usecase(source, port, logger, pool);
+
+  const std::vector<std::string> report = {"Group: a (2 prototypes, 3 parts)",
+                                           "  Part: /Root/BoltA",
+                                           "  Part: /Root/BoltB",
+                                           "  Part: /Root/Sub/BoltC",
+                                           "Group: e (2 prototypes, 2 parts)",
+                                           "  Part: /Root/Sub/Nut1",
+                                           "  Part: /Root/Sub/Nut2",
+                                           "Total: 2 groups, 2 duplicate prototypes, 5 parts"};
+  REQUIRE(usecase.find("mem:model") == report);
+}
+
+TEST_CASE("FindDuplicateGeometryUseCase shares duplicates without moving parts") {
+  Model model = makeModel(std::pmr::get_default_resource());
+  std::vector<DuplicateGroup> groups = {{"a", {{"b", translation(10, 0, 0)}}},
+                                        {"e", {{"f", quarterTurn()}}}};
+
+  REQUIRE(FindDuplicateGeometryUseCase::shareDuplicates(model, groups) == 3);
+
+  const Part *boltB = findPart(model.root, "BoltB");
+  REQUIRE(boltB->prototypeId == "a");
+  REQUIRE(boltB->placement.translation == cad::domain::Point3{10, 5, 0});
+  const Assembly &sub = model.root.children.front();
+  REQUIRE(findPart(sub, "BoltC")->prototypeId == "a");
+  REQUIRE(findPart(sub, "BoltC")->placement.translation == cad::domain::Point3{10, 0, 0});
+  const Part *nut = findPart(sub, "Nut2");
+  REQUIRE(nut->prototypeId == "e");
+  REQUIRE(nut->placement.linear == quarterTurn().linear);
+  REQUIRE(nut->placement.translation == cad::domain::Point3{1, 2, 3});
+  // Untouched: representatives and prototypes without a match
+  REQUIRE(findPart(model.root, "BoltA")->prototypeId == "a");
+  REQUIRE(findPart(sub, "Mirror")->prototypeId == "c");
+  REQUIRE(findPart(sub, "Large")->prototypeId == "d");
+}
+
+TEST_CASE("FindDuplicateGeometryUseCase shares duplicates on request") {
+  cad::concurrency::ThreadPool pool(2);
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  StubPort port;
+  source.registerContent("mem:model", "unused");
+  FindDuplicateGeometryUseCase usecase(source, port, logger, pool);
+
+  cad::usecase::DuplicateGeometryOptions options;
+  options.share = true;
+  const std::vector<std::string> report = usecase.find("mem:model", options);
+  REQUIRE(report.size() == 9);
+  REQUIRE(report[7] == "Total: 2 groups, 2 duplicate prototypes, 5 parts");
+  // BoltB, BoltC and Nut2 move onto a and e; b and f drop out of the model
+  REQUIRE(report[8] == "Shared: 3 parts, 5 of 7 prototypes in use");
+}
+
+TEST_CASE("FindDuplicateGeometryUseCase reports unreadable locators") {
+  cad::concurrency::ThreadPool pool(1);
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  StubPort port;
+
+  FindDuplicateGeometryUseCase usecase(source, port, logger, pool);
+  REQUIRE(usecase.find("mem:missing") ==
+          std::vector<std::string>{"ERROR: failed to open locator"});
+}
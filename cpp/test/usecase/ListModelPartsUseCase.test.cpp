@@ -3,10 +3,20 @@
 #include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
 #include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
 #include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/usecase/BasicListModelPartsUseCase.hpp"
 #include "cpp/cad/core/usecase/ListModelPartsUseCase.hpp"
 
-TEST_CASE("ListModelPartsUseCase lists nested assemblies and parts "
-          "deterministically") {
+// Every listing test runs against both the runtime-composed use case and the
+// statically composed one to keep their behavior identical.
+using StaticListModelPartsUseCase = cad::usecase::BasicListModelPartsUseCase<
+    cad::adapters::fake::FakeModelDataSourceAdapter,
+    cad::adapters::fake::FakeCadModelReaderAdapter,
+    cad::adapters::fake::FakeLoggerAdapter>;
+
+TEMPLATE_TEST_CASE("ListModelPartsUseCase lists nested assemblies and parts "
+                   "deterministically",
+                   "", cad::usecase::ListModelPartsUseCase,
+                   StaticListModelPartsUseCase) {
   cad::adapters::fake::FakeModelDataSourceAdapter source;
   cad::adapters::fake::FakeCadModelReaderAdapter reader;
   cad::adapters::fake::FakeLoggerAdapter logger;
@@ -16,7 +26,7 @@ TEST_CASE("ListModelPartsUseCase lists nested assemblies and parts "
                         "Assembly: A\nPart: A2\nPart: A1\nEndAssembly\n";
   source.registerContent(locator, content);
 
-  cad::usecase::ListModelPartsUseCase usecase(source, reader, logger);
+  TestType usecase(source, reader, logger);
   auto lines = usecase.list(locator);
 
   std::vector<std::string> expected = {
@@ -27,14 +37,62 @@ TEST_CASE("ListModelPartsUseCase lists nested assemblies and parts "
   REQUIRE(lines == expected);
 }
 
-TEST_CASE("ListModelPartsUseCase handles missing locator") {
+TEMPLATE_TEST_CASE("ListModelPartsUseCase handles missing locator", "",
+                   cad::usecase::ListModelPartsUseCase,
+                   StaticListModelPartsUseCase) {
   cad::adapters::fake::FakeModelDataSourceAdapter source;
   cad::adapters::fake::FakeCadModelReaderAdapter reader;
   cad::adapters::fake::FakeLoggerAdapter logger;
 
-  cad::usecase::ListModelPartsUseCase usecase(source, reader, logger);
+  TestType usecase(source, reader, logger);
   auto lines = usecase.list("mem:missing");
 
   REQUIRE(lines.size() == 1);
   REQUIRE(lines[0].find("ERROR") != std::string::npos);
 }
+
+namespace {
+
+// Keeps every record as "kind depth path id name"
+class RecordingListingWriter final : public cad::ports::ListingWriterPort {
+public:
+  std::vector<std::string> records;
+  bool finished = false;
+
+  void addRecord(const cad::ports::ListingRecord &record) override {
+    records.push_back(
+        std::string(record.kind == cad::ports::ListingRecord::Kind::Assembly ? "A " : "P ") +
+        std::to_string(record.depth) + " " + std::string(record.path) + " " +
+        std::string(record.id) + " " + std::string(record.name));
+  }
+  void finish() override { finished = true; }
+};
+
+} // namespace
+
+TEMPLATE_TEST_CASE("ListModelPartsUseCase writes records in listing order", "",
+                   cad::usecase::ListModelPartsUseCase,
+                   StaticListModelPartsUseCase) {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  source.registerContent("mem:test", "Assembly: B\nPart: B2\nPart: B1\nEndAssembly\n"
+                                     "Assembly: A\nAssembly: C\nPart: C1\nEndAssembly\n"
+                                     "Part: A1\nEndAssembly\n");
+  TestType usecase(source, reader, logger);
+
+  RecordingListingWriter writer;
+  REQUIRE(usecase.write("mem:test", writer).empty());
+  REQUIRE(writer.finished);
+  std::vector<std::string> expected = {
+      "A 0 /Root  Root",       "A 1 /Root/A  A",         "P 2 /Root/A/A1  A1",
+      "A 2 /Root/A/C  C",      "P 3 /Root/A/C/C1  C1",   "A 1 /Root/B  B",
+      "P 2 /Root/B/B1  B1",    "P 2 /Root/B/B2  B2",
+  };
+  REQUIRE(writer.records == expected);
+
+  RecordingListingWriter missing;
+  REQUIRE(usecase.write("mem:missing", missing) ==
+          std::vector<std::string>{"ERROR: failed to open locator"});
+  REQUIRE(!missing.finished);
+}
@@ -0,0 +1,159 @@
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/domain/Geometry.hpp"
+#include "cpp/cad/core/usecase/MeasureModelPartsUseCase.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::GeometricProperties;
+using cad::domain::Model;
+using cad::domain::Part;
+using cad::domain::Placement;
+using cad::usecase::MeasureModelPartsUseCase;
+
+namespace {
+
+GeometricProperties box(cad::domain::Point3 min, cad::domain::Point3 max,
+                        double volume, double area) {
+  GeometricProperties properties;
+  properties.bounds.add(min);
+  properties.bounds.add(max);
+  properties.volume = volume;
+  properties.area = area;
+  return properties;
+}
+
+bool near(double a, double b) { return std::abs(a - b) < 1e-9; }
+
+Placement translation(double x, double y, double z) {
+  Placement placement;
+  placement.translation = {x, y, z};
+  return placement;
+}
+
+Placement scale(double factor) {
+  Placement placement;
+  placement.linear = {factor, 0, 0, 0, factor, 0, 0, 0, factor};
+  return placement;
+}
+
+// Root
+//   Frame: Bolt (bolt), Bolt (bolt, moved), Plate (plate, scaled), Label
+// Every distinct prototype is measured once, on the pool.
+class StubGeometryAdapter final : public cad::ports::GeometricPropertiesPort {
+public:
+  std::atomic<int> measurements{0};
+
+  cad::ports::MeasuredModel
+  readMeasuredModel(std::istream &, cad::concurrency::ThreadPool &pool,
+                    std::pmr::memory_resource *resource) override {
+    cad::ports::MeasuredModel result{Model(cad::domain::DomainAllocator{resource}), {}};
+    Model &model = result.model;
+    model.root.name = "Root";
+    Assembly &frame = model.root.children.emplace_back();
+    frame.name = "Frame";
+    addPart(frame, "Bolt", "bolt", Placement());
+    addPart(frame, "Bolt", "bolt", translation(10, 0, 0));
+    addPart(frame, "Plate", "plate", scale(2));
+    addPart(frame, "Label", "", Placement());
+
+    auto bolt = pool.submit([this] {
+      ++measurements;
+      return box({0, 0, 0}, {1, 1, 2}, 2, 10);
+    });
+    auto plate = pool.submit([this] {
+      ++measurements;
+      return box({0, 0, 0}, {1, 1, 1}, 1, 6);
+    });
+    result.prototypes.emplace("bolt", pool.await(bolt));
+    result.prototypes.emplace("plate", pool.await(plate));
+    return result;
+  }
+
+private:
+  static void addPart(Assembly &assembly, const char *name, const char *prototype,
+                      const Placement &placement) {
+    Part &part = assembly.parts.emplace_back();
+    part.name = name;
+    part.prototypeId = prototype;
+    part.placement = placement;
+  }
+};
+
+} // namespace
+
+TEST_CASE("Placing prototype geometry transforms the box and scales measures") {
+  GeometricProperties prototype = box({0, 0, 0}, {1, 2, 3}, 6, 22);
+
+  SECTION("Identity") {
+    auto placed = cad::domain::place(prototype, Placement());
+    REQUIRE(placed.bounds.min == cad::domain::Point3{0, 0, 0});
+    REQUIRE(placed.bounds.max == cad::domain::Point3{1, 2, 3});
+    REQUIRE(placed.volume == 6);
+  }
+
+  SECTION("Rotation about z and translation") {
+    Placement placement = translation(5, 0, 0);
+    placement.linear = {0, -1, 0, 1, 0, 0, 0, 0, 1};
+    auto placed = cad::domain::place(prototype, placement);
+    REQUIRE(placed.bounds.min == cad::domain::Point3{3, 0, 0});
+    REQUIRE(placed.bounds.max == cad::domain::Point3{5, 1, 3});
+    REQUIRE(near(placed.volume, 6));
+    REQUIRE(near(placed.area, 22));
+  }
+
+  SECTION("Uniform scale") {
+    auto placed = cad::domain::place(prototype, scale(2));
+    REQUIRE(placed.bounds.max == cad::domain::Point3{2, 4, 6});
+    REQUIRE(near(placed.volume, 48));
+    REQUIRE(near(placed.area, 88));
+  }
+}
+
+TEST_CASE("MeasureModelPartsUseCase places each prototype at its instances") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  StubGeometryAdapter geometry;
+  cad::concurrency::ThreadPool pool(2);
+  source.registerContent("mem:frame", "unused");
+
+  MeasureModelPartsUseCase usecase(source, geometry, logger, pool);
+
+  REQUIRE(usecase.measure("mem:frame") ==
+          std::vector<std::string>{
+              "Part: /Root/Frame/Bolt bbox=[0 0 0; 1 1 2] volume=2 area=10",
+              "Part: /Root/Frame/Bolt bbox=[10 0 0; 11 1 2] volume=2 area=10",
+              "Part: /Root/Frame/Label (no geometry)",
+              "Part: /Root/Frame/Plate bbox=[0 0 0; 2 2 2] volume=8 area=24",
+              "Total: 4 parts, 3 measured, volume=12 area=44"});
+  REQUIRE(geometry.measurements == 2);
+
+  auto missing = usecase.measure("mem:missing");
+  REQUIRE(missing.size() == 1);
+  REQUIRE(missing[0].find("ERROR") != std::string::npos);
+}
+
+TEST_CASE("MeasureModelPartsUseCase attaches geometry to the domain model") {
+  Model model;
+  Part &bolt = model.root.parts.emplace_back();
+  bolt.name = "Bolt";
+  bolt.prototypeId = "bolt";
+  bolt.placement = translation(0, 0, 1);
+  Part &unknown = model.root.parts.emplace_back();
+  unknown.name = "Unknown";
+  unknown.prototypeId = "unmeasured";
+
+  std::unordered_map<std::string, GeometricProperties> prototypes{
+      {"bolt", box({0, 0, 0}, {1, 1, 1}, 1, 6)}};
+  REQUIRE(MeasureModelPartsUseCase::attachGeometry(model, prototypes) == 1);
+  REQUIRE(model.root.parts[0].geometry);
+  REQUIRE(model.root.parts[0].geometry->bounds.min[2] == 1);
+  REQUIRE_FALSE(model.root.parts[1].geometry);
+}
@@ -0,0 +1,309 @@
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpp/cad/adapters/cad-model-reader/auto/AutoDetectingCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/json/JsonCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/text/TextCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/common/TempFileMemoryResource.hpp"
+#include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/concurrency/MemoryBudget.hpp"
+#include "cpp/cad/core/domain/ModelArena.hpp"
+#include "cpp/cad/core/domain/Name.hpp"
+#include "cpp/cad/core/usecase/ListModelPartsUseCase.hpp"
+#include "cpp/test/support/CountingResource.hpp"
+
+using cad::concurrency::MemoryBudget;
+using cad::test::CountingResource;
+
+namespace {
+
+const std::string kModel = "Assembly: Engine\nPart: Piston\nPart: Valve\nEndAssembly\n"
+                           "Assembly: Frame\nPart: Bolt\nEndAssembly\n";
+
+// A stream that cannot seek, as from a pipe or a decompressor
+class ForwardOnlyBuf : public std::streambuf {
+public:
+  explicit ForwardOnlyBuf(std::string bytes) : bytes_(std::move(bytes)) {
+    setg(bytes_.data(), bytes_.data(), bytes_.data() + bytes_.size());
+  }
+
+private:
+  std::string bytes_;
+};
+
+// The text reader without an estimate, as for input it cannot seek in
+class UnknownSizeReader final : public cad::ports::CadModelReaderPort {
+public:
+  using CadModelReaderPort::readModelFromStream;
+  cad::domain::Model readModelFromStream(std::istream &stream,
+                                         std::pmr::memory_resource *resource) override {
+    return reader_.readModelFromStream(stream, resource);
+  }
+
+private:
+  cad::adapters::text::TextCadModelReaderAdapter reader_;
+};
+
+// Polls `condition` for up to five seconds
+template <typename Condition> bool eventually(Condition condition) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("MemoryBudget admits in arrival order and rejects what never fits") {
+  MemoryBudget budget(100);
+
+  auto first = budget.admit(60);
+  REQUIRE(first);
+  REQUIRE(first.bytes() == 60);
+  REQUIRE_FALSE(budget.admit(101));
+  REQUIRE(budget.stats().rejected == 1);
+
+  // 50 has to wait; 10 would fit but queues behind it
+  auto large = std::async(std::launch::async, [&] { return budget.admit(50).bytes(); });
+  REQUIRE(eventually([&] { return budget.stats().waiting == 1; }));
+  auto small = std::async(std::launch::async, [&] {
+    auto reservation = budget.admit(10);
+    return budget.stats().reservedBytes;
+  });
+  REQUIRE(eventually([&] { return budget.stats().waiting == 2; }));
+  REQUIRE(budget.stats().reservedBytes == 60);
+
+  first = MemoryBudget::Reservation();
+  REQUIRE(large.get() == 50);
+  // The large reservation was released when its thread returned; the small
+  // one saw at most both
+  REQUIRE(small.get() <= 60);
+
+  const auto stats = budget.stats();
+  REQUIRE(stats.reservedBytes == 0);
+  REQUIRE(stats.peakBytes == 60);
+  REQUIRE(stats.admitted == 3);
+  REQUIRE(stats.queued == 2);
+  REQUIRE(stats.waiting == 0);
+}
+
+TEST_CASE("MemoryBudget admits zero bytes without queueing") {
+  MemoryBudget budget(100);
+  auto first = budget.admit(80);
+  auto waiter = std::async(std::launch::async, [&] { return budget.admit(50).bytes(); });
+  REQUIRE(eventually([&] { return budget.stats().waiting == 1; }));
+
+  auto none = std::async(std::launch::async, [&] { return bool(budget.admit(0)); });
+  const bool ready = none.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+  first = MemoryBudget::Reservation();
+  REQUIRE(ready);
+  REQUIRE(none.get());
+  REQUIRE(waiter.get() == 50);
+  REQUIRE(budget.stats().queued == 1);
+}
+
+TEST_CASE("MemoryBudget never blocks a thread that holds a reservation") {
+  MemoryBudget budget(100);
+  auto outer = budget.admit(70);
+  auto nested = budget.admit(20);
+  REQUIRE(nested);
+  // Would have to wait for `outer`, held by this very thread
+  REQUIRE_FALSE(budget.admit(20));
+  REQUIRE(budget.stats().rejected == 1);
+  REQUIRE(budget.stats().waiting == 0);
+}
+
+TEST_CASE("MemoryBudget admits against what resident bytes leave of the limit") {
+  MemoryBudget budget(100);
+  budget.setResident(30);
+  REQUIRE(budget.capacity() == 70);
+  REQUIRE_FALSE(budget.admit(71));
+
+  auto first = budget.admit(40);
+  REQUIRE(first);
+  auto waiter = std::async(std::launch::async, [&] { return bool(budget.admit(40)); });
+  REQUIRE(eventually([&] { return budget.stats().waiting == 1; }));
+
+  // The capacity shrinks below the waiting request: it is turned away
+  // rather than left waiting for memory that never comes back
+  budget.setResident(70);
+  REQUIRE_FALSE(waiter.get());
+  REQUIRE(budget.stats().rejected == 2);
+  REQUIRE(budget.stats().reservedBytes == 40); // kept
+
+  budget.setResident(200);
+  REQUIRE(budget.capacity() == 0);
+  REQUIRE(budget.admit(0));
+}
+
+TEST_CASE("Readers estimate from the input size without consuming it") {
+  cad::adapters::fake::FakeCadModelReaderAdapter fake;
+  cad::adapters::text::TextCadModelReaderAdapter text;
+  cad::adapters::json::JsonCadModelReaderAdapter json;
+
+  std::istringstream stream(kModel);
+  stream.ignore(7); // estimates cover what is left
+  const std::size_t estimate = text.estimateReadBytes(stream);
+  REQUIRE(estimate >= 10 * (kModel.size() - 7));
+  REQUIRE(fake.estimateReadBytes(stream) >= estimate);
+  REQUIRE(json.estimateReadBytes(stream) > 0);
+  REQUIRE(stream.tellg() == std::streampos(7));
+
+  std::istringstream whole(kModel);
+  text.estimateReadBytes(whole);
+  REQUIRE(text.readModelFromStream(whole).root.children.size() == 2);
+
+  ForwardOnlyBuf forwardOnly(kModel);
+  std::istream pipe(&forwardOnly);
+  REQUIRE(text.estimateReadBytes(pipe) == 0);
+
+  SECTION("Auto-detection asks the reader of the detected format") {
+    cad::adapters::autodetect::AutoDetectingCadModelReaderAdapter detecting;
+    detecting.registerReader(cad::adapters::common::ModelFormat::FakeText, [] {
+      return std::make_unique<cad::adapters::text::TextCadModelReaderAdapter>();
+    });
+    std::istringstream input(kModel);
+    REQUIRE(detecting.estimateReadBytes(input) == text.estimateReadBytes(input));
+    REQUIRE(detecting.readModelFromStream(input).root.children.size() == 2);
+
+    // Compressed input is judged from its compressed size, and more than
+    // that size
+    const std::string gzipBytes = std::string("\x1f\x8b\x08\x00", 4) + std::string(64, '\0');
+    std::istringstream gzip(gzipBytes);
+    REQUIRE(detecting.estimateReadBytes(gzip) > gzipBytes.size());
+    REQUIRE(gzip.tellg() == std::streampos(0));
+    REQUIRE(detecting.estimateReadBytes(pipe) == 0);
+  }
+}
+
+TEST_CASE("TempFileMemoryResource maps allocations from unlinked files") {
+  cad::adapters::common::TempFileMemoryResource spill(".");
+
+  void *p = spill.allocate(3 << 20, alignof(std::max_align_t));
+  std::memset(p, 0x5a, 3 << 20);
+  REQUIRE(static_cast<unsigned char *>(p)[(3 << 20) - 1] == 0x5a);
+  REQUIRE(spill.mappedBytes() >= (3u << 20));
+  spill.deallocate(p, 3 << 20, alignof(std::max_align_t));
+  REQUIRE(spill.mappedBytes() == 0);
+  REQUIRE(spill.peakBytes() >= (3u << 20));
+
+  cad::domain::ModelArena arena(1 << 20, &spill);
+  std::istringstream stream(kModel);
+  auto &model = arena.adopt(
+      cad::adapters::text::TextCadModelReaderAdapter().readModelFromStream(stream, arena.resource()));
+  REQUIRE(model.root.children.size() == 2);
+  REQUIRE(spill.mappedBytes() >= (1u << 20));
+
+  cad::adapters::common::TempFileMemoryResource missing("/nonexistent-spill-directory");
+  REQUIRE_THROWS_AS(missing.allocate(4096, 8), std::bad_alloc);
+}
+
+TEST_CASE("Listing under a memory budget spills what does not fit") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+  std::ostringstream log;
+  cad::adapters::fake::FakeLoggerAdapter logger(log);
+  source.registerContent("mem:model", kModel);
+  source.registerContent("mem:other", kModel);
+  const auto expected = cad::usecase::ListModelPartsUseCase(source, reader, logger).list("mem:model");
+
+  // The budgets below leave room for the names interned so far, which
+  // admitRead charges against them
+  const std::size_t names = cad::domain::Name::poolBytes();
+
+  SECTION("A read that fits is admitted with its estimate") {
+    MemoryBudget budget(names + (1 << 20));
+    CountingResource spill;
+    cad::usecase::ListModelPartsUseCase usecase(source, reader, logger, nullptr, {&budget, &spill});
+    REQUIRE(usecase.list("mem:model") == expected);
+
+    std::istringstream stream(kModel);
+    REQUIRE(budget.stats().peakBytes == reader.estimateReadBytes(stream));
+    REQUIRE(budget.stats().admitted == 1);
+    REQUIRE(budget.stats().rejected == 0);
+    REQUIRE(spill.allocations == 0);
+    REQUIRE(budget.stats().residentBytes == names);
+  }
+
+  SECTION("A read over the budget runs alone in the spill resource") {
+    MemoryBudget budget(names + 64);
+    CountingResource spill;
+    cad::usecase::ListModelPartsUseCase usecase(source, reader, logger, nullptr, {&budget, &spill});
+    REQUIRE(usecase.list("mem:model") == expected);
+
+    REQUIRE(budget.stats().rejected == 1);
+    REQUIRE(budget.stats().peakBytes == 64); // all the names leave
+    REQUIRE(spill.allocations > 0);
+    REQUIRE(log.str().find("Over the memory budget, reading alone and spilling: mem:model") !=
+            std::string::npos);
+  }
+
+  SECTION("Batch reads share the budget") {
+    std::istringstream stream(kModel);
+    MemoryBudget budget(names + reader.estimateReadBytes(stream) * 3 / 2); // one at a time
+    cad::concurrency::ThreadPool pool(4);
+    cad::usecase::ListModelPartsUseCase usecase(source, reader, logger, &pool, {&budget, nullptr});
+    const std::vector<std::string> locators(16, "mem:other");
+    for (const auto &lines : usecase.listAll(locators, pool)) {
+      REQUIRE(lines == expected);
+    }
+    REQUIRE(budget.stats().admitted == 16);
+    REQUIRE(budget.stats().rejected == 0);
+    REQUIRE(budget.stats().peakBytes <= budget.capacity());
+  }
+
+  SECTION("A read of unknown size is admitted with the assumed size") {
+    UnknownSizeReader unknown;
+    MemoryBudget budget(names + (1 << 20));
+    CountingResource spill;
+    cad::usecase::ListModelPartsUseCase usecase(source, unknown, logger, nullptr,
+                                                {&budget, &spill, 4096});
+    REQUIRE(usecase.list("mem:model") == expected);
+
+    REQUIRE(budget.stats().peakBytes == 4096);
+    REQUIRE(budget.stats().rejected == 0);
+    REQUIRE(spill.allocations == 0);
+    REQUIRE(log.str().find("Read size unknown, assuming 4096 bytes: mem:model") !=
+            std::string::npos);
+    REQUIRE(log.str().find("Over the memory budget") == std::string::npos);
+  }
+
+  SECTION("Without an assumed size, a read of unknown size runs alone") {
+    UnknownSizeReader unknown;
+    MemoryBudget budget(names + (1 << 20));
+    CountingResource spill;
+    cad::usecase::ListModelPartsUseCase usecase(source, unknown, logger, nullptr,
+                                                {&budget, &spill, 0});
+    REQUIRE(usecase.list("mem:model") == expected);
+
+    REQUIRE(budget.stats().peakBytes == budget.capacity());
+    REQUIRE(spill.allocations > 0);
+    REQUIRE(log.str().find("Read size unknown, reading alone and spilling: mem:model") !=
+            std::string::npos);
+  }
+
+  SECTION("Once the names take the whole budget, reads spill unreserved") {
+    MemoryBudget budget(names);
+    CountingResource spill;
+    cad::usecase::ListModelPartsUseCase usecase(source, reader, logger, nullptr, {&budget, &spill});
+    REQUIRE(usecase.list("mem:model") == expected);
+
+    REQUIRE(budget.stats().admitted == 0);
+    REQUIRE(budget.stats().peakBytes == 0);
+    REQUIRE(spill.allocations > 0);
+  }
+}
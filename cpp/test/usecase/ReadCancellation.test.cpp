@@ -0,0 +1,180 @@
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/adapters/cad-model-reader/fake/FakeCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/cad-model-reader/json/JsonCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/adapters/progress/terminal/TerminalProgressAdapter.hpp"
+#include "cpp/cad/core/concurrency/CancellableProgress.hpp"
+#include "cpp/cad/core/usecase/ListModelPartsUseCase.hpp"
+#include "cpp/test/support/CountingResource.hpp"
+#include "cpp/test/support/GeneratedModels.hpp"
+
+using cad::concurrency::CancellableProgress;
+using cad::ports::ReadCancelled;
+using cad::test::CountingResource;
+using cad::test::makeFakeModel;
+using cad::test::makeJsonModel;
+
+namespace {
+
+// Records reports and cancels once `limit` of them have arrived.
+class RecordingProgress final : public cad::ports::ProgressPort {
+public:
+  explicit RecordingProgress(std::size_t limit = SIZE_MAX) : limit_(limit) {}
+
+  struct Report {
+    std::string phase;
+    std::uint64_t done;
+    std::uint64_t total;
+  };
+  std::vector<Report> reports;
+
+  void report(std::string_view phase, std::uint64_t done,
+              std::uint64_t total) override {
+    reports.push_back({std::string(phase), done, total});
+  }
+  bool cancelled() override { return reports.size() >= limit_; }
+
+private:
+  std::size_t limit_;
+};
+
+} // namespace
+
+TEST_CASE("CancellableProgress cancels on request, on its deadline or with its inner port") {
+  RecordingProgress inner;
+  CancellableProgress progress(&inner);
+  REQUIRE_FALSE(progress.cancelled());
+
+  progress.report("entities", 1024, 0);
+  REQUIRE(inner.reports.size() == 1);
+
+  SECTION("cancel()") {
+    progress.cancel();
+    REQUIRE(progress.cancelled());
+    REQUIRE_FALSE(progress.timedOut());
+  }
+
+  SECTION("Deadline") {
+    progress.setTimeout(std::chrono::hours(1));
+    REQUIRE_FALSE(progress.cancelled());
+    progress.setDeadline(CancellableProgress::Clock::now() - std::chrono::seconds(1));
+    REQUIRE(progress.cancelled());
+    REQUIRE(progress.timedOut());
+  }
+
+  SECTION("Inner port") {
+    RecordingProgress stopping(0);
+    CancellableProgress outer(&stopping);
+    REQUIRE(outer.cancelled());
+    REQUIRE_FALSE(outer.timedOut());
+  }
+}
+
+TEST_CASE("Fake reader reports per entity interval and frees a cancelled read") {
+  std::string content = makeFakeModel(100, 40).text; // 4200 lines
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+
+  SECTION("Uncancelled") {
+    RecordingProgress progress;
+    std::istringstream stream(content);
+    auto model = reader.readModelFromStream(stream, std::pmr::get_default_resource(), progress);
+    REQUIRE(model.root.children.size() == 100);
+    REQUIRE(progress.reports.size() == 4200 / cad::ports::kProgressInterval);
+    REQUIRE(progress.reports[0].phase == "entities");
+    REQUIRE(progress.reports[0].done == cad::ports::kProgressInterval);
+  }
+
+  SECTION("Cancelled after the second report") {
+    RecordingProgress progress(2);
+    CountingResource resource;
+    std::istringstream stream(content);
+    REQUIRE_THROWS_AS(reader.readModelFromStream(stream, &resource, progress),
+                      ReadCancelled);
+    REQUIRE(progress.reports.size() == 2);
+    REQUIRE(resource.allocations > 0);
+    REQUIRE(resource.outstanding == 0);
+  }
+}
+
+TEST_CASE("JSON reader reports bytes then entities and frees a cancelled read") {
+  std::string content = makeJsonModel(200, 20).text;
+  cad::adapters::json::JsonCadModelReaderAdapter reader;
+
+  SECTION("Uncancelled") {
+    RecordingProgress progress;
+    std::istringstream stream(content);
+    auto model = reader.readModelFromStream(stream, std::pmr::get_default_resource(), progress);
+    REQUIRE(model.root.children.size() == 200);
+    REQUIRE(progress.reports.front().phase == "bytes");
+    REQUIRE(progress.reports.front().total == content.size());
+    REQUIRE(progress.reports.back().phase == "entities");
+    REQUIRE(progress.reports.back().total == 201 + 200 * 20);
+  }
+
+  SECTION("Cancelled while parsing") {
+    RecordingProgress progress(1);
+    CountingResource resource;
+    std::istringstream stream(content);
+    REQUIRE_THROWS_AS(reader.readModelFromStream(stream, &resource, progress),
+                      ReadCancelled);
+    REQUIRE(resource.outstanding == 0);
+  }
+
+  SECTION("Cancelled while building nodes") {
+    std::size_t byteReports = (content.size() + 65535) / 65536;
+    RecordingProgress progress(byteReports + 1);
+    CountingResource resource;
+    std::istringstream stream(content);
+    REQUIRE_THROWS_AS(reader.readModelFromStream(stream, &resource, progress),
+                      ReadCancelled);
+    REQUIRE(progress.reports.back().phase == "entities");
+    REQUIRE(resource.allocations > 0);
+    REQUIRE(resource.outstanding == 0);
+  }
+}
+
+TEST_CASE("Listing past its deadline returns an error line") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::fake::FakeCadModelReaderAdapter reader;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  source.registerContent("mem:big", makeFakeModel(100, 40).text);
+  cad::usecase::ListModelPartsUseCase usecase(source, reader, logger);
+
+  CancellableProgress expired;
+  expired.setDeadline(CancellableProgress::Clock::now());
+  REQUIRE(usecase.list("mem:big", &expired) ==
+          std::vector<std::string>{"ERROR: read cancelled"});
+  REQUIRE(expired.timedOut());
+
+  CancellableProgress generous;
+  generous.setTimeout(std::chrono::hours(1));
+  REQUIRE(usecase.list("mem:big", &generous).size() > 1);
+}
+
+TEST_CASE("TerminalProgressAdapter formats bytes and entity counts") {
+  using cad::adapters::terminal::TerminalProgressAdapter;
+  REQUIRE(TerminalProgressAdapter::format("bytes", 1 << 20, 4 << 20) ==
+          "bytes 1.0/4.0 MB (25%)");
+  REQUIRE(TerminalProgressAdapter::format("bytes", 3 << 19, 0) == "bytes 1.5 MB");
+  REQUIRE(TerminalProgressAdapter::format("entities", 2048, 0) == "entities 2048");
+  REQUIRE(TerminalProgressAdapter::format("transfer", 500, 1000) ==
+          "transfer 500/1000 (50%)");
+
+  std::ostringstream out;
+  {
+    TerminalProgressAdapter display(out, std::chrono::hours(1));
+    display.report("entities", 1024, 0);
+    display.report("entities", 2048, 0); // throttled
+  }
+  REQUIRE(out.str() == "\r\x1b[Kentities 1024\r\x1b[K");
+}
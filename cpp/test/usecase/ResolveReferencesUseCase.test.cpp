@@ -0,0 +1,247 @@
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <string_view>
+#include <string>
+#include <vector>
+
+#include "cpp/cad/adapters/cad-model-reader/json/JsonCadModelReaderAdapter.hpp"
+#include "cpp/cad/adapters/logger/fake/FakeLoggerAdapter.hpp"
+#include "cpp/cad/adapters/model-data-source/fake/FakeModelDataSourceAdapter.hpp"
+#include "cpp/cad/core/usecase/ResolveReferencesUseCase.hpp"
+
+using cad::domain::Assembly;
+using cad::domain::Model;
+using cad::domain::ModelArena;
+using cad::domain::Part;
+using cad::domain::Placement;
+using cad::usecase::ResolveReferencesUseCase;
+
+namespace {
+
+bool near(double a, double b) { return std::abs(a - b) < 1e-9; }
+
+Placement translation(double x, double y, double z) {
+  Placement placement;
+  placement.translation = {x, y, z};
+  return placement;
+}
+
+Part &addPart(Assembly &assembly, const char *name, const char *reference = "",
+              const Placement &placement = Placement()) {
+  Part &part = assembly.parts.emplace_back();
+  part.name = name;
+  part.reference = reference;
+  part.placement = placement;
+  return part;
+}
+
+// Builds the model named by the stream's content and counts reads per name,
+// so tests can place parts and prototypes the JSON format has no field for.
+class StubReader final : public cad::ports::CadModelReaderPort {
+public:
+  std::map<std::string, std::function<void(Model &)>> models;
+  std::map<std::string, std::atomic<int>> reads;
+
+  using CadModelReaderPort::readModelFromStream;
+  Model readModelFromStream(std::istream &stream,
+                            std::pmr::memory_resource *resource) override {
+    std::string key(std::istreambuf_iterator<char>(stream), {});
+    auto model = models.find(key);
+    if (model == models.end()) {
+      throw std::runtime_error("no such model: " + key);
+    }
+    ++reads.at(key);
+    Model result(cad::domain::DomainAllocator{resource});
+    result.root.name = key;
+    model->second(result);
+    return result;
+  }
+
+  // Registers a model stored at `locator` whose content is its own name.
+  void add(cad::adapters::fake::FakeModelDataSourceAdapter &source,
+           const std::string &locator, std::function<void(Model &)> build) {
+    source.registerContent(locator, locator);
+    models[locator] = std::move(build);
+    reads[locator] = 0;
+  }
+};
+
+struct Fixture {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  StubReader reader;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  cad::concurrency::ThreadPool pool{4};
+  ResolveReferencesUseCase usecase{source, reader, logger, pool};
+};
+
+} // namespace
+
+TEST_CASE("resolveLocator is relative to the referencing file",
+          "[usecase][references]") {
+  CHECK(ResolveReferencesUseCase::resolveLocator("models/top.step", "bolt.step") ==
+        "models/bolt.step");
+  CHECK(ResolveReferencesUseCase::resolveLocator("models/top.step",
+                                                 "sub/../parts/bolt.step") ==
+        "models/parts/bolt.step");
+  CHECK(ResolveReferencesUseCase::resolveLocator("top.step", "bolt.step") ==
+        "bolt.step");
+  CHECK(ResolveReferencesUseCase::resolveLocator("models/top.step", "/lib/bolt.step") ==
+        "/lib/bolt.step");
+}
+
+TEST_CASE("compose applies the inner placement first", "[domain][references]") {
+  Placement outer = translation(10, 0, 0);
+  outer.linear = {0, -1, 0, 1, 0, 0, 0, 0, 1}; // 90 degrees about z
+  Placement inner = translation(1, 2, 3);
+
+  Placement composed = cad::domain::compose(outer, inner);
+  cad::domain::Point3 expected = outer.apply(inner.apply({1, 1, 1}));
+  cad::domain::Point3 actual = composed.apply({1, 1, 1});
+  for (int axis = 0; axis < 3; ++axis) {
+    CHECK(near(actual[axis], expected[axis]));
+  }
+  CHECK(cad::domain::compose(Placement(), inner).translation == inner.translation);
+}
+
+TEST_CASE("References are replaced by the referenced models",
+          "[usecase][references]") {
+  Fixture f;
+  f.reader.add(f.source, "cad/top", [](Model &model) {
+    addPart(model.root, "Base");
+    addPart(model.root, "Left arm", "arm", translation(-5, 0, 0));
+    Assembly &frame = model.root.children.emplace_back();
+    frame.name = "Frame";
+    addPart(frame, "Right arm", "arm", translation(5, 0, 0));
+  });
+  f.reader.add(f.source, "cad/arm", [](Model &model) {
+    addPart(model.root, "Beam", "", translation(0, 1, 0)).prototypeId = "0:1:1:1";
+    addPart(model.root, "Hand", "parts/hand");
+  });
+  f.reader.add(f.source, "cad/parts/hand", [](Model &model) {
+    addPart(model.root, "Finger", "", translation(0, 0, 2)).prototypeId = "0:1:1:1";
+  });
+
+  ModelArena arena;
+  ResolveReferencesUseCase::Stats stats;
+  const Model &model = f.usecase.load("cad/top", arena, &stats);
+
+  // Each file is read once, however often it is referenced
+  CHECK(stats.filesRead == 3);
+  CHECK(stats.resolved == 4);
+  CHECK(stats.unresolved == 0);
+  CHECK(f.reader.reads.at("cad/arm") == 1);
+  CHECK(f.reader.reads.at("cad/parts/hand") == 1);
+
+  REQUIRE(model.root.parts.size() == 1);
+  CHECK(model.root.parts[0].name == "Base");
+  REQUIRE(model.root.children.size() == 2);
+  CHECK(model.root.children[0].name == "Frame");
+  const Assembly &left = model.root.children[1];
+  CHECK(left.name == "Left arm");
+  REQUIRE(left.parts.size() == 1);
+  const Part &beam = left.parts[0];
+  CHECK(beam.name == "Beam");
+  CHECK(beam.prototypeId == "cad/arm#0:1:1:1");
+  CHECK(beam.placement.translation == cad::domain::Point3{-5, 1, 0});
+
+  // Nested references are resolved relative to the file naming them, and
+  // placements compose all the way down
+  REQUIRE(left.children.size() == 1);
+  const Assembly &hand = left.children[0];
+  CHECK(hand.name == "Hand");
+  REQUIRE(hand.parts.size() == 1);
+  CHECK(hand.parts[0].prototypeId == "cad/parts/hand#0:1:1:1");
+  CHECK(hand.parts[0].placement.translation == cad::domain::Point3{-5, 0, 2});
+
+  const Assembly &frame = model.root.children[0];
+  CHECK(frame.parts.empty());
+  REQUIRE(frame.children.size() == 1);
+  CHECK(frame.children[0].parts[0].placement.translation ==
+        cad::domain::Point3{5, 1, 0});
+  CHECK(frame.children[0].children[0].parts[0].placement.translation ==
+        cad::domain::Point3{5, 0, 2});
+}
+
+TEST_CASE("Missing and cyclic references stay plain parts",
+          "[usecase][references]") {
+  Fixture f;
+  f.reader.add(f.source, "top", [](Model &model) {
+    addPart(model.root, "Gone", "missing");
+    addPart(model.root, "Loop", "loop");
+  });
+  f.reader.add(f.source, "loop", [](Model &model) {
+    addPart(model.root, "Back", "top");
+    addPart(model.root, "Self", "loop");
+  });
+
+  ModelArena arena;
+  ResolveReferencesUseCase::Stats stats;
+  const Model &model = f.usecase.load("top", arena, &stats);
+
+  CHECK(f.reader.reads.at("top") == 1);
+  CHECK(f.reader.reads.at("loop") == 1);
+  CHECK(stats.resolved == 1);
+  CHECK(stats.unresolved == 3);
+  REQUIRE(model.root.parts.size() == 1);
+  CHECK(model.root.parts[0].name == "Gone");
+  REQUIRE(model.root.children.size() == 1);
+  const Assembly &loop = model.root.children[0];
+  REQUIRE(loop.parts.size() == 2);
+  CHECK(loop.parts[0].reference == "top");
+  CHECK(loop.parts[1].reference == "loop");
+}
+
+TEST_CASE("A cancelled read of a referenced file stops the whole load",
+          "[usecase][references]") {
+  Fixture f;
+  f.reader.add(f.source, "top", [](Model &model) {
+    addPart(model.root, "Arm", "arm");
+    addPart(model.root, "Leg", "leg");
+  });
+  f.reader.add(f.source, "arm", [](Model &) {});
+  f.reader.add(f.source, "leg", [](Model &) {});
+
+  // Cancelled as soon as any referenced file has been read
+  struct CancelAfterTop final : cad::ports::ProgressPort {
+    StubReader &reader;
+    explicit CancelAfterTop(StubReader &r) : reader(r) {}
+    void report(std::string_view, std::uint64_t, std::uint64_t) override {}
+    bool cancelled() override { return reader.reads.at("arm") + reader.reads.at("leg") > 0; }
+  } progress(f.reader);
+
+  CHECK(f.usecase.list("top", &progress) == std::vector<std::string>{"ERROR: read cancelled"});
+  CHECK(f.usecase.list("top") == std::vector<std::string>{
+                                     "Assembly: top", "  Assembly: Arm", "  Assembly: Leg"});
+}
+
+TEST_CASE("list stitches JSON files and reports open errors",
+          "[usecase][references]") {
+  cad::adapters::fake::FakeModelDataSourceAdapter source;
+  cad::adapters::json::JsonCadModelReaderAdapter reader;
+  cad::adapters::fake::FakeLoggerAdapter logger;
+  cad::concurrency::ThreadPool pool(2);
+  source.registerContent("plant/line.json", R"({
+    "assemblies": [{"id": "root", "name": "Line", "parent_id": null}],
+    "parts": [
+      {"id": "p1", "name": "Press", "assembly_id": "root", "reference": "press.json"},
+      {"id": "p2", "name": "Spare", "assembly_id": "root", "reference": "x/../press.json"}
+    ]})");
+  source.registerContent("plant/press.json", R"({
+    "assemblies": [{"id": "root", "name": "Press", "parent_id": null}],
+    "parts": [{"id": "ram", "name": "Ram", "assembly_id": "root"}]})");
+
+  ResolveReferencesUseCase usecase(source, reader, logger, pool);
+  std::vector<std::string> lines = usecase.list("plant/line.json");
+  CHECK(lines == std::vector<std::string>{"Assembly: Line", "  Assembly: Press",
+                                          "    Part: Ram", "  Assembly: Spare",
+                                          "    Part: Ram"});
+
+  CHECK(usecase.list("plant/none.json") ==
+        std::vector<std::string>{"ERROR: failed to open locator"});
+}
@@ -26,6 +26,8 @@ pkgs.mkShell {
     spdlog
     nlohmann_json
     opencascade-occt
+    zlib
+    zstd
     git
     nickel
     mask
@@ -43,6 +45,6 @@ pkgs.mkShell {
     echo "Tools: cmake, ninja, clang/lld/libc++, catch2 (${catch2Pkg.pname or "catch2"} ${catch2Pkg.version or ""}), spdlog, nlohmann_json, opencascade-occt"
     export CMAKE_GENERATOR=Ninja
     # Ensure CMake can find packages from Nix buildInputs
-    export CMAKE_PREFIX_PATH="${catch2Pkg}:${pkgs.spdlog}:${pkgs.nlohmann_json}:${pkgs.opencascade-occt}:$CMAKE_PREFIX_PATH"
+    export CMAKE_PREFIX_PATH="${catch2Pkg}:${pkgs.spdlog}:${pkgs.nlohmann_json}:${pkgs.opencascade-occt}:${pkgs.zlib.dev}:$CMAKE_PREFIX_PATH"
   '';
 }